@@ -8,6 +8,8 @@ set(Core_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/ContextInstancerDefault.h
     ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParserKeyword.h
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementDefinition.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/ElementRenderCache.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/MemoryUsageUtilities.h
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorOnlyChild.h
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorNoneInstancer.h
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiledHorizontal.h
@@ -23,6 +25,10 @@ set(Core_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/FontEffectShadowInstancer.h
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorLastOfType.h
     ${PROJECT_SOURCE_DIR}/Source/Core/TextureLayoutRow.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/ElementAncestorFilter.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/Threading.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/TaskPool.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/ParallelLayout.h
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementBackground.h
     ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParserString.h
     ${PROJECT_SOURCE_DIR}/Source/Core/TextureResource.h
@@ -46,8 +52,11 @@ set(Core_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/FontFaceLayer.h
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementImage.h
     ${PROJECT_SOURCE_DIR}/Source/Core/FontFamily.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/FontKerning.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/FontDistanceField.h
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiled.h
     ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParserColour.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParserLinearGradient.h
     ${PROJECT_SOURCE_DIR}/Source/Core/XMLParseTools.h
     ${PROJECT_SOURCE_DIR}/Source/Core/WidgetSliderScroll.h
     ${PROJECT_SOURCE_DIR}/Source/Core/LayoutBlockBoxSpace.h
@@ -61,11 +70,15 @@ set(Core_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/FontEffectNone.h
     ${PROJECT_SOURCE_DIR}/Source/Core/FontEffectShadow.h
     ${PROJECT_SOURCE_DIR}/Source/Core/TextureDatabase.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/TextureLoader.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/ImageDecoder.h
     ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParserNumber.h
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiledVertical.h
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorNthChild.h
     ${PROJECT_SOURCE_DIR}/Source/Core/TextureLayoutRectangle.h
     ${PROJECT_SOURCE_DIR}/Source/Core/LayoutInlineBox.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/GeometryBatch.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/GeometryBuffer.h
     ${PROJECT_SOURCE_DIR}/Source/Core/GeometryDatabase.h
     ${PROJECT_SOURCE_DIR}/Source/Core/FontEffectOutlineInstancer.h
     ${PROJECT_SOURCE_DIR}/Source/Core/TextureLayoutTexture.h
@@ -102,10 +115,13 @@ set(Core_PUB_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/ElementInstancerGeneric.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/FileInterface.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/MathTypes.h
+    ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/MemoryUsage.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/ElementInstancer.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/PropertySpecification.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Property.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Plugin.h
+    ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/ProfileTraceWriter.h
+    ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Profiler.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/ElementReference.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/StreamMemory.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/WString.h
@@ -119,6 +135,7 @@ set(Core_PUB_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/ReferenceCountable.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/StringUtilities.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Vertex.h
+    ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/TextShader.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/ElementUtilities.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Factory.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Stream.h
@@ -138,6 +155,7 @@ set(Core_PUB_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Debug.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/URL.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Input.h
+    ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/LinearGradient.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Event.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Geometry.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Font.h
@@ -167,6 +185,8 @@ set(Core_SRC_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementHandle.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/XMLNodeHandlerBody.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/TextureDatabase.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/TextureLoader.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/ImageDecoder.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiledBox.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetParser.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/Core.cpp
@@ -175,6 +195,10 @@ set(Core_SRC_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/String.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/ReferenceCountable.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorLastOfType.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/ElementAncestorFilter.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/Threading.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/TaskPool.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/ParallelLayout.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementBackground.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiledHorizontal.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/EventDispatcher.cpp
@@ -185,6 +209,8 @@ set(Core_SRC_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiledBoxInstancer.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/Event.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/Clock.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/GeometryBatch.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/GeometryBuffer.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/GeometryDatabase.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorOnlyChild.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/FontEffectInstancer.cpp
@@ -245,6 +271,8 @@ set(Core_SRC_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiledImageInstancer.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/FontEffectOutline.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/FontFamily.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/FontKerning.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/FontDistanceField.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/WString.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/URL.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/FontEffectShadowInstancer.cpp
@@ -260,6 +288,8 @@ set(Core_SRC_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/SystemInterface.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementBorder.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/Plugin.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/ProfileTraceWriter.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/Profiler.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/LayoutLineBox.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/TextureLayoutRectangle.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/TextureResource.cpp
@@ -290,8 +320,11 @@ set(Core_SRC_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorOnlyOfType.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParserString.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParserColour.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParserLinearGradient.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/Factory.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementDefinition.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/ElementRenderCache.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/MemoryUsage.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/LayoutInlineBox.cpp
 )
 
@@ -385,6 +418,10 @@ set(Debugger_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Source/Debugger/Plugin.h
     ${PROJECT_SOURCE_DIR}/Source/Debugger/LogSource.h
     ${PROJECT_SOURCE_DIR}/Source/Debugger/ElementInfo.h
+    ${PROJECT_SOURCE_DIR}/Source/Debugger/ElementProfiler.h
+    ${PROJECT_SOURCE_DIR}/Source/Debugger/ProfilerSource.h
+    ${PROJECT_SOURCE_DIR}/Source/Debugger/ElementMemory.h
+    ${PROJECT_SOURCE_DIR}/Source/Debugger/MemorySource.h
     ${PROJECT_SOURCE_DIR}/Source/Debugger/BeaconSource.h
     ${PROJECT_SOURCE_DIR}/Source/Debugger/Geometry.h
     ${PROJECT_SOURCE_DIR}/Source/Debugger/MenuSource.h
@@ -403,6 +440,8 @@ set(Debugger_SRC_FILES
     ${PROJECT_SOURCE_DIR}/Source/Debugger/ElementInfo.cpp
     ${PROJECT_SOURCE_DIR}/Source/Debugger/Debugger.cpp
     ${PROJECT_SOURCE_DIR}/Source/Debugger/ElementLog.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Debugger/ElementProfiler.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Debugger/ElementMemory.cpp
     ${PROJECT_SOURCE_DIR}/Source/Debugger/ElementContextHook.cpp
     ${PROJECT_SOURCE_DIR}/Source/Debugger/SystemInterface.cpp
     ${PROJECT_SOURCE_DIR}/Source/Debugger/Plugin.cpp
@@ -1,5 +1,12 @@
 # This file was auto-generated with gen_samplelists.sh
 
+set(benchmark_HDR_FILES
+)
+
+set(benchmark_SRC_FILES
+    ${PROJECT_SOURCE_DIR}/Samples/basic/benchmark/src/main.cpp
+)
+
 set(customlog_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Samples/basic/customlog/src/SystemInterface.h
 )
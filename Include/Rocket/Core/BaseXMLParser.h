@@ -59,6 +59,16 @@ class ROCKETCORE_API BaseXMLParser
 		/// interesting phenomena are encountered.
 		void Parse(Stream* stream);
 
+		/// Begins parsing the given stream incrementally. The stream is read by subsequent calls to ContinueParse(),
+		/// and must remain valid until the parse has completed.
+		/// @param[in] stream The stream to parse.
+		void BeginParse(Stream* stream);
+		/// Continues an incremental parse until the stream is exhausted or the budget for this call is spent.
+		/// @param[in] max_elements The number of element tags to open before returning, or -1 for no limit.
+		/// @param[in] max_time The time to parse for before returning, in seconds (as measured by the system interface), or a negative value for no limit.
+		/// @return True if the parse has completed, false if there is more of the stream to parse.
+		bool ContinueParse(int max_elements, float max_time);
+
 		/// Get the line number in the stream.
 		/// @return The line currently being processed in the XML stream.
 		int GetLineNumber();
@@ -76,7 +86,10 @@ class ROCKETCORE_API BaseXMLParser
 
 	private:
 		void ReadHeader();
-		void ReadBody();
+		// Reads the next tag (and any data preceding it) from the body, returning false if the body has ended.
+		bool ReadBodyTag();
+		// Ends the parse and releases the buffer.
+		void EndParse();
 
 		bool ReadOpenTag();
 		bool ReadCloseTag();
@@ -102,8 +115,12 @@ class ROCKETCORE_API BaseXMLParser
 		unsigned char* buffer;
 		int buffer_size;
 		int buffer_used;
+		// True if the buffer is the stream's own memory, which is parsed in place rather than copied.
+		bool buffer_in_place;
 		int line_number;
 		int open_tag_depth;
+		// The number of element tags opened during the parse.
+		int num_open_tags_read;
 
 		// The element attributes being read.
 		XMLAttributes attributes;
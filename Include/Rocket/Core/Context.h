@@ -41,6 +41,7 @@ namespace Core {
 
 class Stream;
 class Dictionary;
+class XMLParser;
 
 }
 }
@@ -51,6 +52,7 @@ namespace Core {
 class ContextInstancer;
 class ElementDocument;
 class EventListener;
+class MemoryUsage;
 class RenderInterface;
 
 /**
@@ -104,6 +106,26 @@ public:
 	/// @param[in] string The string containing the document RML.
 	/// @return The loaded document, or NULL if no document was loaded. The document is returned with a reference owned by the caller.
 	ElementDocument* LoadDocumentFromMemory(const String& string);
+	/// Begins loading a document into the context incrementally. Rather than being instanced all at once, the
+	/// document's elements are instanced over the following calls to Update(), within the budget set by
+	/// SetDocumentLoadBudget(); if the document is shown, its content appears as it is parsed. Its event attributes
+	/// are bound and its 'load' event is sent once it has finished loading. Elements that have been parsed must not
+	/// be removed from the document until it has finished loading.
+	/// @param[in] document_path The path to the document to load.
+	/// @return The loading document, or NULL if no document could be loaded. The document is returned with a reference owned by the caller.
+	ElementDocument* LoadDocumentIncremental(const String& document_path);
+	/// Begins loading a document into the context incrementally.
+	/// @param[in] document_stream The opened stream, ready to read. The context holds a reference to the stream until the document has loaded.
+	/// @return The loading document, or NULL if no document could be loaded. The document is returned with a reference owned by the caller.
+	ElementDocument* LoadDocumentIncremental(Stream* document_stream);
+	/// Returns true if a document is still being loaded incrementally.
+	/// @param[in] document The document to check.
+	/// @return True if the document's stream has not been fully parsed yet.
+	bool IsDocumentLoading(ElementDocument* document) const;
+	/// Sets how much of each incrementally-loading document is parsed on each update.
+	/// @param[in] max_elements The number of elements to instance per document on each update, or -1 for no limit. The default is no limit.
+	/// @param[in] max_time The time to spend parsing each document on each update, in seconds, or a negative value for no limit. The default is 4ms.
+	void SetDocumentLoadBudget(int max_elements, float max_time);
 	/// Unload the given document.
 	/// @param[in] document The document to unload.
 	void UnloadDocument(ElementDocument* document);
@@ -212,6 +234,17 @@ public:
 	/// @return True if the event was not consumed (ie, was prevented from propagating by an element), false if it was.
 	bool ProcessMouseWheel(int wheel_delta, int key_modifier_state);
 
+	/// Enables or disables queueing of input. While input is queued, the Process...() functions store their events
+	/// rather than sending them, and the queue is processed in order at the start of the next call to Update();
+	/// consecutive mouse movements are coalesced into one, so the hover state is only rebuilt once between other
+	/// input events. Queued events are reported as not consumed. Disabling queueing processes any pending input
+	/// immediately. Input is not queued by default.
+	/// @param[in] queue_input True to queue input until the next update, false to process it as it is received.
+	void SetInputQueueing(bool queue_input);
+	/// Returns true if input is queued until the next update.
+	/// @return True if input queueing is enabled.
+	bool IsInputQueueing() const;
+
 	/// Gets the context's render interface.
 	/// @return The render interface the context renders through.
 	RenderInterface* GetRenderInterface() const;
@@ -223,6 +256,15 @@ public:
 	/// @param[out] origin The clipping origin
 	/// @param[out] dimensions The clipping dimensions
 	void SetActiveClipRegion(const Vector2i& origin, const Vector2i& dimensions);
+	/// Forgets the scissor state last sent to the render interface, so the active clipping region is reapplied in
+	/// full the next time it is set. This only needs to be called if the render interface's scissor state has been
+	/// changed outside of Rocket during the render traversal.
+	void DirtyScissorRegion();
+
+	/// Adds an estimate of the memory held by the context's documents and their elements to a breakdown. Resources
+	/// shared between contexts, such as textures, are not included; see Rocket::Core::GetMemoryUsage().
+	/// @param[out] usage The breakdown to add to.
+	void GetMemoryUsage(MemoryUsage& usage);
 
 	/// Sets the instancer to use for releasing this object.
 	/// @param[in] instancer The context's instancer.
@@ -239,8 +281,8 @@ private:
 
 	typedef std::set< ElementReference > ElementSet;
 	typedef std::vector< ElementReference > ElementList;
-	// Set of elements that are currently in hover state.
-	ElementSet hover_chain;
+	// Elements that are currently in hover state, from the hover element up to the root.
+	ElementList hover_chain;
 	// List of elements that are currently in active state.
 	ElementList active_chain;
 	// History of windows that have had focus
@@ -249,6 +291,20 @@ private:
 	// Documents that have been unloaded from the context but not yet released.
 	ElementList unloaded_documents;
 
+	// A document being loaded incrementally, and the parser reading it.
+	struct LoadingDocument
+	{
+		ElementDocument* document;
+		XMLParser* parser;
+		Stream* stream;
+	};
+	typedef std::vector< LoadingDocument > LoadingDocumentList;
+	LoadingDocumentList loading_documents;
+
+	// The budget each loading document is parsed with on each update.
+	int load_budget_elements;
+	float load_budget_time;
+
 	// Root of the element tree.
 	Element* root;
 	// The element that current has input focus.
@@ -283,9 +339,40 @@ private:
 	// The element currently being dragged over; this is equivalent to hover, but only set while an element is being
 	// dragged, and excludes the dragged element.
 	ElementReference drag_hover;
-	// Set of elements that are currently being dragged over; this differs from the hover state as the dragged element
-	// itself can't be part of it.
-	ElementSet drag_hover_chain;
+	// Elements that are currently being dragged over, from the drag hover element up to the root; this differs from
+	// the hover state as the dragged element itself can't be part of it.
+	ElementList drag_hover_chain;
+
+	// An input event received while input is being queued.
+	enum InputEventType
+	{
+		INPUT_KEY_DOWN,
+		INPUT_KEY_UP,
+		INPUT_TEXT_CHARACTER,
+		INPUT_TEXT_STRING,
+		INPUT_MOUSE_MOVE,
+		INPUT_MOUSE_BUTTON_DOWN,
+		INPUT_MOUSE_BUTTON_UP,
+		INPUT_MOUSE_WHEEL
+	};
+
+	struct InputEvent
+	{
+		InputEventType type;
+		// The key identifier, character, button index, wheel delta or x-coordinate of the event.
+		int value;
+		// The y-coordinate of a mouse movement.
+		int y;
+		int key_modifier_state;
+		String text;
+	};
+	typedef std::vector< InputEvent > InputQueue;
+
+	// Input events waiting for the next update, in the order they were received.
+	InputQueue input_queue;
+	bool input_queueing;
+	// True while the input queue is being processed, so the events are sent rather than queued again.
+	bool processing_input_queue;
 
 	// Input state; stored from the most recent input events we receive from the application.
 	Vector2i mouse_position;
@@ -295,6 +382,12 @@ private:
 	Vector2i clip_origin;
 	Vector2i clip_dimensions;
 
+	// The scissor state last sent to the render interface; used to skip redundant scissor calls.
+	bool scissor_dirty;
+	bool scissor_enabled;
+	Vector2i scissor_origin;
+	Vector2i scissor_dimensions;
+
 	// Internal callback for when an element is removed from the hierarchy.
 	void OnElementRemove(Element* element);
 	// Internal callback for when a new element gains focus.
@@ -303,6 +396,12 @@ private:
 	// Generates an event for faking clicks on an element.
 	void GenerateClickEvent(Element* element);
 
+	// Adds an event to the input queue if input is being queued, coalescing it with the previous event if both are
+	// mouse movements. Returns false if the event should be processed immediately.
+	bool QueueInputEvent(InputEventType type, int value, int y, int key_modifier_state, const String& text = String());
+	// Sends all queued input events in the order they were received.
+	void ProcessInputQueue();
+
 	// Updates the current hover elements, sending required events.
 	void UpdateHoverChain(const Dictionary& parameters, const Dictionary& drag_parameters, const Vector2i& old_mouse_position);
 	// Returns the youngest descendent of the given element which is under the given point in screen coordinates.
@@ -331,6 +430,16 @@ private:
 	// Releases all unloaded documents pending destruction.
 	void ReleaseUnloadedDocuments();
 
+	// Parses the next part of each incrementally-loading document, finishing the documents that are complete.
+	void UpdateLoadingDocuments();
+	// Stops loading a document incrementally, releasing its parser and stream.
+	void CancelDocumentLoad(ElementDocument* document);
+	// Binds the events of a newly-loaded document, lays it out and sends its load notifications.
+	void FinishDocumentLoad(ElementDocument* document);
+
+	// Updates the layout of all documents, formatting them in parallel if parallel layout is enabled.
+	void UpdateDocumentLayouts();
+
 
 	ElementList anim_handles;
 
@@ -339,8 +448,14 @@ private:
 
 	// Sends the specified event to all elements in new_items that don't appear in old_items.
 	static void SendEvents(const ElementSet& old_items, const ElementSet& new_items, const String& event, const Dictionary& parameters, bool interruptible);
+	// Builds the chain of elements from an element up to the root.
+	static void BuildChain(Element* element, ElementList& chain);
+	// Sends the 'out' event to the elements of the old chain and the 'over' event to the elements of the new chain
+	// that lie below the chains' common ancestor.
+	static void SendChainEvents(const ElementList& old_chain, const ElementList& new_chain, const String& out_event, const String& over_event, const Dictionary& parameters);
 
 	friend class Element;
+	friend class ElementUtilities;
 	friend ROCKETCORE_API Context* CreateContext(const String&, const Vector2i&, RenderInterface*);
 };
 
@@ -58,7 +58,10 @@
 #include <Rocket/Core/GeometryUtilities.h>
 #include <Rocket/Core/Input.h>
 #include <Rocket/Core/Log.h>
+#include <Rocket/Core/MemoryUsage.h>
 #include <Rocket/Core/Plugin.h>
+#include <Rocket/Core/ProfileTraceWriter.h>
+#include <Rocket/Core/Profiler.h>
 #include <Rocket/Core/Property.h>
 #include <Rocket/Core/PropertyDefinition.h>
 #include <Rocket/Core/PropertyDictionary.h>
@@ -70,6 +73,7 @@
 #include <Rocket/Core/StyleSheetKeywords.h>
 #include <Rocket/Core/StyleSheetSpecification.h>
 #include <Rocket/Core/SystemInterface.h>
+#include <Rocket/Core/TextShader.h>
 #include <Rocket/Core/Texture.h>
 #include <Rocket/Core/Types.h>
 #include <Rocket/Core/Vertex.h>
@@ -141,11 +145,62 @@ ROCKETCORE_API int GetNumContexts();
 /// Registers a generic Rocket plugin.
 ROCKETCORE_API void RegisterPlugin(Plugin* plugin);
 
-/// Forces all compiled geometry handles generated by libRocket to be released.
+/// Forces all compiled geometry handles and geometry buffers generated by libRocket to be released.
 ROCKETCORE_API void ReleaseCompiledGeometries();
 /// Forces all texture handles loaded and generated by libRocket to be released.
 ROCKETCORE_API void ReleaseTextures();
 
+/// Sets the maximum amount of texture memory that elements with a 'render-cache' may use for their offscreen render
+/// targets. Elements that would exceed the budget are rendered normally.
+/// @param[in] budget The budget, in bytes. The default is 16MB.
+ROCKETCORE_API void SetRenderCacheBudget(size_t budget);
+/// Returns the maximum amount of texture memory render caches may use.
+/// @return The render cache budget, in bytes.
+ROCKETCORE_API size_t GetRenderCacheBudget();
+/// Sets the number of threads used to lay out documents. With more than one thread, the documents of a context are
+/// formatted in parallel; events raised during their layout are dispatched on the calling thread once it has finished. Custom elements' OnLayout() may then be called from any
+/// of the threads. The work is run through the system interface's ParallelFor(), so an application that provides its
+/// own job system only needs to set this above one to enable parallel layout; libRocket will start no threads itself.
+/// @param[in] num_threads The number of threads, including the calling thread. The default of one lays out on the
+/// calling thread only; zero uses one thread per processor.
+ROCKETCORE_API void SetLayoutThreads(int num_threads);
+/// Returns the number of threads used to lay out documents.
+/// @return The number of layout threads, including the calling thread.
+ROCKETCORE_API int GetLayoutThreads();
+/// Sets the number of worker threads the default system interface starts to run background jobs, such as texture
+/// decodes, on. These threads are shared with parallel layout, so the pool has as many as either setting needs, and
+/// are only started once a job is submitted.
+/// @param[in] num_threads The number of threads. The default is one; zero runs background jobs on the thread that
+/// submits them, and a negative number uses one thread per processor.
+ROCKETCORE_API void SetBackgroundThreads(int num_threads);
+/// Returns the number of worker threads that run background jobs.
+/// @return The number of background threads.
+ROCKETCORE_API int GetBackgroundThreads();
+/// Enables or disables loading textures in the background. When enabled, a texture's file is read through the file
+/// interface and decoded through RenderInterface::DecodeTexture() on a job submitted through the system interface,
+/// so both must be safe to call from another thread; the pixels are then passed to RenderInterface::GenerateTexture()
+/// the next time a context is rendered. Until then, the texture is drawn with the placeholder texture, and elements
+/// using it are sent a 'load' event once it is ready. The default system interface runs the jobs on its own worker
+/// threads, independently of the number of layout threads; see SetBackgroundThreads().
+/// @param[in] enable True to load textures in the background, false to load them when they are first used. The default is false.
+ROCKETCORE_API void SetAsyncTextureLoading(bool enable);
+/// Returns true if textures are loaded in the background.
+/// @return True if background loading is enabled.
+ROCKETCORE_API bool GetAsyncTextureLoading();
+/// Sets the texture drawn in place of textures that are loading in the background. The placeholder itself is always
+/// loaded immediately.
+/// @param[in] source The placeholder's source, or the empty string to draw nothing until textures are ready.
+ROCKETCORE_API void SetTexturePlaceholder(const String& source);
+/// Adds an estimate of the memory held by resources shared between all contexts, such as font and image textures, to
+/// a breakdown. Use Context::GetMemoryUsage() and ElementDocument::GetMemoryUsage() for the memory held by contexts
+/// and documents.
+/// @param[out] usage The breakdown to add to.
+ROCKETCORE_API void GetMemoryUsage(MemoryUsage& usage);
+
+/// Returns the amount of texture memory currently used by render caches.
+/// @return The render cache memory usage, in bytes.
+ROCKETCORE_API size_t GetRenderCacheMemoryUsage();
+
 }
 }
 
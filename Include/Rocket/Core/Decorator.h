@@ -118,6 +118,7 @@ private:
 	// Stores a list of textures in use by this decorator.
 	std::vector< Texture > textures;
 
+	friend class ElementDecoration;
 	friend class Factory;
 };
 
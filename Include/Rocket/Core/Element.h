@@ -47,6 +47,7 @@ namespace Core {
 
 class Context;
 class Decorator;
+class ElementAncestorFilter;
 class ElementInstancer;
 class EventDispatcher;
 class EventListener;
@@ -55,9 +56,11 @@ class ElementBorder;
 class ElementDecoration;
 class ElementDefinition;
 class ElementDocument;
+class ElementRenderCache;
 class ElementScroll;
 class ElementStyle;
 class FontFaceHandle;
+class MemoryUsage;
 class PropertyDictionary;
 class RenderInterface;
 class StyleSheet;
@@ -77,6 +80,7 @@ public:
 	Element(const String& tag);
 	virtual ~Element();
 
+	/// Updates the element and any of its descendants that have scheduled an update.
 	void Update();
 	void Render();
 
@@ -238,6 +242,12 @@ public:
 	/// Returns local 'width' and 'height' properties from element's style or local cache,
 	/// ignoring default values.
 	void GetLocalDimensionProperties(const Property **width, const Property **height);
+	/// Returns local 'min-width', 'max-width', 'min-height' and 'max-height' properties from element's style or
+	/// local cache, ignoring default values.
+	void GetLocalMinMaxDimensionProperties(const Property **min_width, const Property **max_width, const Property **min_height, const Property **max_height);
+	/// Returns local 'top', 'right', 'bottom' and 'left' properties from element's style or local cache,
+	/// ignoring default values.
+	void GetLocalOffsetProperties(const Property **top, const Property **right, const Property **bottom, const Property **left);
 	/// Returns 'overflow' properties' values from element's style or local cache.
 	void GetOverflow(int *overflow_x, int *overflow_y);
 	/// Returns 'position' property value from element's style or local cache.
@@ -537,6 +547,16 @@ public:
 	void GetElementsByClassName(ElementList& elements, const String& class_name);
 	//@}
 
+	/**
+		@name Memory Accounting
+	 */
+	//@{
+	/// Adds an estimate of the memory held by this element and its descendants to a breakdown. Shared resources, such
+	/// as style sheets and textures, are not included.
+	/// @param[out] usage The breakdown to add to.
+	virtual void GetMemoryUsage(MemoryUsage& usage);
+	//@}
+
 	/**
 		@name Internal Functions
 	 */
@@ -556,6 +576,14 @@ public:
 	/// Returns the element's scrollbar functionality.
 	/// @return The element's scrolling functionality.
 	ElementScroll* GetElementScroll() const;
+	/// Returns the element's render cache, if it renders its subtree into an offscreen texture.
+	/// @return The element's render cache, or NULL if the element has no 'render-cache'.
+	ElementRenderCache* GetElementRenderCache() const;
+	/// Invalidates the render cache of this element and of any ancestor rendering it through their render cache.
+	void DirtyRenderCache();
+	/// Invalidates the cached clipping region of this element and its descendants. The regions are checked lazily,
+	/// when they are next read.
+	void DirtyClippingRegion();
 	//@}
 	
 	/// Returns true if this element requires clipping
@@ -578,6 +606,11 @@ public:
 	/// Update the element's layout if required.
 	void UpdateLayout();
 
+	/// Schedules the element to be updated, and OnUpdate() called, on the next update of its context. Only elements
+	/// with a scheduled update and their ancestors are visited during an update, so elements that need to do work
+	/// every frame should schedule another update from OnUpdate().
+	void ScheduleUpdate();
+
 	/// Update the element animation
 	bool UpdateAnimation(float delta_time);
 
@@ -589,7 +622,7 @@ protected:
 	/// property.
 	void ForceLocalStackingContext();
 
-	/// Called during the update loop after children are updated.
+	/// Called during the update loop after children are updated, if the element has scheduled an update.
 	virtual void OnUpdate();
 	/// Called during render after backgrounds, borders, decorators, but before children, are rendered.
 	virtual void OnRender();
@@ -630,71 +663,107 @@ protected:
 	virtual void OnReferenceDeactivate();
 
 private:
+	void Update(const ElementAncestorFilter& ancestor_filter);
+
 	void SetParent(Element* parent);
+	// Flags our ancestors as having a scheduled update below them.
+	void ScheduleAncestorUpdates();
 
 	void ReleaseDeletedElements();
 	void ReleaseElements(ElementList& elements);
 
 	void DirtyOffset();
 	void UpdateOffset();
+	void UpdateAbsoluteOffset();
+
+	// Returns true if the cached clipping region is still valid, given the parent's current offset generation.
+	bool IsClippingRegionValid(unsigned int offset_generation) const;
+	// Marks the cached clipping region as resolved against the current state of the element's ancestors.
+	void ValidateClippingRegion(unsigned int offset_generation);
 
 	void BuildLocalStackingContext();
 	void BuildStackingContext(ElementList* stacking_context);
 	void DirtyStackingContext();
+	// Brings our stacking context up to date, rebuilding it if it is dirty or inserting any pending additions.
+	void UpdateStackingContext();
+	// Returns the element establishing the stacking context this element is part of.
+	Element* GetStackingContextParent();
+	// Queues this element and its stacking descendants to be inserted into its parent's stacking context.
+	void AddToStackingContext();
+	// Removes this element and its stacking descendants from its parent's stacking context. If the element is being
+	// removed from the hierarchy, the whole context is searched for its descendants.
+	void RemoveFromStackingContext(bool removing_element);
+	// Inserts a queued element and its stacking descendants into our stacking context after the element preceding it
+	// in paint order. Returns false if the stacking context needs to be rebuilt instead.
+	bool InsertIntoStackingContext(Element* element);
 
 	void DirtyStructure();
 
-	// Original tag this element came from.
-	String tag;
-
-	// The optional, unique ID of this object.
-	String id;
+	float GetElementAnimationDuration( );
+	bool GetElementAnimationIterationCount( int &refCount );
+	const KeyframeProperties *GetElementAnimation( );
+	bool LerpAnimationProperties( const PropertyDictionary &a, const PropertyDictionary &b, float weight );
 
-	// Instancer that created us, used for destruction.
-	ElementInstancer* instancer;
+	// The members below are ordered by how often they are touched. The first group is read by every update, render,
+	// stacking context and layout walk over the tree, so it is kept together at the front of the element; data only
+	// needed by events, scripting or the DOM API comes after it, with the attributes stored out of line.
 
 	// Parent element.
 	Element* parent;
-	// Currently focused child object
-	Element* focus;
-	// The owning document
-	ElementDocument* owner_document;
 
-	// The event dispatcher for this element.
-	EventDispatcher* event_dispatcher;
-	// Style information for this element.
-	ElementStyle* style;
-	// Background functionality for this element.
-	ElementBackground* background;
-	// Border functionality for this element.
-	ElementBorder* border;
-	// Decorator information for this element.
-	ElementDecoration* decoration;
-	// Scrollbar information for this element.
-	ElementScroll* scroll;
-	// Attributes on this element.
-	ElementAttributes attributes;
+	ElementList children;
+	int num_non_dom_children;
+
+	ElementList active_children;
+	ElementList deleted_children;
+
+	// True if the element has scheduled an update, and if any of its descendants have.
+	bool update_scheduled;
+	bool child_update_scheduled;
+
+	ElementList stacking_context;
+	// Elements waiting to be inserted into the stacking context when it is next used.
+	ElementList stacking_context_additions;
+	// The number of elements removed from the stacking context since it was last used.
+	int stacking_context_removals;
+	float z_index;
+
+	// True if the element is visible and active.
+	bool visible;
+	bool local_stacking_context;
+	bool local_stacking_context_forced;
+	bool stacking_context_dirty;
+	// True while the stacking context is being rendered, and so can't be modified in place.
+	bool stacking_context_rendering;
+
+	bool offset_fixed;
+	mutable bool offset_dirty;
+	// Incremented each time the absolute offset is recalculated, and the parent's value at that time; an element's
+	// offset is out of date if its parent's generation has moved on.
+	unsigned int offset_generation;
+	unsigned int parent_offset_generation;
+	// The number of offset changes across all elements when our offset was last validated.
+	int validated_offset_changes;
+
+	// Cached rendering information
+	bool clipping_enabled;
+	bool clipping_state_dirty;
+	int clipping_ignore_depth;
 
 	// The offset of the element, and the element it is offset from.
 	Element* offset_parent;
 	Vector2f relative_offset_base;		// the base offset from the parent
 	Vector2f relative_offset_position;	// the offset of a relatively positioned element
-	bool offset_fixed;
-
 	mutable Vector2f absolute_offset;
-	mutable bool offset_dirty;
-
-	float GetElementAnimationDuration( );
-	bool GetElementAnimationIterationCount( int &refCount );
-	const KeyframeProperties *GetElementAnimation( );
-	bool LerpAnimationProperties( const PropertyDictionary &a, const PropertyDictionary &b, float weight );
 
 	// The offset this element adds to its logical children due to scrolling content.
 	Vector2f scroll_offset;
 
-	// The size of the element.
+	// The size of the element. Only inline elements broken across lines have more than one box, so the first is
+	// stored inline and any others follow in a list.
 	typedef std::vector< Box > BoxList;
-	BoxList boxes;
+	Box main_box;
+	BoxList additional_boxes;
 	// And of the element's internal content.
 	Vector2f content_offset;
 	Vector2f content_box;
@@ -702,37 +771,59 @@ private:
 	// Defines what box area represents the element's client area; this is usually padding, but may be content.
 	Box::Area client_area;
 
-	// True if the element is visible and active.
-	bool visible;
+	// The element's clipping region, as resolved from its ancestors by ElementUtilities::GetClippingRegion().
+	Vector2i clipping_region_origin;
+	Vector2i clipping_region_dimensions;
+	bool clipping_region_enabled;
+	// The number of clipping changes, and the offset generation of the parent, when the clipping region was resolved.
+	int clipping_region_changes;
+	unsigned int clipping_region_offset_generation;
 
-	ElementList children;
-	int num_non_dom_children;
+	// Style information for this element.
+	ElementStyle* style;
+	// Background functionality for this element.
+	ElementBackground* background;
+	// Border functionality for this element.
+	ElementBorder* border;
+	// Decorator information for this element.
+	ElementDecoration* decoration;
+	// Offscreen render cache for this element's subtree, if enabled.
+	ElementRenderCache* render_cache;
 
-	ElementList active_children;
-	ElementList deleted_children;
+	// The element's font face; used to render text and resolve em / ex properties.
+	FontFaceHandle* font_face_handle;
 
-	float z_index;
-	bool local_stacking_context;
-	bool local_stacking_context_forced;
+	// The owning document
+	ElementDocument* owner_document;
 
-	ElementList stacking_context;
-	bool stacking_context_dirty;
+	// Original tag this element came from.
+	String tag;
 
-	// The element's font face; used to render text and resolve em / ex properties.
-	FontFaceHandle* font_face_handle;
-	
-	// Cached rendering information
-	int clipping_ignore_depth;
-	bool clipping_enabled;
-	bool clipping_state_dirty;
+	// The optional, unique ID of this object.
+	String id;
+
+	// Instancer that created us, used for destruction.
+	ElementInstancer* instancer;
+
+	// Currently focused child object
+	Element* focus;
+
+	// The event dispatcher for this element.
+	EventDispatcher* event_dispatcher;
+	// Scrollbar information for this element.
+	ElementScroll* scroll;
+	// Attributes on this element; NULL until the first attribute is set.
+	ElementAttributes* attributes;
 
 	// Internal animation time
 	float anim_elapsed;
 
 	friend class Context;
 	friend class ElementStyle;
+	friend class ElementUtilities;
 	friend class LayoutEngine;
 	friend class LayoutInlineBox;
+	friend class TextureLoader;
 };
 
 #include <Rocket/Core/Element.inl>
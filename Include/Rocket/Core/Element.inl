@@ -39,7 +39,10 @@ T Element::GetProperty(const String& name)
 template< typename T >
 void Element::SetAttribute(const String& name, const T& value)
 {
-	attributes.Set(name, value);
+	if (attributes == NULL)
+		attributes = new ElementAttributes();
+
+	attributes->Set(name, value);
 	AttributeNameList changed_attributes;
 	changed_attributes.insert(name);
 
@@ -49,13 +52,19 @@ void Element::SetAttribute(const String& name, const T& value)
 // Gets the specified attribute, with default value.
 template< typename T >
 T Element::GetAttribute(const String& name, const T& default_value) const
-{			
-	return attributes.Get(name, default_value);
+{
+	if (attributes == NULL)
+		return default_value;
+
+	return attributes->Get(name, default_value);
 }
 
 // Iterates over the attributes.
 template< typename T >
 bool Element::IterateAttributes(int& index, String& name, T& value) const
 {
-	return attributes.Iterate(index, name, value);
+	if (attributes == NULL)
+		return false;
+
+	return attributes->Iterate(index, name, value);
 }
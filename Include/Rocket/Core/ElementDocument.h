@@ -86,6 +86,11 @@ public:
 	/// @return The document's style sheet.
 	virtual StyleSheet* GetStyleSheet() const;
 
+	/// Adds an estimate of the memory held by the document, its elements and its style sheet to a breakdown. A style
+	/// sheet shared between several documents is counted against each of them.
+	/// @param[out] usage The breakdown to add to.
+	virtual void GetMemoryUsage(MemoryUsage& usage);
+
 	/// Brings the document to the front of the document stack.
 	void PullToFront();
 	/// Sends the document to the back of the document stack.
@@ -172,10 +177,11 @@ private:
 
 	// Is the layout dirty?
 	bool layout_dirty;
-	int lock_layout;
+	volatile int lock_layout;
 
 	friend class Context;
 	friend class Factory;
+	friend class ParallelLayout;
 	
 	void _UpdateLayout();
 };
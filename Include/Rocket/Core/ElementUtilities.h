@@ -114,6 +114,10 @@ public:
 	/// @param[in] context The context to read the clip region from
 	/// @param[in] render_interface The render interface to update.
 	static void ApplyActiveClipRegion(Context* context, RenderInterface* render_interface);
+	/// Renders any geometry deferred to be batched together through a render interface. Elements that render through
+	/// the render interface directly, rather than through Geometry, must call this first.
+	/// @param[in] render_interface The render interface about to be rendered through.
+	static void FlushGeometry(RenderInterface* render_interface);
 
 	/// Formats the contents of an element. This does not need to be called for ordinary elements, but can be useful
 	/// for non-DOM elements of custom elements.
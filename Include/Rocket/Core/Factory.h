@@ -109,6 +109,12 @@ public:
 	/// @param[in] stream The stream to instance from.
 	/// @return The instanced document, or NULL if an error occurred.
 	static ElementDocument* InstanceDocumentStream(Rocket::Core::Context* context, Stream* stream);
+	/// Instances an empty document and begins parsing a stream into it incrementally.
+	/// @param[in] context The context that is creating the document.
+	/// @param[in] stream The stream to instance from; it must remain valid until the parse has completed.
+	/// @param[out] parser The parser reading the stream. The caller continues the parse through the parser's ContinueParse(), and must delete it once it is finished with it.
+	/// @return The instanced document, or NULL if an error occurred.
+	static ElementDocument* BeginDocumentStream(Rocket::Core::Context* context, Stream* stream, XMLParser*& parser);
 
 	/// Registers an instancer that will be used to instance decorators.
 	/// @param[in] name The name of the decorator the instancer will be called for.
@@ -82,6 +82,14 @@ public:
 	/// @return The length of the file in bytes.
 	virtual size_t Length(FileHandle file);
 
+	/// Maps the entire contents of a previously opened file into memory, so it can be parsed in place rather than
+	/// copied out through Read(). The mapping must remain valid until the file is closed. The default implementation
+	/// returns NULL, in which case the file is read through Read() instead.
+	/// @param file The handle of the file to map.
+	/// @param[out] size The length of the mapped data in bytes.
+	/// @return The file's contents, or NULL if the file can't be mapped.
+	virtual const void* Map(FileHandle file, size_t& size);
+
 	/// Called when this file interface is released.
 	virtual void Release();
 
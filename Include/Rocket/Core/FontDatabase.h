@@ -85,8 +85,9 @@ public:
 	/// @param[in] style The style of the desired font handle.
 	/// @param[in] weight The weight of the desired font handle.
 	/// @param[in] size The size of desired handle, in points.
+	/// @param[in] distance_field True to render the handle from the face's signed distance field atlas, which is shared between all sizes, rather than from bitmaps rasterised for this size. This requires a render interface that supports text shaders.
 	/// @return A valid handle if a matching (or closely matching) font face was found, NULL otherwise.
-	static FontFaceHandle* GetFontFaceHandle(const String& family, const String& charset, Font::Style style, Font::Weight weight, int size);
+	static FontFaceHandle* GetFontFaceHandle(const String& family, const String& charset, Font::Style style, Font::Weight weight, int size, bool distance_field = false);
 
 	/// Returns a font effect, either a newly-instanced effect from the factory or an identical
 	/// shared effect.
@@ -105,8 +106,9 @@ private:
 
 	// Adds a loaded face to the appropriate font family.
 	bool AddFace(void* face, const String& family, Font::Style style, Font::Weight weight, bool release_stream);
-	// Loads a FreeType face.
-	void* LoadFace(const String& file_name);
+	// Loads a FreeType face. If the file can be mapped into memory the face is read from the mapping, which it
+	// releases itself; otherwise release_stream is set, and the face's copy of the file must be freed with it.
+	void* LoadFace(const String& file_name, bool& release_stream);
 	// Loads a FreeType face from memory.
 	void* LoadFace(const byte* data, int data_length, const String& source, bool local_data);
 
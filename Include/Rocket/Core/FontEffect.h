@@ -69,6 +69,14 @@ public:
 	/// @param[in] glyph The glyph the effect is being asked to generate an effect texture for.
 	virtual void GenerateGlyphTexture(byte* destination_data, const Vector2i& destination_dimensions, int destination_stride, const FontGlyph& glyph) const;
 
+	/// Requests the effect describe itself as a transformation of the glyphs' outlines, so it can be rendered from the
+	/// face's signed distance fields when the render interface supports text shaders. Effects that can't be rendered
+	/// this way are skipped on text rendered from distance fields.
+	/// @param[out] offset The offset of the effect's glyphs from the original glyphs, in pixels.
+	/// @param[out] dilation The distance the effect grows the glyphs' outlines by, in pixels.
+	/// @return True if the effect can be rendered from distance fields, false if not. The default implementation returns false.
+	virtual bool GetDistanceFieldMetrics(Vector2f& offset, float& dilation) const;
+
 	/// Sets the colour of the effect's geometry.
 	/// @param[in] colour The effect's colour.
 	void SetColour(const Colourb& colour);
@@ -38,9 +38,12 @@ class Context;
 class Element;
 class RenderInterface;
 struct Texture;
+struct TextShader;
 
 /**
 	A helper object for holding an array of vertices and indices, and compiling it as necessary when rendered.
+	Geometry that is changed soon after being compiled is streamed through the render interface's geometry buffer
+	instead, until it has been left unchanged for a while.
 
 	@author Peter Curry
  */
@@ -73,6 +76,18 @@ public:
 	/// Sets the geometry's texture.
 	void SetTexture(const Texture* texture);
 
+	/// Gets the shader the geometry's texture is rendered with.
+	/// @return The geometry's text shader, or NULL if its texture is rendered normally.
+	const TextShader* GetTextShader() const;
+	/// Sets the shader the geometry's texture is rendered with, if its texture is a signed distance field. The shader
+	/// is passed to the render interface's SetTextShader() around the geometry's rendering.
+	/// @param[in] text_shader The text shader. This must remain valid while the geometry is rendered; it may be NULL.
+	void SetTextShader(const TextShader* text_shader);
+
+	/// Returns the number of bytes held by the geometry's vertex and index buffers.
+	/// @return The size of the geometry's buffers.
+	size_t GetMemoryUsage() const;
+
 	/// Releases any previously-compiled geometry, and forces any new geometry to have a compile attempted.
 	/// @param[in] clear_buffers True to also clear the vertex and index buffers, false to leave intact.
 	void Release(bool clear_buffers = false);
@@ -80,6 +95,10 @@ public:
 private:
 	// Returns the host context's render interface.
 	RenderInterface* GetRenderInterface();
+	// Renders the geometry through a render interface, compiling it first if appropriate.
+	void Draw(RenderInterface* render_interface, const Vector2f& translation);
+	// Renders the geometry's compiled handle, or defers it to be batched with other copies of it.
+	void RenderCompiledGeometry(RenderInterface* render_interface, const Vector2f& translation);
 
 	Context* host_context;
 	Element* host_element;
@@ -87,10 +106,20 @@ private:
 	std::vector< Vertex > vertices;
 	std::vector< int > indices;
 	const Texture* texture;
+	const TextShader* text_shader;
 
 	CompiledGeometryHandle compiled_geometry;
 	bool compile_attempted;
 	bool fixed_texcoords;
+
+	// The bounds of the geometry's vertices, noted when it is compiled.
+	Vector2f bounds_min;
+	Vector2f bounds_max;
+
+	// The number of times the geometry has been rendered since it was last compiled or changed, up to a limit.
+	int num_renders;
+	// True if the geometry changes too often to be worth compiling.
+	bool dynamic;
 };
 
 typedef std::vector< Geometry > GeometryList;
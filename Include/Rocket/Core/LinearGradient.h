@@ -44,7 +44,7 @@ template < class ColourType >
 class LinearGradient
 {
 public:
-	typedef typename ColourType StopColourType;
+	typedef ColourType StopColourType;
 	typedef typename std::vector<ColourType > Stops;
 
 	/// Default constructor.
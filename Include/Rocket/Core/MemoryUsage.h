@@ -0,0 +1,89 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREMEMORYUSAGE_H
+#define ROCKETCOREMEMORYUSAGE_H
+
+#include <Rocket/Core/Header.h>
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	A breakdown of the memory held by part of Rocket, such as an element hierarchy, a document or a context. Sizes are
+	estimated from the objects and the capacities of the containers they own, rather than measured by the allocator,
+	so they will not include allocator overhead.
+ */
+
+class ROCKETCORE_API MemoryUsage
+{
+public:
+	enum Category
+	{
+		ELEMENTS = 0,	// Element objects, their attributes and child lists.
+		STYLES,			// Element styles and the element definitions shared between them.
+		PROPERTIES,		// Locally-set properties and the properties of style sheet nodes and definitions.
+		GEOMETRY,		// Vertex and index buffers for backgrounds, borders, images and text.
+		STYLE_SHEETS,	// Style sheet node trees and indices.
+		FONTS,			// Font glyph textures.
+		TEXTURES,		// Image textures.
+		NUM_CATEGORIES
+	};
+
+	MemoryUsage();
+
+	/// Adds to the number of bytes used in a category.
+	/// @param[in] category The category to add to.
+	/// @param[in] bytes The number of bytes to add.
+	void Add(Category category, size_t bytes);
+	/// Adds the usage from another breakdown into this one.
+	/// @param[in] usage The breakdown to add.
+	void Add(const MemoryUsage& usage);
+
+	/// Returns the number of bytes used in a category.
+	/// @param[in] category The category to query.
+	/// @return The number of bytes.
+	size_t Get(Category category) const;
+	/// Returns the number of bytes used across all categories.
+	/// @return The number of bytes.
+	size_t GetTotal() const;
+
+	/// Returns the name of a category.
+	/// @param[in] category The category to look up.
+	/// @return The category's name.
+	static const char* GetCategoryName(Category category);
+
+private:
+	size_t bytes[NUM_CATEGORIES];
+};
+
+}
+}
+
+#endif
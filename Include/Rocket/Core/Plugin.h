@@ -36,6 +36,7 @@ namespace Core {
 class Element;
 class ElementDocument;
 class Context;
+struct ProfileFrame;
 
 /**
 	Generic Interface for plugins to Rocket.
@@ -53,8 +54,9 @@ public:
 		EVT_BASIC		= (1 << 0),		// Initialise, Shutdown, ContextCreate, ContextDestroy
 		EVT_DOCUMENT	= (1 << 1),		// DocumentOpen, DocumentLoad, DocumentUnload
 		EVT_ELEMENT		= (1 << 2),		// ElementCreate, ElementDestroy
+		EVT_PROFILE		= (1 << 3),		// ProfileZone, ProfileFrame
 
-		EVT_ALL			= EVT_BASIC | EVT_DOCUMENT | EVT_ELEMENT
+		EVT_ALL			= EVT_BASIC | EVT_DOCUMENT | EVT_ELEMENT | EVT_PROFILE
 	};
 	/// Called when the plugin is registered to determine
 	/// which of the above event types the plugin is interested in
@@ -86,6 +88,16 @@ public:
 	virtual void OnElementDestroy(Element* element);
 	/// Called when an element is animated.
 	virtual void OnElementAnimate(Element* element);
+
+	/// Called when a profiler zone closes while the profiler is enabled.
+	/// @param[in] name The name of the zone.
+	/// @param[in] start_time The time the zone opened, as reported by the system interface.
+	/// @param[in] end_time The time the zone closed, as reported by the system interface.
+	/// @param[in] depth The number of zones the zone was nested within.
+	virtual void OnProfileZone(const char* name, float start_time, float end_time, int depth);
+	/// Called when a profiling frame ends while the profiler is enabled.
+	/// @param[in] frame The summary of the frame.
+	virtual void OnProfileFrame(const ProfileFrame& frame);
 };
 
 }
@@ -0,0 +1,74 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREPROFILETRACEWRITER_H
+#define ROCKETCOREPROFILETRACEWRITER_H
+
+#include <Rocket/Core/Header.h>
+#include <Rocket/Core/Plugin.h>
+#include <Rocket/Core/String.h>
+#include <stdio.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	A plugin that enables the profiler and writes every profiled zone and frame to a file in the Chrome trace event
+	format, for viewing in chrome://tracing or compatible tools. Register it with Rocket::Core::RegisterPlugin(); the
+	writer closes its file and releases itself when Rocket shuts down.
+ */
+
+class ROCKETCORE_API ProfileTraceWriter : public Plugin
+{
+public:
+	/// Opens the trace file.
+	/// @param[in] path The path of the file to write the trace to. Any existing file will be overwritten.
+	ProfileTraceWriter(const String& path);
+	virtual ~ProfileTraceWriter();
+
+	/// Returns true if the trace file was opened successfully.
+	bool IsOpen() const;
+
+	virtual int GetEventClasses();
+	virtual void OnShutdown();
+
+	virtual void OnProfileZone(const char* name, float start_time, float end_time, int depth);
+	virtual void OnProfileFrame(const ProfileFrame& frame);
+
+private:
+	// Closes the trace file, if it is open.
+	void Close();
+
+	FILE* file;
+	bool first_event;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREPROFILER_H
+#define ROCKETCOREPROFILER_H
+
+#include <Rocket/Core/Header.h>
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	A summary of the work done by Rocket over a single profiling frame. A frame ends each time a context finishes
+	rendering.
+ */
+
+struct ROCKETCORE_API ProfileFrame
+{
+	/// The total time spent within one zone over the frame.
+	struct Zone
+	{
+		const char* name;
+		int calls;
+		float time;
+	};
+	typedef std::vector< Zone > ZoneList;
+
+	ProfileFrame();
+
+	float start_time;
+	float end_time;
+
+	ZoneList zones;
+	std::vector< int > counters;
+};
+
+/**
+	Rocket's frame profiler. Rocket's core functions are instrumented with named, nested zones and with counters; while
+	the profiler is enabled, the timing of each zone is sent to all plugins interested in EVT_PROFILE as the zone
+	ends, and a summary of the frame is sent as each frame ends.
+
+	Zone names must be string literals, or otherwise outlive the profiler; zones are identified by their address.
+ */
+
+class ROCKETCORE_API Profiler
+{
+public:
+	enum Counter
+	{
+		ELEMENTS_STYLED = 0,
+		ELEMENTS_LAID_OUT,
+		ELEMENTS_RENDERED,
+		GEOMETRY_COMPILES,
+		DRAW_CALLS,
+		NUM_COUNTERS
+	};
+
+	/// Enables the profiler. Calls to Enable() and Disable() nest; the profiler runs while any requester has it
+	/// enabled.
+	static void Enable();
+	/// Releases a previous request to enable the profiler.
+	static void Disable();
+	/// Returns true if the profiler is running.
+	static bool IsEnabled();
+
+	/// Opens a new zone, nested within the currently open zone. Prefer ROCKET_PROFILE_ZONE over calling this directly.
+	/// @param[in] name The name of the zone.
+	static void BeginZone(const char* name);
+	/// Closes the most recently opened zone.
+	static void EndZone();
+
+	/// Adds to one of the profiler's counters for the current frame.
+	/// @param[in] counter The counter to increment.
+	/// @param[in] amount The amount to add to the counter.
+	static void IncrementCounter(Counter counter, int amount = 1);
+	/// Returns the name of one of the profiler's counters.
+	/// @param[in] counter The counter to look up.
+	/// @return The counter's name.
+	static const char* GetCounterName(Counter counter);
+
+	/// Ends the current frame, sending its summary to any interested plugins. This is called automatically at the end
+	/// of Context::Render().
+	static void EndFrame();
+	/// Returns the summary of the last completed frame.
+	/// @return The frame summary. This is empty if the profiler was not running during the last frame.
+	static const ProfileFrame& GetLastFrame();
+};
+
+/**
+	Opens a profiler zone for the lifetime of the object.
+ */
+
+class ROCKETCORE_API ProfileZone
+{
+public:
+	ProfileZone(const char* name);
+	~ProfileZone();
+
+private:
+	bool active;
+};
+
+}
+}
+
+/// Profiles the rest of the enclosing scope as a named zone.
+#define ROCKET_PROFILE_ZONE(name) Rocket::Core::ProfileZone rocket_profile_zone(name)
+
+#endif
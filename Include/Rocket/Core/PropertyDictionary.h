@@ -65,6 +65,9 @@ public:
 	/// Returns the map of properties in the dictionary.
 	/// @return The property map.
 	const PropertyMap& GetProperties() const;
+	/// Returns an estimate of the number of bytes held by the dictionary's properties.
+	/// @return The estimated size of the dictionary's contents.
+	size_t GetMemoryUsage() const;
 
 	/// Imports into the dictionary, and optionally defines the specificity of, potentially
 	/// un-specified properties. In the case of name conflicts, the incoming properties will
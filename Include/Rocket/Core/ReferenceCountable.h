@@ -53,6 +53,10 @@ public:
 	virtual void AddReference();
 	/// Decreases the reference count. If this pushes the count to 0, OnReferenceDeactivate() will be called. 
 	virtual void RemoveReference();
+	/// Increases the reference count only if the object is still referenced. Caches that don't hold a reference on
+	/// their objects use this so they can't revive an object that is being released on another thread.
+	/// @return True if a reference was added, false if the object is being released.
+	bool AddReferenceIfReferenced();
 
 	/// Catches incorrect copy attempts.
 	ReferenceCountable& operator=(const ReferenceCountable& copy);
@@ -67,8 +71,8 @@ protected:
 	virtual void OnReferenceDeactivate();
 
 private:
-	// The number of references against this object.
-	int reference_count;
+	// The number of references against this object. This is only modified atomically.
+	volatile int reference_count;
 };
 
 }
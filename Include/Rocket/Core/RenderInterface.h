@@ -30,6 +30,7 @@
 
 #include <Rocket/Core/ReferenceCountable.h>
 #include <Rocket/Core/Header.h>
+#include <Rocket/Core/TextShader.h>
 #include <Rocket/Core/Texture.h>
 #include <Rocket/Core/Vertex.h>
 
@@ -48,6 +49,19 @@ class Context;
 class ROCKETCORE_API RenderInterface : public ReferenceCountable
 {
 public:
+	/// The GPU-compressed texture formats that can be read from DDS and KTX files. All are made of blocks of 4x4 pixels.
+	enum CompressedTextureFormat
+	{
+		COMPRESSED_BC1 = 0,		// DXT1; 8 bytes per block.
+		COMPRESSED_BC2,			// DXT3; 16 bytes per block.
+		COMPRESSED_BC3,			// DXT5; 16 bytes per block.
+		COMPRESSED_BC7,			// 16 bytes per block.
+		COMPRESSED_ETC1,		// 8 bytes per block.
+		COMPRESSED_ETC2_RGB,	// 8 bytes per block.
+		COMPRESSED_ETC2_RGBA,	// 16 bytes per block.
+		COMPRESSED_ASTC_4X4		// 16 bytes per block.
+	};
+
 	RenderInterface();
 	virtual ~RenderInterface();
 
@@ -79,6 +93,52 @@ public:
 	/// @param[in] geometry The application-specific compiled geometry to release.
 	virtual void ReleaseCompiledGeometry(CompiledGeometryHandle geometry);
 
+	/// Called by Rocket to determine if compiled geometry can be rendered several times in one call through
+	/// RenderCompiledGeometryInstanced(). If so, Rocket defers the geometry rendered by a context until the end of its
+	/// Render() or the next change of scissor region, render target or text shader, and renders copies of the same
+	/// compiled geometry (such as a decorator shared by many elements of the same size) together wherever it can do so
+	/// without changing the result. Elements that render through the render interface directly must call
+	/// ElementUtilities::FlushGeometry() first.
+	/// @return True if the render interface supports instancing, false if not. The default implementation returns false.
+	virtual bool SupportsInstancing();
+	/// Called by Rocket when it wants to render several copies of application-compiled geometry. This is only called
+	/// if SupportsInstancing() returns true.
+	/// @param[in] geometry The application-specific compiled geometry to render.
+	/// @param[in] translations The translation to apply to each copy of the geometry.
+	/// @param[in] num_instances The number of copies to render.
+	virtual void RenderCompiledGeometryInstanced(CompiledGeometryHandle geometry, const Vector2f* translations, int num_instances);
+
+	/// Called by Rocket when it wants a buffer to stream geometry through that changes too often to be worth
+	/// compiling, such as the text of a field being typed into. Rocket writes such geometry into the buffer in a ring,
+	/// starting again from the beginning once it is full; if the application wants to avoid stalling on data still in
+	/// use, it may orphan the buffer's storage when a write begins at the first vertex. If not supported, do not
+	/// override the function or return false; the geometry will be rendered through RenderGeometry() instead.
+	/// @param[out] buffer The handle to write the handle for the new buffer to.
+	/// @param[in] num_vertices The number of vertices the buffer must hold.
+	/// @param[in] num_indices The number of indices the buffer must hold.
+	/// @return True if the buffer was created and the handle is valid, false if not.
+	virtual bool GenerateGeometryBuffer(GeometryBufferHandle& buffer, int num_vertices, int num_indices);
+	/// Called by Rocket when it wants to write geometry into a buffer. The indices are relative to the start of the
+	/// buffer, not to the first vertex written.
+	/// @param[in] buffer The buffer to write to.
+	/// @param[in] first_vertex The index of the first vertex to write.
+	/// @param[in] vertices The vertex data to write.
+	/// @param[in] num_vertices The number of vertices to write.
+	/// @param[in] first_index The offset of the first index to write.
+	/// @param[in] indices The index data to write.
+	/// @param[in] num_indices The number of indices to write. This will always be a multiple of three.
+	virtual void UpdateGeometryBuffer(GeometryBufferHandle buffer, int first_vertex, const Vertex* vertices, int num_vertices, int first_index, const int* indices, int num_indices);
+	/// Called by Rocket when it wants to render a range of a buffer's indices.
+	/// @param[in] buffer The buffer to render from.
+	/// @param[in] first_index The offset of the first index to render.
+	/// @param[in] num_indices The number of indices to render. This will always be a multiple of three.
+	/// @param[in] texture The texture to be applied to the geometry. This may be NULL, in which case the geometry is untextured.
+	/// @param[in] translation The translation to apply to the geometry.
+	virtual void RenderGeometryBuffer(GeometryBufferHandle buffer, int first_index, int num_indices, TextureHandle texture, const Vector2f& translation);
+	/// Called by Rocket when a buffer is no longer required.
+	/// @param[in] buffer The buffer to release.
+	virtual void ReleaseGeometryBuffer(GeometryBufferHandle buffer);
+
 	/// Called by Rocket when it wants to enable or disable scissoring to clip content.
 	/// @param[in] enable True if scissoring is to enabled, false if it is to be disabled.
 	virtual void EnableScissorRegion(bool enable) = 0;
@@ -89,7 +149,9 @@ public:
 	/// @param[in] height The height of the scissored region. All pixels to below (y + height) should be clipped.
 	virtual void SetScissorRegion(int x, int y, int width, int height) = 0;
 
-	/// Called by Rocket when a texture is required by the library.
+	/// Called by Rocket when a texture is required by the library. The default implementation reads the source as a
+	/// file through the file interface; PNG and TGA files are decoded and passed to GenerateTexture(), and the blocks of
+	/// compressed textures in DDS and KTX files are passed to GenerateCompressedTexture().
 	/// @param[out] texture_handle The handle to write the texture handle for the loaded texture to.
 	/// @param[out] texture_dimensions The variable to write the dimensions of the loaded texture.
 	/// @param[in] source The application-defined image source, joined with the path of the referencing document.
@@ -101,10 +163,58 @@ public:
 	/// @param[in] source_dimensions The dimensions, in pixels, of the source data.
 	/// @return True if the texture generation succeeded and the handle is valid, false if not.
 	virtual bool GenerateTexture(TextureHandle& texture_handle, const byte* source, const Vector2i& source_dimensions);
+	/// Called by Rocket when a texture is required to be built from the blocks of a GPU-compressed format, read from a
+	/// DDS or KTX file. If this is not overridden (or returns false), the texture is loaded through LoadTexture()
+	/// instead when it is being loaded in the background, or fails to load if not.
+	/// @param[out] texture_handle The handle to write the texture handle for the generated texture to.
+	/// @param[in] format The compression format of the blocks.
+	/// @param[in] source The blocks of each mipmap level in turn, from the largest down. Each level's blocks are tightly packed, in rows from the top.
+	/// @param[in] source_size The length of the block data, in bytes.
+	/// @param[in] source_dimensions The dimensions, in pixels, of the largest mipmap level. These need not be multiples of the block size.
+	/// @param[in] num_mipmaps The number of mipmap levels in the block data; each is half the size of the last, rounded down, to a minimum of one pixel.
+	/// @return True if the texture generation succeeded and the handle is valid, false if not.
+	virtual bool GenerateCompressedTexture(TextureHandle& texture_handle, CompressedTextureFormat format, const byte* source, size_t source_size, const Vector2i& source_dimensions, int num_mipmaps);
+	/// Called by Rocket to decode a texture's file into pixels when textures are being loaded in the background (see
+	/// SetAsyncTextureLoading()). This is called from the job threads, so it must not use the graphics API; the
+	/// pixels are passed to GenerateTexture() on the rendering thread once they are ready. The default implementation
+	/// decodes PNG and TGA files. If this returns false, the texture is loaded through LoadTexture() instead. Compressed
+	/// textures in DDS and KTX files are read before this is called, and passed to GenerateCompressedTexture().
+	/// @param[out] data The vector to write the decoded pixels to. Each pixel is made up of four 8-bit values, indicating red, green, blue and alpha in that order.
+	/// @param[out] dimensions The variable to write the dimensions of the decoded pixels to.
+	/// @param[in] file_data The contents of the texture's file, read through the file interface.
+	/// @param[in] file_size The length of the file, in bytes.
+	/// @param[in] source The texture's source, joined with the path of the referencing document.
+	/// @return True if the file was decoded, false if not.
+	virtual bool DecodeTexture(std::vector< byte >& data, Vector2i& dimensions, const byte* file_data, size_t file_size, const String& source);
 	/// Called by Rocket when a loaded texture is no longer required.
 	/// @param texture The texture handle to release.
 	virtual void ReleaseTexture(TextureHandle texture);
 
+	/// Called by Rocket when it wants to render an element's subtree into an offscreen texture, for elements with a
+	/// 'render-cache' of 'texture'. If this is not overridden (or returns false), these elements are rendered normally.
+	/// @param[out] texture_handle The handle to write the texture handle for the new render target to. The handle will be used as a texture in future calls to RenderGeometry(), and released through ReleaseTexture().
+	/// @param[in] dimensions The dimensions, in pixels, of the render target.
+	/// @return True if the render target was created and the handle is valid, false if not.
+	virtual bool GenerateRenderTarget(TextureHandle& texture_handle, const Vector2i& dimensions);
+	/// Called by Rocket when it wants to redirect rendering into a render target, or back to the application's frame
+	/// buffer. Geometry and scissor regions are still specified in context coordinates; the top-left of the render
+	/// target maps to the given origin.
+	/// @param[in] render_target The render target to render into, or NULL to restore the application's frame buffer.
+	/// @param[in] origin The position, in context coordinates, of the render target's top-left pixel.
+	virtual void SetRenderTarget(TextureHandle render_target, const Vector2i& origin);
+	/// Called by Rocket when the active render target is about to be redrawn, and should be cleared to transparent.
+	virtual void ClearRenderTarget();
+
+	/// Called by Rocket to determine if text can be rendered from signed distance fields through SetTextShader(). If
+	/// so, each font face is rasterised once into a distance field atlas that serves text of every size and effect,
+	/// rather than into new textures for every font size and outline used.
+	/// @return True if the render interface supports text shaders, false if not. The default implementation returns false, and text is rendered from bitmaps.
+	virtual bool SupportsTextShader();
+	/// Called by Rocket before it renders geometry textured with a signed distance field, and with NULL once it has
+	/// finished. This is only called if SupportsTextShader() returns true.
+	/// @param[in] shader The parameters to render the distance field with, or NULL to return to normal rendering.
+	virtual void SetTextShader(const TextShader* shader);
+
 	/// Returns the native horizontal texel offset for the renderer.
 	/// @return The renderer's horizontal texel offset. The default implementation returns 0.
 	virtual float GetHorizontalTexelOffset();
@@ -129,7 +239,11 @@ protected:
 private:
 	Context* context;
 
+	// True if LoadTexture() hasn't been overridden; this is only known once it has been called.
+	bool default_load_texture;
+
 	friend class Context;
+	friend class TextureResource;
 };
 
 }
@@ -90,6 +90,12 @@ class ROCKETCORE_API Stream : public ReferenceCountable
 		/// Read from the stream, without increasing the stream offset.
 		virtual size_t Peek(void* buffer, size_t bytes) const;
 
+		/// Returns the stream's entire contents if they are held contiguously in memory, so they can be read in place
+		/// rather than copied out through Read(). The data remains valid until the stream is written to or closed.
+		/// @param[out] size The length of the data, in bytes.
+		/// @return The stream's data, or NULL if it isn't held in memory.
+		virtual const byte* GetContiguousData(size_t& size) const;
+
 		/// Write to the stream at the current position.
 		virtual size_t Write(const void* buffer, size_t bytes) = 0;
 		/// Write to this stream from another stream.
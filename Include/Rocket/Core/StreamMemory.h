@@ -91,6 +91,8 @@ public:
 
 	/// Raw access to the stream
 	const byte* RawStream() const;
+	/// Returns the stream's buffer, which is always contiguous.
+	virtual const byte* GetContiguousData(size_t& size) const;
 
 	/// Erase a section of the stream
 	void Erase(size_t offset, size_t bytes);
@@ -37,7 +37,9 @@ namespace Rocket {
 namespace Core {
 
 class Element;
+class ElementAncestorFilter;
 class ElementDefinition;
+class MemoryUsage;
 class StyleSheetNode;
 
 /**
@@ -53,6 +55,15 @@ public:
 	typedef std::set< StyleSheetNode* > NodeList;
 	typedef std::map< String, NodeList > NodeIndex;
 
+	/// The elements whose definitions may change when a class or ID is set or cleared on an element.
+	enum InvalidationScope
+	{
+		INVALIDATE_NONE = 0,		// no selector names the class or ID
+		INVALIDATE_ELEMENT,			// selectors only name it on their subject, so only the element itself changes
+		INVALIDATE_SUBTREE			// a selector names it on an ancestor, so the element's descendants may change too
+	};
+	typedef std::map< String, InvalidationScope > InvalidationScopeMap;
+
 	StyleSheet();
 	virtual ~StyleSheet();
 
@@ -66,12 +77,30 @@ public:
 
 	/// Returns the compiled element definition for a given element hierarchy. A reference count will be added for the
 	/// caller, so another should not be added. The definition should be released by removing the reference count.
-	ElementDefinition* GetElementDefinition(const Element* element) const;
+	/// @param[in] element The element to generate the definition for.
+	/// @param[in] ancestor_filter A filter over the element's ancestors, if the caller is maintaining one during a traversal.
+	ElementDefinition* GetElementDefinition(const Element* element, const ElementAncestorFilter* ancestor_filter = NULL) const;
+
+	/// Returns the elements whose definitions may change when a class is set on or cleared from an element. This is
+	/// only valid once the node index has been built.
+	/// @param[in] class_name The class being changed.
+	/// @return The scope of elements to dirty.
+	InvalidationScope GetClassInvalidationScope(const String& class_name) const;
+	/// Returns the elements whose definitions may change when an element's ID is set or cleared. This is only valid
+	/// once the node index has been built.
+	/// @param[in] id The ID being changed.
+	/// @return The scope of elements to dirty.
+	InvalidationScope GetIdInvalidationScope(const String& id) const;
 
 	void ClearAnimationIndex( );
 	void AddAnimation(const String &name, const KeyframeProperties &frames);
 	const KeyframeProperties *GetAnimation(const String &name);
 
+	/// Adds an estimate of the memory held by the style sheet's node tree, indices and cached element definitions to
+	/// a breakdown.
+	/// @param[out] usage The breakdown to add to.
+	void GetMemoryUsage(MemoryUsage& usage) const;
+
 protected:
 	/// Destroys the style sheet.
 	virtual void OnReferenceDeactivate();
@@ -91,6 +120,12 @@ private:
 	NodeIndex styled_node_index;
 	// Map of every node, even empty, un-styled, nodes.
 	NodeIndex complete_node_index;
+	// True once the node indices have been built.
+	bool node_index_built;
+
+	// The classes and IDs named by the sheet's selectors, and the scope of elements affected by changing each.
+	InvalidationScopeMap class_invalidation_scopes;
+	InvalidationScopeMap id_invalidation_scopes;
 
 	typedef std::map< String, ElementDefinition* > ElementDefinitionCache;
 	// Index of element addresses to element definitions.
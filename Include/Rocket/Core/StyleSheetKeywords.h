@@ -115,6 +115,9 @@ const int FOCUS_AUTO = 1;
 
 const int LOOP_INFINITE = 0;
 
+const int RENDER_CACHE_NONE = 0;
+const int RENDER_CACHE_TEXTURE = 1;
+
 }
 }
 
@@ -39,7 +39,7 @@ namespace Core {
 /**
 	libRocket's System Interface.
 
-	This class provides interfaces for Time, Translation and Logging.
+	This class provides interfaces for Time, Translation, Logging and Jobs.
 
 	Time is the only required implementation.
 
@@ -48,12 +48,23 @@ namespace Core {
 	The default implementation of logging logs Windows Debug Console,
 	or Standard Error, depending on what platform you're using.
 
+	The default implementation of jobs runs them on libRocket's own worker
+	pool, which only starts threads if more than one layout thread has been
+	requested. Applications with their own task scheduler can override
+	SubmitJob(), WaitForJob() and ParallelFor() to run libRocket's work on it
+	instead.
+
 	@author Lloyd Weehuizen
  */
 
 class ROCKETCORE_API SystemInterface : public ReferenceCountable
 {
 public:
+	/// A function run as a job; it receives the data it was submitted with and its index within its batch.
+	typedef void (*JobFunction)(void* data, int index);
+	/// Identifies a submitted job until it has been waited on.
+	typedef void* JobHandle;
+
 	SystemInterface();
 	virtual ~SystemInterface();
 
@@ -79,6 +90,21 @@ public:
 	/// @return True to continue execution, false to break into the debugger.
 	virtual bool LogMessage(Log::Type type, const String& message);
 
+	/// Submits a job to be run, possibly on another thread. The job's function is called with an index of zero.
+	/// @param[in] function The function to run.
+	/// @param[in] data The data to pass to the function.
+	/// @return A handle to the job, which must be passed to WaitForJob().
+	virtual JobHandle SubmitJob(JobFunction function, void* data);
+	/// Waits for a submitted job to complete. The calling thread may run other jobs while it waits.
+	/// @param[in] job The handle returned when the job was submitted; it is invalid once this returns.
+	virtual void WaitForJob(JobHandle job);
+	/// Runs a function once for every index in a range, possibly in parallel, returning once all have completed. The
+	/// function may itself submit jobs or run parallel loops.
+	/// @param[in] function The function to run.
+	/// @param[in] data The data to pass to each call of the function.
+	/// @param[in] count The number of calls to make; each call receives an index from zero to count - 1.
+	virtual void ParallelFor(JobFunction function, void* data, int count);
+
 	/// Activate keyboard (for touchscreen devices)
 	virtual void ActivateKeyboard();
 	
@@ -0,0 +1,55 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCORETEXTSHADER_H
+#define ROCKETCORETEXTSHADER_H
+
+#include <Rocket/Core/Header.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	The parameters for rendering text from a signed distance field. The alpha channel of a distance field texture holds
+	the distance from each texel to the nearest edge of its glyph, mapped so 0.5 lies on the edge, with higher values
+	inside the glyph and lower values outside. A render interface supporting text shaders should compute the coverage
+	of each fragment as smoothstep(edge - smoothing, edge + smoothing, distance), and multiply the vertex alpha by it.
+ */
+
+struct ROCKETCORE_API TextShader
+{
+	/// The distance value the rendered edge of the glyphs lies on. This is 0.5 for plain text, and lower for outlines.
+	float edge;
+	/// Half the width of the ramp used to antialias the edge, in distance values; this spans about a pixel.
+	float smoothing;
+};
+
+}
+}
+
+#endif
@@ -69,6 +69,11 @@ public:
 	/// @param[in] The render interface that is requesting the dimensions.
 	/// @return The texture's dimensions. This will be (0, 0) if the texture isn't loaded.
 	Vector2i GetDimensions(RenderInterface* render_interface) const;
+	/// Returns true if the texture is being loaded in the background, in which case its handle and dimensions are
+	/// those of the placeholder texture. This starts the texture loading if it hasn't been already.
+	/// @param[in] The render interface that is loading the texture.
+	/// @return True if the texture is still loading, false if it is ready or isn't loaded.
+	bool IsLoading(RenderInterface* render_interface) const;
 
 	/// Releases this texture's resource (if any), and sets it to another texture's resource.
 	const Texture& operator=(const Texture&);
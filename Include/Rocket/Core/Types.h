@@ -85,6 +85,7 @@ class Dictionary;
 typedef uintptr_t FileHandle;
 typedef uintptr_t TextureHandle;
 typedef uintptr_t CompiledGeometryHandle;
+typedef uintptr_t GeometryBufferHandle;
 typedef uintptr_t DecoratorDataHandle;
 
 // List of elements.
@@ -0,0 +1,240 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <Rocket/Core.h>
+#include <Rocket/Debugger.h>
+#include <Input.h>
+#include <Shell.h>
+#include <stdio.h>
+#include <string.h>
+
+Rocket::Core::Context* context = NULL;
+Rocket::Core::ElementDocument* document = NULL;
+
+// The number of rows and cells in the benchmark document.
+const int NUM_ROWS = 1250;
+const int NUM_CELLS = 4;
+// The number of cells shown or hidden every frame.
+const int NUM_TOGGLES = 64;
+// The number of rows in the traversal benchmark; with their cells, this makes 10,000 elements.
+const int NUM_TRAVERSAL_ROWS = 2000;
+
+// True to time walks of the whole document rather than toggling cells.
+bool traversal = false;
+
+Rocket::Core::ElementList cells;
+int next_toggle = 0;
+
+float update_time = 0;
+float render_time = 0;
+float traversal_time = 0;
+int num_traversed = 0;
+int num_frames = 0;
+float report_time = 0;
+
+// Builds the rows of the benchmark document.
+void BuildRows(int num_rows)
+{
+	Rocket::Core::Element* rows = document->GetElementById("rows");
+	for (int i = 0; i < num_rows; ++i)
+	{
+		Rocket::Core::Element* row = document->CreateElement("div");
+		row->SetClass("row", true);
+
+		for (int j = 0; j < NUM_CELLS; ++j)
+		{
+			Rocket::Core::Element* cell = document->CreateElement("div");
+			cell->SetClass("cell", true);
+			row->AppendChild(cell);
+			cells.push_back(cell);
+			cell->RemoveReference();
+		}
+
+		rows->AppendChild(row);
+		row->RemoveReference();
+	}
+}
+
+// Shows or hides the next batch of cells, stepping through the document so every row is touched in turn.
+void ToggleCells()
+{
+	for (int i = 0; i < NUM_TOGGLES; ++i)
+	{
+		Rocket::Core::Element* cell = cells[next_toggle];
+		cell->SetClass("hidden", !cell->IsClassSet("hidden"));
+
+		next_toggle = (next_toggle + 7) % (int) cells.size();
+	}
+}
+
+// Walks an element and its descendants depth-first, reading the data the update, render and layout walks read from
+// each element on their way through the tree.
+float TraverseElement(Rocket::Core::Element* element, int& num_elements)
+{
+	num_elements++;
+
+	float sum = element->GetZIndex();
+	if (element->IsVisible())
+	{
+		const Rocket::Core::Box& box = element->GetBox();
+		sum += box.GetSize().x + element->GetRelativeOffset(Rocket::Core::Box::BORDER).y;
+	}
+
+	int num_children = element->GetNumChildren(true);
+	for (int i = 0; i < num_children; ++i)
+	{
+		Rocket::Core::Element* child = element->GetChild(i);
+		if (child->GetParentNode() == element)
+			sum += TraverseElement(child, num_elements);
+	}
+
+	return sum;
+}
+
+void GameLoop()
+{
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	if (!traversal)
+		ToggleCells();
+
+	float start_time = Shell::GetElapsedTime();
+	context->Update();
+	float update_end_time = Shell::GetElapsedTime();
+	context->Render();
+	float render_end_time = Shell::GetElapsedTime();
+
+	update_time += update_end_time - start_time;
+	render_time += render_end_time - update_end_time;
+	num_frames++;
+
+	if (traversal)
+	{
+		int num_elements = 0;
+		float traversal_start_time = Shell::GetElapsedTime();
+		TraverseElement(document, num_elements);
+		render_end_time = Shell::GetElapsedTime();
+
+		traversal_time += render_end_time - traversal_start_time;
+		num_traversed = num_elements;
+	}
+
+	// Report the average times once a second.
+	if (render_end_time - report_time >= 1)
+	{
+		char buffer[256];
+		if (traversal)
+			snprintf(buffer, sizeof(buffer), "Walking %d elements per frame.<br />Walk: %.3f ms, update: %.3f ms, render: %.3f ms", num_traversed, 1000 * traversal_time / num_frames, 1000 * update_time / num_frames, 1000 * render_time / num_frames);
+		else
+			snprintf(buffer, sizeof(buffer), "Toggling %d of %d cells per frame.<br />Update: %.3f ms, render: %.3f ms", NUM_TOGGLES, (int) cells.size(), 1000 * update_time / num_frames, 1000 * render_time / num_frames);
+		document->GetElementById("performance")->SetInnerRML(buffer);
+
+		update_time = 0;
+		render_time = 0;
+		traversal_time = 0;
+		num_frames = 0;
+		report_time = render_end_time;
+	}
+
+	Shell::FlipBuffers();
+}
+
+#if defined ROCKET_PLATFORM_WIN32
+#include <windows.h>
+int APIENTRY WinMain(HINSTANCE ROCKET_UNUSED(instance_handle), HINSTANCE ROCKET_UNUSED(previous_instance_handle), char* command_line, int ROCKET_UNUSED(command_show))
+#else
+int main(int argc, char** argv)
+#endif
+{
+	// Run with 'traversal' on the command line to time walks of a 10,000-element document instead.
+#if defined ROCKET_PLATFORM_WIN32
+	traversal = strstr(command_line, "traversal") != NULL;
+#else
+	traversal = argc > 1 && strcmp(argv[1], "traversal") == 0;
+#endif
+
+	// Generic OS initialisation, creates a window and attaches OpenGL.
+	if (!Shell::Initialise("../Samples/basic/benchmark/") ||
+		!Shell::OpenWindow("Benchmark Sample", true))
+	{
+		Shell::Shutdown();
+		return -1;
+	}
+
+	// Rocket initialisation.
+	ShellRenderInterfaceOpenGL opengl_renderer;
+	opengl_renderer.SetViewport(1024,768);
+
+	Rocket::Core::SetRenderInterface(&opengl_renderer);
+
+	ShellSystemInterface system_interface;
+	Rocket::Core::SetSystemInterface(&system_interface);
+
+	Rocket::Core::Initialise();
+
+	// Create the main Rocket context and set it on the shell's input layer.
+	context = Rocket::Core::CreateContext("main", Rocket::Core::Vector2i(1024, 768));
+	if (context == NULL)
+	{
+		Rocket::Core::Shutdown();
+		Shell::Shutdown();
+		return -1;
+	}
+
+	Rocket::Debugger::Initialise(context);
+	Input::SetContext(context);
+
+	Shell::LoadFonts("../../assets/");
+
+	// Load and show the benchmark document.
+	document = context->LoadDocument("data/benchmark.rml");
+	if (document == NULL)
+	{
+		context->RemoveReference();
+		Rocket::Core::Shutdown();
+		Shell::Shutdown();
+		return -1;
+	}
+
+	document->GetElementById("title")->SetInnerRML(document->GetTitle());
+	BuildRows(traversal ? NUM_TRAVERSAL_ROWS : NUM_ROWS);
+	document->Show();
+
+	Shell::EventLoop(GameLoop);
+
+	// Shutdown Rocket.
+	cells.clear();
+	document->RemoveReference();
+
+	context->RemoveReference();
+	Rocket::Core::Shutdown();
+
+	Shell::CloseWindow();
+	Shell::Shutdown();
+
+	return 0;
+}
@@ -88,6 +88,9 @@ void ElementGame::ProcessEvent(Rocket::Core::Event& event)
 void ElementGame::OnUpdate()
 {
 	game->Update();
+
+	// The game runs every frame.
+	ScheduleUpdate();
 }
 
 // Renders the game.
@@ -94,6 +94,9 @@ void ElementGame::OnUpdate()
 {
 	game->Update();
 
+	// The game runs every frame.
+	ScheduleUpdate();
+
 	if (game->IsGameOver())
 		DispatchEvent("gameover", Rocket::Core::Dictionary(), false);
 }
@@ -63,8 +63,6 @@ public:
 	/// Called by Rocket when it wants to change the scissor region.
 	virtual void SetScissorRegion(int x, int y, int width, int height);
 
-	/// Called by Rocket when a texture is required by the library.
-	virtual bool LoadTexture(Rocket::Core::TextureHandle& texture_handle, Rocket::Core::Vector2i& texture_dimensions, const Rocket::Core::String& source);
 	/// Called by Rocket when a texture is required to be built from an internally-generated sequence of pixels.
 	virtual bool GenerateTexture(Rocket::Core::TextureHandle& texture_handle, const Rocket::Core::byte* source, const Rocket::Core::Vector2i& source_dimensions);
 	/// Called by Rocket when a loaded texture is no longer required.
@@ -75,6 +75,7 @@ ElementDataGrid::~ElementDataGrid()
 void ElementDataGrid::SetDataSource(const Rocket::Core::String& data_source_name)
 {
 	new_data_source = data_source_name;
+	ScheduleUpdate();
 }
 
 // Adds a column to the table.
@@ -242,6 +243,11 @@ void ElementDataGrid::OnUpdate()
 		body->SetProperty("display", "block");
 		body_visible = true;
 	}
+
+	// Rows are loaded over several updates, so keep updating until there are none left.
+	if (any_new_children ||
+		!body_visible)
+		ScheduleUpdate();
 	
 	document->LockLayout(false);
 }
@@ -659,6 +659,11 @@ void ElementDataGridRow::DirtyRow()
 	{
 		parent_row->DirtyRow();
 	}
+	// The grid loads its dirty rows when it updates.
+	else if (parent_grid)
+	{
+		parent_grid->ScheduleUpdate();
+	}
 }
 
 // Sets this row's child rows to be visible.
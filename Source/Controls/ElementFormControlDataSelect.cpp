@@ -80,6 +80,7 @@ void ElementFormControlDataSelect::OnAttributeChange(const Core::AttributeNameLi
 			data_source->DetachListener(this);
 
 		initialised = false;
+		ScheduleUpdate();
 	}
 	else if (changed_attributes.find("fields") != changed_attributes.end() ||
 			 changed_attributes.find("valuefield") != changed_attributes.end() ||
@@ -158,6 +158,15 @@ void ElementFormControlSelect::OnLayout()
 	widget->OnLayout();
 }
 
+// Schedules an update to move new child elements into the widget.
+void ElementFormControlSelect::OnChildAdd(Rocket::Core::Element* child)
+{
+	ElementFormControl::OnChildAdd(child);
+
+	if (child->GetParentNode() == this)
+		ScheduleUpdate();
+}
+
 // Returns true to mark this element as replaced.
 bool ElementFormControlSelect::GetIntrinsicDimensions(Rocket::Core::Vector2f& intrinsic_dimensions)
 {
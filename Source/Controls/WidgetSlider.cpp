@@ -171,6 +171,9 @@ void WidgetSlider::Update()
 				arrow_timers[i] += DEFAULT_REPEAT_PERIOD;
 				SetBarPosition(i == 0 ? OnLineDecrement() : OnLineIncrement());
 			}
+
+			// Keep updating while the arrow is held.
+			parent->ScheduleUpdate();
 		}
 	}
 }
@@ -448,12 +451,16 @@ void WidgetSlider::ProcessEvent(Core::Event& event)
 			arrow_timers[0] = DEFAULT_REPEAT_DELAY;
 			last_update_time = Core::GetSystemInterface()->GetElapsedTime();
 			SetBarPosition(OnLineDecrement());
+
+			parent->ScheduleUpdate();
 		}
 		else if (event.GetTargetElement() == arrows[1])
 		{
 			arrow_timers[1] = DEFAULT_REPEAT_DELAY;
 			last_update_time = Core::GetSystemInterface()->GetElapsedTime();
 			SetBarPosition(OnLineIncrement());
+
+			parent->ScheduleUpdate();
 		}
 	}
 	else if (event == "mouseup" ||
@@ -189,6 +189,9 @@ void WidgetTextInput::OnUpdate()
 			cursor_timer += CURSOR_BLINK_TIME;
 			cursor_visible = !cursor_visible;
 		}
+
+		// Keep blinking for as long as the cursor is shown.
+		parent->ScheduleUpdate();
 	}
 }
 
@@ -638,6 +641,7 @@ void WidgetTextInput::ShowCursor(bool show, bool move_to_cursor)
 		
 		cursor_timer = CURSOR_BLINK_TIME;
 		last_update_time = Core::GetSystemInterface()->GetElapsedTime();
+		parent->ScheduleUpdate();
 
 		// Shift the cursor into view.
 		if (move_to_cursor)
@@ -40,11 +40,15 @@ BaseXMLParser::BaseXMLParser()
 	buffer = NULL;
 	buffer_used = 0;
 	buffer_size = 0;
+	buffer_in_place = false;
 	open_tag_depth = 0;
+	num_open_tags_read = 0;
 }
 
 BaseXMLParser::~BaseXMLParser()
 {
+	if (!buffer_in_place)
+		free(buffer);
 }
 
 // Registers a tag as containing general character data.
@@ -57,21 +61,75 @@ void BaseXMLParser::RegisterCDATATag(const String& tag)
 // Parses the given stream as an XML file, and calls the handlers when
 // interesting phenomenon are encountered.
 void BaseXMLParser::Parse(Stream* stream)
+{
+	BeginParse(stream);
+	ContinueParse(-1, -1);
+}
+
+// Begins parsing the given stream incrementally.
+void BaseXMLParser::BeginParse(Stream* stream)
 {
 	xml_source = stream;
-	buffer_size = DEFAULT_BUFFER_SIZE;
 
-	buffer = (unsigned char*) malloc(buffer_size);
-	read = buffer;
+	if (!buffer_in_place)
+		free(buffer);
+
 	line_number = 1;
-	FillBuffer();
+	open_tag_depth = 0;
+	num_open_tags_read = 0;
+
+	// If the stream is already in memory, tokenise it in place. The stream is moved to its end as if the whole of
+	// it had been read into the buffer.
+	size_t data_size;
+	const byte* data = stream->GetContiguousData(data_size);
+	size_t data_position = data != NULL ? stream->Tell() : 0;
+	if (data != NULL &&
+		data_position < data_size &&
+		stream->Seek(0, SEEK_END))
+	{
+		buffer = (unsigned char*) data + data_position;
+		buffer_size = (int) (data_size - data_position);
+		buffer_used = buffer_size;
+		buffer_in_place = true;
+		read = buffer;
+	}
+	else
+	{
+		buffer_size = DEFAULT_BUFFER_SIZE;
+		buffer = (unsigned char*) malloc(buffer_size);
+		buffer_used = 0;
+		buffer_in_place = false;
+		read = buffer;
+		FillBuffer();
+	}
 
 	// Read (er ... skip) the header, if one exists.
 	ReadHeader();
-	// Read the XML body.
-	ReadBody();
+}
+
+// Continues an incremental parse until the stream is exhausted or the budget for this call is spent.
+bool BaseXMLParser::ContinueParse(int max_elements, float max_time)
+{
+	if (buffer == NULL)
+		return true;
+
+	SystemInterface* system_interface = GetSystemInterface();
+	float start_time = max_time >= 0 ? system_interface->GetElapsedTime() : 0;
+	int max_open_tags_read = max_elements >= 0 ? num_open_tags_read + max_elements : -1;
 
-	free(buffer);
+	while (ReadBodyTag())
+	{
+		if (max_open_tags_read >= 0 &&
+			num_open_tags_read >= max_open_tags_read)
+			return false;
+
+		if (max_time >= 0 &&
+			system_interface->GetElapsedTime() - start_time >= max_time)
+			return false;
+	}
+
+	EndParse();
+	return true;
 }
 
 // Get the current file line number
@@ -104,61 +162,70 @@ void BaseXMLParser::ReadHeader()
 	}
 }
 
-void BaseXMLParser::ReadBody()
+bool BaseXMLParser::ReadBodyTag()
 {
-	open_tag_depth = 0;
+	// Find the next open tag.
+	if (!FindString((unsigned char*) "<", data))
+		return false;
 
-	for(;;)
+	// Check what kind of tag this is.
+	if (PeekString((const unsigned char*) "!--"))
 	{
-		// Find the next open tag.
-		if (!FindString((unsigned char*) "<", data))
-			break;
-
-		// Check what kind of tag this is.
-		if (PeekString((const unsigned char*) "!--"))
-		{
-			// Comment.
-			String temp;
-			if (!FindString((const unsigned char*) "-->", temp))
-				break;
-		}
-		else if (PeekString((const unsigned char*) "![CDATA["))
-		{
-			// CDATA tag; read everything (including markup) until the ending
-			// CDATA tag.
-			if (!ReadCDATA())
-				break;
-		}
-		else if (PeekString((const unsigned char*) "/"))
-		{
-			if (!ReadCloseTag())
-				break;
+		// Comment.
+		String temp;
+		if (!FindString((const unsigned char*) "-->", temp))
+			return false;
+	}
+	else if (PeekString((const unsigned char*) "![CDATA["))
+	{
+		// CDATA tag; read everything (including markup) until the ending
+		// CDATA tag.
+		if (!ReadCDATA())
+			return false;
+	}
+	else if (PeekString((const unsigned char*) "/"))
+	{
+		if (!ReadCloseTag())
+			return false;
 
-			// Bail if we've hit the end of the XML data.
-			if (open_tag_depth == 0)
-			{
-				xml_source->Seek((read - buffer) - buffer_used, SEEK_CUR);
-				break;
-			}
-		}
-		else
+		// Bail if we've hit the end of the XML data.
+		if (open_tag_depth == 0)
 		{
-			if (!ReadOpenTag())
-				break;
+			xml_source->Seek((read - buffer) - buffer_used, SEEK_CUR);
+			return false;
 		}
 	}
+	else
+	{
+		if (!ReadOpenTag())
+			return false;
+	}
+
+	return true;
+}
 
+void BaseXMLParser::EndParse()
+{
 	// Check for error conditions
 	if (open_tag_depth > 0)
 	{
 		Log::Message(Log::LT_WARNING, "XML parse error on line %d of %s.", GetLineNumber(), xml_source->GetSourceURL().GetURL().CString());
 	}
+
+	if (!buffer_in_place)
+		free(buffer);
+
+	buffer = NULL;
+	buffer_in_place = false;
+	read = NULL;
+	buffer_used = 0;
 }
 
 bool BaseXMLParser::ReadOpenTag()
 {
 	// Increase the open depth
 	open_tag_depth++;
+	num_open_tags_read++;
 
 	// Opening tag; send data immediately and open the tag.
 	if (!data.Empty())
@@ -440,6 +507,10 @@ bool BaseXMLParser::PeekString(const unsigned char* string, bool consume)
 
 			if (peek_read - buffer + i >= buffer_used)
 			{
+				// An in-place buffer already holds everything there is to read.
+				if (buffer_in_place)
+					return false;
+
 				// Wierd, seems our buffer is too small, realloc it bigger.
 				buffer_size *= 2;
 				int read_offset = read - buffer;
@@ -482,6 +553,9 @@ bool BaseXMLParser::PeekString(const unsigned char* string, bool consume)
 // Fill the buffer as much as possible, without removing any content that is still pending
 bool BaseXMLParser::FillBuffer()
 {
+	if (buffer_in_place)
+		return false;
+
 	int bytes_free = buffer_size;
 	int bytes_remaining = Math::Max((int)(buffer_used - (read - buffer)), 0);
 
@@ -29,8 +29,11 @@
 #include <Rocket/Core.h>
 #include "EventDispatcher.h"
 #include "EventIterators.h"
+#include "GeometryBatch.h"
+#include "ParallelLayout.h"
 #include "PluginRegistry.h"
 #include "StreamFile.h"
+#include "TextureLoader.h"
 #include <Rocket/Core/StreamMemory.h>
 #include <algorithm>
 #include <iterator>
@@ -40,13 +43,16 @@ namespace Core {
 
 const float DOUBLE_CLICK_TIME = 0.5f;
 
-Context::Context(const String& name) : name(name), mouse_position(0, 0), dimensions(0, 0), clip_origin(-1, -1), clip_dimensions(-1, -1)
+Context::Context(const String& name) : name(name), mouse_position(0, 0), dimensions(0, 0), clip_origin(-1, -1), clip_dimensions(-1, -1), scissor_origin(-1, -1), scissor_dimensions(-1, -1)
 {
 	instancer = NULL;
 
 	// Initialise this to NULL; this will be set in Rocket::Core::CreateContext().
 	render_interface = NULL;
 
+	scissor_dirty = true;
+	scissor_enabled = false;
+
 	root = Factory::InstanceElement(NULL, "*", "#root", XMLAttributes());
 	root->SetId(name);
 	root->SetOffset(Vector2f(0, 0), NULL);
@@ -73,6 +79,12 @@ Context::Context(const String& name) : name(name), mouse_position(0, 0), dimensi
 
 	last_click_element = NULL;
 	last_click_time = 0;
+
+	load_budget_elements = -1;
+	load_budget_time = 0.004f;
+
+	input_queueing = false;
+	processing_input_queue = false;
 }
 
 Context::~Context()
@@ -135,10 +147,20 @@ const Vector2i& Context::GetDimensions() const
 // Updates all elements in the element tree.
 bool Context::Update( )
 {
+	ROCKET_PROFILE_ZONE("Context::Update");
+
 	// TODO: Update animation. This should apply pseudo properties over elements in Update() ?
-	
+
+	ProcessInputQueue();
+
+	UpdateLoadingDocuments();
+
 	root->Update();
 
+	// Documents leave their layout to us if it is being done in parallel.
+	if (ParallelLayout::IsEnabled())
+		UpdateDocumentLayouts();
+
 	// Release any documents that were unloaded during the update.
 	ReleaseUnloadedDocuments();
 
@@ -147,6 +169,8 @@ bool Context::Update( )
 
 bool Context::UpdateWithAnimation(float delta_time)
 {
+	ROCKET_PROFILE_ZONE("Context::UpdateWithAnimation");
+
 	Update( );
 
 	ElementList::iterator i = anim_handles.begin();
@@ -173,16 +197,24 @@ bool Context::UpdateWithAnimation(float delta_time)
 // Renders all visible elements in the element tree.
 bool Context::Render()
 {
+	ROCKET_PROFILE_ZONE("Context::Render");
+
 	RenderInterface* render_interface = GetRenderInterface();
 	if (render_interface == NULL)
 		return false;
 
+	// Generate any textures that have finished loading in the background; their elements may need to be laid out again.
+	TextureLoader::GenerateTextures(render_interface);
+
 	// Update the layout for all documents in the root. This is done now as events during the
 	// update may have caused elements to require an update.
-	for (int i = 0; i < root->GetNumChildren(); ++i)
-		root->GetChild(i)->UpdateLayout();
+	UpdateDocumentLayouts();
 
 	render_interface->context = this;
+	GeometryBatch::Begin(render_interface);
+
+	// The application may have changed the scissor state since we last rendered, so reapply it in full.
+	DirtyScissorRegion();
 	ElementUtilities::ApplyActiveClipRegion(this, render_interface);
 
 	root->Render();
@@ -210,8 +242,12 @@ bool Context::Render()
 		active_cursor->Render();
 	}
 
+	GeometryBatch::End(render_interface);
 	render_interface->context = NULL;
 
+	// This frame will end once the render zone above closes.
+	Profiler::EndFrame();
+
 	return true;
 }
 
@@ -272,19 +308,7 @@ ElementDocument* Context::LoadDocument(Stream* stream)
 		return NULL;
 
 	root->AppendChild(document);
-
-	// Bind the events, run the layout and fire the 'onload' event.
-	ElementUtilities::BindEventAttributes(document);
-
-	document->UpdateLayout();
-
-	// Setup animation cache
-	anim_handles.clear();
-	CacheElementAnimations(document);
-
-	// Dispatch the load notifications.
-	PluginRegistry::NotifyDocumentLoad(document);
-	document->DispatchEvent(LOAD, Dictionary(), false);
+	FinishDocumentLoad(document);
 
 	return document;
 }
@@ -304,6 +328,61 @@ ElementDocument* Context::LoadDocumentFromMemory(const String& string)
 	return document;
 }
 
+// Begins loading a document into the context incrementally.
+ElementDocument* Context::LoadDocumentIncremental(const String& document_path)
+{
+	StreamFile* stream = new StreamFile();
+	if (!stream->Open(document_path))
+	{
+		stream->RemoveReference();
+		return NULL;
+	}
+
+	ElementDocument* document = LoadDocumentIncremental(stream);
+
+	stream->RemoveReference();
+
+	return document;
+}
+
+// Begins loading a document into the context incrementally.
+ElementDocument* Context::LoadDocumentIncremental(Stream* stream)
+{
+	PluginRegistry::NotifyDocumentOpen(this, stream->GetSourceURL().GetURL());
+
+	LoadingDocument loading_document;
+	loading_document.document = Factory::BeginDocumentStream(this, stream, loading_document.parser);
+	if (!loading_document.document)
+		return NULL;
+
+	loading_document.stream = stream;
+	stream->AddReference();
+
+	root->AppendChild(loading_document.document);
+	loading_documents.push_back(loading_document);
+
+	return loading_document.document;
+}
+
+// Returns true if a document is still being loaded incrementally.
+bool Context::IsDocumentLoading(ElementDocument* document) const
+{
+	for (size_t i = 0; i < loading_documents.size(); ++i)
+	{
+		if (loading_documents[i].document == document)
+			return true;
+	}
+
+	return false;
+}
+
+// Sets how much of each incrementally-loading document is parsed on each update.
+void Context::SetDocumentLoadBudget(int max_elements, float max_time)
+{
+	load_budget_elements = max_elements;
+	load_budget_time = max_time;
+}
+
 // Unload the given document
 void Context::UnloadDocument(ElementDocument* _document)
 {
@@ -314,6 +393,9 @@ void Context::UnloadDocument(ElementDocument* _document)
 			return;
 	}
 
+	// The parser mustn't keep adding elements to a document that is going away.
+	CancelDocumentLoad(_document);
+
 	// Add a reference, to ensure the document isn't released
 	// while we're closing it.
 	unloaded_documents.push_back(_document);
@@ -517,10 +599,11 @@ void Context::PullDocumentToFront(ElementDocument* document)
 		{
 			if (root->GetChild(i) == document)
 			{
+				document->RemoveFromStackingContext(false);
 				root->children.erase(root->children.begin() + i);
 				root->children.insert(root->children.begin() + root->GetNumChildren(), document);
 
-				root->DirtyStackingContext();
+				document->AddToStackingContext();
 			}
 		}
 	}
@@ -536,10 +619,11 @@ void Context::PushDocumentToBack(ElementDocument* document)
 		{
 			if (root->GetChild(i) == document)
 			{
+				document->RemoveFromStackingContext(false);
 				root->children.erase(root->children.begin() + i);
 				root->children.insert(root->children.begin(), document);
 
-				root->DirtyStackingContext();
+				document->AddToStackingContext();
 			}
 		}
 	}
@@ -560,6 +644,9 @@ void Context::RemoveEventListener(const String& event, EventListener* listener,
 // Sends a key down event into Rocket.
 bool Context::ProcessKeyDown(Input::KeyIdentifier key_identifier, int key_modifier_state)
 {
+	if (QueueInputEvent(INPUT_KEY_DOWN, key_identifier, 0, key_modifier_state))
+		return true;
+
 	// Generate the parameters for the key event.
 	Dictionary parameters;
 	GenerateKeyEventParameters(parameters, key_identifier);
@@ -574,6 +661,9 @@ bool Context::ProcessKeyDown(Input::KeyIdentifier key_identifier, int key_modifi
 // Sends a key up event into Rocket.
 bool Context::ProcessKeyUp(Input::KeyIdentifier key_identifier, int key_modifier_state)
 {
+	if (QueueInputEvent(INPUT_KEY_UP, key_identifier, 0, key_modifier_state))
+		return true;
+
 	// Generate the parameters for the key event.
 	Dictionary parameters;
 	GenerateKeyEventParameters(parameters, key_identifier);
@@ -588,6 +678,9 @@ bool Context::ProcessKeyUp(Input::KeyIdentifier key_identifier, int key_modifier
 // Sends a single character of text as text input into Rocket.
 bool Context::ProcessTextInput(word character)
 {
+	if (QueueInputEvent(INPUT_TEXT_CHARACTER, character, 0, 0))
+		return true;
+
 	// Generate the parameters for the key event.
 	Dictionary parameters;
 	parameters.Set("data", character);
@@ -601,6 +694,9 @@ bool Context::ProcessTextInput(word character)
 // Sends a string of text as text input into Rocket.
 bool Context::ProcessTextInput(const String& string)
 {
+	if (QueueInputEvent(INPUT_TEXT_STRING, 0, 0, 0, string))
+		return true;
+
 	bool consumed = true;
 
 	for (size_t i = 0; i < string.Length(); ++i)
@@ -621,6 +717,9 @@ bool Context::ProcessTextInput(const String& string)
 // Sends a mouse movement event into Rocket.
 void Context::ProcessMouseMove(int x, int y, int key_modifier_state)
 {
+	if (QueueInputEvent(INPUT_MOUSE_MOVE, x, y, key_modifier_state))
+		return;
+
 	// Check whether the mouse moved since the last event came through.
 	Vector2i old_mouse_position = mouse_position;
 	bool mouse_moved = (x != mouse_position.x) || (y != mouse_position.y);
@@ -675,6 +774,9 @@ static Element* FindFocusElement(Element* element)
 // Sends a mouse-button down event into Rocket.
 void Context::ProcessMouseButtonDown(int button_index, int key_modifier_state)
 {
+	if (QueueInputEvent(INPUT_MOUSE_BUTTON_DOWN, button_index, 0, key_modifier_state))
+		return;
+
 	Dictionary parameters;
 	GenerateMouseEventParameters(parameters, button_index);
 	GenerateKeyModifierEventParameters(parameters, key_modifier_state);
@@ -725,8 +827,7 @@ void Context::ProcessMouseButtonDown(int button_index, int key_modifier_state)
 			}
 		}
 
-		for (ElementSet::iterator itr = hover_chain.begin(); itr != hover_chain.end(); ++itr)
-			active_chain.push_back((*itr));
+		active_chain.insert(active_chain.end(), hover_chain.begin(), hover_chain.end());
 
 		if (propogate)
 		{
@@ -758,6 +859,9 @@ void Context::ProcessMouseButtonDown(int button_index, int key_modifier_state)
 // Sends a mouse-button up event into Rocket.
 void Context::ProcessMouseButtonUp(int button_index, int key_modifier_state)
 {
+	if (QueueInputEvent(INPUT_MOUSE_BUTTON_UP, button_index, 0, key_modifier_state))
+		return;
+
 	Dictionary parameters;
 	GenerateMouseEventParameters(parameters, button_index);
 	GenerateKeyModifierEventParameters(parameters, key_modifier_state);
@@ -820,6 +924,9 @@ void Context::ProcessMouseButtonUp(int button_index, int key_modifier_state)
 // Sends a mouse-wheel movement event into Rocket.
 bool Context::ProcessMouseWheel(int wheel_delta, int key_modifier_state)
 {
+	if (QueueInputEvent(INPUT_MOUSE_WHEEL, wheel_delta, 0, key_modifier_state))
+		return true;
+
 	if (hover)
 	{
 		Dictionary scroll_parameters;
@@ -832,6 +939,20 @@ bool Context::ProcessMouseWheel(int wheel_delta, int key_modifier_state)
 	return true;
 }
 
+// Enables or disables queueing of input until the next update.
+void Context::SetInputQueueing(bool queue_input)
+{
+	input_queueing = queue_input;
+	if (!input_queueing)
+		ProcessInputQueue();
+}
+
+// Returns true if input is queued until the next update.
+bool Context::IsInputQueueing() const
+{
+	return input_queueing;
+}
+
 // Gets the context's render interface.
 RenderInterface* Context::GetRenderInterface() const
 {
@@ -857,6 +978,22 @@ void Context::SetActiveClipRegion(const Vector2i& origin, const Vector2i& dimens
 	clip_dimensions = dimensions;
 }
 
+// Forgets the scissor state last sent to the render interface.
+void Context::DirtyScissorRegion()
+{
+	scissor_dirty = true;
+}
+
+// Adds an estimate of the memory held by the context's documents and their elements to a breakdown.
+void Context::GetMemoryUsage(MemoryUsage& usage)
+{
+	usage.Add(MemoryUsage::ELEMENTS, sizeof(Context));
+
+	root->GetMemoryUsage(usage);
+	if (cursor_proxy != NULL)
+		cursor_proxy->GetMemoryUsage(usage);
+}
+
 // Sets the instancer to use for releasing this object.
 void Context::SetInstancer(ContextInstancer* _instancer)
 {
@@ -868,39 +1005,17 @@ void Context::SetInstancer(ContextInstancer* _instancer)
 // Internal callback for when an element is removed from the hierarchy.
 void Context::OnElementRemove(Element* element)
 {
-	ElementSet::iterator i = hover_chain.find(element);
+	ElementList::iterator i = std::find(hover_chain.begin(), hover_chain.end(), element);
 	if (i == hover_chain.end())
 		return;
 
-	ElementSet old_hover_chain = hover_chain;
-	hover_chain.erase(i);
-
-	Element* hover_element = element;
-	while (hover_element != NULL)
-	{
-		Element* next_hover_element = NULL;
-
-		// Look for a child on this element's children that is also hovered.
-		for (int j = 0; j < hover_element->GetNumChildren(true); ++j)
-		{
-			// Is this child also in the hover chain?
-			Element* hover_child_element = hover_element->GetChild(j);
-			ElementSet::iterator k = hover_chain.find(hover_child_element);
-			if (k != hover_chain.end())
-			{
-				next_hover_element = hover_child_element;
-				hover_chain.erase(k);
-
-				break;
-			}
-		}
-
-		hover_element = next_hover_element;
-	}
+	// The chain runs up from the hover element, so the removed element's hovered descendants all precede it.
+	ElementList old_hover_chain(hover_chain.begin(), i + 1);
+	hover_chain.erase(hover_chain.begin(), i + 1);
 
 	Dictionary parameters;
 	GenerateMouseEventParameters(parameters, -1);
-	SendEvents(old_hover_chain, hover_chain, MOUSEOUT, parameters, true);
+	std::for_each(old_hover_chain.begin(), old_hover_chain.end(), RKTEventFunctor(MOUSEOUT, parameters, true));
 }
 
 // Internal callback for when a new element gains focus
@@ -975,6 +1090,68 @@ void Context::GenerateClickEvent(Element* element)
 	element->DispatchEvent(CLICK, parameters, true);
 }
 
+// Adds an event to the input queue if input is being queued.
+bool Context::QueueInputEvent(InputEventType type, int value, int y, int key_modifier_state, const String& text)
+{
+	if (!input_queueing ||
+		processing_input_queue)
+		return false;
+
+	// Only the last of a run of mouse movements needs to be processed.
+	if (type == INPUT_MOUSE_MOVE &&
+		!input_queue.empty() &&
+		input_queue.back().type == INPUT_MOUSE_MOVE)
+	{
+		input_queue.back().value = value;
+		input_queue.back().y = y;
+		input_queue.back().key_modifier_state = key_modifier_state;
+		return true;
+	}
+
+	InputEvent event;
+	event.type = type;
+	event.value = value;
+	event.y = y;
+	event.key_modifier_state = key_modifier_state;
+	event.text = text;
+	input_queue.push_back(event);
+
+	return true;
+}
+
+// Sends all queued input events in the order they were received.
+void Context::ProcessInputQueue()
+{
+	if (input_queue.empty() ||
+		processing_input_queue)
+		return;
+
+	ROCKET_PROFILE_ZONE("Context::ProcessInputQueue");
+
+	// Input received while the queue is processed is sent immediately, so the queue can't change underneath us.
+	InputQueue events;
+	events.swap(input_queue);
+	processing_input_queue = true;
+
+	for (size_t i = 0; i < events.size(); ++i)
+	{
+		const InputEvent& event = events[i];
+		switch (event.type)
+		{
+			case INPUT_KEY_DOWN:			ProcessKeyDown((Input::KeyIdentifier) event.value, event.key_modifier_state); break;
+			case INPUT_KEY_UP:				ProcessKeyUp((Input::KeyIdentifier) event.value, event.key_modifier_state); break;
+			case INPUT_TEXT_CHARACTER:		ProcessTextInput((word) event.value); break;
+			case INPUT_TEXT_STRING:			ProcessTextInput(event.text); break;
+			case INPUT_MOUSE_MOVE:			ProcessMouseMove(event.value, event.y, event.key_modifier_state); break;
+			case INPUT_MOUSE_BUTTON_DOWN:	ProcessMouseButtonDown(event.value, event.key_modifier_state); break;
+			case INPUT_MOUSE_BUTTON_UP:		ProcessMouseButtonUp(event.value, event.key_modifier_state); break;
+			case INPUT_MOUSE_WHEEL:			ProcessMouseWheel(event.value, event.key_modifier_state); break;
+		}
+	}
+
+	processing_input_queue = false;
+}
+
 // Updates the current hover elements, sending required events.
 void Context::UpdateHoverChain(const Dictionary& parameters, const Dictionary& drag_parameters, const Vector2i& old_mouse_position)
 {
@@ -1013,30 +1190,19 @@ void Context::UpdateHoverChain(const Dictionary& parameters, const Dictionary& d
 		SetMouseCursor(hover->GetProperty< String >(CURSOR));
 
 	// Build the new hover chain.
-	ElementSet new_hover_chain;
-	Element* element = *hover;
-	while (element != NULL)
-	{
-		new_hover_chain.insert(element);
-		element = element->GetParentNode();
-	}
+	ElementList new_hover_chain;
+	BuildChain(*hover, new_hover_chain);
 
 	// Send mouseout / mouseover events.
-	SendEvents(hover_chain, new_hover_chain, MOUSEOUT, parameters, true);
-	SendEvents(new_hover_chain, hover_chain, MOUSEOVER, parameters, true);
+	SendChainEvents(hover_chain, new_hover_chain, MOUSEOUT, MOUSEOVER, parameters);
 
 	// Send out drag events.
 	if (drag)
 	{
 		drag_hover = GetElementAtPoint(position, *drag);
 
-		ElementSet new_drag_hover_chain;
-		element = *drag_hover;
-		while (element != NULL)
-		{
-			new_drag_hover_chain.insert(element);
-			element = element->GetParentNode();
-		}
+		ElementList new_drag_hover_chain;
+		BuildChain(*drag_hover, new_drag_hover_chain);
 
 /*		if (mouse_moved && !drag_started)
 		{
@@ -1054,8 +1220,7 @@ void Context::UpdateHoverChain(const Dictionary& parameters, const Dictionary& d
 			drag_verbose)
 		{
 			// Send out ondragover and ondragout events as appropriate.
-			SendEvents(drag_hover_chain, new_drag_hover_chain, DRAGOUT, drag_parameters, true);
-			SendEvents(new_drag_hover_chain, drag_hover_chain, DRAGOVER, drag_parameters, true);
+			SendChainEvents(drag_hover_chain, new_drag_hover_chain, DRAGOUT, DRAGOVER, drag_parameters);
 		}
 
 		drag_hover_chain.swap(new_drag_hover_chain);
@@ -1098,8 +1263,7 @@ Element* Context::GetElementAtPoint(const Vector2f& point, const Element* ignore
 	// that is under the cursor.
 	if (element->local_stacking_context)
 	{
-		if (element->stacking_context_dirty)
-			element->BuildLocalStackingContext();
+		element->UpdateStackingContext();
 
 		for (int i = (int) element->stacking_context.size() - 1; i >= 0; --i)
 		{
@@ -1240,6 +1404,80 @@ void Context::ReleaseUnloadedDocuments()
 	}
 }
 
+// Parses the next part of each incrementally-loading document, finishing the documents that are complete.
+void Context::UpdateLoadingDocuments()
+{
+	size_t i = 0;
+	while (i < loading_documents.size())
+	{
+		LoadingDocument loading_document = loading_documents[i];
+
+		// Lock the layout while elements are being added; the partial document is formatted as normal afterwards.
+		loading_document.document->LockLayout(true);
+		bool complete = loading_document.parser->ContinueParse(load_budget_elements, load_budget_time);
+		loading_document.document->LockLayout(false);
+
+		if (!complete)
+		{
+			++i;
+			continue;
+		}
+
+		// Remove the document from the list before finishing it, as its load handlers may load or unload others.
+		loading_documents.erase(loading_documents.begin() + i);
+		delete loading_document.parser;
+		loading_document.stream->RemoveReference();
+
+		FinishDocumentLoad(loading_document.document);
+	}
+}
+
+// Stops loading a document incrementally, releasing its parser and stream.
+void Context::CancelDocumentLoad(ElementDocument* document)
+{
+	for (LoadingDocumentList::iterator i = loading_documents.begin(); i != loading_documents.end(); ++i)
+	{
+		if ((*i).document == document)
+		{
+			delete (*i).parser;
+			(*i).stream->RemoveReference();
+			loading_documents.erase(i);
+			return;
+		}
+	}
+}
+
+// Binds the events of a newly-loaded document, lays it out and sends its load notifications.
+void Context::FinishDocumentLoad(ElementDocument* document)
+{
+	// Bind the events, run the layout and fire the 'onload' event.
+	ElementUtilities::BindEventAttributes(document);
+
+	document->UpdateLayout();
+
+	// Setup animation cache
+	anim_handles.clear();
+	CacheElementAnimations(document);
+
+	// Dispatch the load notifications.
+	PluginRegistry::NotifyDocumentLoad(document);
+	document->DispatchEvent(LOAD, Dictionary(), false);
+}
+
+// Updates the layout of all documents, formatting them in parallel if parallel layout is enabled.
+void Context::UpdateDocumentLayouts()
+{
+	std::vector< ElementDocument* > documents;
+	for (int i = 0; i < GetNumDocuments(); ++i)
+	{
+		ElementDocument* document = GetDocument(i);
+		if (document != NULL)
+			documents.push_back(document);
+	}
+
+	ParallelLayout::UpdateDocuments(documents);
+}
+
 // Store off all element handles
 void Context::CacheElementAnimations( Element *node )
 {
@@ -1266,6 +1504,39 @@ void Context::SendEvents(const ElementSet& old_items, const ElementSet& new_item
 	std::for_each(elements.begin(), elements.end(), RKTEventFunctor(event, parameters, interruptible));
 }
 
+// Builds the chain of elements from an element up to the root.
+void Context::BuildChain(Element* element, ElementList& chain)
+{
+	while (element != NULL)
+	{
+		chain.push_back(element);
+		element = element->GetParentNode();
+	}
+}
+
+// Sends the out and over events to the elements of two chains that lie below their common ancestor.
+void Context::SendChainEvents(const ElementList& old_chain, const ElementList& new_chain, const String& out_event, const String& over_event, const Dictionary& parameters)
+{
+	// Both chains end at the root, so walk back from their ends until they diverge; everything from there up is
+	// shared by both chains and keeps its state.
+	size_t old_size = old_chain.size();
+	size_t new_size = new_chain.size();
+	while (old_size > 0 &&
+		   new_size > 0 &&
+		   old_chain[old_size - 1] == new_chain[new_size - 1])
+	{
+		--old_size;
+		--new_size;
+	}
+
+	// Copy the elements out before sending the events, as the handlers may change the chains.
+	ElementList out_elements(old_chain.begin(), old_chain.begin() + old_size);
+	ElementList over_elements(new_chain.begin(), new_chain.begin() + new_size);
+
+	std::for_each(out_elements.begin(), out_elements.end(), RKTEventFunctor(out_event, parameters, true));
+	std::for_each(over_elements.rbegin(), over_elements.rend(), RKTEventFunctor(over_event, parameters, true));
+}
+
 void Context::OnReferenceDeactivate()
 {
 	if (instancer != NULL)
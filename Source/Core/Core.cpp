@@ -28,12 +28,17 @@
 #include "precompiled.h"
 #include <Rocket/Core.h>
 #include <algorithm>
+#include "ElementRenderCache.h"
 #include "FileInterfaceDefault.h"
+#include "GeometryBuffer.h"
 #include "GeometryDatabase.h"
 #include "PluginRegistry.h"
 #include "StyleSheetFactory.h"
+#include "TaskPool.h"
 #include "TemplateCache.h"
 #include "TextureDatabase.h"
+#include "TextureLoader.h"
+#include "Threading.h"
 
 namespace Rocket {
 namespace Core {
@@ -51,6 +56,7 @@ static bool initialised = false;
 
 typedef std::map< String, Context* > ContextMap;
 static ContextMap contexts;
+static Mutex contexts_mutex;
 
 #ifndef ROCKET_VERSION
 	#define ROCKET_VERSION "1.2.1-dev"
@@ -70,6 +76,7 @@ class PluginContextRelease : public Plugin
 
 		virtual void OnContextDestroy(Context* context)
 		{
+			MutexLock lock(contexts_mutex);
 			contexts.erase(context->GetName());
 		}
 };
@@ -126,6 +133,8 @@ void Shutdown()
 		Core::Log::Message(Log::LT_WARNING, "Context '%s' still active on shutdown.", (*itr).first.CString());
 	contexts.clear();
 
+	TextureLoader::Shutdown();
+	TaskPool::Shutdown();
 	TemplateCache::Shutdown();
 	StyleSheetFactory::Shutdown();
 	StyleSheetSpecification::Shutdown();
@@ -227,6 +236,8 @@ Context* CreateContext(const String& name, const Vector2i& dimensions, RenderInt
 		render_interface == NULL)
 		Log::Message(Log::LT_WARNING, "Failed to create context '%s', no render interface specified and no default render interface exists.", name.CString());
 
+	MutexLock lock(contexts_mutex);
+
 	if (GetContext(name) != NULL)
 	{
 		Log::Message(Log::LT_WARNING, "Failed to create context '%s', context already exists.", name.CString());
@@ -258,6 +269,8 @@ Context* CreateContext(const String& name, const Vector2i& dimensions, RenderInt
 // Fetches a previously constructed context by name.
 Context* GetContext(const String& name)
 {
+	MutexLock lock(contexts_mutex);
+
 	ContextMap::iterator i = contexts.find(name);
 	if (i == contexts.end())
 		return NULL;
@@ -268,6 +281,8 @@ Context* GetContext(const String& name)
 // Fetches a context by index.
 Context* GetContext(int index)
 {
+	MutexLock lock(contexts_mutex);
+
 	ContextMap::iterator i = contexts.begin();
 	int count = 0;
 
@@ -289,6 +304,7 @@ Context* GetContext(int index)
 // Returns the number of active contexts.
 int GetNumContexts()
 {
+	MutexLock lock(contexts_mutex);
 	return (int) contexts.size();
 }
 
@@ -301,16 +317,86 @@ void RegisterPlugin(Plugin* plugin)
 	PluginRegistry::RegisterPlugin(plugin);
 }
 
-// Forces all compiled geometry handles generated by libRocket to be released.
+// Forces all compiled geometry handles and geometry buffers generated by libRocket to be released.
 void ReleaseCompiledGeometries()
 {
 	GeometryDatabase::ReleaseGeometries();
+	GeometryBuffer::ReleaseBuffers();
 }
 
 // Forces all texture handles loaded and generated by libRocket to be released.
 void ReleaseTextures()
 {
 	TextureDatabase::ReleaseTextures();
+	ElementRenderCache::ReleaseRenderTargets();
+}
+
+// Sets the maximum amount of texture memory render caches may use.
+void SetRenderCacheBudget(size_t budget)
+{
+	ElementRenderCache::SetMemoryBudget(budget);
+}
+
+// Returns the maximum amount of texture memory render caches may use.
+size_t GetRenderCacheBudget()
+{
+	return ElementRenderCache::GetMemoryBudget();
+}
+
+// Sets the number of threads used to lay out documents.
+void SetLayoutThreads(int num_threads)
+{
+	TaskPool::SetNumThreads(num_threads);
+}
+
+// Returns the number of threads used to lay out documents.
+int GetLayoutThreads()
+{
+	return TaskPool::GetNumThreads();
+}
+
+// Sets the number of threads that run background jobs.
+void SetBackgroundThreads(int num_threads)
+{
+	TaskPool::SetNumBackgroundThreads(num_threads);
+}
+
+// Returns the number of threads that run background jobs.
+int GetBackgroundThreads()
+{
+	return TaskPool::GetNumBackgroundThreads();
+}
+
+// Enables or disables loading textures in the background.
+void SetAsyncTextureLoading(bool enable)
+{
+	TextureLoader::SetEnabled(enable);
+}
+
+// Returns true if textures are loaded in the background.
+bool GetAsyncTextureLoading()
+{
+	return TextureLoader::IsEnabled();
+}
+
+// Sets the texture drawn in place of textures that are loading in the background.
+void SetTexturePlaceholder(const String& source)
+{
+	TextureLoader::SetPlaceholder(source);
+}
+
+// Adds an estimate of the memory held by resources shared between all contexts to a breakdown.
+void GetMemoryUsage(MemoryUsage& usage)
+{
+	TextureDatabase::GetMemoryUsage(usage);
+	usage.Add(MemoryUsage::TEXTURES, ElementRenderCache::GetMemoryUsage());
+	usage.Add(MemoryUsage::GEOMETRY, GeometryDatabase::GetMemoryUsage());
+}
+
+// Returns the amount of texture memory currently used by render caches.
+size_t GetRenderCacheMemoryUsage()
+{
+	return ElementRenderCache::GetMemoryUsage();
 }
 
 }
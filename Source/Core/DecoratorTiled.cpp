@@ -28,6 +28,7 @@
 #include "precompiled.h"
 #include "DecoratorTiled.h"
 #include <Rocket/Core.h>
+#include <Rocket/Core/Geometry.h>
 
 namespace Rocket {
 namespace Core {
@@ -262,5 +263,84 @@ void DecoratorTiled::ScaleTileDimensions(Vector2f& tile_dimensions, float axis_v
 	}
 }
 
+// Returns the data generated for another element in the same context with the same padding size.
+DecoratorDataHandle DecoratorTiled::AcquireSharedElementData(Element* element)
+{
+	SharedElementDataKey key;
+	key.context = element->GetContext();
+	key.size = element->GetBox().GetSize(Box::PADDING);
+	if (key.context == NULL)
+		return 0;
+
+	MutexLock lock(shared_data_mutex);
+
+	SharedElementDataKeyMap::iterator i = shared_data_keys.find(key);
+	if (i == shared_data_keys.end())
+		return 0;
+
+	shared_data[(*i).second].num_references++;
+	return (*i).second;
+}
+
+// Shares data newly generated for an element with later elements in the same context with the same padding size.
+void DecoratorTiled::ShareElementData(Element* element, DecoratorDataHandle element_data)
+{
+	SharedElementData data;
+	data.key.context = element->GetContext();
+	data.key.size = element->GetBox().GetSize(Box::PADDING);
+	data.num_references = 1;
+	if (data.key.context == NULL)
+		return;
+
+	// Data generated while a texture is loading in the background is sized to the placeholder and generated again once
+	// the texture is ready, so it isn't shared.
+	RenderInterface* render_interface = element->GetRenderInterface();
+	for (int i = 0; GetTexture(i) != NULL; ++i)
+	{
+		if (GetTexture(i)->IsLoading(render_interface))
+			return;
+	}
+
+	MutexLock lock(shared_data_mutex);
+
+	// Another element may have shared its own data while this element's was generated; this element's data is then
+	// left unshared.
+	if (shared_data_keys.insert(SharedElementDataKeyMap::value_type(data.key, element_data)).second)
+		shared_data[element_data] = data;
+}
+
+// Removes a reference from element data that may be shared.
+bool DecoratorTiled::ReleaseSharedElementData(DecoratorDataHandle element_data)
+{
+	MutexLock lock(shared_data_mutex);
+
+	SharedElementDataMap::iterator i = shared_data.find(element_data);
+	if (i == shared_data.end())
+		return true;
+
+	if (--(*i).second.num_references > 0)
+		return false;
+
+	shared_data_keys.erase((*i).second.key);
+	shared_data.erase(i);
+	return true;
+}
+
+// Creates geometry for element data that may be shared with other elements.
+Geometry* DecoratorTiled::CreateSharedGeometry(Element* element)
+{
+	Context* context = element->GetContext();
+	return context != NULL ? new Geometry(context) : new Geometry(element);
+}
+
+bool DecoratorTiled::SharedElementDataKey::operator<(const SharedElementDataKey& rhs) const
+{
+	if (context != rhs.context)
+		return context < rhs.context;
+	if (size.x != rhs.size.x)
+		return size.x < rhs.size.x;
+	return size.y < rhs.size.y;
+}
+
 }
 }
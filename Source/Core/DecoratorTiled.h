@@ -30,10 +30,13 @@
 
 #include <Rocket/Core/Decorator.h>
 #include <Rocket/Core/Vertex.h>
+#include "Threading.h"
 
 namespace Rocket {
 namespace Core {
 
+class Context;
+class Geometry;
 struct Texture;
 
 /**
@@ -123,6 +126,50 @@ protected:
 	/// @param axis_value[in] The fixed value to scale against.
 	/// @param axis[in] The axis to scale against; either 0 (for x) or 1 (for y).
 	void ScaleTileDimensions(Vector2f& tile_dimensions, float axis_value, int axis);
+
+	/// Returns the data generated for another element in the same context with the same padding size, adding a
+	/// reference to it. As a tiled decorator's geometry depends only on these, elements such as a grid of identical
+	/// slots can share their geometry, allowing it to be rendered as instances of the same compiled geometry.
+	/// @param[in] element The newly decorated element.
+	/// @return The shared data, or 0 if there is no data the element can share.
+	DecoratorDataHandle AcquireSharedElementData(Element* element);
+	/// Shares data newly generated for an element with later elements in the same context with the same padding size.
+	/// The data's geometry must be hosted by the element's context rather than the element.
+	/// @param[in] element The decorated element.
+	/// @param[in] element_data The data generated for the element.
+	void ShareElementData(Element* element, DecoratorDataHandle element_data);
+	/// Removes a reference from element data that may be shared.
+	/// @param[in] element_data The data to release.
+	/// @return True if the data is no longer used and should be destroyed, false if other elements are still using it.
+	bool ReleaseSharedElementData(DecoratorDataHandle element_data);
+	/// Creates geometry for element data that may be shared with other elements. The geometry is hosted by the
+	/// element's context if it has one, rather than by the element, so it outlives the element that generated it.
+	/// @param[in] element The decorated element.
+	/// @return The new geometry.
+	Geometry* CreateSharedGeometry(Element* element);
+
+private:
+	struct SharedElementDataKey
+	{
+		Context* context;
+		Vector2f size;
+
+		bool operator<(const SharedElementDataKey& rhs) const;
+	};
+
+	struct SharedElementData
+	{
+		SharedElementDataKey key;
+		int num_references;
+	};
+
+	typedef std::map< SharedElementDataKey, DecoratorDataHandle > SharedElementDataKeyMap;
+	typedef std::map< DecoratorDataHandle, SharedElementData > SharedElementDataMap;
+
+	// The data shared between elements, indexed both by the elements' context and size and by the data itself.
+	SharedElementDataKeyMap shared_data_keys;
+	SharedElementDataMap shared_data;
+	Mutex shared_data_mutex;
 };
 
 }
@@ -36,10 +36,10 @@ namespace Core {
 
 struct DecoratorTiledBoxData
 {
-	DecoratorTiledBoxData(Element* host_element)
+	DecoratorTiledBoxData()
 	{
 		for (int i = 0; i < 9; ++i)
-			geometry[i] = new Geometry(host_element);
+			geometry[i] = NULL;
 	}
 
 	~DecoratorTiledBoxData()
@@ -112,6 +112,10 @@ bool DecoratorTiledBox::Initialise(const Tile* _tiles, const String* _texture_na
 // Called on a decorator to generate any required per-element data for a newly decorated element.
 DecoratorDataHandle DecoratorTiledBox::GenerateElementData(Element* element)
 {
+	DecoratorDataHandle shared_data = AcquireSharedElementData(element);
+	if (shared_data != 0)
+		return shared_data;
+
 	// Initialise the tiles for this element.
 	for (int i = 0; i < 9; i++)
 	{
@@ -195,7 +199,9 @@ DecoratorDataHandle DecoratorTiledBox::GenerateElementData(Element* element)
 			bottom_dimensions.y = bottom_right_dimensions.y;
 	}
 
-	DecoratorTiledBoxData* data = new DecoratorTiledBoxData(element);
+	DecoratorTiledBoxData* data = new DecoratorTiledBoxData();
+	for (int i = 0; i < 9; ++i)
+		data->geometry[i] = CreateSharedGeometry(element);
 
 	// Generate the geometry for the top-left tile.
 	tiles[TOP_LEFT_CORNER].GenerateGeometry(data->geometry[tiles[TOP_LEFT_CORNER].texture_index]->GetVertices(),
@@ -278,13 +284,15 @@ DecoratorDataHandle DecoratorTiledBox::GenerateElementData(Element* element)
 	while ((texture = GetTexture(texture_index)) != NULL)
 		data->geometry[texture_index++]->SetTexture(texture);
 
+	ShareElementData(element, reinterpret_cast<DecoratorDataHandle>(data));
 	return reinterpret_cast<DecoratorDataHandle>(data);
 }
 
 // Called to release element data generated by this decorator.
 void DecoratorTiledBox::ReleaseElementData(DecoratorDataHandle element_data)
 {
-	delete reinterpret_cast< DecoratorTiledBoxData* >(element_data);
+	if (ReleaseSharedElementData(element_data))
+		delete reinterpret_cast< DecoratorTiledBoxData* >(element_data);
 }
 
 // Called to render the decorator on an element.
@@ -36,10 +36,10 @@ namespace Core {
 
 struct DecoratorTiledHorizontalData
 {
-	DecoratorTiledHorizontalData(Element* host_element)
+	DecoratorTiledHorizontalData()
 	{
 		for (int i = 0; i < 3; ++i)
-			geometry[i] = new Geometry(host_element);
+			geometry[i] = NULL;
 	}
 
 	~DecoratorTiledHorizontalData()
@@ -99,11 +99,17 @@ bool DecoratorTiledHorizontal::Initialise(const Tile* _tiles, const String* _tex
 // Called on a decorator to generate any required per-element data for a newly decorated element.
 DecoratorDataHandle DecoratorTiledHorizontal::GenerateElementData(Element* element)
 {
+	DecoratorDataHandle shared_data = AcquireSharedElementData(element);
+	if (shared_data != 0)
+		return shared_data;
+
 	// Initialise the tiles for this element.
 	for (int i = 0; i < 3; i++)
 		tiles[i].CalculateDimensions(element, *(GetTexture(tiles[i].texture_index)));
 
-	DecoratorTiledHorizontalData* data = new DecoratorTiledHorizontalData(element);
+	DecoratorTiledHorizontalData* data = new DecoratorTiledHorizontalData();
+	for (int i = 0; i < 3; ++i)
+		data->geometry[i] = CreateSharedGeometry(element);
 
 	Vector2f padded_size = element->GetBox().GetSize(Box::PADDING);
 
@@ -137,13 +143,15 @@ DecoratorDataHandle DecoratorTiledHorizontal::GenerateElementData(Element* eleme
 	while ((texture = GetTexture(texture_index)) != NULL)
 		data->geometry[texture_index++]->SetTexture(texture);
 
+	ShareElementData(element, reinterpret_cast<DecoratorDataHandle>(data));
 	return reinterpret_cast<DecoratorDataHandle>(data);
 }
 
 // Called to release element data generated by this decorator.
 void DecoratorTiledHorizontal::ReleaseElementData(DecoratorDataHandle element_data)
 {
-	delete reinterpret_cast< DecoratorTiledHorizontalData* >(element_data);
+	if (ReleaseSharedElementData(element_data))
+		delete reinterpret_cast< DecoratorTiledHorizontalData* >(element_data);
 }
 
 // Called to render the decorator on an element.
@@ -57,22 +57,28 @@ bool DecoratorTiledImage::Initialise(const Tile& _tile, const String& _texture_n
 // Called on a decorator to generate any required per-element data for a newly decorated element.
 DecoratorDataHandle DecoratorTiledImage::GenerateElementData(Element* element)
 {
+	DecoratorDataHandle shared_data = AcquireSharedElementData(element);
+	if (shared_data != 0)
+		return shared_data;
+
 	// Calculate the tile's dimensions for this element.
 	tile.CalculateDimensions(element, *GetTexture(tile.texture_index));
 
-	Geometry* data = new Geometry(element);
+	Geometry* data = CreateSharedGeometry(element);
 	data->SetTexture(GetTexture());
 
 	// Generate the geometry for the tile.
 	tile.GenerateGeometry(data->GetVertices(), data->GetIndices(), element, Vector2f(0, 0), element->GetBox().GetSize(Box::PADDING), tile.GetDimensions(element));
 
+	ShareElementData(element, reinterpret_cast<DecoratorDataHandle>(data));
 	return reinterpret_cast<DecoratorDataHandle>(data);
 }
 
 // Called to release element data generated by this decorator.
 void DecoratorTiledImage::ReleaseElementData(DecoratorDataHandle element_data)
 {
-	delete reinterpret_cast< Geometry* >(element_data);
+	if (ReleaseSharedElementData(element_data))
+		delete reinterpret_cast< Geometry* >(element_data);
 }
 
 // Called to render the decorator on an element.
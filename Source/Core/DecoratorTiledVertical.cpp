@@ -37,10 +37,10 @@ namespace Core {
 
 struct DecoratorTiledVerticalData
 {
-	DecoratorTiledVerticalData(Element* host_element)
+	DecoratorTiledVerticalData()
 	{
 		for (int i = 0; i < 3; ++i)
-			geometry[i] = new Geometry(host_element);
+			geometry[i] = NULL;
 	}
 
 	~DecoratorTiledVerticalData()
@@ -100,11 +100,17 @@ bool DecoratorTiledVertical::Initialise(const Tile* _tiles, const String* _textu
 // Called on a decorator to generate any required per-element data for a newly decorated element.
 DecoratorDataHandle DecoratorTiledVertical::GenerateElementData(Element* element)
 {
+	DecoratorDataHandle shared_data = AcquireSharedElementData(element);
+	if (shared_data != 0)
+		return shared_data;
+
 	// Initialise the tile for this element.
 	for (int i = 0; i < 3; i++)
 		tiles[i].CalculateDimensions(element, *GetTexture(tiles[i].texture_index));
 
-	DecoratorTiledVerticalData* data = new DecoratorTiledVerticalData(element);
+	DecoratorTiledVerticalData* data = new DecoratorTiledVerticalData();
+	for (int i = 0; i < 3; ++i)
+		data->geometry[i] = CreateSharedGeometry(element);
 
 	Vector2f padded_size = element->GetBox().GetSize(Box::PADDING);
 
@@ -138,13 +144,15 @@ DecoratorDataHandle DecoratorTiledVertical::GenerateElementData(Element* element
 	while ((texture = GetTexture(texture_index)) != NULL)
 		data->geometry[texture_index++]->SetTexture(texture);
 
+	ShareElementData(element, reinterpret_cast<DecoratorDataHandle>(data));
 	return reinterpret_cast<DecoratorDataHandle>(data);
 }
 
 // Called to release element data generated by this decorator.
 void DecoratorTiledVertical::ReleaseElementData(DecoratorDataHandle element_data)
 {
-	delete reinterpret_cast< DecoratorTiledVerticalData* >(element_data);
+	if (ReleaseSharedElementData(element_data))
+		delete reinterpret_cast< DecoratorTiledVerticalData* >(element_data);
 }
 
 // Called to render the decorator on an element.
@@ -29,16 +29,21 @@
 #include <Rocket/Core/Element.h>
 #include <Rocket/Core/Dictionary.h>
 #include <algorithm>
+#include "ElementAncestorFilter.h"
 #include "ElementBackground.h"
 #include "ElementBorder.h"
 #include "ElementDefinition.h"
 #include "ElementStyle.h"
 #include "EventDispatcher.h"
 #include "ElementDecoration.h"
+#include "ElementRenderCache.h"
 #include "FontFaceHandle.h"
 #include "LayoutEngine.h"
+#include "MemoryUsageUtilities.h"
 #include "PluginRegistry.h"
 #include "StyleSheetParser.h"
+#include "TextureLoader.h"
+#include "Threading.h"
 #include "XMLParseTools.h"
 #include <Rocket/Core/Core.h>
 
@@ -72,8 +77,47 @@ public:
 	}
 };
 
+// The number of elements that can be waiting to be inserted into a stacking context before it is rebuilt instead.
+const size_t MAX_STACKING_CONTEXT_ADDITIONS = 32;
+// The number of elements that can be removed from a stacking context between uses before it is rebuilt instead.
+const int MAX_STACKING_CONTEXT_REMOVALS = 32;
+
+// Incremented each time any element's offset is dirtied; an element whose offset was validated at the current count
+// can't have been moved since, so doesn't need to check its ancestors.
+static volatile int offset_changes = 0;
+
+// Incremented each time anything that may change an element's clipping region, such as its ancestors' boxes or
+// overflow, changes. Cached clipping regions resolved at the current count are still valid.
+static volatile int clipping_changes = 0;
+
+// Returns the rank of an element amongst its siblings in its stacking context; positioned elements render on top of
+// inline elements, which render on top of floated elements, which render on top of block elements.
+static int GetStackingOrder(Element* element)
+{
+	if (element->GetPosition() != POSITION_STATIC)
+		return 3;
+	else if (element->GetFloat() != FLOAT_NONE)
+		return 1;
+	else if (element->GetDisplay() == DISPLAY_BLOCK)
+		return 0;
+	else
+		return 2;
+}
+
+// Returns true if an element is a descendant of another.
+static bool IsDescendantOf(Element* element, Element* ancestor)
+{
+	for (element = element->GetParentNode(); element != NULL; element = element->GetParentNode())
+	{
+		if (element == ancestor)
+			return true;
+	}
+
+	return false;
+}
+
 /// Constructs a new libRocket element.
-Element::Element(const String& _tag) : absolute_offset(0, 0), relative_offset_base(0, 0), relative_offset_position(0, 0), scroll_offset(0, 0), content_offset(0, 0), content_box(0, 0), boxes(1)
+Element::Element(const String& _tag) : relative_offset_base(0, 0), relative_offset_position(0, 0), absolute_offset(0, 0), scroll_offset(0, 0), content_offset(0, 0), content_box(0, 0)
 {
 	tag = _tag.ToLower();
 	parent = NULL;
@@ -84,6 +128,9 @@ Element::Element(const String& _tag) : absolute_offset(0, 0), relative_offset_ba
 	offset_fixed = false;
 	offset_parent = NULL;
 	offset_dirty = true;
+	offset_generation = 0;
+	parent_offset_generation = 0;
+	validated_offset_changes = 0;
 
 	client_area = Box::PADDING;
 
@@ -96,6 +143,8 @@ Element::Element(const String& _tag) : absolute_offset(0, 0), relative_offset_ba
 	local_stacking_context = false;
 	local_stacking_context_forced = false;
 	stacking_context_dirty = false;
+	stacking_context_rendering = false;
+	stacking_context_removals = 0;
 
 	font_face_handle = NULL;
 	
@@ -103,12 +152,24 @@ Element::Element(const String& _tag) : absolute_offset(0, 0), relative_offset_ba
 	clipping_enabled = false;
 	clipping_state_dirty = true;
 
+	clipping_region_origin = Vector2i(-1, -1);
+	clipping_region_dimensions = Vector2i(-1, -1);
+	clipping_region_enabled = false;
+	clipping_region_changes = -1;
+	clipping_region_offset_generation = 0;
+
+	// New elements need their definition resolved on their first update.
+	update_scheduled = true;
+	child_update_scheduled = false;
+
 	event_dispatcher = new EventDispatcher(this);
 	style = new ElementStyle(this);
 	background = new ElementBackground(this);
 	border = new ElementBorder(this);
 	decoration = new ElementDecoration(this);
 	scroll = new ElementScroll(this);
+	render_cache = NULL;
+	attributes = NULL;
 
 	anim_elapsed = 0.0f;
 }
@@ -118,6 +179,7 @@ Element::~Element()
 	ROCKET_ASSERT(parent == NULL);	
 
 	PluginRegistry::NotifyElementDestroy(this);
+	TextureLoader::RemoveListener(this);
 
 	// Delete the scroll funtionality before we delete the children!
 	delete scroll;
@@ -138,11 +200,13 @@ Element::~Element()
 	// Release all deleted children.
 	ReleaseElements(deleted_children);
 
+	delete render_cache;
 	delete decoration;
 	delete border;
 	delete background;
 	delete style;
 	delete event_dispatcher;
+	delete attributes;
 
 	if (font_face_handle != NULL)
 		font_face_handle->RemoveReference();
@@ -153,14 +217,43 @@ Element::~Element()
 
 void Element::Update()
 {
-	ReleaseElements(deleted_children);
-	active_children = children;
-	
-	for (size_t i = 0; i < active_children.size(); i++)
-		active_children[i]->Update();
+	update_scheduled = true;
+
+	ElementAncestorFilter ancestor_filter(NULL, parent);
+	Update(ancestor_filter);
+}
+
+// Updates the element if it has scheduled an update, and any children on the way to descendants that have,
+// maintaining a filter over the ancestors for restyling.
+void Element::Update(const ElementAncestorFilter& ancestor_filter)
+{
+	// The flags are cleared first, so any updates scheduled while we're updating are left for the next update.
+	bool update_element = update_scheduled;
+	update_scheduled = false;
+
+	if (update_element)
+		ReleaseElements(deleted_children);
+
+	if (child_update_scheduled)
+	{
+		child_update_scheduled = false;
+		active_children = children;
+
+		ElementAncestorFilter child_filter(&ancestor_filter, this);
+		for (size_t i = 0; i < active_children.size(); i++)
+		{
+			Element* child = active_children[i];
+			if (child->update_scheduled ||
+				child->child_update_scheduled)
+				child->Update(child_filter);
+		}
+	}
+
+	if (!update_element)
+		return;
 
 	// Force a definition reload, if necessary.
-	style->GetDefinition();
+	style->UpdateDefinition(&ancestor_filter);
 
 	scroll->Update();
 	OnUpdate();
@@ -322,8 +415,18 @@ bool Element::GetElementAnimationIterationCount( int &refCount )
 void Element::Render()
 {
 	// Rebuild our stacking context if necessary.
-	if (stacking_context_dirty)
-		BuildLocalStackingContext();
+	UpdateStackingContext();
+
+	// Draw our subtree from our render cache if we have one; if we're being rendered into the cache, or the cache
+	// can't be used, we render as normal.
+	if (render_cache != NULL &&
+		!render_cache->IsRendering() &&
+		render_cache->Render())
+		return;
+
+	// Elements may be shown, hidden or moved by the elements we render, so until we're done any changes to our context
+	// dirty it instead.
+	stacking_context_rendering = true;
 
 	// Render all elements in our local stacking context that have a z-index beneath our local index of 0.
 	size_t i = 0;
@@ -333,6 +436,8 @@ void Element::Render()
 	// Set up the clipping region for this element.
 	if (ElementUtilities::SetClippingRegion(this))
 	{
+		Profiler::IncrementCounter(Profiler::ELEMENTS_RENDERED);
+
 		background->RenderBackground();
 		border->RenderBorder();
 		decoration->RenderDecorators();
@@ -343,6 +448,8 @@ void Element::Render()
 	// Render the rest of the elements in the stacking context.
 	for (; i < stacking_context.size(); ++i)
 		stacking_context[i]->Render();
+
+	stacking_context_rendering = false;
 }
 
 // Clones this element, returning a new, unparented element.
@@ -350,14 +457,17 @@ Element* Element::Clone() const
 {
 	Element* clone = NULL;
 
+	ElementAttributes empty_attributes;
+	const ElementAttributes& clone_attributes = attributes != NULL ? *attributes : empty_attributes;
+
 	if (instancer != NULL)
 	{
-		clone = instancer->InstanceElement(NULL, GetTagName(), attributes);
+		clone = instancer->InstanceElement(NULL, GetTagName(), clone_attributes);
 		if (clone != NULL)
 			clone->SetInstancer(instancer);
 	}
 	else
-		clone = Factory::InstanceElement(NULL, GetTagName(), GetTagName(), attributes);
+		clone = Factory::InstanceElement(NULL, GetTagName(), GetTagName(), clone_attributes);
 
 	if (clone != NULL)
 	{
@@ -490,29 +600,7 @@ Vector2f Element::GetRelativeOffset(Box::Area area)
 Vector2f Element::GetAbsoluteOffset(Box::Area area)
 {
 	UpdateLayout();
-	if (offset_dirty)
-	{
-		offset_dirty = false;
-
-		if (offset_parent != NULL)
-			absolute_offset = offset_parent->GetAbsoluteOffset(Box::BORDER) + relative_offset_base + relative_offset_position;
-		else
-			absolute_offset = relative_offset_base + relative_offset_position;
-
-		// Add any parent scrolling onto our position as well. Could cache this if required.
-		if (!offset_fixed)
-		{
-			Element* scroll_parent = parent;
-			while (scroll_parent != NULL)
-			{
-				absolute_offset -= (scroll_parent->scroll_offset + scroll_parent->content_offset);
-				if (scroll_parent == offset_parent)
-					break;
-				else
-					scroll_parent = scroll_parent->parent;
-			}
-		}
-	}
+	UpdateAbsoluteOffset();
 
 	return absolute_offset + GetBox().GetPosition(area);
 }
@@ -542,6 +630,8 @@ void Element::SetContentBox(const Vector2f& _content_offset, const Vector2f& _co
 		content_offset = _content_offset;
 		content_box = _content_box;
 
+		DirtyRenderCache();
+
 		scroll_offset.x = Math::Min(scroll_offset.x, GetScrollWidth() - GetClientWidth());
 		scroll_offset.y = Math::Min(scroll_offset.y, GetScrollHeight() - GetClientHeight());
 		DirtyOffset();
@@ -551,11 +641,14 @@ void Element::SetContentBox(const Vector2f& _content_offset, const Vector2f& _co
 // Sets the box describing the size of the element.
 void Element::SetBox(const Box& box)
 {
-	if (box != boxes[0] ||
-		boxes.size() > 1)
+	if (box != main_box ||
+		!additional_boxes.empty())
 	{
-		boxes[0] = box;
-		boxes.resize(1);
+		main_box = box;
+		additional_boxes.clear();
+
+		DirtyRenderCache();
+		DirtyClippingRegion();
 
 		background->DirtyBackground();
 		border->DirtyBorder();
@@ -568,9 +661,12 @@ void Element::SetBox(const Box& box)
 // Adds a box to the end of the list describing this element's geometry.
 void Element::AddBox(const Box& box)
 {
-	boxes.push_back(box);
+	additional_boxes.push_back(box);
 	DispatchEvent(RESIZE, Dictionary());
 
+	DirtyRenderCache();
+	DirtyClippingRegion();
+
 	background->DirtyBackground();
 	border->DirtyBorder();
 	decoration->ReloadDecorators();
@@ -581,19 +677,19 @@ const Box& Element::GetBox(int index)
 {
 	UpdateLayout();
 
-	if (index < 0)
-		return boxes[0];
-	else if (index >= GetNumBoxes())
-		return boxes.back();
+	if (index <= 0)
+		return main_box;
+	else if (index > (int) additional_boxes.size())
+		return additional_boxes.empty() ? main_box : additional_boxes.back();
 
-	return boxes[index];
+	return additional_boxes[index - 1];
 }
 
 // Returns the number of boxes making up this element's geometry.
 int Element::GetNumBoxes()
 {
 	UpdateLayout();
-	return (int) boxes.size();
+	return 1 + (int) additional_boxes.size();
 }
 
 // Returns the baseline of the element, in pixels offset from the bottom of the element's content area.
@@ -716,6 +812,16 @@ void Element::GetLocalDimensionProperties(const Property **width, const Property
 	style->GetLocalDimensionProperties(width, height);
 }
 
+void Element::GetLocalMinMaxDimensionProperties(const Property **min_width, const Property **max_width, const Property **min_height, const Property **max_height)
+{
+	style->GetLocalMinMaxDimensionProperties(min_width, max_width, min_height, max_height);
+}
+
+void Element::GetLocalOffsetProperties(const Property **top, const Property **right, const Property **bottom, const Property **left)
+{
+	style->GetLocalOffsetProperties(top, right, bottom, left);
+}
+
 void Element::GetOverflow(int *overflow_x, int *overflow_y)
 {
 	style->GetOverflow(overflow_x, overflow_y);
@@ -800,19 +906,23 @@ const PseudoClassList& Element::GetActivePseudoClasses() const
 /// Get the named attribute
 Variant* Element::GetAttribute(const String& name) const
 {
-	return attributes.Get(name);
+	if (attributes == NULL)
+		return NULL;
+
+	return attributes->Get(name);
 }
 
 // Checks if the element has a certain attribute.
 bool Element::HasAttribute(const String& name)
 {
-	return attributes.Get(name) != NULL;
+	return attributes != NULL && attributes->Get(name) != NULL;
 }
 
 // Removes an attribute from the element
 void Element::RemoveAttribute(const String& name)
 {
-	if (attributes.Remove(name))
+	if (attributes != NULL &&
+		attributes->Remove(name))
 	{
 		AttributeNameList changed_attributes;
 		changed_attributes.insert(name);
@@ -857,10 +967,13 @@ void Element::SetAttributes(const ElementAttributes* _attributes)
 
 	AttributeNameList changed_attributes;
 
+	if (attributes == NULL)
+		attributes = new ElementAttributes();
+
 	while (_attributes->Iterate(index, key, value))
 	{		
 		changed_attributes.insert(key);
-		attributes.Set(key, *value);
+		attributes->Set(key, *value);
 	}
 
 	OnAttributeChange(changed_attributes);
@@ -869,7 +982,10 @@ void Element::SetAttributes(const ElementAttributes* _attributes)
 // Returns the number of attributes on the element.
 int Element::GetNumAttributes() const
 {
-	return attributes.Size();
+	if (attributes == NULL)
+		return 0;
+
+	return attributes->Size();
 }
 
 // Iterates over all decorators attached to the element.
@@ -983,6 +1099,7 @@ void Element::SetScrollLeft(float scroll_left)
 	scroll_offset.x = LayoutEngine::Round(Math::Clamp(scroll_left, 0.0f, GetScrollWidth() - GetClientWidth()));
 	scroll->UpdateScrollbar(ElementScroll::HORIZONTAL);
 	DirtyOffset();
+	DirtyRenderCache();
 
 	DispatchEvent("scroll", Dictionary());
 }
@@ -1000,6 +1117,7 @@ void Element::SetScrollTop(float scroll_top)
 	scroll_offset.y = LayoutEngine::Round(Math::Clamp(scroll_top, 0.0f, GetScrollHeight() - GetClientHeight()));
 	scroll->UpdateScrollbar(ElementScroll::VERTICAL);
 	DirtyOffset();
+	DirtyRenderCache();
 
 	DispatchEvent("scroll", Dictionary());
 }
@@ -1211,11 +1329,11 @@ bool Element::DispatchEvent(const String& event, const Dictionary& parameters, b
 void Element::ScrollIntoView(bool align_with_top)
 {
 	Vector2f size(0, 0);
-	if (!align_with_top &&
-		!boxes.empty())
+	if (!align_with_top)
 	{
-		size.y = boxes.back().GetOffset().y +
-				 boxes.back().GetSize(Box::BORDER).y;
+		const Box& last_box = additional_boxes.empty() ? main_box : additional_boxes.back();
+		size.y = last_box.GetOffset().y +
+				 last_box.GetSize(Box::BORDER).y;
 	}
 
 	Element* scroll_parent = parent;
@@ -1267,7 +1385,7 @@ void Element::AppendChild(Element* child, bool dom_element)
 	child->GetStyle()->DirtyProperties();
 
 	child->OnChildAdd(child);
-	DirtyStackingContext();
+	child->AddToStackingContext();
 	DirtyStructure();
 
 	if (dom_element)
@@ -1315,7 +1433,7 @@ void Element::InsertBefore(Element* child, Element* adjacent_element)
 		child->GetStyle()->DirtyProperties();
 
 		child->OnChildAdd(child);
-		DirtyStackingContext();
+		child->AddToStackingContext();
 		DirtyStructure();
 
 		LockLayout(false);
@@ -1352,6 +1470,7 @@ bool Element::ReplaceChild(Element* inserted_element, Element* replaced_element)
 	inserted_element->GetStyle()->DirtyDefinition();
 	inserted_element->GetStyle()->DirtyProperties();
 	inserted_element->OnChildAdd(inserted_element);
+	inserted_element->AddToStackingContext();
 
 	LockLayout(false);
 
@@ -1376,6 +1495,7 @@ bool Element::RemoveChild(Element* child)
 				context->OnElementRemove(child);
 
 			child->OnChildRemove(child);
+			child->RemoveFromStackingContext(true);
 
 			if (child_index >= children.size() - num_non_dom_children)
 				num_non_dom_children--;
@@ -1383,6 +1503,9 @@ bool Element::RemoveChild(Element* child)
 			deleted_children.push_back(child);
 			children.erase(itr);
 
+			// Our deleted children are released on our next update.
+			ScheduleUpdate();
+
 			// Remove the child element as the focussed child of this element.
 			if (child == focus)
 			{
@@ -1408,7 +1531,6 @@ bool Element::RemoveChild(Element* child)
 			}
 
 			DirtyLayout();
-			DirtyStackingContext();
 			DirtyStructure();
 
 			LockLayout(false);
@@ -1457,6 +1579,25 @@ void Element::GetElementsByClassName(ElementList& elements, const String& class_
 	return ElementUtilities::GetElementsByClassName(elements, this, class_name);
 }
 
+// Adds an estimate of the memory held by this element and its descendants to a breakdown.
+void Element::GetMemoryUsage(MemoryUsage& usage)
+{
+	size_t element_size = sizeof(Element) + sizeof(EventDispatcher) + sizeof(ElementBackground) + sizeof(ElementBorder) + sizeof(ElementDecoration) + sizeof(ElementScroll);
+	element_size += MemoryUsageUtilities::GetStringSize(tag) + MemoryUsageUtilities::GetStringSize(id);
+	if (attributes != NULL)
+		element_size += sizeof(ElementAttributes) + attributes->Size() * (sizeof(String) + sizeof(Variant));
+	element_size += MemoryUsageUtilities::GetVectorSize(additional_boxes);
+	element_size += MemoryUsageUtilities::GetVectorSize(children) + MemoryUsageUtilities::GetVectorSize(active_children) + MemoryUsageUtilities::GetVectorSize(deleted_children);
+	element_size += MemoryUsageUtilities::GetVectorSize(stacking_context) + MemoryUsageUtilities::GetVectorSize(stacking_context_additions);
+	usage.Add(MemoryUsage::ELEMENTS, element_size);
+
+	style->GetMemoryUsage(usage);
+	usage.Add(MemoryUsage::GEOMETRY, background->GetMemoryUsage() + border->GetMemoryUsage());
+
+	for (size_t i = 0; i < children.size(); ++i)
+		children[i]->GetMemoryUsage(usage);
+}
+
 // Access the event dispatcher
 EventDispatcher* Element::GetEventDispatcher() const
 {
@@ -1486,6 +1627,33 @@ ElementScroll* Element::GetElementScroll() const
 {
 	return scroll;
 }
+
+// Returns the element's render cache, if it has one.
+ElementRenderCache* Element::GetElementRenderCache() const
+{
+	return render_cache;
+}
+
+// Invalidates the render cache of this element and of any ancestor rendering it through their render cache.
+void Element::DirtyRenderCache()
+{
+	// Skip the walk entirely if nothing is being cached.
+	if (ElementRenderCache::GetNumCaches() == 0)
+		return;
+
+	for (Element* element = this; element != NULL; element = element->parent)
+	{
+		if (element->render_cache != NULL)
+			element->render_cache->DirtyCache();
+	}
+}
+
+// Invalidates the cached clipping region of this element and its descendants.
+void Element::DirtyClippingRegion()
+{
+	// Rather than walking our descendants, we invalidate every cached region; each is resolved again when it's read.
+	AtomicIncrement(clipping_changes);
+}
 	
 int Element::GetClippingIgnoreDepth()
 {
@@ -1569,8 +1737,12 @@ void Element::OnAttributeChange(const AttributeNameList& changed_attributes)
 {
 	if (changed_attributes.find("id") != changed_attributes.end())
 	{
+		String old_id = id;
 		id = GetAttribute< String >("id", "");
-		style->DirtyDefinition();
+		ElementAncestorFilter::Invalidate();
+
+		if (id != old_id)
+			style->DirtyDefinition(Math::Max(style->GetIdInvalidationScope(old_id), style->GetIdInvalidationScope(id)));
 	}
 
 	if (changed_attributes.find("class") != changed_attributes.end())
@@ -1598,6 +1770,8 @@ void Element::OnPropertyChange(const PropertyNameList& changed_properties)
 {
 	bool all_dirty = StyleSheetSpecification::GetRegisteredProperties() == changed_properties;
 
+	DirtyRenderCache();
+
 	if (!IsLayoutDirty())
 	{
 		if (all_dirty)
@@ -1623,6 +1797,7 @@ void Element::OnPropertyChange(const PropertyNameList& changed_properties)
 	}
 
 	// Update the visibility.
+	bool visibility_changed = false;
 	if (all_dirty || changed_properties.find(VISIBILITY) != changed_properties.end() ||
 		changed_properties.find(DISPLAY) != changed_properties.end())
 	{
@@ -1632,9 +1807,12 @@ void Element::OnPropertyChange(const PropertyNameList& changed_properties)
 		if (visible != new_visibility)
 		{
 			visible = new_visibility;
+			visibility_changed = true;
 
-			if (parent != NULL)
-				parent->DirtyStackingContext();
+			if (visible)
+				AddToStackingContext();
+			else
+				RemoveFromStackingContext(false);
 		}
 
 		if (all_dirty || 
@@ -1645,6 +1823,18 @@ void Element::OnPropertyChange(const PropertyNameList& changed_properties)
 		}
 	}
 
+	// Move the element within its stacking context if the order it stacks in amongst its siblings may have changed.
+	if (visible &&
+		!visibility_changed &&
+		(all_dirty ||
+		 changed_properties.find(DISPLAY) != changed_properties.end() ||
+		 changed_properties.find(POSITION) != changed_properties.end() ||
+		 changed_properties.find(FLOAT) != changed_properties.end()))
+	{
+		RemoveFromStackingContext(false);
+		AddToStackingContext();
+	}
+
 	// Update the position.
 	if (all_dirty ||
 		changed_properties.find(LEFT) != changed_properties.end() ||
@@ -1666,13 +1856,15 @@ void Element::OnPropertyChange(const PropertyNameList& changed_properties)
 			z_index_property->value.Get< int >() == Z_INDEX_AUTO)
 		{
 			if (local_stacking_context &&
-				!local_stacking_context_forced)
+				!local_stacking_context_forced &&
+				render_cache == NULL)
 			{
 				// We're no longer acting as a stacking context.
 				local_stacking_context = false;
 
 				stacking_context_dirty = false;
 				stacking_context.clear();
+				stacking_context_additions.clear();
 			}
 
 			// If our old z-index was not zero, then we must dirty our stacking context so we'll be re-indexed.
@@ -1776,6 +1968,53 @@ void Element::OnPropertyChange(const PropertyNameList& changed_properties)
 		changed_properties.find(OVERFLOW_Y) != changed_properties.end())
 	{
 		clipping_state_dirty = true;
+		DirtyClippingRegion();
+	}
+
+	// Create or destroy our render cache if it has been changed.
+	if (all_dirty ||
+		changed_properties.find(RENDER_CACHE) != changed_properties.end())
+	{
+		bool render_cache_enabled = GetProperty< int >(RENDER_CACHE) == RENDER_CACHE_TEXTURE;
+		if (render_cache_enabled &&
+			render_cache == NULL)
+		{
+			render_cache = new ElementRenderCache(this);
+
+			// The cached subtree must be rendered by us, so we need our own stacking context. Our descendants will be
+			// in our parent's stacking context until it is rebuilt.
+			if (!local_stacking_context)
+			{
+				local_stacking_context = true;
+				stacking_context_dirty = true;
+
+				if (parent != NULL)
+					parent->DirtyStackingContext();
+			}
+		}
+		else if (!render_cache_enabled &&
+				 render_cache != NULL)
+		{
+			delete render_cache;
+			render_cache = NULL;
+
+			// Give up our stacking context if we only had one for the cache.
+			const Property* z_index_property = GetProperty(Z_INDEX);
+			if (local_stacking_context &&
+				!local_stacking_context_forced &&
+				z_index_property->unit == Property::KEYWORD &&
+				z_index_property->value.Get< int >() == Z_INDEX_AUTO)
+			{
+				local_stacking_context = false;
+
+				stacking_context_dirty = false;
+				stacking_context.clear();
+				stacking_context_additions.clear();
+
+				if (parent != NULL)
+					parent->DirtyStackingContext();
+			}
+		}
 	}
 }
 
@@ -1801,9 +2040,21 @@ void Element::UpdateLayout()
 		document->UpdateLayout();
 }
 
+// Schedules the element to be updated on the next update of its context.
+void Element::ScheduleUpdate()
+{
+	if (update_scheduled)
+		return;
+
+	update_scheduled = true;
+	ScheduleAncestorUpdates();
+}
+
 // Forces a re-layout of this element, and any other children required.
 void Element::DirtyLayout()
 {
+	DirtyRenderCache();
+
 	Element* document = GetOwnerDocument();
 	if (document != NULL)
 		document->DirtyLayout();
@@ -1881,6 +2132,10 @@ void Element::ProcessEvent(Event& event)
 			SetPseudoClass(FOCUS, true);
 		else if (event == BLUR)
 			SetPseudoClass(FOCUS, false);
+		// Load events sent to elements when their textures are ready are of no interest to their document.
+		else if (event == LOAD &&
+				 GetOwnerDocument() != this)
+			event.StopPropagation();
 	}
 }
 
@@ -1926,6 +2181,25 @@ void Element::SetParent(Element* _parent)
 
 	// Save our parent
 	parent = _parent;
+	ElementAncestorFilter::Invalidate();
+
+	// Our offset was validated against our old parent's.
+	DirtyOffset();
+
+	// Our clipping region is inherited from our ancestors, so we'll need to resolve it again.
+	DirtyClippingRegion();
+
+	// Make sure our new ancestors will visit us if we're waiting for an update.
+	if (update_scheduled ||
+		child_update_scheduled)
+		ScheduleAncestorUpdates();
+}
+
+void Element::ScheduleAncestorUpdates()
+{
+	// Stop at the first ancestor already flagged, as all of its own ancestors will be too.
+	for (Element* ancestor = parent; ancestor != NULL && !ancestor->child_update_scheduled; ancestor = ancestor->parent)
+		ancestor->child_update_scheduled = true;
 }
 
 void Element::ReleaseDeletedElements()
@@ -1963,13 +2237,74 @@ void Element::ReleaseElements(ElementList& released_elements)
 	}
 }
 
+// Marks the element's absolute offset for recalculation. Descendants aren't visited; they pick up the change
+// through their parent's offset generation when their own offsets are next requested.
 void Element::DirtyOffset()
 {
 	offset_dirty = true;
+	AtomicIncrement(offset_changes);
+}
+
+// Recalculates the element's absolute offset if it, or the offset of any of its ancestors, has changed.
+void Element::UpdateAbsoluteOffset()
+{
+	// If no offsets have changed since we were last validated, ours is still correct.
+	int changes = offset_changes;
+	if (!offset_dirty &&
+		validated_offset_changes == changes)
+		return;
+
+	validated_offset_changes = changes;
 
-	// Not strictly true ... ?
-	for (size_t i = 0; i < children.size(); i++)
-		children[i]->DirtyOffset();
+	unsigned int parent_generation = 0;
+	if (parent != NULL)
+	{
+		parent->UpdateAbsoluteOffset();
+		parent_generation = parent->offset_generation;
+	}
+
+	if (!offset_dirty &&
+		parent_offset_generation == parent_generation)
+		return;
+
+	offset_dirty = false;
+	parent_offset_generation = parent_generation;
+
+	// Our children are offset from us, so they'll need to recalculate their offsets as well.
+	++offset_generation;
+
+	if (offset_parent != NULL)
+		absolute_offset = offset_parent->GetAbsoluteOffset(Box::BORDER) + relative_offset_base + relative_offset_position;
+	else
+		absolute_offset = relative_offset_base + relative_offset_position;
+
+	// Add any parent scrolling onto our position as well. Could cache this if required.
+	if (!offset_fixed)
+	{
+		Element* scroll_parent = parent;
+		while (scroll_parent != NULL)
+		{
+			absolute_offset -= (scroll_parent->scroll_offset + scroll_parent->content_offset);
+			if (scroll_parent == offset_parent)
+				break;
+			else
+				scroll_parent = scroll_parent->parent;
+		}
+	}
+}
+
+// Returns true if the cached clipping region is still valid.
+bool Element::IsClippingRegionValid(unsigned int offset_generation) const
+{
+	return clipping_region_changes == clipping_changes &&
+		   clipping_region_offset_generation == offset_generation;
+}
+
+// Marks the cached clipping region as resolved against the current state of the element's ancestors.
+void Element::ValidateClippingRegion(unsigned int offset_generation)
+{
+	clipping_region_changes = clipping_changes;
+	clipping_region_offset_generation = offset_generation;
 }
 
 void Element::UpdateOffset()
@@ -1983,27 +2318,25 @@ void Element::UpdateOffset()
 			const Box& parent_box = offset_parent->GetBox();
 			Vector2f containing_block = parent_box.GetSize(Box::PADDING);
 
-			const Property *left = GetLocalProperty(LEFT);
-			const Property *right = GetLocalProperty(RIGHT);
+			const Property *top, *right, *bottom, *left;
+			GetLocalOffsetProperties(&top, &right, &bottom, &left);
 			// If the element is anchored left, then the position is offset by that resolved value.
 			if (left != NULL && left->unit != Property::KEYWORD)
-				relative_offset_base.x = parent_box.GetEdge(Box::BORDER, Box::LEFT) + (ResolveProperty(LEFT, containing_block.x) + GetBox().GetEdge(Box::MARGIN, Box::LEFT));
+				relative_offset_base.x = parent_box.GetEdge(Box::BORDER, Box::LEFT) + (ResolveProperty(left, containing_block.x) + GetBox().GetEdge(Box::MARGIN, Box::LEFT));
 			// If the element is anchored right, then the position is set first so the element's right-most edge
 			// (including margins) will render up against the containing box's right-most content edge, and then
 			// offset by the resolved value.
 			if (right != NULL && right->unit != Property::KEYWORD)
-				relative_offset_base.x = containing_block.x + parent_box.GetEdge(Box::BORDER, Box::LEFT) - (ResolveProperty(RIGHT, containing_block.x) + GetBox().GetSize(Box::BORDER).x + GetBox().GetEdge(Box::MARGIN, Box::RIGHT));
+				relative_offset_base.x = containing_block.x + parent_box.GetEdge(Box::BORDER, Box::LEFT) - (ResolveProperty(right, containing_block.x) + GetBox().GetSize(Box::BORDER).x + GetBox().GetEdge(Box::MARGIN, Box::RIGHT));
 
-			const Property *top = GetLocalProperty(TOP);
-			const Property *bottom = GetLocalProperty(BOTTOM);
 			// If the element is anchored top, then the position is offset by that resolved value.
 			if (top != NULL && top->unit != Property::KEYWORD)
-				relative_offset_base.y = parent_box.GetEdge(Box::BORDER, Box::TOP) + (ResolveProperty(TOP, containing_block.y) + GetBox().GetEdge(Box::MARGIN, Box::TOP));
+				relative_offset_base.y = parent_box.GetEdge(Box::BORDER, Box::TOP) + (ResolveProperty(top, containing_block.y) + GetBox().GetEdge(Box::MARGIN, Box::TOP));
 			// If the element is anchored bottom, then the position is set first so the element's right-most edge
 			// (including margins) will render up against the containing box's right-most content edge, and then
 			// offset by the resolved value.
 			else if (bottom != NULL && bottom->unit != Property::KEYWORD)
-				relative_offset_base.y = containing_block.y + parent_box.GetEdge(Box::BORDER, Box::TOP) - (ResolveProperty(BOTTOM, containing_block.y) + GetBox().GetSize(Box::BORDER).y + GetBox().GetEdge(Box::MARGIN, Box::BOTTOM));
+				relative_offset_base.y = containing_block.y + parent_box.GetEdge(Box::BORDER, Box::TOP) - (ResolveProperty(bottom, containing_block.y) + GetBox().GetSize(Box::BORDER).y + GetBox().GetEdge(Box::MARGIN, Box::BOTTOM));
 		}
 	}
 	else if (position_property == POSITION_RELATIVE)
@@ -2013,21 +2346,19 @@ void Element::UpdateOffset()
 			const Box& parent_box = offset_parent->GetBox();
 			Vector2f containing_block = parent_box.GetSize();
 
-			const Property *left = GetLocalProperty(LEFT);
-			const Property *right = GetLocalProperty(RIGHT);
+			const Property *top, *right, *bottom, *left;
+			GetLocalOffsetProperties(&top, &right, &bottom, &left);
 			if (left != NULL && left->unit != Property::KEYWORD)
-				relative_offset_position.x = ResolveProperty(LEFT, containing_block.x);
+				relative_offset_position.x = ResolveProperty(left, containing_block.x);
 			else if (right != NULL && right->unit != Property::KEYWORD)
-				relative_offset_position.x = -1 * ResolveProperty(RIGHT, containing_block.x);
+				relative_offset_position.x = -1 * ResolveProperty(right, containing_block.x);
 			else
 				relative_offset_position.x = 0;
 
-			const Property *top = GetLocalProperty(TOP);
-			const Property *bottom = GetLocalProperty(BOTTOM);
 			if (top != NULL && top->unit != Property::KEYWORD)
-				relative_offset_position.y = ResolveProperty(TOP, containing_block.y);
+				relative_offset_position.y = ResolveProperty(top, containing_block.y);
 			else if (bottom != NULL && bottom->unit != Property::KEYWORD)
-				relative_offset_position.y = -1 * ResolveProperty(BOTTOM, containing_block.y);
+				relative_offset_position.y = -1 * ResolveProperty(bottom, containing_block.y);
 			else
 				relative_offset_position.y = 0;
 		}
@@ -2046,6 +2377,7 @@ void Element::BuildLocalStackingContext()
 {
 	stacking_context_dirty = false;
 	stacking_context.clear();
+	stacking_context_additions.clear();
 
 	BuildStackingContext(&stacking_context);
 	std::stable_sort(stacking_context.begin(), stacking_context.end(), ElementSortZIndex());
@@ -2066,15 +2398,7 @@ void Element::BuildStackingContext(ElementList* new_stacking_context)
 
 		std::pair< Element*, float > ordered_child;
 		ordered_child.first = child;
-
-		if (child->GetPosition() != POSITION_STATIC)
-			ordered_child.second = 3;
-		else if (child->GetFloat() != FLOAT_NONE)
-			ordered_child.second = 1;
-		else if (child->GetDisplay() == DISPLAY_BLOCK)
-			ordered_child.second = 0;
-		else
-			ordered_child.second = 2;
+		ordered_child.second = (float) GetStackingOrder(child);
 
 		ordered_children.push_back(ordered_child);
 	}
@@ -2093,6 +2417,42 @@ void Element::BuildStackingContext(ElementList* new_stacking_context)
 }
 
 void Element::DirtyStackingContext()
+{
+	Element* stacking_context_parent = GetStackingContextParent();
+	if (stacking_context_parent != NULL)
+	{
+		stacking_context_parent->stacking_context_dirty = true;
+		stacking_context_parent->stacking_context_additions.clear();
+	}
+
+	DirtyRenderCache();
+}
+
+void Element::UpdateStackingContext()
+{
+	stacking_context_removals = 0;
+
+	if (!stacking_context_dirty &&
+		!stacking_context_additions.empty())
+	{
+		ElementList additions;
+		additions.swap(stacking_context_additions);
+
+		for (size_t i = 0; i < additions.size(); ++i)
+		{
+			if (!InsertIntoStackingContext(additions[i]))
+			{
+				stacking_context_dirty = true;
+				break;
+			}
+		}
+	}
+
+	if (stacking_context_dirty)
+		BuildLocalStackingContext();
+}
+
+Element* Element::GetStackingContextParent()
 {
 	// The first ancestor of ours that doesn't have an automatic z-index is the ancestor that is establishing our local
 	// stacking context.
@@ -2101,8 +2461,210 @@ void Element::DirtyStackingContext()
 		   !stacking_context_parent->local_stacking_context)
 		stacking_context_parent = stacking_context_parent->GetParentNode();
 
-	if (stacking_context_parent != NULL)
-		stacking_context_parent->stacking_context_dirty = true;
+	return stacking_context_parent;
+}
+
+void Element::AddToStackingContext()
+{
+	if (parent == NULL)
+		return;
+
+	parent->DirtyRenderCache();
+
+	// The element is inserted when the context is next used, as its place in it depends on its style. A dirty context
+	// will pick it up when it is rebuilt.
+	Element* stacking_context_parent = parent->GetStackingContextParent();
+	if (stacking_context_parent == NULL ||
+		stacking_context_parent->stacking_context_dirty)
+		return;
+
+	if (stacking_context_parent->stacking_context_additions.size() >= MAX_STACKING_CONTEXT_ADDITIONS)
+		stacking_context_parent->DirtyStackingContext();
+	else
+		stacking_context_parent->stacking_context_additions.push_back(this);
+}
+
+void Element::RemoveFromStackingContext(bool removing_element)
+{
+	if (parent == NULL)
+		return;
+
+	parent->DirtyRenderCache();
+
+	// Forget any pending additions of the element or its descendants; an ancestor may have become a stacking context
+	// since they were queued, so every context above us is checked.
+	for (Element* ancestor = parent; ancestor != NULL; ancestor = ancestor->parent)
+	{
+		ElementList& additions = ancestor->stacking_context_additions;
+		for (size_t i = 0; i < additions.size(); )
+		{
+			if (additions[i] == this ||
+				IsDescendantOf(additions[i], this))
+				additions.erase(additions.begin() + i);
+			else
+				++i;
+		}
+	}
+
+	Element* stacking_context_parent = parent->GetStackingContextParent();
+	if (stacking_context_parent == NULL ||
+		stacking_context_parent->stacking_context_dirty)
+		return;
+
+	if (stacking_context_parent->stacking_context_rendering)
+	{
+		stacking_context_parent->DirtyStackingContext();
+		return;
+	}
+
+	// Each removal searches the context, so when many elements are removed at once (such as when an element's
+	// contents are replaced) it is cheaper to rebuild the context when it is next used.
+	if (++stacking_context_parent->stacking_context_removals > MAX_STACKING_CONTEXT_REMOVALS)
+	{
+		stacking_context_parent->DirtyStackingContext();
+		return;
+	}
+
+	ElementList& context = stacking_context_parent->stacking_context;
+
+	// Our stacking descendants without a z-index directly follow us in the context; any with a z-index are sorted
+	// towards either end of it.
+	ElementList::iterator begin = std::find(context.begin(), context.end(), this);
+	if (begin == context.end())
+	{
+		// An element leaving the hierarchy may be released; if it isn't where we expect it, rebuild the context rather
+		// than risk leaving any of its descendants behind.
+		if (removing_element)
+			stacking_context_parent->DirtyStackingContext();
+
+		return;
+	}
+
+	ElementList::iterator end = begin + 1;
+	while (end != context.end() &&
+		   (*end)->z_index == 0 &&
+		   IsDescendantOf(*end, this))
+		++end;
+
+	size_t index = context.erase(begin, end) - context.begin();
+
+	for (size_t i = 0; i < context.size() && context[i]->z_index < 0; )
+	{
+		if (IsDescendantOf(context[i], this))
+		{
+			context.erase(context.begin() + i);
+			--index;
+		}
+		else
+			++i;
+	}
+
+	for (size_t i = context.size(); i > index && context[i - 1]->z_index > 0; --i)
+	{
+		if (IsDescendantOf(context[i - 1], this))
+			context.erase(context.begin() + (i - 1));
+	}
+}
+
+bool Element::InsertIntoStackingContext(Element* element)
+{
+	// Check the element is still a visible part of our stacking context; if not, there's nothing to insert.
+	for (Element* ancestor = element; ancestor != this; ancestor = ancestor->parent)
+	{
+		if (ancestor == NULL ||
+			!ancestor->IsVisible() ||
+			(ancestor != element && ancestor->local_stacking_context))
+			return true;
+	}
+
+	// It may already have been inserted along with an ancestor.
+	if (std::find(stacking_context.begin(), stacking_context.end(), element) != stacking_context.end())
+		return true;
+
+	ElementList entries;
+	entries.push_back(element);
+	if (!element->local_stacking_context)
+		element->BuildStackingContext(&entries);
+
+	// Elements with a z-index are sorted amongst the entire context, so we leave them to a rebuild.
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		if (entries[i]->z_index != 0)
+			return false;
+	}
+
+	// Find the sibling that renders before the element, so we can go after it and its own stacking descendants. This
+	// is the closest previous sibling of the same stacking order if there is one, otherwise the last sibling of the
+	// highest order below the element's.
+	Element* element_parent = element->parent;
+	const ElementList& siblings = element_parent->children;
+	int order = GetStackingOrder(element);
+
+	size_t element_index = std::find(siblings.begin(), siblings.end(), element) - siblings.begin();
+	ElementList::iterator previous = stacking_context.end();
+
+	for (size_t i = element_index; i > 0 && previous == stacking_context.end(); --i)
+	{
+		Element* sibling = siblings[i - 1];
+		if (sibling->IsVisible() &&
+			sibling->z_index == 0 &&
+			GetStackingOrder(sibling) == order)
+			previous = std::find(stacking_context.begin(), stacking_context.end(), sibling);
+	}
+
+	if (previous == stacking_context.end() &&
+		order > 0)
+	{
+		std::vector< int > sibling_orders(siblings.size(), -1);
+		for (size_t i = 0; i < siblings.size(); ++i)
+		{
+			if (siblings[i] != element &&
+				siblings[i]->IsVisible() &&
+				siblings[i]->z_index == 0)
+				sibling_orders[i] = GetStackingOrder(siblings[i]);
+		}
+
+		for (int previous_order = order - 1; previous_order >= 0 && previous == stacking_context.end(); --previous_order)
+		{
+			for (size_t i = siblings.size(); i > 0 && previous == stacking_context.end(); --i)
+			{
+				if (sibling_orders[i - 1] == previous_order)
+					previous = std::find(stacking_context.begin(), stacking_context.end(), siblings[i - 1]);
+			}
+		}
+	}
+
+	ElementList::iterator position;
+	if (previous != stacking_context.end())
+	{
+		Element* previous_element = *previous;
+
+		position = previous + 1;
+		while (position != stacking_context.end() &&
+			   (*position)->z_index == 0 &&
+			   IsDescendantOf(*position, previous_element))
+			++position;
+	}
+	// Without a sibling before it, the element goes directly after its parent ...
+	else if (element_parent != this)
+	{
+		position = std::find(stacking_context.begin(), stacking_context.end(), element_parent);
+		if (position == stacking_context.end())
+			return false;
+
+		++position;
+	}
+	// ... or at the start of the elements without a z-index if its parent is us.
+	else
+	{
+		position = stacking_context.begin();
+		while (position != stacking_context.end() &&
+			   (*position)->z_index < 0)
+			++position;
+	}
+
+	stacking_context.insert(position, entries.begin(), entries.end());
+	return true;
 }
 
 void Element::DirtyStructure()
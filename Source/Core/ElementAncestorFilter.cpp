@@ -0,0 +1,145 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "ElementAncestorFilter.h"
+#include "ElementStyle.h"
+#include "Threading.h"
+
+namespace Rocket {
+namespace Core {
+
+// Incremented whenever an element changes in a way that invalidates built filters. Filters are built against a
+// generation, so a filter whose generation is zero has never been built.
+static volatile int filter_generation = 1;
+
+// Salts for the different selector types, so a class doesn't set the same bits as a tag with the same name.
+const Hash ID_SALT = 0x9e3779b9;
+const Hash CLASS_SALT = 0x85ebca6b;
+
+ElementAncestorFilter::ElementAncestorFilter(const ElementAncestorFilter* _parent_filter, const Element* _element) : parent_filter(_parent_filter), element(_element), generation(0)
+{
+}
+
+// Returns the element this filter was constructed over.
+const Element* ElementAncestorFilter::GetElement() const
+{
+	return element;
+}
+
+// Returns true if the element or one of its ancestors may match a hash.
+bool ElementAncestorFilter::MayContain(Hash hash) const
+{
+	Build();
+
+	unsigned int bit_a = hash & 0xff;
+	unsigned int bit_b = (hash >> 8) & 0xff;
+
+	return (bits[bit_a >> 5] & (1u << (bit_a & 31))) != 0 &&
+		   (bits[bit_b >> 5] & (1u << (bit_b & 31))) != 0;
+}
+
+// Returns the hash to filter a tag name on.
+Hash ElementAncestorFilter::GetTagHash(const String& tag)
+{
+	return tag.Hash();
+}
+
+// Returns the hash to filter an ID on.
+Hash ElementAncestorFilter::GetIdHash(const String& id)
+{
+	return id.Hash() ^ ID_SALT;
+}
+
+// Returns the hash to filter a class name on.
+Hash ElementAncestorFilter::GetClassHash(const String& class_name)
+{
+	return class_name.Hash() ^ CLASS_SALT;
+}
+
+// Invalidates all filters that have already been built.
+void ElementAncestorFilter::Invalidate()
+{
+	AtomicIncrement(filter_generation);
+}
+
+// Builds the filter's bits, if they haven't been built since the last invalidation.
+void ElementAncestorFilter::Build() const
+{
+	int current_generation = filter_generation;
+	if (generation == current_generation)
+		return;
+
+	// The parent filter is only usable if the tree hasn't been rearranged since the traversal started.
+	if (parent_filter != NULL &&
+		(element == NULL || parent_filter->element == element->GetParentNode()))
+	{
+		parent_filter->Build();
+		for (int i = 0; i < NUM_WORDS; ++i)
+			bits[i] = parent_filter->bits[i];
+
+		if (element != NULL)
+			AddElement(element);
+	}
+	else
+	{
+		for (int i = 0; i < NUM_WORDS; ++i)
+			bits[i] = 0;
+
+		for (const Element* ancestor = element; ancestor != NULL; ancestor = ancestor->GetParentNode())
+			AddElement(ancestor);
+	}
+
+	generation = current_generation;
+}
+
+// Adds a single element's tag, ID and classes into the filter.
+void ElementAncestorFilter::AddElement(const Element* element) const
+{
+	Add(GetTagHash(element->GetTagName()));
+
+	if (!element->GetId().Empty())
+		Add(GetIdHash(element->GetId()));
+
+	const StringList& classes = const_cast< Element* >(element)->GetStyle()->GetClassList();
+	for (size_t i = 0; i < classes.size(); ++i)
+		Add(GetClassHash(classes[i]));
+}
+
+// Sets the bits for a hash.
+void ElementAncestorFilter::Add(Hash hash) const
+{
+	unsigned int bit_a = hash & 0xff;
+	unsigned int bit_b = (hash >> 8) & 0xff;
+
+	bits[bit_a >> 5] |= 1u << (bit_a & 31);
+	bits[bit_b >> 5] |= 1u << (bit_b & 31);
+}
+
+}
+}
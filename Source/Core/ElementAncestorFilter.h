@@ -0,0 +1,95 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREELEMENTANCESTORFILTER_H
+#define ROCKETCOREELEMENTANCESTORFILTER_H
+
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+class Element;
+
+/**
+	A bloom filter over the tags, IDs and classes of an element and its ancestors. Style sheet nodes whose ancestor
+	requirements aren't all in the filter can't apply to the element's children, so they can be rejected without
+	walking up the parent chain.
+
+	Filters are chained through a traversal of the element tree, each building its bits from its parent's the first
+	time it is queried. A filter with no parent builds itself by walking up from its element instead.
+ */
+
+class ElementAncestorFilter
+{
+public:
+	/// Constructs a filter over an element and its ancestors.
+	/// @param[in] parent_filter The filter over the element's ancestors, or NULL to build from the element's parents.
+	/// @param[in] element The element to filter over. May be NULL for an empty filter.
+	ElementAncestorFilter(const ElementAncestorFilter* parent_filter, const Element* element);
+
+	/// Returns the element this filter was constructed over.
+	const Element* GetElement() const;
+
+	/// Returns true if the element or one of its ancestors may match a hash. False positives are possible, false
+	/// negatives are not.
+	/// @param[in] hash A hash generated by GetTagHash(), GetIdHash() or GetClassHash().
+	/// @return False if no element in the filter can match the hash.
+	bool MayContain(Hash hash) const;
+
+	/// Returns the hash to filter a tag name on.
+	static Hash GetTagHash(const String& tag);
+	/// Returns the hash to filter an ID on.
+	static Hash GetIdHash(const String& id);
+	/// Returns the hash to filter a class name on.
+	static Hash GetClassHash(const String& class_name);
+
+	/// Invalidates all filters that have already been built. This must be called whenever an element's ID or classes
+	/// change, or an element is moved in the tree.
+	static void Invalidate();
+
+private:
+	// Builds the filter's bits, if they haven't been built since the last invalidation.
+	void Build() const;
+	// Adds a single element's tag, ID and classes into the filter.
+	void AddElement(const Element* element) const;
+	// Sets the bits for a hash.
+	void Add(Hash hash) const;
+
+	const ElementAncestorFilter* parent_filter;
+	const Element* element;
+
+	static const int NUM_WORDS = 8;
+	mutable unsigned int bits[NUM_WORDS];
+	mutable int generation;
+};
+
+}
+}
+
+#endif
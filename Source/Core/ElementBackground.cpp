@@ -30,6 +30,7 @@
 #include <Rocket/Core/Element.h>
 #include <Rocket/Core/GeometryUtilities.h>
 #include <Rocket/Core/Property.h>
+#include <algorithm>
 
 namespace Rocket {
 namespace Core {
@@ -62,6 +63,12 @@ void ElementBackground::DirtyBackground()
 	background_dirty = true;
 }
 
+// Returns the number of bytes held by the background geometry.
+size_t ElementBackground::GetMemoryUsage() const
+{
+	return geometry.GetMemoryUsage();
+}
+
 // Generates the background geometry for the element.
 void ElementBackground::GenerateBackground()
 {
@@ -52,6 +52,9 @@ public:
 	/// Marks the border geometry as dirty.
 	void DirtyBackground();
 
+	/// Returns the number of bytes held by the background geometry.
+	size_t GetMemoryUsage() const;
+
 private:
 	// Generates the border geometry for the element.
 	void GenerateBackground();
@@ -61,6 +61,12 @@ void ElementBorder::DirtyBorder()
 	border_dirty = true;
 }
 
+// Returns the number of bytes held by the border geometry.
+size_t ElementBorder::GetMemoryUsage() const
+{
+	return geometry.GetMemoryUsage();
+}
+
 // Generates the border geometry for the element.
 void ElementBorder::GenerateBorder()
 {
@@ -28,6 +28,7 @@
 #include "precompiled.h"
 #include "ElementDecoration.h"
 #include "ElementDefinition.h"
+#include "TextureLoader.h"
 #include <Rocket/Core/Decorator.h>
 #include <Rocket/Core/Element.h>
 
@@ -49,6 +50,7 @@ ElementDecoration::~ElementDecoration()
 bool ElementDecoration::ReloadDecorators()
 {
 	ReleaseDecorators();
+	element->DirtyRenderCache();
 
 	const ElementDefinition* definition = element->GetDefinition();
 	if (definition == NULL)
@@ -109,6 +111,15 @@ int ElementDecoration::LoadDecorator(Decorator* decorator)
 	element_decorator.decorator->AddReference();
 	element_decorator.decorator_data = decorator->GenerateElementData(element);
 
+	// If any of the decorator's textures are loading in the background, its data will need to be generated again once
+	// they are ready.
+	RenderInterface* render_interface = element->GetRenderInterface();
+	for (size_t i = 0; i < decorator->textures.size(); ++i)
+	{
+		if (decorator->textures[i].IsLoading(render_interface))
+			TextureLoader::AddListener(decorator->textures[i].GetSource(), element, true);
+	}
+
 	decorators.push_back(element_decorator);
 	return (int) (decorators.size() - 1);
 }
@@ -176,6 +187,7 @@ void ElementDecoration::RenderDecorators()
 void ElementDecoration::DirtyDecorators()
 {
 	active_decorators_dirty = true;
+	element->DirtyRenderCache();
 }
 
 // Iterates over all active decorators attached to the decoration's element.
@@ -27,6 +27,7 @@
 
 #include "precompiled.h"
 #include "ElementDefinition.h"
+#include "MemoryUsageUtilities.h"
 #include <Rocket/Core/Decorator.h>
 #include <Rocket/Core/Factory.h>
 #include <Rocket/Core/FontDatabase.h>
@@ -333,6 +334,23 @@ bool ElementDefinition::IsStructurallyVolatile() const
 	return structurally_volatile;
 }
 
+// Adds an estimate of the memory held by the definition and its properties to a breakdown.
+void ElementDefinition::GetMemoryUsage(MemoryUsage& usage) const
+{
+	size_t definition_size = sizeof(ElementDefinition);
+	definition_size += MemoryUsageUtilities::GetTreeSize(decorators) + MemoryUsageUtilities::GetTreeSize(pseudo_class_decorators);
+	for (PseudoClassDecoratorMap::const_iterator i = pseudo_class_decorators.begin(); i != pseudo_class_decorators.end(); ++i)
+		definition_size += MemoryUsageUtilities::GetTreeSize((*i).second);
+	definition_size += MemoryUsageUtilities::GetVectorSize(font_effects) + MemoryUsageUtilities::GetTreeSize(font_effect_index);
+	definition_size += MemoryUsageUtilities::GetTreeSize(pseudo_class_volatility);
+	usage.Add(MemoryUsage::STYLES, definition_size);
+
+	size_t properties_size = properties.GetMemoryUsage() + MemoryUsageUtilities::GetTreeSize(pseudo_class_properties);
+	for (PseudoClassPropertyDictionary::const_iterator i = pseudo_class_properties.begin(); i != pseudo_class_properties.end(); ++i)
+		properties_size += MemoryUsageUtilities::GetVectorSize((*i).second);
+	usage.Add(MemoryUsage::PROPERTIES, properties_size);
+}
+
 // Destroys the definition.
 void ElementDefinition::OnReferenceDeactivate()
 {
@@ -122,6 +122,10 @@ public:
 	/// @return True if this definition is structurally volatile.
 	bool IsStructurallyVolatile() const;
 
+	/// Adds an estimate of the memory held by the definition and its properties to a breakdown.
+	/// @param[out] usage The breakdown to add to.
+	void GetMemoryUsage(MemoryUsage& usage) const;
+
 protected:
 	/// Destroys the definition.
 	void OnReferenceDeactivate();
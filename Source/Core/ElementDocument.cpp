@@ -33,10 +33,12 @@
 #include "ElementStyle.h"
 #include "EventDispatcher.h"
 #include "LayoutEngine.h"
+#include "ParallelLayout.h"
 #include "StreamFile.h"
 #include "StyleSheetFactory.h"
 #include "Template.h"
 #include "TemplateCache.h"
+#include "Threading.h"
 #include "XMLParseTools.h"
 
 namespace Rocket {
@@ -89,39 +91,30 @@ void ElementDocument::ProcessHeader(const DocumentHeader* document_header)
 	title = document_header->title;
 
 	// If a style-sheet (or sheets) has been specified for this element, then we load them and set the combined sheet
-	// on the element; all of its children will inherit it by default.
-	StyleSheet* style_sheet = NULL;
-	if (header.rcss_external.size() > 0)
-		style_sheet = StyleSheetFactory::GetStyleSheet(header.rcss_external);
+	// on the element; all of its children will inherit it by default. The individual sheets, inline or external, and
+	// their combination are all cached by the factory, so reloading a document doesn't re-parse or re-merge anything.
+	std::vector< StyleSheet* > sheets;
+	for (size_t i = 0; i < header.rcss_external.size(); i++)
+	{
+		StyleSheet* sheet = StyleSheetFactory::GetStyleSheet(header.rcss_external[i]);
+		if (sheet)
+			sheets.push_back(sheet);
+		else
+			Log::Message(Log::LT_ERROR, "Failed to load style sheet %s.", header.rcss_external[i].CString());
+	}
 
 	// Combine any inline sheets.
-	if (header.rcss_inline.size() > 0)
-	{			
-		for (size_t i = 0;i < header.rcss_inline.size(); i++)
-		{			
-			StyleSheet* new_sheet = new StyleSheet();
-			StreamMemory* stream = new StreamMemory((const byte*) header.rcss_inline[i].CString(), header.rcss_inline[i].Length());
-			stream->SetSourceURL(document_header->source);
-
-			if (new_sheet->LoadStyleSheet(stream))
-			{
-				if (style_sheet)
-				{
-					StyleSheet* combined_sheet = style_sheet->CombineStyleSheet(new_sheet);
-					style_sheet->RemoveReference();
-					new_sheet->RemoveReference();
-					style_sheet = combined_sheet;
-				}
-				else
-					style_sheet = new_sheet;
-			}
-			else
-				new_sheet->RemoveReference();
-
-			stream->RemoveReference();
-		}		
+	for (size_t i = 0; i < header.rcss_inline.size(); i++)
+	{
+		StyleSheet* sheet = StyleSheetFactory::GetInlineStyleSheet(header.rcss_inline[i], document_header->source);
+		if (sheet)
+			sheets.push_back(sheet);
 	}
 
+	StyleSheet* style_sheet = StyleSheetFactory::CombineStyleSheets(sheets);
+	for (size_t i = 0; i < sheets.size(); i++)
+		sheets[i]->RemoveReference();
+
 	// If a style sheet is available, set it on the document and release it.
 	if (style_sheet)
 	{
@@ -203,6 +196,16 @@ StyleSheet* ElementDocument::GetStyleSheet() const
 	return style_sheet;
 }
 
+// Adds an estimate of the memory held by the document, its elements and its style sheet to a breakdown.
+void ElementDocument::GetMemoryUsage(MemoryUsage& usage)
+{
+	Element::GetMemoryUsage(usage);
+	usage.Add(MemoryUsage::ELEMENTS, sizeof(ElementDocument) - sizeof(Element));
+
+	if (style_sheet != NULL)
+		style_sheet->GetMemoryUsage(usage);
+}
+
 // Brings the document to the front of the document stack.
 void ElementDocument::PullToFront()
 {
@@ -294,8 +297,10 @@ void ElementDocument::LoadScript(Stream* ROCKET_UNUSED(stream), const String& RO
 // Updates the layout if necessary.
 void ElementDocument::_UpdateLayout()
 {
+	ROCKET_PROFILE_ZONE("ElementDocument::UpdateLayout");
+
 	layout_dirty = false;
-	lock_layout++;
+	AtomicIncrement(lock_layout);
 
 	Vector2f containing_block(0, 0);
 	if (GetParentNode() != NULL)
@@ -304,7 +309,7 @@ void ElementDocument::_UpdateLayout()
 	LayoutEngine layout_engine;
 	layout_engine.FormatElement(this, containing_block);
 	
-	lock_layout--;
+	AtomicDecrement(lock_layout);
 }
 
 // Updates the position of the document based on the style properties.
@@ -341,10 +346,11 @@ void ElementDocument::UpdatePosition()
 	
 void ElementDocument::LockLayout(bool lock)
 {
+	// Elements of the document may be locking its layout from several threads if it is being formatted in parallel.
 	if (lock)
-		lock_layout++;
+		AtomicIncrement(lock_layout);
 	else
-		lock_layout--;
+		AtomicDecrement(lock_layout);
 	
 	ROCKET_ASSERT(lock_layout >= 0);
 }
@@ -352,6 +358,10 @@ void ElementDocument::LockLayout(bool lock)
 void ElementDocument::DirtyLayout()
 {
 	layout_dirty = true;
+	DirtyRenderCache();
+
+	// Our layout is refreshed on our next update.
+	ScheduleUpdate();
 }
 
 bool ElementDocument::IsLayoutDirty()
@@ -362,6 +372,12 @@ bool ElementDocument::IsLayoutDirty()
 // Refreshes the document layout if required.
 void ElementDocument::OnUpdate()
 {
+	// If layout is being spread over several threads, our context will lay out all of its documents together once
+	// they've been updated.
+	if (GetContext() != NULL &&
+		ParallelLayout::IsEnabled())
+		return;
+
 	UpdateLayout();
 }
 
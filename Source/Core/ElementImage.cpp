@@ -29,6 +29,7 @@
 #include "ElementImage.h"
 #include <Rocket/Core.h>
 #include "TextureDatabase.h"
+#include "TextureLoader.h"
 #include "TextureResource.h"
 
 namespace Rocket {
@@ -75,6 +76,15 @@ bool ElementImage::GetIntrinsicDimensions(Vector2f& _dimensions)
 	return true;
 }
 
+// Adds an estimate of the memory held by the element and its geometry to a breakdown.
+void ElementImage::GetMemoryUsage(MemoryUsage& usage)
+{
+	Element::GetMemoryUsage(usage);
+
+	usage.Add(MemoryUsage::ELEMENTS, sizeof(ElementImage) - sizeof(Element));
+	usage.Add(MemoryUsage::GEOMETRY, geometry.GetMemoryUsage());
+}
+
 // Renders the element.
 void ElementImage::OnRender()
 {
@@ -161,10 +171,14 @@ void ElementImage::ProcessEvent(Rocket::Core::Event& event)
 {
 	Element::ProcessEvent(event);
 
-	if (event.GetTargetElement() == this &&
-		event == RESIZE)
+	if (event.GetTargetElement() == this)
 	{
-		GenerateGeometry();
+		if (event == RESIZE)
+			GenerateGeometry();
+		// Our texture has finished loading in the background, so our texture coordinates may no longer be those of
+		// the placeholder.
+		else if (event == LOAD)
+			geometry_dirty = true;
 	}
 }
 
@@ -234,6 +248,11 @@ bool ElementImage::LoadTexture()
 
 	// Set the texture onto our geometry object.
 	geometry.SetTexture(&texture);
+
+	// If the texture is loading in the background, we'll be sent a 'load' event when it is ready.
+	if (texture.IsLoading(GetRenderInterface()))
+		TextureLoader::AddListener(texture.GetSource(), this, false);
+
 	return true;
 }
 
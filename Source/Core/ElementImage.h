@@ -76,6 +76,11 @@ public:
 	/// @return True.
 	bool GetIntrinsicDimensions(Vector2f& dimensions);
 
+	/// Adds an estimate of the memory held by the element and its geometry to a breakdown. The image's texture is
+	/// shared through the texture database, so is not included.
+	/// @param[out] usage The breakdown to add to.
+	virtual void GetMemoryUsage(MemoryUsage& usage);
+
 protected:
 	/// Renders the image.
 	virtual void OnRender();
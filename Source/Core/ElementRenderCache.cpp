@@ -0,0 +1,289 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "precompiled.h"
+#include "ElementRenderCache.h"
+#include "GeometryBatch.h"
+#include "Threading.h"
+#include <Rocket/Core/Context.h>
+#include <Rocket/Core/Element.h>
+#include <Rocket/Core/ElementUtilities.h>
+#include <Rocket/Core/GeometryUtilities.h>
+#include <Rocket/Core/RenderInterface.h>
+
+namespace Rocket {
+namespace Core {
+
+typedef std::set< ElementRenderCache* > RenderCacheSet;
+static RenderCacheSet render_caches;
+// The size of the cache set, kept separately so it can be read without the lock.
+static volatile int num_caches = 0;
+
+// The stacks of render targets currently being rendered into, and their origins. Each context has its own stack, as
+// separate contexts may be rendered on separate threads.
+typedef std::vector< std::pair< TextureHandle, Vector2i > > RenderTargetStack;
+typedef std::map< Context*, RenderTargetStack > RenderTargetStackMap;
+static RenderTargetStackMap render_target_stacks;
+
+static size_t memory_usage = 0;
+static size_t memory_budget = 16 * 1024 * 1024;
+
+// Guards the cache set, the render target stacks and the memory accounting.
+static Mutex mutex;
+
+ElementRenderCache::ElementRenderCache(Element* _element) : render_target_dimensions(0, 0)
+{
+	element = _element;
+
+	render_interface = NULL;
+	render_target = 0;
+
+	cache_dirty = true;
+	rendering = false;
+
+	MutexLock lock(mutex);
+	render_caches.insert(this);
+	AtomicIncrement(num_caches);
+}
+
+ElementRenderCache::~ElementRenderCache()
+{
+	MutexLock lock(mutex);
+	ReleaseRenderTarget();
+	render_caches.erase(this);
+	AtomicDecrement(num_caches);
+}
+
+// Renders the element's subtree through the cache, regenerating the cached texture if required.
+bool ElementRenderCache::Render()
+{
+	Context* context = element->GetContext();
+	RenderInterface* element_render_interface = element->GetRenderInterface();
+	if (context == NULL ||
+		element_render_interface == NULL)
+		return false;
+
+	// The cache covers the element's primary border box; any content overflowing it is clipped.
+	Vector2f offset = element->GetAbsoluteOffset(Box::BORDER);
+	Vector2f size = element->GetBox().GetSize(Box::BORDER);
+
+	Vector2i origin(Math::Round(offset.x), Math::Round(offset.y));
+	Vector2i dimensions(Math::RoundUp(size.x), Math::RoundUp(size.y));
+	if (dimensions.x <= 0 ||
+		dimensions.y <= 0)
+	{
+		ReleaseRenderTarget();
+		return false;
+	}
+
+	// (Re-)generate the render target if we don't have one of the right size.
+	if (render_target == 0 ||
+		render_interface != element_render_interface ||
+		render_target_dimensions != dimensions)
+	{
+		ReleaseRenderTarget();
+
+		// Reserve the target's memory up front, so caches generating concurrently can't overrun the budget.
+		size_t render_target_size = (size_t) dimensions.x * (size_t) dimensions.y * 4;
+		{
+			MutexLock lock(mutex);
+			if (memory_usage + render_target_size > memory_budget)
+				return false;
+
+			memory_usage += render_target_size;
+		}
+
+		if (!element_render_interface->GenerateRenderTarget(render_target, dimensions))
+		{
+			MutexLock lock(mutex);
+			memory_usage -= render_target_size;
+
+			render_target = 0;
+			return false;
+		}
+
+		render_interface = element_render_interface;
+		render_target_dimensions = dimensions;
+
+		cache_dirty = true;
+	}
+
+	if (cache_dirty)
+	{
+		cache_dirty = false;
+
+		// Store the context's clipping region, so it can be restored once the subtree has been rendered.
+		Vector2i clip_origin(-1, -1);
+		Vector2i clip_dimensions(-1, -1);
+		if (!context->GetActiveClipRegion(clip_origin, clip_dimensions))
+		{
+			clip_origin = Vector2i(-1, -1);
+			clip_dimensions = Vector2i(-1, -1);
+		}
+
+		{
+			MutexLock lock(mutex);
+			render_target_stacks[context].push_back(std::pair< TextureHandle, Vector2i >(render_target, origin));
+		}
+		GeometryBatch::Flush(render_interface);
+		render_interface->SetRenderTarget(render_target, origin);
+		render_interface->ClearRenderTarget();
+
+		// Start the subtree unclipped; we can't assume the scissor state has survived the change of render target.
+		context->SetActiveClipRegion(Vector2i(-1, -1), Vector2i(-1, -1));
+		context->DirtyScissorRegion();
+		ElementUtilities::ApplyActiveClipRegion(context, render_interface);
+
+		// Render the subtree as normal; while we're rendering, the element and its descendants are not clipped by
+		// anything above the element.
+		rendering = true;
+		element->DirtyClippingRegion();
+		element->Render();
+		rendering = false;
+		element->DirtyClippingRegion();
+
+		TextureHandle parent_render_target = 0;
+		Vector2i parent_origin(0, 0);
+		{
+			MutexLock lock(mutex);
+			RenderTargetStackMap::iterator i = render_target_stacks.find(context);
+			(*i).second.pop_back();
+			if ((*i).second.empty())
+				render_target_stacks.erase(i);
+			else
+			{
+				parent_render_target = (*i).second.back().first;
+				parent_origin = (*i).second.back().second;
+			}
+		}
+		GeometryBatch::Flush(render_interface);
+		render_interface->SetRenderTarget(parent_render_target, parent_origin);
+
+		context->SetActiveClipRegion(clip_origin, clip_dimensions);
+		context->DirtyScissorRegion();
+		ElementUtilities::ApplyActiveClipRegion(context, render_interface);
+	}
+
+	// Draw the cached subtree as a single quad, clipped by the element's ancestors.
+	if (ElementUtilities::SetClippingRegion(element))
+	{
+		Vertex vertices[4];
+		int indices[6];
+		GeometryUtilities::GenerateQuad(vertices, indices, Vector2f(0, 0), Vector2f((float) dimensions.x, (float) dimensions.y), Colourb(255, 255, 255), Vector2f(0, 0), Vector2f(1, 1));
+
+		Vector2f translation((float) origin.x, (float) origin.y);
+		if (!GeometryBatch::RenderGeometry(render_interface, vertices, 4, indices, 6, render_target, translation))
+		{
+			render_interface->RenderGeometry(vertices, 4, indices, 6, render_target, translation);
+			Profiler::IncrementCounter(Profiler::DRAW_CALLS);
+		}
+	}
+
+	return true;
+}
+
+// Marks the cached texture as out of date.
+void ElementRenderCache::DirtyCache()
+{
+	cache_dirty = true;
+}
+
+// Returns true if the cache is currently rendering its element's subtree into its render target.
+bool ElementRenderCache::IsRendering() const
+{
+	return rendering;
+}
+
+// Returns the number of bytes of texture memory currently held by render caches.
+size_t ElementRenderCache::GetMemoryUsage()
+{
+	MutexLock lock(mutex);
+	return memory_usage;
+}
+
+// Sets the maximum number of bytes of texture memory render caches may hold.
+void ElementRenderCache::SetMemoryBudget(size_t budget)
+{
+	MutexLock lock(mutex);
+	memory_budget = budget;
+
+	// Drop all existing targets if we're now over budget; they'll be regenerated within the new budget as they render.
+	if (memory_usage > memory_budget)
+		ReleaseRenderTargets();
+}
+
+// Returns the maximum number of bytes of texture memory render caches may hold.
+size_t ElementRenderCache::GetMemoryBudget()
+{
+	MutexLock lock(mutex);
+	return memory_budget;
+}
+
+// Returns the number of render caches currently in use.
+int ElementRenderCache::GetNumCaches()
+{
+	return num_caches;
+}
+
+// Releases the render targets of all caches.
+void ElementRenderCache::ReleaseRenderTargets()
+{
+	MutexLock lock(mutex);
+	for (RenderCacheSet::iterator i = render_caches.begin(); i != render_caches.end(); ++i)
+		(*i)->ReleaseRenderTarget();
+}
+
+// Releases the render targets of all caches generated through a render interface.
+void ElementRenderCache::ReleaseRenderTargets(RenderInterface* render_interface)
+{
+	MutexLock lock(mutex);
+	for (RenderCacheSet::iterator i = render_caches.begin(); i != render_caches.end(); ++i)
+	{
+		if ((*i)->render_interface == render_interface)
+			(*i)->ReleaseRenderTarget();
+	}
+}
+
+// Releases the cache's render target, if it has one.
+void ElementRenderCache::ReleaseRenderTarget()
+{
+	if (render_target != 0)
+	{
+		render_interface->ReleaseTexture(render_target);
+
+		MutexLock lock(mutex);
+		memory_usage -= (size_t) render_target_dimensions.x * (size_t) render_target_dimensions.y * 4;
+	}
+
+	render_interface = NULL;
+	render_target = 0;
+	render_target_dimensions = Vector2i(0, 0);
+	cache_dirty = true;
+}
+
+}
+}
@@ -0,0 +1,94 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef ROCKETCOREELEMENTRENDERCACHE_H
+#define ROCKETCOREELEMENTRENDERCACHE_H
+
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+class Element;
+class RenderInterface;
+
+/**
+	Renders an element's subtree once into an offscreen render target, and then draws the target as a single quad
+	until something within the subtree is changed. Used by elements with a 'render-cache' of 'texture'.
+ */
+
+class ElementRenderCache
+{
+public:
+	ElementRenderCache(Element* element);
+	~ElementRenderCache();
+
+	/// Renders the element's subtree through the cache, regenerating the cached texture if required.
+	/// @return True if the subtree was rendered from the cache, false if the element must be rendered normally.
+	bool Render();
+
+	/// Marks the cached texture as out of date; it will be regenerated the next time it is rendered.
+	void DirtyCache();
+
+	/// Returns true if the cache is currently rendering its element's subtree into its render target.
+	bool IsRendering() const;
+
+	/// Returns the number of bytes of texture memory currently held by render caches.
+	static size_t GetMemoryUsage();
+	/// Sets the maximum number of bytes of texture memory render caches may hold. Elements that would push the usage
+	/// over the budget are rendered normally instead.
+	static void SetMemoryBudget(size_t budget);
+	/// Returns the maximum number of bytes of texture memory render caches may hold.
+	static size_t GetMemoryBudget();
+	/// Returns the number of render caches currently in use. This doesn't take the render caches' lock, so it is cheap
+	/// enough to check before every invalidation.
+	static int GetNumCaches();
+
+	/// Releases the render targets of all caches, forcing them to be regenerated when next rendered.
+	static void ReleaseRenderTargets();
+	/// Releases the render targets of all caches generated through a render interface.
+	static void ReleaseRenderTargets(RenderInterface* render_interface);
+
+private:
+	// Releases the cache's render target, if it has one.
+	void ReleaseRenderTarget();
+
+	Element* element;
+
+	// The render target the subtree is cached in, and the interface it was generated through.
+	RenderInterface* render_interface;
+	TextureHandle render_target;
+	Vector2i render_target_dimensions;
+
+	bool cache_dirty;
+	bool rendering;
+};
+
+}
+}
+
+#endif
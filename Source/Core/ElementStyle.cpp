@@ -27,7 +27,9 @@
 
 #include "precompiled.h"
 #include "ElementStyle.h"
+#include "ElementAncestorFilter.h"
 #include "ElementStyleCache.h"
+#include "MemoryUsageUtilities.h"
 #include <algorithm>
 #include <Rocket/Core/ElementDocument.h>
 #include <Rocket/Core/ElementUtilities.h>
@@ -45,13 +47,43 @@
 namespace Rocket {
 namespace Core {
 
+// Returns the resolution of the render interface an element is rendered through.
+static float GetPixelsPerInch(Element* element)
+{
+	RenderInterface* render_interface = element->GetRenderInterface();
+	if (render_interface == NULL)
+		return 0;
+
+	return render_interface->GetPixelsPerInch();
+}
+
+// Resolves a property in one of the pixels-per-inch units into pixels.
+static float ResolvePixelsPerInchUnit(const Property* property, float pixels_per_inch)
+{
+	float inches = property->value.Get< float >();
+	switch (property->unit)
+	{
+		case Property::CM:	inches /= 2.54f; break;
+		case Property::MM:	inches /= 25.4f; break;
+		case Property::PT:	inches /= 72.0f; break;
+		case Property::PC:	inches /= 6.0f; break;
+		default:			break;
+	}
+
+	return inches * pixels_per_inch;
+}
+
 ElementStyle::ElementStyle(Element* _element)
 {
 	local_properties = NULL;
 	em_properties = NULL;
 	definition = NULL;
 	element = _element;
-	cache = new ElementStyleCache(this);
+	cache = NULL;
+
+	font_size = 0;
+	font_size_dirty = true;
+	font_size_ppi = 0;
 
 	definition_dirty = true;
 	child_definition_dirty = true;
@@ -67,14 +99,27 @@ ElementStyle::~ElementStyle()
 	if (definition != NULL)
 		definition->RemoveReference();
 
-	delete cache;
+	if (cache != NULL)
+		cache->RemoveReference();
 }
 
-static PropCounter prop_counter;
-
-PropCounter &ElementStyle::GetPropCounter()
+// Adds an estimate of the memory held by the style and its local properties to a breakdown.
+void ElementStyle::GetMemoryUsage(MemoryUsage& usage) const
 {
-	return prop_counter;
+	size_t style_size = sizeof(ElementStyle);
+	if (cache != NULL)
+		style_size += sizeof(ElementStyleCache) / cache->GetReferenceCount();
+	style_size += MemoryUsageUtilities::GetVectorSize(classes);
+	for (size_t i = 0; i < classes.size(); ++i)
+		style_size += MemoryUsageUtilities::GetStringSize(classes[i]);
+	style_size += MemoryUsageUtilities::GetTreeSize(pseudo_classes);
+	if (em_properties != NULL)
+		style_size += sizeof(PropertyNameList) + MemoryUsageUtilities::GetTreeSize(*em_properties);
+
+	usage.Add(MemoryUsage::STYLES, style_size);
+
+	if (local_properties != NULL)
+		usage.Add(MemoryUsage::PROPERTIES, sizeof(PropertyDictionary) + local_properties->GetMemoryUsage());
 }
 
 // Returns the element's definition, updating if necessary.
@@ -88,18 +133,19 @@ const ElementDefinition* ElementStyle::GetDefinition()
 	return definition;
 }
 	
-void ElementStyle::UpdateDefinition()
+void ElementStyle::UpdateDefinition(const ElementAncestorFilter* ancestor_filter)
 {
 	if (definition_dirty)
 	{
 		definition_dirty = false;
+		Profiler::IncrementCounter(Profiler::ELEMENTS_STYLED);
 		
 		ElementDefinition* new_definition = NULL;
 		
 		const StyleSheet* style_sheet = GetStyleSheet();
 		if (style_sheet != NULL)
 		{
-			new_definition = style_sheet->GetElementDefinition(element);
+			new_definition = style_sheet->GetElementDefinition(element, ancestor_filter);
 		}
 		
 		// Switch the property definitions if the definition has changed.
@@ -129,9 +175,10 @@ void ElementStyle::UpdateDefinition()
 	
 	if (child_definition_dirty)
 	{
+		ElementAncestorFilter child_filter(ancestor_filter, element);
 		for (int i = 0; i < element->GetNumChildren(true); i++)
 		{
-			element->GetChild(i)->GetStyle()->UpdateDefinition();
+			element->GetChild(i)->GetStyle()->UpdateDefinition(&child_filter);
 		}
 		
 		child_definition_dirty = false;
@@ -152,6 +199,12 @@ void ElementStyle::SetPseudoClass(const String& pseudo_class, bool activate)
 	{
 		element->GetElementDecoration()->DirtyDecorators();
 
+		// Our pseudo-classes are part of the key of a shared cache, so we can't keep using it even if no properties
+		// have changed.
+		if (cache != NULL &&
+			cache->IsShared())
+			ReleaseCache();
+
 		const ElementDefinition* definition = element->GetDefinition();
 		if (definition != NULL)
 		{
@@ -197,7 +250,8 @@ void ElementStyle::SetClass(const String& class_name, bool activate)
 		if (class_location == classes.end())
 		{
 			classes.push_back(class_name);
-			DirtyDefinition();
+			ElementAncestorFilter::Invalidate();
+			DirtyDefinition(GetClassInvalidationScope(class_name));
 		}
 	}
 	else
@@ -205,7 +259,8 @@ void ElementStyle::SetClass(const String& class_name, bool activate)
 		if (class_location != classes.end())
 		{
 			classes.erase(class_location);
-			DirtyDefinition();
+			ElementAncestorFilter::Invalidate();
+			DirtyDefinition(GetClassInvalidationScope(class_name));
 		}
 	}
 }
@@ -219,9 +274,31 @@ bool ElementStyle::IsClassSet(const String& class_name) const
 // Specifies the entire list of classes for this element. This will replace any others specified.
 void ElementStyle::SetClassNames(const String& class_names)
 {
-	classes.clear();
+	StringList old_classes;
+	old_classes.swap(classes);
 	StringUtilities::ExpandString(classes, class_names, ' ');
-	DirtyDefinition();
+	ElementAncestorFilter::Invalidate();
+
+	// Only the classes that were actually added or removed can change any definitions.
+	StyleSheet::InvalidationScope scope = StyleSheet::INVALIDATE_NONE;
+	for (size_t i = 0; i < old_classes.size(); i++)
+	{
+		if (std::find(classes.begin(), classes.end(), old_classes[i]) == classes.end())
+			scope = Math::Max(scope, GetClassInvalidationScope(old_classes[i]));
+	}
+	for (size_t i = 0; i < classes.size(); i++)
+	{
+		if (std::find(old_classes.begin(), old_classes.end(), classes[i]) == old_classes.end())
+			scope = Math::Max(scope, GetClassInvalidationScope(classes[i]));
+	}
+
+	DirtyDefinition(scope);
+}
+
+// Returns the list of classes specified for this element.
+const StringList& ElementStyle::GetClassList() const
+{
+	return classes;
 }
 
 // Returns the list of classes specified for this element.
@@ -292,10 +369,6 @@ void ElementStyle::RemoveProperty(const String& name)
 // Returns one of this element's properties.
 const Property* ElementStyle::GetProperty(const String& name)
 {
-	if (prop_counter.find(name) == prop_counter.end())
-		prop_counter[name] = 0;
-	prop_counter[name] = prop_counter[name] + 1;
-
 	const Property* local_property = GetLocalProperty(name);
 	if (local_property != NULL)
 		return local_property;
@@ -363,6 +436,11 @@ float ElementStyle::ResolveProperty(const Property* property, float base_value)
 		return property->value.Get< float >();
 	}
 
+	if (property->unit & Property::PPI_UNIT)
+	{
+		return ResolvePixelsPerInchUnit(property, GetPixelsPerInch(element));
+	}
+
 	// We're not a numeric property; return 0.
 	return 0.0f;
 }
@@ -370,6 +448,11 @@ float ElementStyle::ResolveProperty(const Property* property, float base_value)
 // Resolves one of this element's properties.
 float ElementStyle::ResolveProperty(const String& name, float base_value)
 {
+	// The calculated value of the font-size property is inherited, so it is resolved against our parent's font-size
+	// rather than the base value.
+	if (name == FONT_SIZE)
+		return ResolveFontSize();
+
 	const Property* property = GetProperty(name);
 	if (!property)
 	{
@@ -377,43 +460,7 @@ float ElementStyle::ResolveProperty(const String& name, float base_value)
 		return 0.0f;
 	}
 
-	if (property->unit & Property::RELATIVE_UNIT)
-	{
-		// The calculated value of the font-size property is inherited, so we need to check if this
-		// is an inherited property. If so, then we return our parent's font size instead.
-		if (name == FONT_SIZE)
-		{
-			Rocket::Core::Element* parent = element->GetParentNode();
-			if (parent == NULL)
-				return 0;
-
-			if (GetLocalProperty(FONT_SIZE) == NULL)
-				return parent->ResolveProperty(FONT_SIZE, 0);
-
-			// The base value for font size is always the height of *this* element's parent's font.
-			base_value = parent->ResolveProperty(FONT_SIZE, 0);
-		}
-
-		if (property->unit & Property::PERCENT)
-			return base_value * property->value.Get< float >() * 0.01f;
-		else if (property->unit & Property::EM)
-		{
-			// If an em-relative font size is specified, it is expressed relative to the parent's
-			// font height.
-			if (name == FONT_SIZE)
-				return property->value.Get< float >() * base_value;
-			else
-				return property->value.Get< float >() * ElementUtilities::GetFontSize(element);
-		}
-	}
-
-	if (property->unit & Property::NUMBER || property->unit & Property::PX)
-	{
-		return property->value.Get< float >();
-	}
-
-	// We're not a numeric property; return 0.
-	return 0.0f;
+	return ResolveProperty(property, base_value);
 }
 
 // Iterates over the properties defined on the element.
@@ -477,20 +524,90 @@ void ElementStyle::DirtyDefinition()
 {
 	definition_dirty = true;
 	DirtyChildDefinitions();
-	
-	// Dirty the child definition update the element tree
-	Element* parent = element->GetParentNode();
-	while (parent)
+	DirtyAncestorChildDefinitions();
+
+	element->ScheduleUpdate();
+}
+
+// Dirties the definitions of the elements within a scope.
+void ElementStyle::DirtyDefinition(StyleSheet::InvalidationScope scope)
+{
+	switch (scope)
 	{
-		parent->GetStyle()->child_definition_dirty = true;
-		parent = parent->GetParentNode();
+		case StyleSheet::INVALIDATE_SUBTREE:
+			DirtyDefinition();
+			break;
+
+		case StyleSheet::INVALIDATE_ELEMENT:
+			definition_dirty = true;
+			DirtyAncestorChildDefinitions();
+			element->ScheduleUpdate();
+			break;
+
+		default:
+			break;
 	}
 }
 
 void ElementStyle::DirtyChildDefinitions()
 {
-	for (int i = 0; i < element->GetNumChildren(true); i++)
-		element->GetChild(i)->GetStyle()->DirtyDefinition();
+	int num_children = element->GetNumChildren(true);
+	if (num_children == 0)
+		return;
+
+	for (int i = 0; i < num_children; i++)
+		element->GetChild(i)->GetStyle()->DirtySubtreeDefinitions();
+
+	child_definition_dirty = true;
+	DirtyAncestorChildDefinitions();
+
+	// Our update will resolve the definitions of our descendants along with our own.
+	element->ScheduleUpdate();
+}
+
+// Returns the elements whose definitions may change when one of this element's classes changes.
+StyleSheet::InvalidationScope ElementStyle::GetClassInvalidationScope(const String& class_name) const
+{
+	// Without a style sheet we can't tell what depends on the class, so assume everything does.
+	const StyleSheet* style_sheet = GetStyleSheet();
+	if (style_sheet == NULL)
+		return StyleSheet::INVALIDATE_SUBTREE;
+
+	return style_sheet->GetClassInvalidationScope(class_name);
+}
+
+// Returns the elements whose definitions may change when this element's ID changes.
+StyleSheet::InvalidationScope ElementStyle::GetIdInvalidationScope(const String& id) const
+{
+	const StyleSheet* style_sheet = GetStyleSheet();
+	if (style_sheet == NULL)
+		return StyleSheet::INVALIDATE_SUBTREE;
+
+	return style_sheet->GetIdInvalidationScope(id);
+}
+
+// Dirties the definitions of this element and all of its descendants, without notifying ancestors.
+void ElementStyle::DirtySubtreeDefinitions()
+{
+	definition_dirty = true;
+
+	int num_children = element->GetNumChildren(true);
+	for (int i = 0; i < num_children; i++)
+		element->GetChild(i)->GetStyle()->DirtySubtreeDefinitions();
+
+	if (num_children > 0)
+		child_definition_dirty = true;
+}
+
+// Flags our ancestors as having dirty definitions below them.
+void ElementStyle::DirtyAncestorChildDefinitions()
+{
+	Element* parent = element->GetParentNode();
+	while (parent)
+	{
+		parent->GetStyle()->child_definition_dirty = true;
+		parent = parent->GetParentNode();
+	}
 }
 
 // Dirties every property.
@@ -503,10 +620,19 @@ void ElementStyle::DirtyProperties()
 // Dirties em-relative properties.
 void ElementStyle::DirtyEmProperties()
 {
-	const PropertyNameList &properties = StyleSheetSpecification::GetRegisteredProperties();
-
 	if (!em_properties)
 	{
+		// Only properties that are set on this element or inherited from its ancestors can be em-relative, as
+		// property defaults are absolute; we don't need to check every registered property.
+		PropertyNameList properties = StyleSheetSpecification::GetRegisteredInheritedProperties();
+		if (local_properties != NULL)
+		{
+			for (PropertyMap::const_iterator i = local_properties->GetProperties().begin(); i != local_properties->GetProperties().end(); ++i)
+				properties.insert((*i).first);
+		}
+		if (definition != NULL)
+			definition->GetDefinedProperties(properties, pseudo_classes);
+
 		// Check if any of these are currently em-relative. If so, dirty them.
 		em_properties = new PropertyNameList;
 		for (PropertyNameList::const_iterator list_iterator = properties.begin(); list_iterator != properties.end(); ++list_iterator)
@@ -517,7 +643,9 @@ void ElementStyle::DirtyEmProperties()
 
 			// Get this property from this element. If this is em-relative, then add it to the list to
 			// dirty.
-			if (element->GetProperty(*list_iterator)->unit == Property::EM)
+			const Property* property = GetProperty(*list_iterator);
+			if (property != NULL &&
+				property->unit == Property::EM)
 				em_properties->insert(*list_iterator);
 		}
 	}
@@ -563,6 +691,10 @@ void ElementStyle::DirtyProperties(const PropertyNameList& properties, bool clea
 	if (properties.empty())
 		return;
 
+	if (!font_size_dirty &&
+		properties.find(FONT_SIZE) != properties.end())
+		DirtyResolvedFontSize();
+
 	bool all_inherited_dirty = 
 		StyleSheetSpecification::GetRegisteredProperties() == properties ||
 		StyleSheetSpecification::GetRegisteredInheritedProperties() == properties;
@@ -574,7 +706,7 @@ void ElementStyle::DirtyProperties(const PropertyNameList& properties, bool clea
 			element->GetChild(i)->GetStyle()->DirtyInheritedProperties(all_inherited_properties);
 
 		// Clear all cached properties.
-		cache->Clear();
+		ClearCache();
 	}
 	else
 	{
@@ -597,7 +729,7 @@ void ElementStyle::DirtyProperties(const PropertyNameList& properties, bool clea
 		}
 
 		// Clear cached properties.
-		cache->Clear();
+		ClearCache();
 	}
 
 	// clear the list of EM-properties, we will refill it in DirtyEmProperties
@@ -639,8 +771,15 @@ void ElementStyle::DirtyInheritedProperties(const PropertyNameList& properties)
 		em_properties = NULL;
 	}
 
-	// Clear cached inherited properties.
-	cache->ClearInherited();
+	// Clear cached inherited properties. A shared cache is released instead, as the styles sharing it may not have
+	// had their properties dirtied.
+	if (cache != NULL)
+	{
+		if (cache->IsShared())
+			ReleaseCache();
+		else
+			cache->ClearInherited();
+	}
 
 	// Pass the list of those properties that this element doesn't override onto our children.
 	for (int i = 0; i < element->GetNumChildren(true); i++)
@@ -651,72 +790,190 @@ void ElementStyle::DirtyInheritedProperties(const PropertyNameList& properties)
 
 void ElementStyle::GetBorderWidthProperties(const Property **border_top_width, const Property **border_bottom_width, const Property **border_left_width, const Property **bottom_right_width)
 {
-	cache->GetBorderWidthProperties(border_top_width, border_bottom_width, border_left_width, bottom_right_width);
+	GetCache()->GetBorderWidthProperties(this, border_top_width, border_bottom_width, border_left_width, bottom_right_width);
 }
 
 void ElementStyle::GetMarginProperties(const Property **margin_top, const Property **margin_bottom, const Property **margin_left, const Property **margin_right)
 {
-	cache->GetMarginProperties(margin_top, margin_bottom, margin_left, margin_right);
+	GetCache()->GetMarginProperties(this, margin_top, margin_bottom, margin_left, margin_right);
 }
 
 void ElementStyle::GetPaddingProperties(const Property **padding_top, const Property **padding_bottom, const Property **padding_left, const Property **padding_right)
 {
-	cache->GetPaddingProperties(padding_top, padding_bottom, padding_left, padding_right);
+	GetCache()->GetPaddingProperties(this, padding_top, padding_bottom, padding_left, padding_right);
 }
 
 void ElementStyle::GetDimensionProperties(const Property **width, const Property **height)
 {
-	cache->GetDimensionProperties(width, height);
+	GetCache()->GetDimensionProperties(this, width, height);
 }
 
 void ElementStyle::GetLocalDimensionProperties(const Property **width, const Property **height)
 {
-	cache->GetLocalDimensionProperties(width, height);
+	GetCache()->GetLocalDimensionProperties(this, width, height);
+}
+
+void ElementStyle::GetLocalMinMaxDimensionProperties(const Property **min_width, const Property **max_width, const Property **min_height, const Property **max_height)
+{
+	GetCache()->GetLocalMinMaxDimensionProperties(this, min_width, max_width, min_height, max_height);
+}
+
+void ElementStyle::GetLocalOffsetProperties(const Property **top, const Property **right, const Property **bottom, const Property **left)
+{
+	GetCache()->GetLocalOffsetProperties(this, top, right, bottom, left);
 }
 
 void ElementStyle::GetOverflow(int *overflow_x, int *overflow_y)
 {
-	cache->GetOverflow(overflow_x, overflow_y);
+	GetCache()->GetOverflow(this, overflow_x, overflow_y);
 }
 
 int ElementStyle::GetPosition()
 {
-	return cache->GetPosition();
+	return GetCache()->GetPosition(this);
 }
 
 int ElementStyle::GetFloat()
 {
-	return cache->GetFloat();
+	return GetCache()->GetFloat(this);
 }
 
 int ElementStyle::GetDisplay()
 {
-	return cache->GetDisplay();
+	return GetCache()->GetDisplay(this);
 }
 
 int ElementStyle::GetWhitespace()
 {
-	return cache->GetWhitespace();
+	return GetCache()->GetWhitespace(this);
 }
 
 const Property *ElementStyle::GetLineHeightProperty()
 {
-	return cache->GetLineHeightProperty();
+	return GetCache()->GetLineHeightProperty(this);
 }
 
 int ElementStyle::GetTextAlign()
 {
-	return cache->GetTextAlign();
+	return GetCache()->GetTextAlign(this);
 }
 
 int ElementStyle::GetTextTransform()
 {
-	return cache->GetTextTransform();
+	return GetCache()->GetTextTransform(this);
 }
 
 const Property *ElementStyle::GetVerticalAlignProperty()
 {
-	return cache->GetVerticalAlignProperty();
+	return GetCache()->GetVerticalAlignProperty(this);
+}
+
+// Resolves the element's font-size into pixels, using the cached value if it is still valid.
+float ElementStyle::ResolveFontSize()
+{
+	// A font-size resolved from a pixels-per-inch unit is only valid while the resolution is unchanged.
+	if (!font_size_dirty &&
+		(font_size_ppi == 0 || font_size_ppi == GetPixelsPerInch(element)))
+		return font_size;
+
+	font_size = 0;
+	font_size_dirty = false;
+	font_size_ppi = 0;
+
+	const Property* property = GetProperty(FONT_SIZE);
+	if (!property)
+	{
+		ROCKET_ERROR;
+		return font_size;
+	}
+
+	if (property->unit & Property::RELATIVE_UNIT)
+	{
+		// Relative font sizes are expressed in terms of *this* element's parent's font size; if we don't set our own
+		// font size, we simply inherit our parent's.
+		Element* parent = element->GetParentNode();
+		if (parent != NULL)
+		{
+			float parent_font_size = parent->GetStyle()->ResolveFontSize();
+			font_size_ppi = parent->GetStyle()->font_size_ppi;
+
+			if (GetLocalProperty(FONT_SIZE) == NULL)
+				font_size = parent_font_size;
+			else if (property->unit & Property::PERCENT)
+				font_size = parent_font_size * property->value.Get< float >() * 0.01f;
+			else
+				font_size = parent_font_size * property->value.Get< float >();
+		}
+	}
+	else if (property->unit & Property::NUMBER || property->unit & Property::PX)
+	{
+		font_size = property->value.Get< float >();
+	}
+	else if (property->unit & Property::PPI_UNIT)
+	{
+		font_size_ppi = GetPixelsPerInch(element);
+		font_size = ResolvePixelsPerInchUnit(property, font_size_ppi);
+	}
+
+	return font_size;
+}
+
+// Invalidates the resolved font-size of this element and of any descendants that may depend on it.
+void ElementStyle::DirtyResolvedFontSize()
+{
+	font_size_dirty = true;
+
+	// A clean font-size is only ever resolved against a clean parent, so we can stop at any descendant that is
+	// already dirty.
+	int num_children = element->GetNumChildren(true);
+	for (int i = 0; i < num_children; ++i)
+	{
+		ElementStyle* child_style = element->GetChild(i)->GetStyle();
+		if (!child_style->font_size_dirty)
+			child_style->DirtyResolvedFontSize();
+	}
+}
+
+// Returns the style's property cache, fetching or creating one if necessary.
+ElementStyleCache* ElementStyle::GetCache()
+{
+	if (cache == NULL)
+	{
+		// Only styles whose properties depend solely on their definition, pseudo-classes and parent can share a cache.
+		if (local_properties != NULL &&
+			local_properties->GetNumProperties() > 0)
+			cache = new ElementStyleCache();
+		else
+		{
+			Element* parent = element->GetParentNode();
+			ElementStyleCache* parent_cache = parent != NULL ? parent->GetStyle()->GetCache() : NULL;
+			cache = ElementStyleCache::GetSharedCache(this, definition, pseudo_classes, parent_cache);
+		}
+	}
+
+	return cache;
+}
+
+// Clears all cached properties.
+void ElementStyle::ClearCache()
+{
+	if (cache == NULL)
+		return;
+
+	if (cache->IsShared())
+		ReleaseCache();
+	else
+		cache->Clear();
+}
+
+// Releases the style's property cache.
+void ElementStyle::ReleaseCache()
+{
+	if (cache != NULL)
+	{
+		cache->RemoveReference();
+		cache = NULL;
+	}
 }
 
 }
@@ -29,14 +29,15 @@
 #define ROCKETCOREELEMENTSTYLE_H
 
 #include "ElementDefinition.h"
+#include <Rocket/Core/StyleSheet.h>
 #include <Rocket/Core/Types.h>
 
 namespace Rocket {
 namespace Core {
 
+class ElementAncestorFilter;
 class ElementStyleCache;
-
-typedef std::map<String, int> PropCounter;
+class MemoryUsage;
 
 /**
 	Manages an element's style and property information.
@@ -55,7 +56,8 @@ public:
 	const ElementDefinition* GetDefinition();
 	
 	/// Update this definition if required
-	void UpdateDefinition();
+	/// @param[in] ancestor_filter A filter over the element's ancestors, if the caller is maintaining one.
+	void UpdateDefinition(const ElementAncestorFilter* ancestor_filter = NULL);
 
 	/// Sets or removes a pseudo-class on the element.
 	/// @param[in] pseudo_class The pseudo class to activate or deactivate.
@@ -82,6 +84,9 @@ public:
 	/// Return the active class list.
 	/// @return A string containing all the classes on the element, separated by spaces.
 	String GetClassNames() const;
+	/// Return the active class list.
+	/// @return The list of classes on the element.
+	const StringList& GetClassList() const;
 
 	/// Sets a local property override on the element.
 	/// @param[in] name The name of the new property.
@@ -112,7 +117,8 @@ public:
 	/// @return The value of this property for this element.
 	float ResolveProperty(const Property *property, float base_value);
 	/// Resolves one of this element's properties. If the value is a number or px, this is returned. If it's a 
-	/// percentage then it is resolved based on the second argument (the base value).
+	/// percentage then it is resolved based on the second argument (the base value). The element's font-size is
+	/// cached once resolved.
 	/// @param[in] name The name of the property to resolve the value for.
 	/// @param[in] base_value The value that is scaled by the percentage value, if it is a percentage.
 	/// @return The value of this property for this element.
@@ -131,9 +137,21 @@ public:
 
 	/// Mark definition and all children dirty
 	void DirtyDefinition();
+	/// Mark the definitions of the elements within a scope dirty
+	/// @param[in] scope The elements to dirty, relative to this one.
+	void DirtyDefinition(StyleSheet::InvalidationScope scope);
 	/// Dirty all child definitions
 	void DirtyChildDefinitions();
 
+	/// Returns the elements whose definitions may change when one of this element's classes is set or cleared.
+	/// @param[in] class_name The class being changed.
+	/// @return The scope of elements to dirty.
+	StyleSheet::InvalidationScope GetClassInvalidationScope(const String& class_name) const;
+	/// Returns the elements whose definitions may change when this element's ID is changed.
+	/// @param[in] id The old or new ID.
+	/// @return The scope of elements to dirty.
+	StyleSheet::InvalidationScope GetIdInvalidationScope(const String& id) const;
+
 	// Dirties every property.
 	void DirtyProperties();
 	// Dirties em-relative properties.
@@ -152,6 +170,12 @@ public:
 	/// Returns local 'width' and 'height' properties from element's style or local cache,
 	/// ignoring default values.
 	void GetLocalDimensionProperties(const Property **width, const Property **height);
+	/// Returns local 'min-width', 'max-width', 'min-height' and 'max-height' properties from element's style or
+	/// local cache, ignoring default values.
+	void GetLocalMinMaxDimensionProperties(const Property **min_width, const Property **max_width, const Property **min_height, const Property **max_height);
+	/// Returns local 'top', 'right', 'bottom' and 'left' properties from element's style or local cache,
+	/// ignoring default values.
+	void GetLocalOffsetProperties(const Property **top, const Property **right, const Property **bottom, const Property **left);
 	/// Returns 'overflow' properties' values from element's style or local cache.
 	void GetOverflow(int *overflow_x, int *overflow_y);
 	/// Returns 'position' property value from element's style or local cache.
@@ -172,9 +196,16 @@ public:
 	/// Returns 'vertical-align' property value from element's style or local cache.
 	const Property *GetVerticalAlignProperty();
 
-	static PropCounter &GetPropCounter();
+	/// Adds an estimate of the memory held by the style and its local properties to a breakdown.
+	/// @param[out] usage The breakdown to add to.
+	void GetMemoryUsage(MemoryUsage& usage) const;
 
 private:
+	// Dirties the definitions of this element and all of its descendants, without notifying ancestors.
+	void DirtySubtreeDefinitions();
+	// Flags our ancestors as having dirty definitions below them.
+	void DirtyAncestorChildDefinitions();
+
 	// Sets a single property as dirty.
 	void DirtyProperty(const String& property);
 	// Sets a list of properties as dirty.
@@ -182,6 +213,18 @@ private:
 	// Sets a list of our potentially inherited properties as dirtied by an ancestor.
 	void DirtyInheritedProperties(const PropertyNameList& properties);
 
+	// Resolves the element's font-size into pixels, using the cached value if it is still valid.
+	float ResolveFontSize();
+	// Invalidates the resolved font-size of this element and of any descendants that may depend on it.
+	void DirtyResolvedFontSize();
+
+	// Returns the style's property cache, fetching or creating one if necessary.
+	ElementStyleCache* GetCache();
+	// Clears all cached properties, releasing the cache if it is shared.
+	void ClearCache();
+	// Releases the style's property cache.
+	void ReleaseCache();
+
 	// Element these properties belong to
 	Element* element;
 
@@ -200,8 +243,14 @@ private:
 	bool definition_dirty;
 	// Set if a child element has a dirty style definition
 	bool child_definition_dirty;
-	// cached non-inherited properties
+	// cached non-inherited properties; this may be shared with other styles with identical inputs
 	ElementStyleCache *cache;
+
+	// The element's font-size in pixels, valid unless 'font_size_dirty' is set.
+	float font_size;
+	bool font_size_dirty;
+	// The pixels-per-inch the font-size was resolved with, or zero if the font-size doesn't depend on it.
+	float font_size_ppi;
 };
 
 }
@@ -28,20 +28,136 @@
 #include "precompiled.h"
 #include "ElementStyle.h"
 #include "ElementStyleCache.h"
+#include "Threading.h"
 
 namespace Rocket {
 namespace Core {
 
-ElementStyleCache::ElementStyleCache(ElementStyle *style) : style(style), 
+ElementStyleCache::SharedCacheMap* ElementStyleCache::shared_caches = NULL;
+volatile int ElementStyleCache::next_serial = 0;
+static Mutex shared_caches_mutex;
+
+ElementStyleCache::ElementStyleCache() : shared(false), serial((unsigned int) AtomicIncrement(next_serial)),
 	border_top_width(NULL), border_bottom_width(NULL), border_left_width(NULL), border_right_width(NULL),
 	margin_top(NULL), margin_bottom(NULL), margin_left(NULL), margin_right(NULL),
 	padding_top(NULL), padding_bottom(NULL), padding_left(NULL), padding_right(NULL),
 	width(NULL), height(NULL),
 	local_width(NULL), local_height(NULL), have_local_width(false), have_local_height(false),
+	local_min_width(NULL), local_max_width(NULL), local_min_height(NULL), local_max_height(NULL),
+	have_local_min_max_width(false), have_local_min_max_height(false),
+	local_top(NULL), local_right(NULL), local_bottom(NULL), local_left(NULL), have_local_offsets(false),
 	overflow_x(NULL), overflow_y(NULL),
 	position(-1), float_(-1), display(-1), whitespace(-1),
 	line_height(NULL), text_align(-1), text_transform(-1), vertical_align(NULL)
 {
+	key.definition = NULL;
+	key.parent_serial = 0;
+}
+
+ElementStyleCache::~ElementStyleCache()
+{
+}
+
+// Returns the cache shared between all styles with the given inputs, creating it if necessary.
+ElementStyleCache* ElementStyleCache::GetSharedCache(ElementStyle* style, const ElementDefinition* definition, const PseudoClassList& pseudo_classes, ElementStyleCache* parent_cache)
+{
+	MutexLock lock(shared_caches_mutex);
+
+	if (shared_caches == NULL)
+		shared_caches = new SharedCacheMap();
+
+	SharedKey key;
+	key.definition = definition;
+	key.pseudo_classes = pseudo_classes;
+	key.parent_serial = parent_cache != NULL ? parent_cache->GetSerial() : 0;
+
+	// A cache whose last reference is being released on another thread is replaced rather than revived.
+	SharedCacheMap::iterator i = shared_caches->find(key);
+	if (i != shared_caches->end() &&
+		(*i).second->AddReferenceIfReferenced())
+		return (*i).second;
+
+	// The definition is part of our key, so we hold a reference to it to stop its address being reused.
+	if (definition != NULL)
+		const_cast< ElementDefinition* >(definition)->AddReference();
+
+	ElementStyleCache* cache = new ElementStyleCache();
+	cache->key = key;
+	cache->shared = true;
+	cache->Fill(style);
+	(*shared_caches)[key] = cache;
+
+	return cache;
+}
+
+// Returns true if this cache is shared between styles with identical inputs.
+bool ElementStyleCache::IsShared() const
+{
+	return shared;
+}
+
+// Returns the number identifying this cache.
+unsigned int ElementStyleCache::GetSerial() const
+{
+	return serial;
+}
+
+void ElementStyleCache::OnReferenceDeactivate()
+{
+	if (shared)
+	{
+		MutexLock lock(shared_caches_mutex);
+
+		SharedCacheMap::iterator i = shared_caches->find(key);
+		if (i != shared_caches->end() &&
+			(*i).second == this)
+			shared_caches->erase(i);
+
+		if (shared_caches->empty())
+		{
+			delete shared_caches;
+			shared_caches = NULL;
+		}
+
+		if (key.definition != NULL)
+			const_cast< ElementDefinition* >(key.definition)->RemoveReference();
+	}
+
+	delete this;
+}
+
+// Fetches every cached property from a style.
+void ElementStyleCache::Fill(ElementStyle* style)
+{
+	const Property* properties[4];
+	int values[2];
+
+	GetBorderWidthProperties(style, &properties[0], &properties[1], &properties[2], &properties[3]);
+	GetMarginProperties(style, &properties[0], &properties[1], &properties[2], &properties[3]);
+	GetPaddingProperties(style, &properties[0], &properties[1], &properties[2], &properties[3]);
+	GetDimensionProperties(style, &properties[0], &properties[1]);
+	GetLocalDimensionProperties(style, &properties[0], &properties[1]);
+	GetLocalMinMaxDimensionProperties(style, &properties[0], &properties[1], &properties[2], &properties[3]);
+	GetLocalOffsetProperties(style, &properties[0], &properties[1], &properties[2], &properties[3]);
+	GetOverflow(style, &values[0], &values[1]);
+	GetPosition(style);
+	GetFloat(style);
+	GetDisplay(style);
+	GetWhitespace(style);
+	GetLineHeightProperty(style);
+	GetTextAlign(style);
+	GetTextTransform(style);
+	GetVerticalAlignProperty(style);
+}
+
+bool ElementStyleCache::SharedKey::operator<(const SharedKey& rhs) const
+{
+	if (definition != rhs.definition)
+		return definition < rhs.definition;
+	if (parent_serial != rhs.parent_serial)
+		return parent_serial < rhs.parent_serial;
+
+	return pseudo_classes < rhs.pseudo_classes;
 }
 
 void ElementStyleCache::Clear()
@@ -50,6 +166,7 @@ void ElementStyleCache::Clear()
 	ClearMargin();
 	ClearPadding();
 	ClearDimensions();
+	ClearOffsets();
 	ClearOverflow();
 	ClearPosition();
 	ClearFloat();
@@ -84,6 +201,12 @@ void ElementStyleCache::ClearDimensions()
 {
 	width = height = NULL;
 	have_local_width = have_local_height = false;
+	have_local_min_max_width = have_local_min_max_height = false;
+}
+
+void ElementStyleCache::ClearOffsets()
+{
+	have_local_offsets = false;
 }
 
 void ElementStyleCache::ClearOverflow()
@@ -131,7 +254,7 @@ void ElementStyleCache::ClearVerticalAlign()
 	vertical_align = NULL;
 }
 
-void ElementStyleCache::GetBorderWidthProperties(const Property **o_border_top_width, const Property **o_border_bottom_width, const Property **o_border_left_width, const Property **o_border_right_width)
+void ElementStyleCache::GetBorderWidthProperties(ElementStyle* style, const Property **o_border_top_width, const Property **o_border_bottom_width, const Property **o_border_left_width, const Property **o_border_right_width)
 {
 	if (o_border_top_width)
 	{
@@ -162,7 +285,7 @@ void ElementStyleCache::GetBorderWidthProperties(const Property **o_border_top_w
 	}
 }
 
-void ElementStyleCache::GetMarginProperties(const Property **o_margin_top, const Property **o_margin_bottom, const Property **o_margin_left, const Property **o_margin_right)
+void ElementStyleCache::GetMarginProperties(ElementStyle* style, const Property **o_margin_top, const Property **o_margin_bottom, const Property **o_margin_left, const Property **o_margin_right)
 {
 	if (o_margin_top)
 	{
@@ -193,7 +316,7 @@ void ElementStyleCache::GetMarginProperties(const Property **o_margin_top, const
 	}
 }
 
-void ElementStyleCache::GetPaddingProperties(const Property **o_padding_top, const Property **o_padding_bottom, const Property **o_padding_left, const Property **o_padding_right)
+void ElementStyleCache::GetPaddingProperties(ElementStyle* style, const Property **o_padding_top, const Property **o_padding_bottom, const Property **o_padding_left, const Property **o_padding_right)
 {
 	if (o_padding_top)
 	{
@@ -224,7 +347,7 @@ void ElementStyleCache::GetPaddingProperties(const Property **o_padding_top, con
 	}
 }
 
-void ElementStyleCache::GetDimensionProperties(const Property **o_width, const Property **o_height)
+void ElementStyleCache::GetDimensionProperties(ElementStyle* style, const Property **o_width, const Property **o_height)
 {
 	if (o_width)
 	{
@@ -241,7 +364,7 @@ void ElementStyleCache::GetDimensionProperties(const Property **o_width, const P
 	}
 }
 
-void ElementStyleCache::GetLocalDimensionProperties(const Property **o_width, const Property **o_height)
+void ElementStyleCache::GetLocalDimensionProperties(ElementStyle* style, const Property **o_width, const Property **o_height)
 {
 	if (o_width)
 	{
@@ -264,7 +387,59 @@ void ElementStyleCache::GetLocalDimensionProperties(const Property **o_width, co
 	}
 }
 
-void ElementStyleCache::GetOverflow(int *o_overflow_x, int *o_overflow_y)
+void ElementStyleCache::GetLocalMinMaxDimensionProperties(ElementStyle* style, const Property **o_min_width, const Property **o_max_width, const Property **o_min_height, const Property **o_max_height)
+{
+	if (o_min_width || o_max_width)
+	{
+		if (!have_local_min_max_width)
+		{
+			have_local_min_max_width = true;
+			local_min_width = style->GetLocalProperty(MIN_WIDTH);
+			local_max_width = style->GetLocalProperty(MAX_WIDTH);
+		}
+		if (o_min_width)
+			*o_min_width = local_min_width;
+		if (o_max_width)
+			*o_max_width = local_max_width;
+	}
+
+	if (o_min_height || o_max_height)
+	{
+		if (!have_local_min_max_height)
+		{
+			have_local_min_max_height = true;
+			local_min_height = style->GetLocalProperty(MIN_HEIGHT);
+			local_max_height = style->GetLocalProperty(MAX_HEIGHT);
+		}
+		if (o_min_height)
+			*o_min_height = local_min_height;
+		if (o_max_height)
+			*o_max_height = local_max_height;
+	}
+}
+
+void ElementStyleCache::GetLocalOffsetProperties(ElementStyle* style, const Property **o_top, const Property **o_right, const Property **o_bottom, const Property **o_left)
+{
+	if (!have_local_offsets)
+	{
+		have_local_offsets = true;
+		local_top = style->GetLocalProperty(TOP);
+		local_right = style->GetLocalProperty(RIGHT);
+		local_bottom = style->GetLocalProperty(BOTTOM);
+		local_left = style->GetLocalProperty(LEFT);
+	}
+
+	if (o_top)
+		*o_top = local_top;
+	if (o_right)
+		*o_right = local_right;
+	if (o_bottom)
+		*o_bottom = local_bottom;
+	if (o_left)
+		*o_left = local_left;
+}
+
+void ElementStyleCache::GetOverflow(ElementStyle* style, int *o_overflow_x, int *o_overflow_y)
 {
 	if (o_overflow_x)
 	{
@@ -281,56 +456,56 @@ void ElementStyleCache::GetOverflow(int *o_overflow_x, int *o_overflow_y)
 	}
 }
 
-int ElementStyleCache::GetPosition()
+int ElementStyleCache::GetPosition(ElementStyle* style)
 {
 	if (position < 0)
 		position = style->GetProperty(POSITION)->Get< int >();
 	return position;
 }
 
-int ElementStyleCache::GetFloat()
+int ElementStyleCache::GetFloat(ElementStyle* style)
 {
 	if (float_ < 0)
 		float_ = style->GetProperty(FLOAT)->Get< int >();
 	return float_;
 }
 
-int ElementStyleCache::GetDisplay()
+int ElementStyleCache::GetDisplay(ElementStyle* style)
 {
 	if (display < 0)
 		display = style->GetProperty(DISPLAY)->Get< int >();
 	return display;
 }
 
-int ElementStyleCache::GetWhitespace()
+int ElementStyleCache::GetWhitespace(ElementStyle* style)
 {
 	if (whitespace < 0)
 		whitespace = style->GetProperty(WHITE_SPACE)->Get< int >();
 	return whitespace;
 }
 
-const Property *ElementStyleCache::GetLineHeightProperty()
+const Property *ElementStyleCache::GetLineHeightProperty(ElementStyle* style)
 {
 	if (!line_height)
 		line_height = style->GetProperty(LINE_HEIGHT);
 	return line_height;
 }
 
-int ElementStyleCache::GetTextAlign()
+int ElementStyleCache::GetTextAlign(ElementStyle* style)
 {
 	if (text_align < 0)
 		text_align = style->GetProperty(TEXT_ALIGN)->Get< int >();
 	return text_align;
 }
 
-int ElementStyleCache::GetTextTransform()
+int ElementStyleCache::GetTextTransform(ElementStyle* style)
 {
 	if (text_transform < 0)
 		text_transform = style->GetProperty(TEXT_TRANSFORM)->Get< int >();
 	return text_transform;
 }
 
-const Property *ElementStyleCache::GetVerticalAlignProperty()
+const Property *ElementStyleCache::GetVerticalAlignProperty(ElementStyle* style)
 {
 	if (!vertical_align)
 		vertical_align = style->GetProperty(VERTICAL_ALIGN);
@@ -29,6 +29,7 @@
 #define ROCKETCOREELEMENTSTYLECACHE_H
 
 #include "ElementDefinition.h"
+#include <Rocket/Core/ReferenceCountable.h>
 #include <Rocket/Core/Types.h>
 
 namespace Rocket {
@@ -40,13 +41,33 @@ class ElementStyle;
 	Manages caching of layout-important properties and provides
 	O(1) access to them (note that for invalidated cache, the access
 	time is still O(log(N)) as per standard std::map).
+
+	Styles without local properties resolve their properties purely from their definition, pseudo-classes and their
+	parent's properties, so styles with identical inputs share a single cache.
 	@author Victor Luchits
  */
 
-class ElementStyleCache
+class ElementStyleCache : public ReferenceCountable
 {
 public:
-	ElementStyleCache(ElementStyle *style);
+	/// Constructs a cache for a single style.
+	ElementStyleCache();
+	virtual ~ElementStyleCache();
+
+	/// Returns the cache shared between all styles with the given inputs, creating it if necessary. A reference is
+	/// added for the caller. New caches are filled completely, so shared caches are never written to once they can be
+	/// read from several threads.
+	/// @param[in] style The style requesting the cache.
+	/// @param[in] definition The styles' element definition.
+	/// @param[in] pseudo_classes The styles' active pseudo-classes.
+	/// @param[in] parent_cache The cache of the styles' parent elements, or NULL for root elements.
+	/// @return The shared cache.
+	static ElementStyleCache* GetSharedCache(ElementStyle* style, const ElementDefinition* definition, const PseudoClassList& pseudo_classes, ElementStyleCache* parent_cache);
+
+	/// Returns true if this cache is shared between styles with identical inputs.
+	bool IsShared() const;
+	/// Returns the number identifying this cache. Unlike the cache's address, this is never reused.
+	unsigned int GetSerial() const;
 
 	/// Invalidation function for all non-inherited properties
 	void Clear();
@@ -59,6 +80,7 @@ public:
 	void ClearMargin();
 	void ClearPadding();
 	void ClearDimensions();
+	void ClearOffsets();
 	void ClearPosition();
 	void ClearFloat();
 	void ClearDisplay();
@@ -72,39 +94,66 @@ public:
 	void ClearVerticalAlign();
 
 	/// Returns 'border-width' properties from element's style or local cache.
-	void GetBorderWidthProperties(const Property **border_top_width, const Property **border_bottom_width, const Property **border_left_width, const Property **border_right_width);
+	void GetBorderWidthProperties(ElementStyle* style, const Property **border_top_width, const Property **border_bottom_width, const Property **border_left_width, const Property **border_right_width);
 	/// Returns 'margin' properties from element's style or local cache.
-	void GetMarginProperties(const Property **margin_top, const Property **margin_bottom, const Property **margin_left, const Property **margin_right);
+	void GetMarginProperties(ElementStyle* style, const Property **margin_top, const Property **margin_bottom, const Property **margin_left, const Property **margin_right);
 	/// Returns 'padding' properties from element's style or local cache.
-	void GetPaddingProperties(const Property **padding_top, const Property **padding_bottom, const Property **padding_left, const Property **padding_right);
+	void GetPaddingProperties(ElementStyle* style, const Property **padding_top, const Property **padding_bottom, const Property **padding_left, const Property **padding_right);
 	/// Returns 'width' and 'height' properties from element's style or local cache.
-	void GetDimensionProperties(const Property **width, const Property **height);
+	void GetDimensionProperties(ElementStyle* style, const Property **width, const Property **height);
 	/// Returns local 'width' and 'height' properties from element's style or local cache,
 	/// ignoring default values.
-	void GetLocalDimensionProperties(const Property **width, const Property **height);
+	void GetLocalDimensionProperties(ElementStyle* style, const Property **width, const Property **height);
+	/// Returns local 'min-width', 'max-width', 'min-height' and 'max-height' properties from element's style or
+	/// local cache, ignoring default values.
+	void GetLocalMinMaxDimensionProperties(ElementStyle* style, const Property **min_width, const Property **max_width, const Property **min_height, const Property **max_height);
+	/// Returns local 'top', 'right', 'bottom' and 'left' properties from element's style or local cache,
+	/// ignoring default values.
+	void GetLocalOffsetProperties(ElementStyle* style, const Property **top, const Property **right, const Property **bottom, const Property **left);
 	/// Returns 'overflow' properties' values from element's style or local cache.
-	void GetOverflow(int *overflow_x, int *overflow_y);
+	void GetOverflow(ElementStyle* style, int *overflow_x, int *overflow_y);
 	/// Returns 'position' property value from element's style or local cache.
-	int GetPosition();
+	int GetPosition(ElementStyle* style);
 	/// Returns 'float' property value from element's style or local cache.
-	int GetFloat();
+	int GetFloat(ElementStyle* style);
 	/// Returns 'display' property value from element's style or local cache.
-	int GetDisplay();
+	int GetDisplay(ElementStyle* style);
 	/// Returns 'white-space' property value from element's style or local cache.
-	int GetWhitespace();
+	int GetWhitespace(ElementStyle* style);
 
 	/// Returns 'line-height' property value from element's style or local cache.
-	const Property *GetLineHeightProperty();
+	const Property *GetLineHeightProperty(ElementStyle* style);
 	/// Returns 'text-align' property value from element's style or local cache.
-	int GetTextAlign();
+	int GetTextAlign(ElementStyle* style);
 	/// Returns 'text-transform' property value from element's style or local cache.
-	int GetTextTransform();
+	int GetTextTransform(ElementStyle* style);
 	/// Returns 'vertical-align' property value from element's style or local cache.
-	const Property *GetVerticalAlignProperty();
+	const Property *GetVerticalAlignProperty(ElementStyle* style);
+
+protected:
+	virtual void OnReferenceDeactivate();
 
 private:
-	/// Element style that owns this cache instance.
-	ElementStyle *style;
+	// The inputs that styles sharing a cache have in common.
+	struct SharedKey
+	{
+		const ElementDefinition* definition;
+		PseudoClassList pseudo_classes;
+		unsigned int parent_serial;
+
+		bool operator<(const SharedKey& rhs) const;
+	};
+	typedef std::map< SharedKey, ElementStyleCache* > SharedCacheMap;
+	static SharedCacheMap* shared_caches;
+	static volatile int next_serial;
+
+	/// Fetches every cached property from a style.
+	void Fill(ElementStyle* style);
+
+	/// The inputs of a shared cache.
+	SharedKey key;
+	bool shared;
+	unsigned int serial;
 
 	/// Cached properties.
 	const Property *border_top_width, *border_bottom_width, *border_left_width, *border_right_width;
@@ -113,6 +162,10 @@ private:
 	const Property *width, *height;
 	const Property *local_width, *local_height;
 	bool have_local_width, have_local_height;
+	const Property *local_min_width, *local_max_width, *local_min_height, *local_max_height;
+	bool have_local_min_max_width, have_local_min_max_height;
+	const Property *local_top, *local_right, *local_bottom, *local_left;
+	bool have_local_offsets;
 	int overflow_x, overflow_y;
 	int position;
 	int float_;
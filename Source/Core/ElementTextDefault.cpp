@@ -30,6 +30,7 @@
 #include "ElementDefinition.h"
 #include "ElementStyle.h"
 #include "FontFaceHandle.h"
+#include "MemoryUsageUtilities.h"
 #include <Rocket/Core/ElementDocument.h>
 #include <Rocket/Core/ElementUtilities.h>
 #include <Rocket/Core/Event.h>
@@ -277,6 +278,23 @@ void ElementTextDefault::SuppressAutoLayout()
 	dirty_layout_on_change = false;
 }
 
+// Adds an estimate of the memory held by the element, its text and its text geometry to a breakdown.
+void ElementTextDefault::GetMemoryUsage(MemoryUsage& usage)
+{
+	ElementText::GetMemoryUsage(usage);
+
+	size_t text_size = sizeof(ElementTextDefault) - sizeof(Element) + (text.Length() + 1) * sizeof(word);
+	text_size += MemoryUsageUtilities::GetVectorSize(lines);
+	for (size_t i = 0; i < lines.size(); ++i)
+		text_size += (lines[i].text.Length() + 1) * sizeof(word);
+	usage.Add(MemoryUsage::ELEMENTS, text_size);
+
+	size_t geometry_size = MemoryUsageUtilities::GetVectorSize(geometry) + decoration.GetMemoryUsage();
+	for (size_t i = 0; i < geometry.size(); ++i)
+		geometry_size += geometry[i].GetMemoryUsage();
+	usage.Add(MemoryUsage::GEOMETRY, geometry_size);
+}
+
 void ElementTextDefault::OnPropertyChange(const PropertyNameList& changed_properties)
 {
 	Element::OnPropertyChange(changed_properties);
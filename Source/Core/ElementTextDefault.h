@@ -76,6 +76,10 @@ public:
 	/// Prevents the element from dirtying its document's layout when its text is changed.
 	virtual void SuppressAutoLayout();
 
+	/// Adds an estimate of the memory held by the element, its text and its text geometry to a breakdown.
+	/// @param[out] usage The breakdown to add to.
+	virtual void GetMemoryUsage(MemoryUsage& usage);
+
 protected:
 	virtual void OnPropertyChange(const PropertyNameList& properties);
 
@@ -28,7 +28,9 @@
 #include "precompiled.h"
 #include <Rocket/Core/ElementUtilities.h>
 #include <queue>
+#include "ElementRenderCache.h"
 #include "FontFaceHandle.h"
+#include "GeometryBatch.h"
 #include "LayoutEngine.h"
 #include <Rocket/Core.h>
 
@@ -39,6 +41,8 @@ namespace Core {
 static void SetBox(Element* element);
 // Positions an element relative to an offset parent.
 static void SetElementOffset(Element* element, const Vector2f& offset);
+// Returns true if the element is currently rendering its subtree into its render cache.
+static bool IsRenderingCache(Element* element);
 
 Element* ElementUtilities::GetElementById(Element* root_element, const String& id)
 {
@@ -119,7 +123,11 @@ FontFaceHandle* ElementUtilities::GetFontFaceHandle(Element* element)
 	Font::Weight font_weight = (Font::Weight) element->GetProperty(FONT_WEIGHT)->value.Get< int >();
 	int font_size = Math::RealToInteger(element->ResolveProperty(FONT_SIZE, 0));
 
-	FontFaceHandle* font = FontDatabase::GetFontFaceHandle(font_family, font_charset, font_style, font_weight, font_size);
+	// Render from the face's distance fields if the element's renderer can shade them.
+	RenderInterface* render_interface = element->GetRenderInterface();
+	bool distance_field = render_interface != NULL && render_interface->SupportsTextShader();
+
+	FontFaceHandle* font = FontDatabase::GetFontFaceHandle(font_family, font_charset, font_style, font_weight, font_size, distance_field);
 	return font;
 }
 
@@ -190,6 +198,25 @@ void ElementUtilities::BindEventAttributes(Element* element)
 // Generates the clipping region for an element.
 bool ElementUtilities::GetClippingRegion(Vector2i& clip_origin, Vector2i& clip_dimensions, Element* element)
 {
+	// The clipping region depends on the offsets of the element's ancestors, so it is stale if its parent's offset
+	// generation has changed.
+	unsigned int offset_generation = 0;
+	Element* parent = element->GetParentNode();
+	if (parent != NULL)
+	{
+		parent->UpdateLayout();
+		parent->UpdateAbsoluteOffset();
+		offset_generation = parent->offset_generation;
+	}
+
+	// Use the element's cached clipping region if nothing above it has changed since it was last resolved.
+	if (element->IsClippingRegionValid(offset_generation))
+	{
+		clip_origin = element->clipping_region_origin;
+		clip_dimensions = element->clipping_region_dimensions;
+		return element->clipping_region_enabled;
+	}
+
 	clip_origin = Vector2i(-1, -1);
 	clip_dimensions = Vector2i(-1, -1);
 	
@@ -197,6 +224,10 @@ bool ElementUtilities::GetClippingRegion(Vector2i& clip_origin, Vector2i& clip_d
 	if (num_ignored_clips < 0)
 		return false;
 
+	// An element being rendered into its own render cache isn't clipped by anything above it.
+	if (IsRenderingCache(element))
+		return false;
+
 	// Search through the element's ancestors, finding all elements that clip their overflow and have overflow to clip.
 	// For each that we find, we combine their clipping region with the existing clipping region, and so build up a
 	// complete clipping region for the element.
@@ -252,11 +283,20 @@ bool ElementUtilities::GetClippingRegion(Vector2i& clip_origin, Vector2i& clip_d
 		
 		num_ignored_clips = Math::Max(num_ignored_clips, clipping_element_ignore_clips);
 
+		// Nothing above an element being rendered into its render cache clips its descendants.
+		if (IsRenderingCache(clipping_element))
+			break;
+
 		// Climb the tree to this region's parent.
 		clipping_element = clipping_element->GetParentNode();
 	}
-	
-	return clip_dimensions.x >= 0 && clip_dimensions.y >= 0;
+
+	element->clipping_region_origin = clip_origin;
+	element->clipping_region_dimensions = clip_dimensions;
+	element->clipping_region_enabled = clip_dimensions.x >= 0 && clip_dimensions.y >= 0;
+	element->ValidateClippingRegion(offset_generation);
+
+	return element->clipping_region_enabled;
 }
 
 // Sets the clipping region from an element and its ancestors.
@@ -279,7 +319,7 @@ bool ElementUtilities::SetClippingRegion(Element* element, Context* context)
 	if (!render_interface || !context)
 		return false;
 	
-	Vector2i clip_origin, clip_dimensions;
+	Vector2i clip_origin(-1, -1), clip_dimensions(-1, -1);
 	bool clip = element && GetClippingRegion(clip_origin, clip_dimensions, element);
 	
 	Vector2i current_origin;
@@ -303,13 +343,40 @@ void ElementUtilities::ApplyActiveClipRegion(Context* context, RenderInterface*
 	Vector2i dimensions;
 	bool clip_enabled = context->GetActiveClipRegion(origin, dimensions);
 
-	render_interface->EnableScissorRegion(clip_enabled);
-	if (clip_enabled)
+	// If we don't know what state the render interface is in, forget the last region we sent it and reapply.
+	if (context->scissor_dirty)
+	{
+		GeometryBatch::Flush(render_interface);
+		render_interface->EnableScissorRegion(clip_enabled);
+		context->scissor_enabled = clip_enabled;
+		context->scissor_dimensions = Vector2i(-1, -1);
+		context->scissor_dirty = false;
+	}
+	// Otherwise only send the render interface what has changed since the scissor state was last applied.
+	else if (context->scissor_enabled != clip_enabled)
+	{
+		GeometryBatch::Flush(render_interface);
+		render_interface->EnableScissorRegion(clip_enabled);
+		context->scissor_enabled = clip_enabled;
+	}
+
+	if (clip_enabled &&
+		(context->scissor_origin != origin ||
+		 context->scissor_dimensions != dimensions))
 	{
+		GeometryBatch::Flush(render_interface);
 		render_interface->SetScissorRegion(origin.x, origin.y, dimensions.x, dimensions.y);
+		context->scissor_origin = origin;
+		context->scissor_dimensions = dimensions;
 	}
 }
 
+// Renders any geometry deferred to be batched together through a render interface.
+void ElementUtilities::FlushGeometry(RenderInterface* render_interface)
+{
+	GeometryBatch::Flush(render_interface);
+}
+
 // Formats the contents of an element.
 bool ElementUtilities::FormatElement(Element* element, const Vector2f& containing_block)
 {
@@ -439,5 +506,12 @@ static void SetElementOffset(Element* element, const Vector2f& offset)
 	element->SetOffset(relative_offset, element->GetParentNode());
 }
 
+// Returns true if the element is currently rendering its subtree into its render cache.
+static bool IsRenderingCache(Element* element)
+{
+	ElementRenderCache* render_cache = element->GetElementRenderCache();
+	return render_cache != NULL && render_cache->IsRendering();
+}
+
 }
 }
@@ -27,6 +27,7 @@
 
 #include "precompiled.h"
 #include "EventDispatcher.h"
+#include "ParallelLayout.h"
 #include <Rocket/Core/Element.h>
 #include <Rocket/Core/Event.h>
 #include <Rocket/Core/EventListener.h>
@@ -112,6 +113,13 @@ void EventDispatcher::DetachAllEvents()
 
 bool EventDispatcher::DispatchEvent(Element* target_element, const String& name, const Dictionary& parameters, bool interruptible)
 {
+	ROCKET_PROFILE_ZONE("EventDispatcher::DispatchEvent");
+
+	// Events raised while the target's document is being laid out on several threads are dispatched once the layout
+	// has finished.
+	if (ParallelLayout::DeferEvent(target_element, name, parameters, interruptible))
+		return true;
+
 	//Event event(target_element, name, parameters, interruptible);
 	Event* event = Factory::InstanceEvent(target_element, name, parameters, interruptible);
 	if (event == NULL)
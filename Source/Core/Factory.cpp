@@ -45,6 +45,7 @@
 #include "PropertyParserColour.h"
 #include "StreamFile.h"
 #include "StyleSheetFactory.h"
+#include "Threading.h"
 #include "XMLNodeHandlerBody.h"
 #include "XMLNodeHandlerDefault.h"
 #include "XMLNodeHandlerHead.h"
@@ -66,6 +67,10 @@ static DecoratorInstancerMap decorator_instancers;
 typedef std::map< String, FontEffectInstancer* > FontEffectInstancerMap;
 static FontEffectInstancerMap font_effect_instancers;
 
+// Protects the instancer maps. Instancers should still be registered before contexts are updated on other threads,
+// as an instancer that is replaced is released while it may be in use.
+static Mutex instancer_mutex;
+
 // The context instancer.
 static ContextInstancer* context_instancer = NULL;
 
@@ -179,6 +184,8 @@ ElementInstancer* Factory::RegisterElementInstancer(const String& name, ElementI
 	String lower_case_name = name.ToLower();
 	instancer->AddReference();
 
+	MutexLock lock(instancer_mutex);
+
 	// Check if an instancer for this tag is already defined, if so release it
 	ElementInstancerMap::iterator itr = element_instancers.find(lower_case_name);
 	if (itr != element_instancers.end())
@@ -193,6 +200,8 @@ ElementInstancer* Factory::RegisterElementInstancer(const String& name, ElementI
 // Looks up the instancer for the given element
 ElementInstancer* Factory::GetElementInstancer(const String& tag)
 {
+	MutexLock lock(instancer_mutex);
+
 	ElementInstancerMap::iterator instancer_iterator = element_instancers.find(tag);
 	if (instancer_iterator == element_instancers.end())
 	{
@@ -305,6 +314,25 @@ bool Factory::InstanceElementStream(Element* parent, Stream* stream)
 // Instances a element tree based on the stream
 ElementDocument* Factory::InstanceDocumentStream(Rocket::Core::Context* context, Stream* stream)
 {
+	XMLParser* parser;
+	ElementDocument* document = BeginDocumentStream(context, stream, parser);
+	if (!document)
+		return NULL;
+
+	document->lock_layout = true;
+	parser->ContinueParse(-1, -1);
+	document->lock_layout = false;
+
+	delete parser;
+
+	return document;
+}
+
+// Instances an empty document and begins parsing a stream into it incrementally.
+ElementDocument* Factory::BeginDocumentStream(Rocket::Core::Context* context, Stream* stream, XMLParser*& parser)
+{
+	parser = NULL;
+
 	Element* element = Factory::InstanceElement(NULL, "body", "body", XMLAttributes());
 	if (!element)
 	{
@@ -319,13 +347,10 @@ ElementDocument* Factory::InstanceDocumentStream(Rocket::Core::Context* context,
 		return NULL;
 	}
 
-	document->lock_layout = true;
 	document->context = context;
 
-	XMLParser parser(element);
-	parser.Parse(stream);
-
-	document->lock_layout = false;
+	parser = new XMLParser(element);
+	parser->BeginParse(stream);
 
 	return document;
 }
@@ -336,6 +361,8 @@ DecoratorInstancer* Factory::RegisterDecoratorInstancer(const String& name, Deco
 	String lower_case_name = name.ToLower();
 	instancer->AddReference();
 
+	MutexLock lock(instancer_mutex);
+
 	// Check if an instancer for this tag is already defined. If so, release it.
 	DecoratorInstancerMap::iterator iterator = decorator_instancers.find(lower_case_name);
 	if (iterator != decorator_instancers.end())
@@ -351,12 +378,19 @@ Decorator* Factory::InstanceDecorator(const String& name, const PropertyDictiona
 	float z_index = 0;
 	int specificity = -1;
 
-	DecoratorInstancerMap::iterator iterator = decorator_instancers.find(name);
-	if (iterator == decorator_instancers.end())
-		return NULL;
+	DecoratorInstancer* instancer;
+	{
+		MutexLock lock(instancer_mutex);
+
+		DecoratorInstancerMap::iterator iterator = decorator_instancers.find(name);
+		if (iterator == decorator_instancers.end())
+			return NULL;
+
+		instancer = (*iterator).second;
+	}
 
 	// Turn the generic, un-parsed properties we've got into a properly parsed dictionary.
-	const PropertySpecification& property_specification = (*iterator).second->GetPropertySpecification();
+	const PropertySpecification& property_specification = instancer->GetPropertySpecification();
 
 	PropertyDictionary parsed_properties;
 	for (PropertyMap::const_iterator i = properties.GetProperties().begin(); i != properties.GetProperties().end(); ++i)
@@ -373,13 +407,13 @@ Decorator* Factory::InstanceDecorator(const String& name, const PropertyDictiona
 	// Set the property defaults for all unset properties.
 	property_specification.SetPropertyDefaults(parsed_properties);
 
-	Decorator* decorator = (*iterator).second->InstanceDecorator(name, parsed_properties);
+	Decorator* decorator = instancer->InstanceDecorator(name, parsed_properties);
 	if (decorator == NULL)
 		return NULL;
 
 	decorator->SetZIndex(z_index);
 	decorator->SetSpecificity(specificity);
-	decorator->instancer = (*iterator).second;
+	decorator->instancer = instancer;
 	return decorator;
 }
 
@@ -389,6 +423,8 @@ FontEffectInstancer* Factory::RegisterFontEffectInstancer(const String& name, Fo
 	String lower_case_name = name.ToLower();
 	instancer->AddReference();
 
+	MutexLock lock(instancer_mutex);
+
 	// Check if an instancer for this tag is already defined. If so, release it.
 	FontEffectInstancerMap::iterator iterator = font_effect_instancers.find(lower_case_name);
 	if (iterator != font_effect_instancers.end())
@@ -409,14 +445,19 @@ FontEffect* Factory::InstanceFontEffect(const String& name, const PropertyDictio
 
 	int specificity = -1;
 
-	FontEffectInstancerMap::iterator iterator = font_effect_instancers.find(name);
-	if (iterator == font_effect_instancers.end())
-		return NULL;
+	FontEffectInstancer* instancer;
+	{
+		MutexLock lock(instancer_mutex);
+
+		FontEffectInstancerMap::iterator iterator = font_effect_instancers.find(name);
+		if (iterator == font_effect_instancers.end())
+			return NULL;
 
-	FontEffectInstancer* instancer = iterator->second;
+		instancer = iterator->second;
+	}
 
 	// Turn the generic, un-parsed properties we've got into a properly parsed dictionary.
-	const PropertySpecification& property_specification = (*iterator).second->GetPropertySpecification();
+	const PropertySpecification& property_specification = instancer->GetPropertySpecification();
 
 	PropertyDictionary parsed_properties;
 	for (PropertyMap::const_iterator i = properties.GetProperties().begin(); i != properties.GetProperties().end(); ++i)
@@ -474,7 +515,7 @@ FontEffect* Factory::InstanceFontEffect(const String& name, const PropertyDictio
 	}
 
 	// Now we can actually instance the effect!
-	FontEffect* font_effect = (*iterator).second->InstanceFontEffect(name, parsed_properties);
+	FontEffect* font_effect = instancer->InstanceFontEffect(name, parsed_properties);
 	if (font_effect == NULL)
 		return NULL;
 
@@ -488,7 +529,7 @@ FontEffect* Factory::InstanceFontEffect(const String& name, const PropertyDictio
 		font_effect->SetColour(colour);
 
 	font_effect->SetSpecificity(specificity);
-	font_effect->instancer = (*iterator).second;
+	font_effect->instancer = instancer;
 	return font_effect;
 }
 
@@ -49,6 +49,13 @@ size_t FileInterface::Length(FileHandle file)
     return length;
 }
 
+// Maps the entire contents of a previously opened file into memory.
+const void* FileInterface::Map(FileHandle ROCKET_UNUSED(file), size_t& size)
+{
+	size = 0;
+	return NULL;
+}
+
 // Called when this file interface is released.
 void FileInterface::Release()
 {
@@ -30,11 +30,21 @@
 
 #ifndef ROCKET_NO_FILE_INTERFACE_DEFAULT
 
+#ifdef ROCKET_PLATFORM_WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 namespace Rocket {
 namespace Core {
 
 FileInterfaceDefault::~FileInterfaceDefault()
 {
+	for (FileMappingMap::iterator i = mappings.begin(); i != mappings.end(); ++i)
+		Unmap((*i).second);
 }
 
 // Opens a file.
@@ -46,6 +56,17 @@ FileHandle FileInterfaceDefault::Open(const String& path)
 // Closes a previously opened file.
 void FileInterfaceDefault::Close(FileHandle file)
 {
+	{
+		MutexLock lock(mapping_mutex);
+
+		FileMappingMap::iterator i = mappings.find(file);
+		if (i != mappings.end())
+		{
+			Unmap((*i).second);
+			mappings.erase(i);
+		}
+	}
+
 	fclose((FILE*) file);
 }
 
@@ -67,6 +88,81 @@ size_t FileInterfaceDefault::Tell(FileHandle file)
 	return ftell((FILE*) file);
 }
 
+// Maps the entire contents of a previously opened file into memory.
+const void* FileInterfaceDefault::Map(FileHandle file, size_t& size)
+{
+	size = 0;
+
+	MutexLock lock(mapping_mutex);
+
+	FileMappingMap::iterator i = mappings.find(file);
+	if (i != mappings.end())
+	{
+		size = (*i).second.size;
+		return (*i).second.data;
+	}
+
+	FileMapping mapping;
+	mapping.data = NULL;
+	mapping.size = 0;
+
+#ifdef ROCKET_PLATFORM_WIN32
+	HANDLE file_handle = (HANDLE) _get_osfhandle(_fileno((FILE*) file));
+	if (file_handle == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file_handle, &file_size) ||
+		file_size.QuadPart <= 0 ||
+		(ULONGLONG) file_size.QuadPart > (size_t) -1)
+		return NULL;
+
+	mapping.mapping_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping.mapping_handle == NULL)
+		return NULL;
+
+	mapping.data = MapViewOfFile(mapping.mapping_handle, FILE_MAP_READ, 0, 0, 0);
+	if (mapping.data == NULL)
+	{
+		CloseHandle(mapping.mapping_handle);
+		return NULL;
+	}
+
+	mapping.size = (size_t) file_size.QuadPart;
+#else
+	int descriptor = fileno((FILE*) file);
+
+	struct stat file_status;
+	if (fstat(descriptor, &file_status) != 0 ||
+		!S_ISREG(file_status.st_mode) ||
+		file_status.st_size <= 0)
+		return NULL;
+
+	void* data = mmap(NULL, (size_t) file_status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	if (data == MAP_FAILED)
+		return NULL;
+
+	mapping.data = data;
+	mapping.size = (size_t) file_status.st_size;
+#endif
+
+	mappings[file] = mapping;
+
+	size = mapping.size;
+	return mapping.data;
+}
+
+// Unmaps a file's contents.
+void FileInterfaceDefault::Unmap(const FileMapping& mapping)
+{
+#ifdef ROCKET_PLATFORM_WIN32
+	UnmapViewOfFile(mapping.data);
+	CloseHandle(mapping.mapping_handle);
+#else
+	munmap(mapping.data, mapping.size);
+#endif
+}
+
 }
 }
 
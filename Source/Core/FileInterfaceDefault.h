@@ -29,6 +29,7 @@
 #define ROCKETCOREFILEINTERFACEDEFAULT_H
 
 #include <Rocket/Core/FileInterface.h>
+#include "Threading.h"
 
 #ifndef ROCKET_NO_FILE_INTERFACE_DEFAULT
 
@@ -36,7 +37,8 @@ namespace Rocket {
 namespace Core {
 
 /**
-	Implementation of the Rocket file interface using the Standard C file functions.
+	Implementation of the Rocket file interface using the Standard C file functions. Files are mapped into memory
+	with the platform's file mapping functions when they are parsed.
 
 	@author Peter Curry
  */
@@ -70,6 +72,30 @@ public:
 	/// @param file The handle of the file to be queried.
 	/// @return The number of bytes from the origin of the file.
 	virtual size_t Tell(FileHandle file);
+
+	/// Maps the entire contents of a previously opened file into memory.
+	/// @param file The handle of the file to map.
+	/// @param[out] size The length of the mapped data in bytes.
+	/// @return The file's contents, or NULL if the file can't be mapped.
+	virtual const void* Map(FileHandle file, size_t& size);
+
+private:
+	struct FileMapping
+	{
+		void* data;
+		size_t size;
+#ifdef ROCKET_PLATFORM_WIN32
+		void* mapping_handle;
+#endif
+	};
+
+	// Unmaps a file's contents.
+	void Unmap(const FileMapping& mapping);
+
+	typedef std::map< FileHandle, FileMapping > FileMappingMap;
+	FileMappingMap mappings;
+	// Guards the mappings, as files may be opened from several threads.
+	Mutex mapping_mutex;
 };
 
 }
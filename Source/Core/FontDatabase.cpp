@@ -27,7 +27,11 @@
 
 #include "precompiled.h"
 #include <Rocket/Core/FontDatabase.h>
+#include "FontFace.h"
 #include "FontFamily.h"
+#include "StreamFile.h"
+#include "TextureDatabase.h"
+#include "Threading.h"
 #include <Rocket/Core.h>
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -42,6 +46,16 @@ FontEffectCache font_effect_cache;
 
 static FT_Library ft_library = NULL;
 
+// Protects the font families and their faces, so existing handles can be fetched by several threads at once.
+static ReadWriteLock family_lock;
+
+// Closes the file a face was read from in place; FreeType calls this when the face is destroyed.
+static void ReleaseFaceStream(void* object)
+{
+	FT_Face face = (FT_Face) object;
+	((Stream*) face->generic.data)->RemoveReference();
+}
+
 FontDatabase::FontDatabase()
 {
 	ROCKET_ASSERT(instance == NULL);
@@ -92,7 +106,8 @@ void FontDatabase::Shutdown()
 // Loads a new font face.
 bool FontDatabase::LoadFontFace(const String& file_name)
 {
-	FT_Face ft_face = (FT_Face) instance->LoadFace(file_name);
+	bool release_stream;
+	FT_Face ft_face = (FT_Face) instance->LoadFace(file_name, release_stream);
 	if (ft_face == NULL)
 	{
 		Log::Message(Log::LT_ERROR, "Failed to load font face from %s.", file_name.CString());
@@ -102,7 +117,7 @@ bool FontDatabase::LoadFontFace(const String& file_name)
 	Font::Style style = ft_face->style_flags & FT_STYLE_FLAG_ITALIC ? Font::STYLE_ITALIC : Font::STYLE_NORMAL;
 	Font::Weight weight = ft_face->style_flags & FT_STYLE_FLAG_BOLD ? Font::WEIGHT_BOLD : Font::WEIGHT_NORMAL;
 
-	if (instance->AddFace(ft_face, ft_face->family_name, style, weight, true))
+	if (instance->AddFace(ft_face, ft_face->family_name, style, weight, release_stream))
 	{
 		Log::Message(Log::LT_INFO, "Loaded font face %s %s (from %s).", ft_face->family_name, ft_face->style_name, file_name.CString());
 		return true;
@@ -117,14 +132,15 @@ bool FontDatabase::LoadFontFace(const String& file_name)
 // Adds a new font face to the database, ignoring any family, style and weight information stored in the face itself.
 bool FontDatabase::LoadFontFace(const String& file_name, const String& family, Font::Style style, Font::Weight weight)
 {
-	FT_Face ft_face = (FT_Face) instance->LoadFace(file_name);
+	bool release_stream;
+	FT_Face ft_face = (FT_Face) instance->LoadFace(file_name, release_stream);
 	if (ft_face == NULL)
 	{
 		Log::Message(Log::LT_ERROR, "Failed to load font face from %s.", file_name.CString());
 		return false;
 	}
 
-	if (instance->AddFace(ft_face, family, style, weight, true))
+	if (instance->AddFace(ft_face, family, style, weight, release_stream))
 	{
 		Log::Message(Log::LT_INFO, "Loaded font face %s %s (from %s).", ft_face->family_name, ft_face->style_name, file_name.CString());
 		return true;
@@ -184,13 +200,36 @@ bool FontDatabase::LoadFontFace(const byte* data, int data_length, const String&
 }
 
 // Returns a handle to a font face that can be used to position and render text.
-FontFaceHandle* FontDatabase::GetFontFaceHandle(const String& family, const String& charset, Font::Style style, Font::Weight weight, int size)
+FontFaceHandle* FontDatabase::GetFontFaceHandle(const String& family, const String& charset, Font::Style style, Font::Weight weight, int size, bool distance_field)
 {
-	FontFamilyMap::iterator iterator = instance->font_families.find(family);
-	if (iterator == instance->font_families.end())
-		return NULL;
+	// Most handles have already been generated, and can be found without blocking other threads. Families and faces
+	// aren't destroyed until the database is, so they can be used once the lock is released.
+	FontFamily* font_family = NULL;
+	FontFace* distance_field_face = NULL;
+	{
+		ReadLock read_lock(family_lock);
+
+		FontFamilyMap::iterator iterator = instance->font_families.find(family);
+		if (iterator == instance->font_families.end())
+			return NULL;
+
+		font_family = (*iterator).second;
+
+		FontFaceHandle* handle = font_family->FindFaceHandle(charset, style, weight, size, distance_field);
+		if (handle != NULL)
+			return handle;
+
+		if (distance_field)
+			distance_field_face = font_family->GetMatchingFace(style, weight);
+	}
 
-	return (*iterator).second->GetFaceHandle(charset, style, weight, size);
+	// The face's distance fields are generated on the task pool, so they are generated before the lock is taken.
+	if (distance_field_face != NULL)
+		distance_field_face->GenerateDistanceField(charset);
+
+	// Generating a new handle renders its glyphs, so only one thread may fetch one at a time.
+	MutexLock lock(TextureDatabase::GetMutex());
+	return font_family->GetFaceHandle(charset, style, weight, size, distance_field);
 }
 
 // Returns a font effect, either a newly-instanced effect from the factory or an identical shared
@@ -224,14 +263,16 @@ FontEffect* FontDatabase::GetFontEffect(const String& name, const PropertyDictio
 	for (PropertyList::iterator i = sorted_properties.begin(); i != sorted_properties.end(); ++i)
 		key += i->first + ":" + i->second + ";";
 
-	// Check if we have a previously instanced effect.
+	MutexLock lock(TextureDatabase::GetMutex());
+
+	// Check if we have a previously instanced effect. An effect may still be in the cache while it is being released
+	// on another thread; if so, we replace it.
 	FontEffectCache::iterator i = font_effect_cache.find(key);
 	if (i != font_effect_cache.end())
 	{
 		FontEffect* effect = i->second;
-		effect->AddReference();
-
-		return effect;
+		if (effect->AddReferenceIfReferenced())
+			return effect;
 	}
 
 	FontEffect* font_effect = Factory::InstanceFontEffect(name, properties);
@@ -245,6 +286,8 @@ FontEffect* FontDatabase::GetFontEffect(const String& name, const PropertyDictio
 // Removes a font effect from the font database's cache.
 void FontDatabase::ReleaseFontEffect(const FontEffect* effect)
 {
+	MutexLock lock(TextureDatabase::GetMutex());
+
 	for (FontEffectCache::iterator i = font_effect_cache.begin(); i != font_effect_cache.end(); ++i)
 	{
 		if (i->second == effect)
@@ -258,6 +301,9 @@ void FontDatabase::ReleaseFontEffect(const FontEffect* effect)
 // Adds a loaded face to the appropriate font family.
 bool FontDatabase::AddFace(void* face, const String& family, Font::Style style, Font::Weight weight, bool release_stream)
 {
+	MutexLock lock(TextureDatabase::GetMutex());
+	WriteLock write_lock(family_lock);
+
 	FontFamily* font_family = NULL;
 	FontFamilyMap::iterator iterator = instance->font_families.find(family);
 	if (iterator != instance->font_families.end())
@@ -272,28 +318,51 @@ bool FontDatabase::AddFace(void* face, const String& family, Font::Style style,
 }
 
 // Loads a FreeType face.
-void* FontDatabase::LoadFace(const String& file_name)
+void* FontDatabase::LoadFace(const String& file_name, bool& release_stream)
 {
-	FileInterface* file_interface = GetFileInterface();
-	FileHandle handle = file_interface->Open(file_name);
+	release_stream = false;
 
-	if (!handle)
+	StreamFile* stream = new StreamFile();
+	if (!stream->Open(file_name))
 	{
+		stream->RemoveReference();
 		return NULL;
 	}
 
-	size_t length = file_interface->Length(handle);
+	// If the file is mapped, FreeType can read it in place; the stream is then kept open for as long as the face is.
+	size_t length;
+	const byte* data = stream->GetContiguousData(length);
+	if (data != NULL)
+	{
+		FT_Face face = (FT_Face) LoadFace(data, (int) length, file_name, false);
+		if (face == NULL)
+		{
+			stream->RemoveReference();
+			return NULL;
+		}
+
+		face->generic.data = stream;
+		face->generic.finalizer = ReleaseFaceStream;
+
+		return face;
+	}
+
+	length = stream->Length();
 
 	FT_Byte* buffer = new FT_Byte[length];
-	file_interface->Read(buffer, length, handle);
-	file_interface->Close(handle);
+	stream->Read(buffer, length);
+	stream->RemoveReference();
 
+	release_stream = true;
 	return LoadFace(buffer, length, file_name, true);
 }
 
 // Loads a FreeType face from memory.
 void* FontDatabase::LoadFace(const byte* data, int data_length, const String& source, bool local_data)
 {
+	// FreeType libraries can't create faces on more than one thread at a time.
+	MutexLock lock(TextureDatabase::GetMutex());
+
 	FT_Face face = NULL;
 	int error = FT_New_Memory_Face(ft_library, (const FT_Byte*) data, data_length, 0, &face);
 	if (error != 0)
@@ -0,0 +1,418 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "FontDistanceField.h"
+#include <Rocket/Core/Log.h>
+#include FT_OUTLINE_H
+#include "TaskPool.h"
+
+namespace Rocket {
+namespace Core {
+
+// The size, in pixels per em, glyphs' distance fields are generated at.
+static const float REFERENCE_SIZE = 32;
+// The distance, in reference pixels, distance fields extend either side of the glyphs' outlines.
+static const int SPREAD = 8;
+// The number of line segments each curve of an outline is flattened into.
+static const int CURVE_SEGMENTS = 8;
+
+// A straight edge of a glyph's flattened outline, in reference pixels with the y-axis pointing up.
+struct OutlineSegment
+{
+	Vector2f begin;
+	Vector2f end;
+};
+
+typedef std::vector< OutlineSegment > OutlineSegmentList;
+
+// Flattens the outline of a glyph into a list of line segments, as it is decomposed by FreeType.
+struct OutlineBuilder
+{
+	OutlineSegmentList* segments;
+	Vector2f position;
+	float scale;
+
+	Vector2f Transform(const FT_Vector* point) const
+	{
+		return Vector2f(point->x * scale, point->y * scale);
+	}
+
+	void AddSegment(const Vector2f& end)
+	{
+		OutlineSegment segment;
+		segment.begin = position;
+		segment.end = end;
+		segments->push_back(segment);
+
+		position = end;
+	}
+};
+
+static int MoveTo(const FT_Vector* to, void* user)
+{
+	OutlineBuilder* builder = (OutlineBuilder*) user;
+	builder->position = builder->Transform(to);
+	return 0;
+}
+
+static int LineTo(const FT_Vector* to, void* user)
+{
+	OutlineBuilder* builder = (OutlineBuilder*) user;
+	builder->AddSegment(builder->Transform(to));
+	return 0;
+}
+
+static int ConicTo(const FT_Vector* control, const FT_Vector* to, void* user)
+{
+	OutlineBuilder* builder = (OutlineBuilder*) user;
+
+	Vector2f p0 = builder->position;
+	Vector2f p1 = builder->Transform(control);
+	Vector2f p2 = builder->Transform(to);
+
+	for (int i = 1; i <= CURVE_SEGMENTS; ++i)
+	{
+		float t = i / (float) CURVE_SEGMENTS;
+		float u = 1 - t;
+		builder->AddSegment(p0 * (u * u) + p1 * (2 * u * t) + p2 * (t * t));
+	}
+
+	return 0;
+}
+
+static int CubicTo(const FT_Vector* control_1, const FT_Vector* control_2, const FT_Vector* to, void* user)
+{
+	OutlineBuilder* builder = (OutlineBuilder*) user;
+
+	Vector2f p0 = builder->position;
+	Vector2f p1 = builder->Transform(control_1);
+	Vector2f p2 = builder->Transform(control_2);
+	Vector2f p3 = builder->Transform(to);
+
+	for (int i = 1; i <= CURVE_SEGMENTS; ++i)
+	{
+		float t = i / (float) CURVE_SEGMENTS;
+		float u = 1 - t;
+		builder->AddSegment(p0 * (u * u * u) + p1 * (3 * u * u * t) + p2 * (3 * u * t * t) + p3 * (t * t * t));
+	}
+
+	return 0;
+}
+
+/**
+	Generates the distance field of a single glyph from its flattened outline.
+ */
+
+class DistanceFieldTask : public Task
+{
+public:
+	DistanceFieldTask(std::vector< byte >& _distance_field) : distance_field(_distance_field)
+	{
+	}
+
+	virtual void Execute()
+	{
+		distance_field.resize(dimensions.x * dimensions.y);
+
+		const float max_distance = (float) SPREAD;
+
+		for (int y = 0; y < dimensions.y; ++y)
+		{
+			float point_y = top_left.y - y - 0.5f;
+
+			for (int x = 0; x < dimensions.x; ++x)
+			{
+				float point_x = top_left.x + x + 0.5f;
+
+				// Find the distance to the nearest edge, and the winding number of the outline around the texel
+				// centre to determine if it is inside the glyph.
+				float min_distance_squared = max_distance * max_distance;
+				int winding = 0;
+
+				for (size_t i = 0; i < segments.size(); ++i)
+				{
+					const OutlineSegment& segment = segments[i];
+
+					if ((segment.begin.y <= point_y) != (segment.end.y <= point_y))
+					{
+						float t = (point_y - segment.begin.y) / (segment.end.y - segment.begin.y);
+						if (segment.begin.x + t * (segment.end.x - segment.begin.x) > point_x)
+							winding += segment.end.y > segment.begin.y ? 1 : -1;
+					}
+
+					float edge_x = segment.end.x - segment.begin.x;
+					float edge_y = segment.end.y - segment.begin.y;
+					float offset_x = point_x - segment.begin.x;
+					float offset_y = point_y - segment.begin.y;
+
+					float edge_length_squared = edge_x * edge_x + edge_y * edge_y;
+					float t = 0;
+					if (edge_length_squared > 0)
+						t = Math::Clamp((offset_x * edge_x + offset_y * edge_y) / edge_length_squared, 0.0f, 1.0f);
+
+					offset_x -= edge_x * t;
+					offset_y -= edge_y * t;
+					min_distance_squared = Math::Min(min_distance_squared, offset_x * offset_x + offset_y * offset_y);
+				}
+
+				float distance = Math::SquareRoot(min_distance_squared);
+				if (winding == 0)
+					distance = -distance;
+
+				float value = 0.5f + distance / (2 * max_distance);
+				distance_field[y * dimensions.x + x] = (byte) Math::Round(Math::Clamp(value, 0.0f, 1.0f) * 255);
+			}
+		}
+	}
+
+	OutlineSegmentList segments;
+	Vector2i top_left;
+	Vector2i dimensions;
+
+private:
+	std::vector< byte >& distance_field;
+};
+
+FontDistanceField::FontDistanceField()
+{
+}
+
+FontDistanceField::~FontDistanceField()
+{
+	for (size_t i = 0; i < tasks.size(); ++i)
+		delete tasks[i];
+}
+
+// Reads the outlines of a face's glyphs, ready for their distance fields to be generated.
+bool FontDistanceField::Initialise(FT_Face ft_face, const UnicodeRangeList& charset)
+{
+	if (!FT_IS_SCALABLE(ft_face))
+		return false;
+
+	unsigned int max_codepoint = 0;
+	for (size_t i = 0; i < charset.size(); ++i)
+		max_codepoint = Math::Max(max_codepoint, charset[i].max_codepoint);
+
+	glyphs.resize(max_codepoint + 1, Glyph());
+	distance_fields.resize(max_codepoint + 1);
+
+	FT_Outline_Funcs outline_functions;
+	outline_functions.move_to = (FT_Outline_MoveToFunc) MoveTo;
+	outline_functions.line_to = (FT_Outline_LineToFunc) LineTo;
+	outline_functions.conic_to = (FT_Outline_ConicToFunc) ConicTo;
+	outline_functions.cubic_to = (FT_Outline_CubicToFunc) CubicTo;
+	outline_functions.shift = 0;
+	outline_functions.delta = 0;
+
+	// Flatten the outline of each glyph, and lay out its distance field in the atlas. FreeType faces can't be shared
+	// between threads, so this is done up front.
+	for (size_t i = 0; i < charset.size(); ++i)
+	{
+		for (unsigned int character = Math::Max< unsigned int >(charset[i].min_codepoint, 32); character <= charset[i].max_codepoint; ++character)
+		{
+			if (glyphs[character].texture_index >= 0)
+				continue;
+
+			FT_UInt index = FT_Get_Char_Index(ft_face, character);
+			if (index == 0)
+				continue;
+
+			FT_Error error = FT_Load_Glyph(ft_face, index, FT_LOAD_NO_SCALE | FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP);
+			if (error != 0)
+			{
+				Log::Message(Log::LT_WARNING, "Unable to load glyph for character '%u' on the font face '%s %s'; error code: %d.", character, ft_face->family_name, ft_face->style_name, error);
+				continue;
+			}
+
+			if (ft_face->glyph->format != FT_GLYPH_FORMAT_OUTLINE)
+				continue;
+
+			DistanceFieldTask* task = new DistanceFieldTask(distance_fields[character]);
+
+			OutlineBuilder builder;
+			builder.segments = &task->segments;
+			builder.scale = REFERENCE_SIZE / ft_face->units_per_EM;
+			FT_Outline_Decompose(&ft_face->glyph->outline, &outline_functions, &builder);
+
+			// Glyphs without outlines, such as spaces, have nothing to render.
+			if (task->segments.empty())
+			{
+				delete task;
+				continue;
+			}
+
+			Vector2f minimum = task->segments[0].begin;
+			Vector2f maximum = task->segments[0].begin;
+			for (size_t j = 0; j < task->segments.size(); ++j)
+			{
+				minimum.x = Math::Min(minimum.x, task->segments[j].end.x);
+				minimum.y = Math::Min(minimum.y, task->segments[j].end.y);
+				maximum.x = Math::Max(maximum.x, task->segments[j].end.x);
+				maximum.y = Math::Max(maximum.y, task->segments[j].end.y);
+			}
+
+			task->top_left = Vector2i(Math::RoundDown(minimum.x) - SPREAD, Math::RoundUp(maximum.y) + SPREAD);
+			Vector2i bottom_right(Math::RoundUp(maximum.x) + SPREAD, Math::RoundDown(minimum.y) - SPREAD);
+			task->dimensions = Vector2i(bottom_right.x - task->top_left.x, task->top_left.y - bottom_right.y);
+
+			Glyph& glyph = glyphs[character];
+			glyph.origin = Vector2f((float) task->top_left.x, (float) -task->top_left.y);
+			glyph.dimensions = Vector2f((float) task->dimensions.x, (float) task->dimensions.y);
+
+			texture_layout.AddRectangle(character, task->dimensions);
+			tasks.push_back(task);
+		}
+	}
+
+	return true;
+}
+
+// Generates the distance fields from the outlines, and lays them out in the atlas.
+bool FontDistanceField::Generate()
+{
+	// Generate the distance fields in parallel.
+	if (!tasks.empty())
+		TaskPool::Run(&tasks[0], (int) tasks.size());
+
+	for (size_t i = 0; i < tasks.size(); ++i)
+		delete tasks[i];
+	tasks.clear();
+
+	if (!texture_layout.GenerateLayout(512))
+		return false;
+
+	for (int i = 0; i < texture_layout.GetNumRectangles(); ++i)
+	{
+		TextureLayoutRectangle& rectangle = texture_layout.GetRectangle(i);
+		const TextureLayoutTexture& texture = texture_layout.GetTexture(rectangle.GetTextureIndex());
+		Glyph& glyph = glyphs[rectangle.GetId()];
+
+		glyph.texture_index = rectangle.GetTextureIndex();
+
+		glyph.texcoords[0].x = float(rectangle.GetPosition().x) / float(texture.GetDimensions().x);
+		glyph.texcoords[0].y = float(rectangle.GetPosition().y) / float(texture.GetDimensions().y);
+		glyph.texcoords[1].x = float(rectangle.GetPosition().x + rectangle.GetDimensions().x) / float(texture.GetDimensions().x);
+		glyph.texcoords[1].y = float(rectangle.GetPosition().y + rectangle.GetDimensions().y) / float(texture.GetDimensions().y);
+	}
+
+	for (int i = 0; i < texture_layout.GetNumTextures(); ++i)
+	{
+		Texture texture;
+		if (!texture.Load(String(64, "?distance-field::%p/%d", this, i)))
+			return false;
+
+		textures.push_back(texture);
+	}
+
+	return true;
+}
+
+// Returns the size, in pixels per em, the distance fields were generated at.
+float FontDistanceField::GetSize() const
+{
+	return REFERENCE_SIZE;
+}
+
+// Returns the distance the distance fields extend beyond the glyphs' outlines.
+float FontDistanceField::GetSpread() const
+{
+	return (float) SPREAD;
+}
+
+// Returns a character's quad in the atlas.
+const FontDistanceField::Glyph* FontDistanceField::GetGlyph(word character) const
+{
+	if (character >= glyphs.size() ||
+		glyphs[character].texture_index < 0)
+		return NULL;
+
+	return &glyphs[character];
+}
+
+// Returns one of the atlas's textures.
+const Texture* FontDistanceField::GetTexture(int index) const
+{
+	ROCKET_ASSERT(index >= 0);
+	ROCKET_ASSERT(index < GetNumTextures());
+
+	return &textures[index];
+}
+
+// Returns the number of textures in the atlas.
+int FontDistanceField::GetNumTextures() const
+{
+	return (int) textures.size();
+}
+
+// Generates the data of one of the atlas's textures.
+bool FontDistanceField::GenerateTexture(const byte*& texture_data, Vector2i& texture_dimensions, int texture_id)
+{
+	if (texture_id < 0 ||
+		texture_id >= texture_layout.GetNumTextures())
+		return false;
+
+	texture_data = texture_layout.GetTexture(texture_id).AllocateTexture();
+	texture_dimensions = texture_layout.GetTexture(texture_id).GetDimensions();
+
+	// Copy each glyph's distance field into the alpha channel of its rectangle.
+	for (int i = 0; i < texture_layout.GetNumRectangles(); ++i)
+	{
+		TextureLayoutRectangle& rectangle = texture_layout.GetRectangle(i);
+		if (rectangle.GetTextureIndex() != texture_id)
+			continue;
+
+		const std::vector< byte >& distance_field = distance_fields[rectangle.GetId()];
+		Vector2i dimensions = rectangle.GetDimensions();
+		if ((int) distance_field.size() != dimensions.x * dimensions.y)
+			continue;
+
+		byte* destination = rectangle.GetTextureData();
+		const byte* source = &distance_field[0];
+
+		for (int y = 0; y < dimensions.y; ++y)
+		{
+			for (int x = 0; x < dimensions.x; ++x)
+				destination[x * 4 + 3] = source[x];
+
+			destination += rectangle.GetTextureStride();
+			source += dimensions.x;
+		}
+	}
+
+	return true;
+}
+
+// Destroys the atlas.
+void FontDistanceField::OnReferenceDeactivate()
+{
+	delete this;
+}
+
+}
+}
@@ -0,0 +1,128 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREFONTDISTANCEFIELD_H
+#define ROCKETCOREFONTDISTANCEFIELD_H
+
+#include <Rocket/Core/ReferenceCountable.h>
+#include <Rocket/Core/Texture.h>
+#include "TextureLayout.h"
+#include "UnicodeRange.h"
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+namespace Rocket {
+namespace Core {
+
+class Task;
+
+/**
+	An atlas of signed distance fields generated from the outlines of a font face's glyphs. The distance fields are
+	generated once, at a reference size, and are shared by the face's handles of every size; each handle scales the
+	glyphs' quads to its own size, and renders them through the render interface's text shader.
+ */
+
+class FontDistanceField : public ReferenceCountable
+{
+public:
+	/// A glyph's quad in the atlas.
+	struct Glyph
+	{
+		Glyph() : texture_index(-1) { }
+
+		/// The offset of the quad's top-left corner from the glyph's origin on the baseline, in reference pixels.
+		Vector2f origin;
+		/// The dimensions of the quad, in reference pixels.
+		Vector2f dimensions;
+		/// The texture coordinates of the quad's corners.
+		Vector2f texcoords[2];
+
+		/// The texture the glyph is stored in, or -1 if the glyph has no distance field.
+		int texture_index;
+	};
+
+	FontDistanceField();
+	virtual ~FontDistanceField();
+
+	/// Reads the outlines of a face's glyphs, ready for their distance fields to be generated. This is the only step
+	/// that uses the face, so it must be serialised with other users of it.
+	/// @param[in] ft_face The face to read the outlines from. This must be scalable.
+	/// @param[in] charset The characters to generate distance fields for.
+	/// @return True if the outlines were read successfully, false if not.
+	bool Initialise(FT_Face ft_face, const UnicodeRangeList& charset);
+	/// Generates the distance fields from the outlines read by Initialise(), and lays them out in the atlas. This runs
+	/// jobs on the task pool, so it mustn't be called with the texture database's lock held.
+	/// @return True if the atlas was generated successfully, false if not.
+	bool Generate();
+
+	/// Returns the size, in pixels per em, the distance fields were generated at.
+	float GetSize() const;
+	/// Returns the distance, in reference pixels, the distance fields extend beyond the glyphs' outlines.
+	float GetSpread() const;
+
+	/// Returns a character's quad in the atlas.
+	/// @param[in] character The character.
+	/// @return The character's glyph, or NULL if the atlas has no glyph for it.
+	const Glyph* GetGlyph(word character) const;
+
+	/// Returns one of the atlas's textures.
+	/// @param[in] index The index of the texture.
+	/// @return The texture.
+	const Texture* GetTexture(int index) const;
+	/// Returns the number of textures in the atlas.
+	int GetNumTextures() const;
+
+	/// Generates the data of one of the atlas's textures (for the texture database).
+	/// @param[out] texture_data The pointer to be set to the generated texture data.
+	/// @param[out] texture_dimensions The dimensions of the texture.
+	/// @param[in] texture_id The index of the texture within the atlas.
+	/// @return True if the texture data was generated, false if not.
+	bool GenerateTexture(const byte*& texture_data, Vector2i& texture_dimensions, int texture_id);
+
+protected:
+	/// Destroys the atlas.
+	virtual void OnReferenceDeactivate();
+
+private:
+	typedef std::vector< Glyph > GlyphList;
+	typedef std::vector< Texture > TextureList;
+
+	GlyphList glyphs;
+	// The 8-bit distance fields of the glyphs, indexed by character.
+	std::vector< std::vector< byte > > distance_fields;
+	// The jobs that generate the distance fields, waiting for Generate().
+	std::vector< Task* > tasks;
+
+	TextureLayout texture_layout;
+	TextureList textures;
+};
+
+}
+}
+
+#endif
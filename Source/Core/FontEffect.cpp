@@ -67,6 +67,12 @@ void FontEffect::GenerateGlyphTexture(byte* ROCKET_UNUSED(destination_data), con
 {
 }
 
+// Requests the effect describe itself as a transformation of the glyphs' outlines.
+bool FontEffect::GetDistanceFieldMetrics(Vector2f& ROCKET_UNUSED(offset), float& ROCKET_UNUSED(dilation)) const
+{
+	return false;
+}
+
 // Sets the colour of the effect's geometry.
 void FontEffect::SetColour(const Colourb& _colour)
 {
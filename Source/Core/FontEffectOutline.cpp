@@ -101,5 +101,13 @@ void FontEffectOutline::GenerateGlyphTexture(byte* destination_data, const Vecto
 	filter.Run(destination_data, destination_dimensions, destination_stride, glyph.bitmap_data, glyph.bitmap_dimensions, Vector2i(width, width));
 }
 
+// Grows the glyphs' distance fields by the outline's width.
+bool FontEffectOutline::GetDistanceFieldMetrics(Vector2f& offset, float& dilation) const
+{
+	offset = Vector2f(0, 0);
+	dilation = (float) width;
+	return true;
+}
+
 }
 }
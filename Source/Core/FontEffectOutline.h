@@ -71,6 +71,12 @@ public:
 	/// @param[in] glyph The glyph the effect is being asked to generate an effect texture for.
 	virtual void GenerateGlyphTexture(byte* destination_data, const Vector2i& destination_dimensions, int destination_stride, const FontGlyph& glyph) const;
 
+	/// Grows the glyphs' distance fields by the outline's width.
+	/// @param[out] offset The offset of the effect's glyphs from the original glyphs, in pixels.
+	/// @param[out] dilation The distance the effect grows the glyphs' outlines by, in pixels.
+	/// @return True.
+	virtual bool GetDistanceFieldMetrics(Vector2f& offset, float& dilation) const;
+
 private:
 	int width;
 	ConvolutionFilter filter;
@@ -61,5 +61,13 @@ bool FontEffectShadow::GetGlyphMetrics(Vector2i& origin, Vector2i& ROCKET_UNUSED
 	return true;
 }
 
+// Offsets the glyphs' distance fields by the shadow's offset.
+bool FontEffectShadow::GetDistanceFieldMetrics(Vector2f& _offset, float& dilation) const
+{
+	_offset = Vector2f((float) offset.x, (float) offset.y);
+	dilation = 0;
+	return true;
+}
+
 }
 }
@@ -61,6 +61,12 @@ public:
 	/// @return False if the effect is not providing support for the glyph, true otherwise.
 	virtual bool GetGlyphMetrics(Vector2i& origin, Vector2i& dimensions, const FontGlyph& glyph) const;
 
+	/// Offsets the glyphs' distance fields by the shadow's offset.
+	/// @param[out] offset The offset of the effect's glyphs from the original glyphs, in pixels.
+	/// @param[out] dilation The distance the effect grows the glyphs' outlines by, in pixels.
+	/// @return True.
+	virtual bool GetDistanceFieldMetrics(Vector2f& offset, float& dilation) const;
+
 private:
 	Vector2i offset;
 };
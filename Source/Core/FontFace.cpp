@@ -27,7 +27,10 @@
 
 #include "precompiled.h"
 #include "FontFace.h"
+#include "FontDistanceField.h"
 #include "FontFaceHandle.h"
+#include "FontKerning.h"
+#include "TextureDatabase.h"
 #include <Rocket/Core/Log.h>
 
 namespace Rocket {
@@ -40,6 +43,9 @@ FontFace::FontFace(FT_Face _face, Font::Style _style, Font::Weight _weight, bool
 	weight = _weight;
 
 	release_stream = _release_stream;
+	scalable = FT_IS_SCALABLE(face) != 0;
+
+	kerning = NULL;
 }
 
 FontFace::~FontFace()
@@ -51,6 +57,15 @@ FontFace::~FontFace()
 			handle_list[i]->RemoveReference();
 	}
 
+	if (kerning != NULL)
+		kerning->RemoveReference();
+
+	for (DistanceFieldMap::iterator i = distance_fields.begin(); i != distance_fields.end(); ++i)
+	{
+		if (i->second != NULL)
+			i->second->RemoveReference();
+	}
+
 	ReleaseFace();
 }
 
@@ -67,28 +82,25 @@ Font::Weight FontFace::GetWeight() const
 }
 
 // Returns a handle for positioning and rendering this face at the given size.
-FontFaceHandle* FontFace::GetHandle(const String& _raw_charset, int size)
+FontFaceHandle* FontFace::GetHandle(const String& _raw_charset, int size, bool distance_field)
 {
+	FontFaceHandle* handle = FindHandle(_raw_charset, size, distance_field);
+	if (handle != NULL)
+		return handle;
+
 	UnicodeRangeList charset;
 
+	// Only outline fonts can generate distance fields.
+	if (!scalable)
+		distance_field = false;
+
 	HandleMap::iterator iterator = handles.find(size);
 	if (iterator != handles.end())
 	{
 		const HandleList& handles = (*iterator).second;
 
-		// Check all the handles if their charsets match the requested one exactly (ie, were specified by the same
-		// string).
-		String raw_charset(_raw_charset);
-		for (size_t i = 0; i < handles.size(); ++i)
-		{
-			if (handles[i]->GetRawCharset() == _raw_charset)
-			{
-				handles[i]->AddReference();
-				return handles[i];
-			}
-		}
-
 		// Check all the handles if their charsets contain the requested charset.
+		String raw_charset(_raw_charset);
 		if (!UnicodeRange::BuildList(charset, raw_charset))
 		{
 			Log::Message(Log::LT_ERROR, "Invalid font charset '%s'.", _raw_charset.CString());
@@ -97,6 +109,9 @@ FontFaceHandle* FontFace::GetHandle(const String& _raw_charset, int size)
 
 		for (size_t i = 0; i < handles.size(); ++i)
 		{
+			if ((handles[i]->GetDistanceField() != NULL) != distance_field)
+				continue;
+
 			bool range_contained = true;
 
 			const UnicodeRangeList& handle_charset = handles[i]->GetCharset();
@@ -121,9 +136,26 @@ FontFaceHandle* FontFace::GetHandle(const String& _raw_charset, int size)
 		return NULL;
 	}
 
+	// Read the face's kerning pairs the first time they're needed.
+	if (kerning == NULL)
+	{
+		kerning = new FontKerning();
+		kerning->Initialise(face);
+	}
+
+	// The distance field atlas for the charset has been generated by GenerateDistanceField(). If it couldn't be, the
+	// handle falls back to rendering from bitmaps.
+	FontDistanceField* handle_distance_field = NULL;
+	if (distance_field)
+	{
+		DistanceFieldMap::iterator distance_field_iterator = distance_fields.find(_raw_charset);
+		if (distance_field_iterator != distance_fields.end())
+			handle_distance_field = distance_field_iterator->second;
+	}
+
 	// Construct and initialise the new handle.
-	FontFaceHandle* handle = new FontFaceHandle();
-	if (!handle->Initialise(face, _raw_charset, size))
+	handle = new FontFaceHandle();
+	if (!handle->Initialise(face, _raw_charset, size, kerning, handle_distance_field))
 	{
 		handle->RemoveReference();
 		return NULL;
@@ -131,16 +163,97 @@ FontFaceHandle* FontFace::GetHandle(const String& _raw_charset, int size)
 
 	// Save the handle, and add a reference for the callee. The initial reference will be removed when the font face
 	// releases it.
+	handle->AddReference();
+
+	WriteLock lock(handle_lock);
 	if (iterator != handles.end())
 		(*iterator).second.push_back(handle);
 	else
 		handles[size] = HandleList(1, handle);
 
-	handle->AddReference();
-
 	return handle;
 }
 
+// Returns an existing handle whose charset was specified by the same string.
+FontFaceHandle* FontFace::FindHandle(const String& raw_charset, int size, bool distance_field)
+{
+	// Only outline fonts can generate distance fields.
+	if (!scalable)
+		distance_field = false;
+
+	ReadLock lock(handle_lock);
+
+	HandleMap::iterator iterator = handles.find(size);
+	if (iterator == handles.end())
+		return NULL;
+
+	// Check all the handles if their charsets match the requested one exactly (ie, were specified by the same string).
+	const HandleList& handle_list = (*iterator).second;
+	for (size_t i = 0; i < handle_list.size(); ++i)
+	{
+		if ((handle_list[i]->GetDistanceField() != NULL) == distance_field &&
+			handle_list[i]->GetRawCharset() == raw_charset)
+		{
+			handle_list[i]->AddReference();
+			return handle_list[i];
+		}
+	}
+
+	return NULL;
+}
+
+// Generates the face's distance field atlas for a charset, if it hasn't been already.
+void FontFace::GenerateDistanceField(const String& raw_charset)
+{
+	if (!scalable)
+		return;
+
+	// Read the glyphs' outlines under the lock, as the FreeType face is shared with the face's handles.
+	FontDistanceField* distance_field = new FontDistanceField();
+	{
+		MutexLock lock(TextureDatabase::GetMutex());
+
+		if (face == NULL ||
+			distance_fields.find(raw_charset) != distance_fields.end())
+		{
+			distance_field->RemoveReference();
+			return;
+		}
+
+		UnicodeRangeList charset;
+		if (!UnicodeRange::BuildList(charset, raw_charset) ||
+			!distance_field->Initialise(face, charset))
+		{
+			Log::Message(Log::LT_WARNING, "Unable to generate distance fields for the font face '%s %s'; rendering it from bitmaps instead.", face->family_name, face->style_name);
+			distance_field->RemoveReference();
+			distance_fields[raw_charset] = NULL;
+			return;
+		}
+	}
+
+	// Generate the distance fields without the lock; the jobs that generate them may be run alongside others that
+	// need it.
+	bool generated = distance_field->Generate();
+
+	MutexLock lock(TextureDatabase::GetMutex());
+
+	// Another thread may have generated the same atlas in the meantime; if so, we keep theirs.
+	if (distance_fields.find(raw_charset) != distance_fields.end())
+	{
+		distance_field->RemoveReference();
+		return;
+	}
+
+	if (!generated)
+	{
+		Log::Message(Log::LT_WARNING, "Unable to generate distance fields for the font face '%s %s'; rendering it from bitmaps instead.", face->family_name, face->style_name);
+		distance_field->RemoveReference();
+		distance_field = NULL;
+	}
+
+	distance_fields[raw_charset] = distance_field;
+}
+
 // Releases the face's FreeType face structure.
 void FontFace::ReleaseFace()
 {
@@ -29,13 +29,16 @@
 #define ROCKETCOREFONTFACE_H
 
 #include <Rocket/Core/Font.h>
+#include "Threading.h"
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
 namespace Rocket {
 namespace Core {
 
+class FontDistanceField;
 class FontFaceHandle;
+class FontKerning;
 
 /**
 	@author Peter Curry
@@ -57,8 +60,22 @@ public:
 	/// Returns a handle for positioning and rendering this face at the given size.
 	/// @param[in] charset The set of characters in the handle, as a comma-separated list of unicode ranges.
 	/// @param[in] size The size of the desired handle, in points.
+	/// @param[in] distance_field True to render the handle from the face's distance field atlas, if the face is scalable.
 	/// @return The shared font handle.
-	FontFaceHandle* GetHandle(const String& charset, int size);
+	FontFaceHandle* GetHandle(const String& charset, int size, bool distance_field);
+	/// Returns an existing handle whose charset was specified by the same string, without generating one. Unlike
+	/// GetHandle(), this may be called while another thread is fetching handles from the face.
+	/// @param[in] charset The set of characters in the handle, as a comma-separated list of unicode ranges.
+	/// @param[in] size The size of the desired handle, in points.
+	/// @param[in] distance_field True to render the handle from the face's distance field atlas, if the face is scalable.
+	/// @return The shared font handle, or NULL if a matching handle hasn't been generated.
+	FontFaceHandle* FindHandle(const String& charset, int size, bool distance_field);
+
+	/// Generates the face's distance field atlas for a charset, if it hasn't been already. This must be called before
+	/// GetHandle() is asked for a handle rendering from distance fields, and without the texture database's lock held,
+	/// as the atlas is generated on the task pool.
+	/// @param[in] charset The set of characters in the atlas, as a comma-separated list of unicode ranges.
+	void GenerateDistanceField(const String& charset);
 
 	/// Releases the face's FreeType face structure. This will mean handles for new sizes cannot be constructed,
 	/// but existing ones can still be fetched.
@@ -70,10 +87,22 @@ private:
 	Font::Weight weight;
 
 	bool release_stream;
+	// True if the face is an outline font, and so can generate distance fields.
+	bool scalable;
+
+	// The face's kerning pairs, read when its first handle is generated and shared between all of them.
+	FontKerning* kerning;
+
+	// The face's distance field atlases, indexed by charset, generated before the first handle rendering from each is.
+	// An atlas that couldn't be generated is stored as NULL.
+	typedef std::map< String, FontDistanceField* > DistanceFieldMap;
+	DistanceFieldMap distance_fields;
 
 	typedef std::vector< FontFaceHandle* > HandleList;
 	typedef std::map< int, HandleList > HandleMap;
 	HandleMap handles;
+	// Protects the handle map, so existing handles can be found while another thread generates a new one.
+	ReadWriteLock handle_lock;
 };
 
 }
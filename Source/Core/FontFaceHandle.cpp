@@ -29,8 +29,12 @@
 #include "FontFaceHandle.h"
 #include <algorithm>
 #include <Rocket/Core.h>
+#include "FontDistanceField.h"
 #include "FontFaceLayer.h"
+#include "FontKerning.h"
+#include "TextureDatabase.h"
 #include "TextureLayout.h"
+#include "Threading.h"
 
 namespace Rocket {
 namespace Core {
@@ -56,6 +60,12 @@ FontFaceHandle::FontFaceHandle()
 	underline_thickness = 0;
 
 	base_layer = NULL;
+
+	distance_field = NULL;
+
+	kerning = NULL;
+	kerning_scale = 0;
+	kerning_ppem = 0;
 }
 
 FontFaceHandle::~FontFaceHandle()
@@ -65,13 +75,24 @@ FontFaceHandle::~FontFaceHandle()
 
 	for (FontLayerMap::iterator i = layers.begin(); i != layers.end(); ++i)
 		delete i->second;
+
+	if (kerning != NULL)
+		kerning->RemoveReference();
+
+	if (distance_field != NULL)
+		distance_field->RemoveReference();
 }
 
 // Initialises the handle so it is able to render text.
-bool FontFaceHandle::Initialise(FT_Face ft_face, const String& _charset, int _size)
+bool FontFaceHandle::Initialise(FT_Face ft_face, const String& _charset, int _size, FontKerning* _kerning, FontDistanceField* _distance_field)
 {
 	size = _size;
 
+	// Handles rendering from the face's distance fields only need their glyphs' metrics at this size.
+	distance_field = _distance_field;
+	if (distance_field != NULL)
+		distance_field->AddReference();
+
 	raw_charset = _charset;
 	if (!UnicodeRange::BuildList(charset, raw_charset))
 	{
@@ -100,7 +121,14 @@ bool FontFaceHandle::Initialise(FT_Face ft_face, const String& _charset, int _si
 	// Generate the metrics for the handle.
 	GenerateMetrics(ft_face);
 
-	BuildKerning(ft_face);
+	// Share the face's kerning pairs, noting how they scale to this size.
+	kerning = _kerning;
+	if (kerning != NULL)
+	{
+		kerning->AddReference();
+		kerning_scale = ft_face->size->metrics.x_scale;
+		kerning_ppem = ft_face->size->metrics.x_ppem;
+	}
 
 	// Generate the default layer and layer configuration.
 	base_layer = GenerateLayer(NULL);
@@ -147,6 +175,12 @@ const FontGlyphList& FontFaceHandle::GetGlyphs() const
 	return glyphs;
 }
 
+// Returns the distance field atlas the handle renders from.
+const FontDistanceField* FontFaceHandle::GetDistanceField() const
+{
+	return distance_field;
+}
+
 // Returns the width a string will take up if rendered with this handle.
 int FontFaceHandle::GetStringWidth(const WString& string, word prior_character) const
 {
@@ -178,6 +212,9 @@ int FontFaceHandle::GenerateLayerConfiguration(FontEffectMap& font_effects)
 	if (font_effects.empty())
 		return 0;
 
+	// Handles are shared between all contexts, so their layers are protected by the texture database's lock.
+	MutexLock lock(TextureDatabase::GetMutex());
+
 	// Prepare a list of effects, sorted by z-index.
 	FontEffectList sorted_effects;
 	for (FontEffectMap::const_iterator i = font_effects.begin(); i != font_effects.end(); ++i)
@@ -219,8 +256,7 @@ int FontFaceHandle::GenerateLayerConfiguration(FontEffectMap& font_effects)
 	}
 
 	// No match, so we have to generate a new layer configuration.
-	layer_configurations.push_back(LayerConfiguration());
-	LayerConfiguration& layer_configuration = layer_configurations.back();
+	LayerConfiguration layer_configuration;
 
 	bool added_base_layer = false;
 
@@ -240,12 +276,18 @@ int FontFaceHandle::GenerateLayerConfiguration(FontEffectMap& font_effects)
 	if (!added_base_layer)
 		layer_configuration.push_back(base_layer);
 
+	// Adding the configuration may move the others, so strings can't be generated from them meanwhile.
+	WriteLock configuration_lock(layer_configuration_lock);
+	layer_configurations.push_back(layer_configuration);
+
 	return (int) (layer_configurations.size() - 1);
 }
 
 // Generates the texture data for a layer (for the texture database).
 bool FontFaceHandle::GenerateLayerTexture(const byte*& texture_data, Vector2i& texture_dimensions, FontEffect* layer_id, int texture_id)
 {
+	MutexLock lock(TextureDatabase::GetMutex());
+
 	FontLayerMap::iterator layer_iterator = layers.find(layer_id);
 	if (layer_iterator == layers.end())
 		return false;
@@ -256,6 +298,11 @@ bool FontFaceHandle::GenerateLayerTexture(const byte*& texture_data, Vector2i& t
 // Generates the geometry required to render a single line of text.
 int FontFaceHandle::GenerateString(GeometryList& geometry, const WString& string, const Vector2f& position, const Colourb& colour, int layer_configuration_index) const
 {
+	ROCKET_PROFILE_ZONE("FontFaceHandle::GenerateString");
+
+	// The glyphs and layers are fixed once generated, so only the configurations need protecting.
+	ReadLock lock(layer_configuration_lock);
+
 	int geometry_index = 0;
 	int line_width = 0;
 
@@ -280,7 +327,10 @@ int FontFaceHandle::GenerateString(GeometryList& geometry, const WString& string
 
 		// Bind the textures to the geometries.
 		for (int i = 0; i < layer->GetNumTextures(); ++i)
+		{
 			geometry[geometry_index + i].SetTexture(layer->GetTexture(i));
+			geometry[geometry_index + i].SetTextShader(layer->GetTextShader());
+		}
 
 		line_width = 0;
 		word prior_character = 0;
@@ -398,16 +448,22 @@ void FontFaceHandle::BuildGlyphMap(FT_Face ft_face, const UnicodeRange& unicode_
 				continue;
 			}
 
-			error = FT_Render_Glyph(ft_face->glyph, FT_RENDER_MODE_NORMAL);
-			if (error != 0)
-			{
-				Log::Message(Log::LT_WARNING, "Unable to render glyph for character '%u' on the font face '%s %s'; error code: %d.", character_code, ft_face->family_name, ft_face->style_name, error);
-				continue;
-			}
-
 			FontGlyph glyph;
 			glyph.character = character_code;
-			BuildGlyph(glyph, ft_face->glyph);
+
+			if (distance_field == NULL)
+			{
+				error = FT_Render_Glyph(ft_face->glyph, FT_RENDER_MODE_NORMAL);
+				if (error != 0)
+				{
+					Log::Message(Log::LT_WARNING, "Unable to render glyph for character '%u' on the font face '%s %s'; error code: %d.", character_code, ft_face->family_name, ft_face->style_name, error);
+					continue;
+				}
+
+				BuildGlyph(glyph, ft_face->glyph);
+			}
+			else
+				BuildGlyphMetrics(glyph, ft_face->glyph);
 			glyphs[character_code] = glyph;
 		}
 	}
@@ -415,16 +471,7 @@ void FontFaceHandle::BuildGlyphMap(FT_Face ft_face, const UnicodeRange& unicode_
 
 void FontFaceHandle::BuildGlyph(FontGlyph& glyph, FT_GlyphSlot ft_glyph)
 {
-	// Set the glyph's dimensions.
-	glyph.dimensions.x = ft_glyph->metrics.width >> 6;
-	glyph.dimensions.y = ft_glyph->metrics.height >> 6;
-
-	// Set the glyph's bearing.
-	glyph.bearing.x = ft_glyph->metrics.horiBearingX >> 6;
-	glyph.bearing.y = ft_glyph->metrics.horiBearingY >> 6;
-
-	// Set the glyph's advance.
-	glyph.advance = ft_glyph->metrics.horiAdvance >> 6;
+	BuildGlyphMetrics(glyph, ft_glyph);
 
 	// Set the glyph's bitmap dimensions.
 	glyph.bitmap_dimensions.x = ft_glyph->bitmap.width;
@@ -496,48 +543,37 @@ void FontFaceHandle::BuildGlyph(FontGlyph& glyph, FT_GlyphSlot ft_glyph)
 		glyph.bitmap_data = NULL;
 }
 
-void FontFaceHandle::BuildKerning(FT_Face ft_face)
+void FontFaceHandle::BuildGlyphMetrics(FontGlyph& glyph, FT_GlyphSlot ft_glyph)
 {
-	// Compile the kerning information for this character if the font includes it.
-	if (FT_HAS_KERNING(ft_face))
-	{
-		kerning.resize(max_codepoint+1, GlyphKerningList(max_codepoint+1, 0));
-
-		for (size_t i = 0; i < charset.size(); ++i)
-		{
-			for (word rhs = (word) (Math::Max< unsigned int >(charset[i].min_codepoint, 32)); rhs <= charset[i].max_codepoint; ++rhs)
-			{
-				GlyphKerningList glyph_kerning(max_codepoint+1, 0);
-
-				for (size_t j = 0; j < charset.size(); ++j)
-				{
-					for (word lhs = (word) (Math::Max< unsigned int >(charset[j].min_codepoint, 32)); lhs <= charset[j].max_codepoint; ++lhs)
-					{
-						FT_Vector ft_kerning;
-						FT_Get_Kerning(ft_face, FT_Get_Char_Index(ft_face, lhs), FT_Get_Char_Index(ft_face, rhs), FT_KERNING_DEFAULT, &ft_kerning);
+	// Set the glyph's dimensions.
+	glyph.dimensions.x = ft_glyph->metrics.width >> 6;
+	glyph.dimensions.y = ft_glyph->metrics.height >> 6;
 
-						int kerning = ft_kerning.x >> 6;
-						if (kerning != 0)
-							glyph_kerning[lhs] = kerning;
-					}
-				}
+	// Set the glyph's bearing.
+	glyph.bearing.x = ft_glyph->metrics.horiBearingX >> 6;
+	glyph.bearing.y = ft_glyph->metrics.horiBearingY >> 6;
 
-				kerning[rhs] = glyph_kerning;
-			}
-		}
-	}
+	// Set the glyph's advance.
+	glyph.advance = ft_glyph->metrics.horiAdvance >> 6;
 }
 
+// Returns the kerning between two characters, in pixels.
 int FontFaceHandle::GetKerning(word lhs, word rhs) const
 {
-	if (rhs >= kerning.size())
+	if (kerning == NULL)
 		return 0;
 
-	const GlyphKerningList &kerning_map = kerning[rhs];
-	if (lhs >= kerning_map.size())
+	int units = kerning->GetKerning(lhs, rhs);
+	if (units == 0)
 		return 0;
 
-	return kerning_map[lhs];
+	// Scale and round the kerning as FreeType's default mode does, damping it at small sizes where rounding would
+	// exaggerate it.
+	FT_Pos scaled_kerning = FT_MulFix(units, kerning_scale);
+	if (kerning_ppem < 25)
+		scaled_kerning = FT_MulDiv(scaled_kerning, kerning_ppem, 25);
+
+	return (int) (((scaled_kerning + 32) & -64) >> 6);
 }
 
 // Generates (or shares) a layer derived from a font effect.
@@ -551,7 +587,14 @@ FontFaceLayer* FontFaceHandle::GenerateLayer(FontEffect* font_effect)
 	FontFaceLayer* layer = new FontFaceLayer();
 	layers[font_effect] = layer;
 
-	if (font_effect == NULL)
+	// Every layer of a handle rendering from distance fields shares the face's atlas, so effects only change how the
+	// glyphs are positioned and shaded.
+	if (distance_field != NULL)
+	{
+		if (!layer->InitialiseDistanceField(this, font_effect, distance_field, size))
+			Log::Message(Log::LT_WARNING, "Font effect '%s' can't be rendered from distance fields; it will be skipped.", font_effect->GetName().CString());
+	}
+	else if (font_effect == NULL)
 	{
 		layer->Initialise(this);
 	}
@@ -29,6 +29,7 @@
 #define ROCKETCOREFONTFACEHANDLE_H
 
 #include <Rocket/Core/ReferenceCountable.h>
+#include "Threading.h"
 #include "UnicodeRange.h"
 #include <Rocket/Core/Font.h>
 #include <Rocket/Core/FontEffect.h>
@@ -42,7 +43,9 @@
 namespace Rocket {
 namespace Core {
 
+class FontDistanceField;
 class FontFaceLayer;
+class FontKerning;
 
 /**
 	@author Peter Curry
@@ -58,8 +61,10 @@ public:
 	/// @param[in] ft_face The FreeType face that this handle is rendering.
 	/// @param[in] charset The comma-separated list of unicode ranges this handle must support.
 	/// @param[in] size The size, in points, of the face this handle should render at.
+	/// @param[in] kerning The face's kerning pairs, shared between all of its handles. This may be NULL.
+	/// @param[in] distance_field The face's distance field atlas to render from, or NULL to render from bitmaps rasterised at the handle's size.
 	/// @return True if the handle initialised successfully and is ready for rendering, false if an error occured.
-	bool Initialise(FT_Face ft_face, const String& charset, int size);
+	bool Initialise(FT_Face ft_face, const String& charset, int size, FontKerning* kerning, FontDistanceField* distance_field);
 
 	/// Returns the average advance of all glyphs in this font face.
 	/// @return An approximate width of the characters in this font face.
@@ -83,6 +88,10 @@ public:
 	/// @return The font's glyphs.
 	const FontGlyphList& GetGlyphs() const;
 
+	/// Returns the distance field atlas the handle renders from.
+	/// @return The face's distance field atlas, or NULL if the handle renders from bitmaps.
+	const FontDistanceField* GetDistanceField() const;
+
 	/// Returns the width a string will take up if rendered with this handle.
 	/// @param[in] string The string to measure.
 	/// @param[in] prior_character The optionally-specified character that immediately precedes the string. This may have an impact on the string width due to kerning.
@@ -131,18 +140,22 @@ private:
 
 	void BuildGlyphMap(FT_Face ft_face, const UnicodeRange& unicode_range);
 	void BuildGlyph(FontGlyph& glyph, FT_GlyphSlot ft_glyph);
+	void BuildGlyphMetrics(FontGlyph& glyph, FT_GlyphSlot ft_glyph);
 
-	void BuildKerning(FT_Face ft_face);
 	int GetKerning(word lhs, word rhs) const;
 
 	// Generates (or shares) a layer derived from a font effect.
 	FontFaceLayer* GenerateLayer(FontEffect* font_effect);
 
-	typedef std::vector< int > GlyphKerningList;
-	typedef std::vector< GlyphKerningList > FontKerningList;
-
 	FontGlyphList glyphs;
-	FontKerningList kerning;
+
+	// The face's distance field atlas, shared between all its handles that render from it.
+	FontDistanceField* distance_field;
+
+	// The face's kerning pairs in font units, and the scale and pixels-per-em they're converted to pixels with.
+	FontKerning* kerning;
+	FT_Fixed kerning_scale;
+	int kerning_ppem;
 
 	typedef std::map< const FontEffect*, FontFaceLayer* > FontLayerMap;
 	typedef std::map< String, FontFaceLayer* > FontLayerCache;
@@ -157,8 +170,11 @@ private:
 	FontLayerCache layer_cache;
 
 	// All configurations currently in use on this handle. New configurations will be generated as
-	// required.
+	// required. Strings are generated from the configurations under a read lock, so text on several
+	// threads isn't serialised on the texture database's lock; new configurations are added under the
+	// write lock.
 	LayerConfigurationList layer_configurations;
+	mutable ReadWriteLock layer_configuration_lock;
 
 	// The average advance (in pixels) of all of this face's glyphs.
 	int average_advance;
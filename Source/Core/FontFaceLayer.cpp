@@ -28,6 +28,7 @@
 #include "precompiled.h"
 #include "FontFaceLayer.h"
 #include <Rocket/Core/Core.h>
+#include "FontDistanceField.h"
 #include "FontFaceHandle.h"
 
 namespace Rocket {
@@ -37,6 +38,10 @@ FontFaceLayer::FontFaceLayer() : colour(255, 255, 255)
 {
 	handle = NULL;
 	effect = NULL;
+
+	text_shader.edge = 0.5f;
+	text_shader.smoothing = 0;
+	distance_field_layer = false;
 }
 
 FontFaceLayer::~FontFaceLayer()
@@ -161,6 +166,55 @@ bool FontFaceLayer::Initialise(const FontFaceHandle* _handle, FontEffect* _effec
 	return true;
 }
 
+// Generates the character data for a layer rendered from the face's distance field atlas.
+bool FontFaceLayer::InitialiseDistanceField(const FontFaceHandle* _handle, FontEffect* _effect, const FontDistanceField* distance_field, int size)
+{
+	handle = _handle;
+	effect = _effect;
+	if (effect != NULL)
+	{
+		effect->AddReference();
+		colour = effect->GetColour();
+	}
+
+	Vector2f offset(0, 0);
+	float dilation = 0;
+	if (effect != NULL &&
+		!effect->GetDistanceFieldMetrics(offset, dilation))
+		return false;
+
+	// Work out how far a pixel at this size spans in the distance field. The edge is antialiased over a pixel, and
+	// moved out for effects that dilate the glyphs; a glyph can't grow beyond the spread of its distance field.
+	float scale = size / distance_field->GetSize();
+	float pixel_distance = 1.0f / (2 * distance_field->GetSpread() * scale);
+
+	distance_field_layer = true;
+	text_shader.smoothing = 0.5f * pixel_distance;
+	text_shader.edge = Math::Max(0.5f - dilation * pixel_distance, text_shader.smoothing);
+
+	// Scale each glyph's quad in the atlas to the handle's size.
+	const FontGlyphList& glyphs = handle->GetGlyphs();
+	characters.resize(glyphs.size(), Character());
+	for (size_t i = 0; i < glyphs.size(); ++i)
+	{
+		const FontDistanceField::Glyph* glyph = distance_field->GetGlyph((word) i);
+		if (glyph == NULL)
+			continue;
+
+		Character& character = characters[i];
+		character.origin = glyph->origin * scale + offset;
+		character.dimensions = glyph->dimensions * scale;
+		character.texcoords[0] = glyph->texcoords[0];
+		character.texcoords[1] = glyph->texcoords[1];
+		character.texture_index = glyph->texture_index;
+	}
+
+	for (int i = 0; i < distance_field->GetNumTextures(); ++i)
+		textures.push_back(*distance_field->GetTexture(i));
+
+	return true;
+}
+
 // Generates the texture data for a layer (for the texture database).
 bool FontFaceLayer::GenerateTexture(const byte*& texture_data, Vector2i& texture_dimensions, int texture_id)
 {
@@ -238,5 +292,14 @@ const Colourb& FontFaceLayer::GetColour() const
 	return colour;
 }
 
+// Returns the shader the layer's textures are rendered with.
+const TextShader* FontFaceLayer::GetTextShader() const
+{
+	if (!distance_field_layer)
+		return NULL;
+
+	return &text_shader;
+}
+
 }
 }
@@ -32,12 +32,14 @@
 #include <Rocket/Core/Geometry.h>
 #include <Rocket/Core/GeometryUtilities.h>
 #include <Rocket/Core/String.h>
+#include <Rocket/Core/TextShader.h>
 #include <Rocket/Core/Texture.h>
 #include "TextureLayout.h"
 
 namespace Rocket {
 namespace Core {
 
+class FontDistanceField;
 class FontEffect;
 class FontFaceHandle;
 
@@ -61,6 +63,13 @@ public:
 	/// @param[in] deep_clone If true, the clones geometry will be completely cloned and the effect will have no option to affect even the glyph origins.
 	/// @return True if the layer was generated successfully, false if not.
 	bool Initialise(const FontFaceHandle* handle, FontEffect* effect = NULL, const FontFaceLayer* clone = NULL, bool deep_clone = false);
+	/// Generates the character data for a layer rendered from the face's distance field atlas.
+	/// @param[in] handle The handle generating this layer.
+	/// @param[in] effect The effect to initialise the layer with. This may be NULL.
+	/// @param[in] distance_field The atlas to render the glyphs from.
+	/// @param[in] size The size of the handle, in pixels per em.
+	/// @return True if the layer was generated successfully, false if the effect can't be rendered from distance fields.
+	bool InitialiseDistanceField(const FontFaceHandle* handle, FontEffect* effect, const FontDistanceField* distance_field, int size);
 
 	/// Generates the texture data for a layer (for the texture database).
 	/// @param[out] texture_data The pointer to be set to the generated texture data.
@@ -107,6 +116,10 @@ public:
 	/// @return The layer's colour.
 	const Colourb& GetColour() const;
 
+	/// Returns the shader the layer's textures are rendered with.
+	/// @return The layer's text shader, or NULL if the layer is rendered from bitmaps.
+	const TextShader* GetTextShader() const;
+
 private:
 	struct Character
 	{
@@ -134,6 +147,9 @@ private:
 	CharacterList characters;
 	TextureList textures;
 	Colourb colour;
+
+	TextShader text_shader;
+	bool distance_field_layer;
 };
 
 }
@@ -52,7 +52,27 @@ bool FontFamily::AddFace(FT_Face ft_face, Font::Style style, Font::Weight weight
 }
 
 // Returns a handle to the most appropriate font in the family, at the correct size.
-FontFaceHandle* FontFamily::GetFaceHandle(const String& charset, Font::Style style, Font::Weight weight, int size)
+FontFaceHandle* FontFamily::GetFaceHandle(const String& charset, Font::Style style, Font::Weight weight, int size, bool distance_field)
+{
+	FontFace* matching_face = GetMatchingFace(style, weight);
+	if (matching_face == NULL)
+		return NULL;
+
+	return matching_face->GetHandle(charset, size, distance_field);
+}
+
+// Returns an existing handle to the most appropriate font in the family.
+FontFaceHandle* FontFamily::FindFaceHandle(const String& charset, Font::Style style, Font::Weight weight, int size, bool distance_field)
+{
+	FontFace* matching_face = GetMatchingFace(style, weight);
+	if (matching_face == NULL)
+		return NULL;
+
+	return matching_face->FindHandle(charset, size, distance_field);
+}
+
+// Returns the face that best matches a style and weight.
+FontFace* FontFamily::GetMatchingFace(Font::Style style, Font::Weight weight) const
 {
 	// Search for a face of the same style, and match the weight as closely as we can.
 	FontFace* matching_face = NULL;
@@ -69,10 +89,7 @@ FontFaceHandle* FontFamily::GetFaceHandle(const String& charset, Font::Style sty
 		}
 	}
 
-	if (matching_face == NULL)
-		return NULL;
-
-	return matching_face->GetHandle(charset, size);
+	return matching_face;
 }
 
 }
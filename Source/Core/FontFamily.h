@@ -61,10 +61,27 @@ public:
 	/// @param[in] style The style of the desired handle.
 	/// @param[in] weight The weight of the desired handle.
 	/// @param[in] size The size of desired handle, in points.
+	/// @param[in] distance_field True to render the handle from the face's distance field atlas, if it has one.
 	/// @return A valid handle if a matching (or closely matching) font face was found, NULL otherwise.
-	FontFaceHandle* GetFaceHandle(const String& charset, Font::Style style, Font::Weight weight, int size);
+	FontFaceHandle* GetFaceHandle(const String& charset, Font::Style style, Font::Weight weight, int size, bool distance_field);
+	/// Returns an existing handle to the most appropriate font in the family, without generating one. This may be
+	/// called while another thread is fetching handles from the family.
+	/// @param[in] charset The set of characters in the handle, as a comma-separated list of unicode ranges.
+	/// @param[in] style The style of the desired handle.
+	/// @param[in] weight The weight of the desired handle.
+	/// @param[in] size The size of desired handle, in points.
+	/// @param[in] distance_field True to render the handle from the face's distance field atlas, if it has one.
+	/// @return A valid handle if one has already been generated for the charset, NULL otherwise.
+	FontFaceHandle* FindFaceHandle(const String& charset, Font::Style style, Font::Weight weight, int size, bool distance_field);
+
+	/// Returns the face that best matches a style and weight.
+	/// @param[in] style The style of the desired face.
+	/// @param[in] weight The weight of the desired face.
+	/// @return The face with the style and the closest weight, or NULL if none have the style.
+	FontFace* GetMatchingFace(Font::Style style, Font::Weight weight) const;
 
 private:
+
 	String name;
 
 	typedef std::vector< FontFace* > FontFaceList;
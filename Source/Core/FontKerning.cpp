@@ -0,0 +1,583 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "FontKerning.h"
+#include <algorithm>
+#include <set>
+#include FT_TRUETYPE_TABLES_H
+#include FT_TRUETYPE_TAGS_H
+
+namespace Rocket {
+namespace Core {
+
+// The raw bytes of an SFNT table.
+struct FontTable
+{
+	const FT_Byte* data;
+	FT_ULong length;
+};
+
+// Reads a big-endian unsigned 16-bit value from a table, or zero if the read would overrun the table.
+static FT_UInt ReadUShort(const FontTable& table, FT_ULong offset)
+{
+	if (offset + 2 > table.length)
+		return 0;
+
+	return (table.data[offset] << 8) | table.data[offset + 1];
+}
+
+// Reads a big-endian signed 16-bit value from a table.
+static int ReadShort(const FontTable& table, FT_ULong offset)
+{
+	return (FT_Short) ReadUShort(table, offset);
+}
+
+// Reads a big-endian unsigned 32-bit value from a table.
+static FT_ULong ReadULong(const FontTable& table, FT_ULong offset)
+{
+	return (ReadUShort(table, offset) << 16) | ReadUShort(table, offset + 2);
+}
+
+// Loads one of a face's SFNT tables into memory.
+static bool LoadTable(FT_Face ft_face, FT_ULong tag, std::vector< FT_Byte >& data)
+{
+	FT_ULong length = 0;
+	if (FT_Load_Sfnt_Table(ft_face, tag, 0, NULL, &length) != 0 ||
+		length == 0)
+		return false;
+
+	data.resize(length);
+	return FT_Load_Sfnt_Table(ft_face, tag, 0, &data[0], &length) == 0;
+}
+
+// Returns the size in bytes of a GPOS value record of the given format.
+static FT_ULong GetValueRecordSize(FT_UInt value_format)
+{
+	FT_ULong size = 0;
+	for (int i = 0; i < 8; ++i)
+	{
+		if (value_format & (1 << i))
+			size += 2;
+	}
+
+	return size;
+}
+
+// Reads the horizontal advance adjustment from a GPOS value record.
+static int ReadXAdvance(const FontTable& table, FT_ULong offset, FT_UInt value_format)
+{
+	if (!(value_format & 0x0004))
+		return 0;
+
+	// Skip the x and y placement adjustments, if the record has them.
+	if (value_format & 0x0001)
+		offset += 2;
+	if (value_format & 0x0002)
+		offset += 2;
+
+	return ReadShort(table, offset);
+}
+
+// Reads the glyphs of a coverage table in coverage index order.
+static void ReadCoverage(const FontTable& table, FT_ULong offset, std::vector< FT_UInt >& glyphs)
+{
+	FT_UInt format = ReadUShort(table, offset);
+	FT_UInt count = ReadUShort(table, offset + 2);
+
+	if (format == 1)
+	{
+		for (FT_UInt i = 0; i < count; ++i)
+			glyphs.push_back(ReadUShort(table, offset + 4 + i * 2));
+	}
+	else if (format == 2)
+	{
+		for (FT_UInt i = 0; i < count; ++i)
+		{
+			FT_ULong range = offset + 4 + i * 6;
+			FT_UInt first_glyph = ReadUShort(table, range);
+			FT_UInt last_glyph = ReadUShort(table, range + 2);
+
+			for (FT_UInt glyph = first_glyph; glyph <= last_glyph; ++glyph)
+				glyphs.push_back(glyph);
+		}
+	}
+}
+
+// Reads the glyphs a class definition table assigns to a class other than zero.
+static void ReadClassDefinition(const FontTable& table, FT_ULong offset, std::vector< std::pair< FT_UInt, FT_UInt > >& glyph_classes)
+{
+	FT_UInt format = ReadUShort(table, offset);
+
+	if (format == 1)
+	{
+		FT_UInt first_glyph = ReadUShort(table, offset + 2);
+		FT_UInt count = ReadUShort(table, offset + 4);
+
+		for (FT_UInt i = 0; i < count; ++i)
+		{
+			FT_UInt glyph_class = ReadUShort(table, offset + 6 + i * 2);
+			if (glyph_class != 0)
+				glyph_classes.push_back(std::pair< FT_UInt, FT_UInt >(first_glyph + i, glyph_class));
+		}
+	}
+	else if (format == 2)
+	{
+		FT_UInt count = ReadUShort(table, offset + 2);
+		for (FT_UInt i = 0; i < count; ++i)
+		{
+			FT_ULong range = offset + 4 + i * 6;
+			FT_UInt first_glyph = ReadUShort(table, range);
+			FT_UInt last_glyph = ReadUShort(table, range + 2);
+			FT_UInt glyph_class = ReadUShort(table, range + 4);
+
+			if (glyph_class == 0)
+				continue;
+
+			for (FT_UInt glyph = first_glyph; glyph <= last_glyph; ++glyph)
+				glyph_classes.push_back(std::pair< FT_UInt, FT_UInt >(glyph, glyph_class));
+		}
+	}
+}
+
+// Returns true if a glyph is mapped to a character.
+static bool IsGlyphMapped(const std::vector< bool >& mapped_glyphs, FT_UInt glyph)
+{
+	return glyph < mapped_glyphs.size() && mapped_glyphs[glyph];
+}
+
+// Orders kerning pairs by their key.
+template < typename T >
+static bool CompareKeys(const T& lhs, const T& rhs)
+{
+	return lhs.key < rhs.key;
+}
+
+// Returns true if two kerning pairs have the same key.
+template < typename T >
+static bool EqualKeys(const T& lhs, const T& rhs)
+{
+	return lhs.key == rhs.key;
+}
+
+// Orders glyph-to-character mappings by glyph alone.
+static bool CompareGlyphs(const std::pair< FT_UInt, word >& lhs, const std::pair< FT_UInt, word >& rhs)
+{
+	return lhs.first < rhs.first;
+}
+
+typedef std::vector< std::pair< FT_UInt, word > >::const_iterator CharacterIterator;
+typedef std::pair< CharacterIterator, CharacterIterator > CharacterRange;
+
+// Returns the range of characters mapped to a glyph in a list ordered by glyph.
+static CharacterRange GetCharacters(const std::vector< std::pair< FT_UInt, word > >& characters, FT_UInt glyph)
+{
+	return std::equal_range(characters.begin(), characters.end(), std::pair< FT_UInt, word >(glyph, 0), CompareGlyphs);
+}
+
+FontKerning::FontKerning()
+{
+	hash_shift = 32;
+	num_pairs = 0;
+}
+
+FontKerning::~FontKerning()
+{
+}
+
+// Reads the kerning pairs from a FreeType face.
+void FontKerning::Initialise(FT_Face ft_face)
+{
+	// Build the list of characters mapped to each glyph, ordered by glyph.
+	GlyphCharacterList characters;
+	std::vector< bool > mapped_glyphs(ft_face->num_glyphs, false);
+
+	FT_UInt glyph;
+	FT_ULong character = FT_Get_First_Char(ft_face, &glyph);
+	while (glyph != 0 &&
+		   character <= 0xFFFF)
+	{
+		if (character >= 32 &&
+			glyph < mapped_glyphs.size())
+		{
+			characters.push_back(std::pair< FT_UInt, word >(glyph, (word) character));
+			mapped_glyphs[glyph] = true;
+		}
+
+		character = FT_Get_Next_Char(ft_face, character, &glyph);
+	}
+
+	std::sort(characters.begin(), characters.end());
+
+	// Read the pairs from the richest source the face has; OpenType fonts with a GPOS table rarely bother keeping
+	// their 'kern' table complete.
+	KerningPairList glyph_pairs;
+	if (FT_IS_SFNT(ft_face))
+	{
+		if (!ReadGPOS(ft_face, mapped_glyphs, glyph_pairs))
+			ReadKern(ft_face, glyph_pairs);
+	}
+	else if (FT_HAS_KERNING(ft_face))
+		ReadFreeType(ft_face, characters, glyph_pairs);
+
+	// Sum the adjustments for any pairs specified more than once, and drop those that cancel out.
+	std::stable_sort(glyph_pairs.begin(), glyph_pairs.end(), CompareKeys< KerningPair >);
+
+	size_t num_glyph_pairs = 0;
+	for (size_t i = 0; i < glyph_pairs.size(); ++i)
+	{
+		if (num_glyph_pairs > 0 &&
+			glyph_pairs[num_glyph_pairs - 1].key == glyph_pairs[i].key)
+			glyph_pairs[num_glyph_pairs - 1].value += glyph_pairs[i].value;
+		else
+			glyph_pairs[num_glyph_pairs++] = glyph_pairs[i];
+	}
+	glyph_pairs.resize(num_glyph_pairs);
+
+	// Count the character pairs each glyph pair expands into, so the hash table can be sized up front.
+	size_t num_character_pairs = 0;
+	for (size_t i = 0; i < glyph_pairs.size(); ++i)
+	{
+		if (glyph_pairs[i].value == 0)
+			continue;
+
+		CharacterRange lhs = GetCharacters(characters, glyph_pairs[i].key >> 16);
+		CharacterRange rhs = GetCharacters(characters, glyph_pairs[i].key & 0xFFFF);
+		num_character_pairs += (lhs.second - lhs.first) * (rhs.second - rhs.first);
+	}
+
+	if (num_character_pairs == 0)
+		return;
+
+	unsigned int size = 16;
+	hash_shift = 28;
+	while (size < num_character_pairs * 2)
+	{
+		size <<= 1;
+		hash_shift--;
+	}
+
+	KerningPair empty_pair = { 0, 0 };
+	pairs.assign(size, empty_pair);
+
+	for (size_t i = 0; i < glyph_pairs.size(); ++i)
+	{
+		if (glyph_pairs[i].value == 0)
+			continue;
+
+		CharacterRange lhs = GetCharacters(characters, glyph_pairs[i].key >> 16);
+		CharacterRange rhs = GetCharacters(characters, glyph_pairs[i].key & 0xFFFF);
+
+		for (CharacterIterator j = lhs.first; j != lhs.second; ++j)
+		{
+			for (CharacterIterator k = rhs.first; k != rhs.second; ++k)
+				Insert(((unsigned int) j->second << 16) | k->second, glyph_pairs[i].value);
+		}
+	}
+}
+
+// Returns the kerning between two characters.
+int FontKerning::GetKerning(word lhs, word rhs) const
+{
+	if (num_pairs == 0)
+		return 0;
+
+	unsigned int key = ((unsigned int) lhs << 16) | rhs;
+	unsigned int mask = (unsigned int) pairs.size() - 1;
+
+	for (unsigned int slot = GetSlot(key); ; slot = (slot + 1) & mask)
+	{
+		const KerningPair& pair = pairs[slot];
+		if (pair.key == key)
+			return pair.value;
+		if (pair.key == 0)
+			return 0;
+	}
+}
+
+// Returns the number of kerning pairs in the table.
+int FontKerning::GetNumPairs() const
+{
+	return num_pairs;
+}
+
+// Destroys the table.
+void FontKerning::OnReferenceDeactivate()
+{
+	delete this;
+}
+
+// Reads the pairs of the GPOS table's 'kern' feature into a list of glyph pairs.
+bool FontKerning::ReadGPOS(FT_Face ft_face, const std::vector< bool >& mapped_glyphs, KerningPairList& glyph_pairs)
+{
+	std::vector< FT_Byte > data;
+	if (!LoadTable(ft_face, TTAG_GPOS, data))
+		return false;
+
+	FontTable table = { &data[0], data.size() };
+	FT_ULong feature_list = ReadUShort(table, 6);
+	FT_ULong lookup_list = ReadUShort(table, 8);
+	if (feature_list == 0 ||
+		lookup_list == 0)
+		return false;
+
+	// Gather the lookups of every 'kern' feature, regardless of script or language; they're applied in lookup order.
+	std::set< FT_UInt > lookups;
+	FT_UInt num_features = ReadUShort(table, feature_list);
+	for (FT_UInt i = 0; i < num_features; ++i)
+	{
+		FT_ULong feature_record = feature_list + 2 + i * 6;
+		if (ReadULong(table, feature_record) != TTAG_kern)
+			continue;
+
+		FT_ULong feature = feature_list + ReadUShort(table, feature_record + 4);
+		FT_UInt num_lookups = ReadUShort(table, feature + 2);
+		for (FT_UInt j = 0; j < num_lookups; ++j)
+			lookups.insert(ReadUShort(table, feature + 4 + j * 2));
+	}
+
+	FT_UInt num_lookups = ReadUShort(table, lookup_list);
+	for (std::set< FT_UInt >::const_iterator i = lookups.begin(); i != lookups.end() && *i < num_lookups; ++i)
+	{
+		FT_ULong lookup = lookup_list + ReadUShort(table, lookup_list + 2 + *i * 2);
+		FT_UInt lookup_type = ReadUShort(table, lookup);
+		FT_UInt num_subtables = ReadUShort(table, lookup + 4);
+
+		KerningPairList lookup_pairs;
+		for (FT_UInt j = 0; j < num_subtables; ++j)
+		{
+			FT_ULong subtable = lookup + ReadUShort(table, lookup + 6 + j * 2);
+
+			// Extension subtables wrap a subtable of another type with a 32-bit offset.
+			FT_UInt subtable_type = lookup_type;
+			if (lookup_type == 9)
+			{
+				subtable_type = ReadUShort(table, subtable + 2);
+				subtable += ReadULong(table, subtable + 4);
+			}
+
+			// Only pair adjustment subtables kern.
+			if (subtable_type != 2)
+				continue;
+
+			std::vector< FT_UInt > coverage;
+			ReadCoverage(table, subtable + ReadUShort(table, subtable + 2), coverage);
+
+			FT_UInt value_format_1 = ReadUShort(table, subtable + 4);
+			FT_UInt value_format_2 = ReadUShort(table, subtable + 6);
+			FT_ULong value_size_1 = GetValueRecordSize(value_format_1);
+			FT_ULong value_size_2 = GetValueRecordSize(value_format_2);
+
+			FT_UInt format = ReadUShort(table, subtable);
+			if (format == 1)
+			{
+				// Individual glyph pairs, in sets ordered by the coverage of the first glyph.
+				FT_UInt num_pair_sets = Math::Min< FT_UInt >(ReadUShort(table, subtable + 8), (FT_UInt) coverage.size());
+				for (FT_UInt k = 0; k < num_pair_sets; ++k)
+				{
+					if (!IsGlyphMapped(mapped_glyphs, coverage[k]))
+						continue;
+
+					FT_ULong pair_set = subtable + ReadUShort(table, subtable + 10 + k * 2);
+					FT_UInt num_pair_values = ReadUShort(table, pair_set);
+					FT_ULong pair_value_size = 2 + value_size_1 + value_size_2;
+
+					for (FT_UInt l = 0; l < num_pair_values; ++l)
+					{
+						FT_ULong pair_value = pair_set + 2 + l * pair_value_size;
+						FT_UInt second_glyph = ReadUShort(table, pair_value);
+						if (!IsGlyphMapped(mapped_glyphs, second_glyph))
+							continue;
+
+						// Pairs with no adjustment are kept for now, as they still mask later subtables.
+						KerningPair pair = { (coverage[k] << 16) | second_glyph, ReadXAdvance(table, pair_value + 2, value_format_1) };
+						lookup_pairs.push_back(pair);
+					}
+				}
+			}
+			else if (format == 2 &&
+					 (value_format_1 & 0x0004))
+			{
+				// Adjustments between classes of glyphs; these are expanded into every glyph pair they cover.
+				FT_ULong class_definition_1 = subtable + ReadUShort(table, subtable + 8);
+				FT_ULong class_definition_2 = subtable + ReadUShort(table, subtable + 10);
+				FT_UInt num_classes_1 = ReadUShort(table, subtable + 12);
+				FT_UInt num_classes_2 = ReadUShort(table, subtable + 14);
+				FT_ULong class_records = subtable + 16;
+				FT_ULong class_record_size = value_size_1 + value_size_2;
+
+				if (class_records + (FT_ULong) num_classes_1 * num_classes_2 * class_record_size > table.length)
+					continue;
+
+				std::vector< std::pair< FT_UInt, FT_UInt > > first_classes;
+				ReadClassDefinition(table, class_definition_1, first_classes);
+				std::sort(first_classes.begin(), first_classes.end());
+
+				std::vector< std::pair< FT_UInt, FT_UInt > > second_classes;
+				ReadClassDefinition(table, class_definition_2, second_classes);
+
+				for (size_t k = 0; k < coverage.size(); ++k)
+				{
+					if (!IsGlyphMapped(mapped_glyphs, coverage[k]))
+						continue;
+
+					// Covered glyphs missing from the first class definition are in class zero.
+					FT_UInt class_1 = 0;
+					std::vector< std::pair< FT_UInt, FT_UInt > >::const_iterator first_class = std::lower_bound(first_classes.begin(), first_classes.end(), std::pair< FT_UInt, FT_UInt >(coverage[k], 0));
+					if (first_class != first_classes.end() &&
+						first_class->first == coverage[k])
+						class_1 = first_class->second;
+
+					if (class_1 >= num_classes_1)
+						continue;
+
+					for (size_t l = 0; l < second_classes.size(); ++l)
+					{
+						if (second_classes[l].second >= num_classes_2 ||
+							!IsGlyphMapped(mapped_glyphs, second_classes[l].first))
+							continue;
+
+						int value = ReadXAdvance(table, class_records + (class_1 * num_classes_2 + second_classes[l].second) * class_record_size, value_format_1);
+						if (value == 0)
+							continue;
+
+						KerningPair pair = { (coverage[k] << 16) | second_classes[l].first, value };
+						lookup_pairs.push_back(pair);
+					}
+				}
+			}
+		}
+
+		// Only the first subtable in a lookup to match a pair applies to it.
+		std::stable_sort(lookup_pairs.begin(), lookup_pairs.end(), CompareKeys< KerningPair >);
+		lookup_pairs.erase(std::unique(lookup_pairs.begin(), lookup_pairs.end(), EqualKeys< KerningPair >), lookup_pairs.end());
+
+		for (size_t j = 0; j < lookup_pairs.size(); ++j)
+		{
+			if (lookup_pairs[j].value != 0)
+				glyph_pairs.push_back(lookup_pairs[j]);
+		}
+	}
+
+	return !glyph_pairs.empty();
+}
+
+// Reads the pairs of the horizontal, format 0 subtables of the 'kern' table into a list of glyph pairs.
+bool FontKerning::ReadKern(FT_Face ft_face, KerningPairList& glyph_pairs)
+{
+	std::vector< FT_Byte > data;
+	if (!LoadTable(ft_face, TTAG_kern, data))
+		return false;
+
+	// Only the Microsoft version of the table is supported, as with FreeType.
+	FontTable table = { &data[0], data.size() };
+	if (ReadUShort(table, 0) != 0)
+		return false;
+
+	FT_UInt num_subtables = ReadUShort(table, 2);
+	FT_ULong subtable = 4;
+	for (FT_UInt i = 0; i < num_subtables && subtable < table.length; ++i)
+	{
+		FT_UInt subtable_length = ReadUShort(table, subtable + 2);
+		FT_UInt coverage = ReadUShort(table, subtable + 4);
+
+		// Skip vertical, minimum and cross-stream subtables, and any but format 0.
+		if ((coverage & ~0x0008) == 0x0001)
+		{
+			FT_UInt num_pairs = ReadUShort(table, subtable + 6);
+			for (FT_UInt j = 0; j < num_pairs; ++j)
+			{
+				FT_ULong pair_offset = subtable + 14 + j * 6;
+				if (pair_offset + 6 > table.length)
+					break;
+
+				KerningPair pair = { (ReadUShort(table, pair_offset) << 16) | ReadUShort(table, pair_offset + 2), ReadShort(table, pair_offset + 4) };
+				glyph_pairs.push_back(pair);
+			}
+		}
+
+		if (subtable_length < 6)
+			break;
+		subtable += subtable_length;
+	}
+
+	return !glyph_pairs.empty();
+}
+
+// Queries FreeType for the kerning of every pair of mapped glyphs, for faces that aren't SFNT-based.
+void FontKerning::ReadFreeType(FT_Face ft_face, const GlyphCharacterList& characters, KerningPairList& glyph_pairs)
+{
+	std::vector< FT_UInt > glyphs;
+	for (size_t i = 0; i < characters.size(); ++i)
+	{
+		if (glyphs.empty() ||
+			glyphs.back() != characters[i].first)
+			glyphs.push_back(characters[i].first);
+	}
+
+	for (size_t i = 0; i < glyphs.size(); ++i)
+	{
+		for (size_t j = 0; j < glyphs.size(); ++j)
+		{
+			FT_Vector ft_kerning;
+			if (FT_Get_Kerning(ft_face, glyphs[i], glyphs[j], FT_KERNING_UNSCALED, &ft_kerning) == 0 &&
+				ft_kerning.x != 0)
+			{
+				KerningPair pair = { (glyphs[i] << 16) | glyphs[j], (int) ft_kerning.x };
+				glyph_pairs.push_back(pair);
+			}
+		}
+	}
+}
+
+// Returns the slot in the hash table a key is first probed at.
+unsigned int FontKerning::GetSlot(unsigned int key) const
+{
+	// Fibonacci hashing; the upper bits of the product depend on all of the key's bits.
+	return (key * 2654435769u) >> hash_shift;
+}
+
+// Adds the kerning for a pair of characters to the hash table.
+void FontKerning::Insert(unsigned int key, int value)
+{
+	unsigned int mask = (unsigned int) pairs.size() - 1;
+
+	unsigned int slot = GetSlot(key);
+	while (pairs[slot].key != 0 &&
+		   pairs[slot].key != key)
+		slot = (slot + 1) & mask;
+
+	if (pairs[slot].key == 0)
+		num_pairs++;
+
+	pairs[slot].key = key;
+	pairs[slot].value = value;
+}
+
+}
+}
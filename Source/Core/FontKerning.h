@@ -0,0 +1,102 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREFONTKERNING_H
+#define ROCKETCOREFONTKERNING_H
+
+#include <Rocket/Core/ReferenceCountable.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+namespace Rocket {
+namespace Core {
+
+/**
+	The kerning pairs of a font face, in font units. The pairs are read from the 'kern' feature of the face's GPOS
+	table, or its 'kern' table if it has no GPOS kerning, and stored sparsely in an open-addressed hash table keyed by
+	character pair. The table is shared between all of the face's handles, which scale its values to their own size.
+ */
+
+class FontKerning : public ReferenceCountable
+{
+public:
+	FontKerning();
+	virtual ~FontKerning();
+
+	/// Reads the kerning pairs from a FreeType face.
+	/// @param[in] ft_face The face to read the pairs from.
+	void Initialise(FT_Face ft_face);
+
+	/// Returns the kerning between two characters.
+	/// @param[in] lhs The first character of the pair.
+	/// @param[in] rhs The second character of the pair.
+	/// @return The adjustment to the advance of the first character, in font units.
+	int GetKerning(word lhs, word rhs) const;
+
+	/// Returns the number of kerning pairs in the table.
+	int GetNumPairs() const;
+
+protected:
+	/// Destroys the table.
+	virtual void OnReferenceDeactivate();
+
+private:
+	// A pair of glyphs or characters, packed into a key with the first in the upper sixteen bits, and its kerning.
+	struct KerningPair
+	{
+		unsigned int key;
+		int value;
+	};
+
+	typedef std::vector< KerningPair > KerningPairList;
+	typedef std::vector< std::pair< FT_UInt, word > > GlyphCharacterList;
+
+	// Reads the pairs of the GPOS table's 'kern' feature into a list of glyph pairs, returning false if there are none.
+	// Pairs of glyphs without characters are skipped.
+	bool ReadGPOS(FT_Face ft_face, const std::vector< bool >& mapped_glyphs, KerningPairList& glyph_pairs);
+	// Reads the pairs of the horizontal, format 0 subtables of the 'kern' table into a list of glyph pairs.
+	bool ReadKern(FT_Face ft_face, KerningPairList& glyph_pairs);
+	// Queries FreeType for the kerning of every pair of mapped glyphs, for faces that aren't SFNT-based.
+	void ReadFreeType(FT_Face ft_face, const GlyphCharacterList& characters, KerningPairList& glyph_pairs);
+
+	// Returns the slot in the hash table a key is first probed at.
+	unsigned int GetSlot(unsigned int key) const;
+	// Adds the kerning for a pair of characters to the hash table, which must have room for it.
+	void Insert(unsigned int key, int value);
+
+	// The hash table of character pairs; a key of zero marks an empty slot. The table's size is always a power of
+	// two, and it is never more than half full.
+	KerningPairList pairs;
+	unsigned int hash_shift;
+	int num_pairs;
+};
+
+}
+}
+
+#endif
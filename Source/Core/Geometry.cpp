@@ -28,13 +28,23 @@
 #include "precompiled.h"
 #include <Rocket/Core/Geometry.h>
 #include <Rocket/Core.h>
+#include "GeometryBatch.h"
+#include "GeometryBuffer.h"
 #include "GeometryDatabase.h"
+#include "Threading.h"
 
 namespace Rocket {
 namespace Core {
 
 static bool read_texel_offset = false;
 static Vector2f texel_offset;
+static Mutex texel_offset_mutex;
+
+// Compiled geometry released after fewer renders than this is changing too often to be worth compiling, and is
+// streamed through the render interface's geometry buffer instead.
+const int MIN_COMPILED_RENDERS = 30;
+// Streamed geometry left unchanged for this many renders is compiled again.
+const int MIN_STREAMED_RENDERS = 120;
 
 Geometry::Geometry(Element* _host_element)
 {
@@ -44,10 +54,14 @@ Geometry::Geometry(Element* _host_element)
 	GeometryDatabase::AddGeometry(this);
 
 	texture = NULL;
+	text_shader = NULL;
 
 	fixed_texcoords = false;
 	compile_attempted = false;
 	compiled_geometry = NULL;
+
+	num_renders = 0;
+	dynamic = false;
 }
 
 Geometry::Geometry(Context* _host_context)
@@ -58,10 +72,14 @@ Geometry::Geometry(Context* _host_context)
 	GeometryDatabase::AddGeometry(this);
 
 	texture = NULL;
+	text_shader = NULL;
 
 	fixed_texcoords = false;
 	compile_attempted = false;
 	compiled_geometry = NULL;
+
+	num_renders = 0;
+	dynamic = false;
 }
 
 Geometry::~Geometry()
@@ -69,6 +87,7 @@ Geometry::~Geometry()
 	GeometryDatabase::RemoveGeometry(this);
 
 	Release();
+	GeometryDatabase::RecycleBuffers(vertices, indices);
 }
 
 // Set the host element for this geometry; this should be passed in the constructor if possible.
@@ -92,11 +111,28 @@ void Geometry::Render(const Vector2f& translation)
 	if (render_interface == NULL)
 		return;
 
-	// Render our compiled geometry if possible.
-	if (compiled_geometry)
+	if (text_shader == NULL)
 	{
-		render_interface->RenderCompiledGeometry(compiled_geometry, translation);
+		Draw(render_interface, translation);
+		return;
 	}
+
+	GeometryBatch::Flush(render_interface);
+	render_interface->SetTextShader(text_shader);
+	Draw(render_interface, translation);
+	GeometryBatch::Flush(render_interface);
+	render_interface->SetTextShader(NULL);
+}
+
+// Renders the geometry through a render interface, compiling it first if appropriate.
+void Geometry::Draw(RenderInterface* render_interface, const Vector2f& translation)
+{
+	if (num_renders < MIN_STREAMED_RENDERS)
+		++num_renders;
+
+	// Render our compiled geometry if possible.
+	if (compiled_geometry)
+		RenderCompiledGeometry(render_interface, translation);
 	// Otherwise, if we actually have geometry, try to compile it if we haven't already done so, otherwise render it in
 	// immediate mode.
 	else
@@ -105,12 +141,13 @@ void Geometry::Render(const Vector2f& translation)
 			indices.empty())
 			return;
 
-		if (!compile_attempted)
+		if (!fixed_texcoords)
 		{
-			if (!fixed_texcoords)
-			{
-				fixed_texcoords = true;
+			fixed_texcoords = true;
 
+			Vector2f offset;
+			{
+				MutexLock lock(texel_offset_mutex);
 				if (!read_texel_offset)
 				{
 					read_texel_offset = true;
@@ -118,42 +155,103 @@ void Geometry::Render(const Vector2f& translation)
 					texel_offset.y = render_interface->GetVerticalTexelOffset();
 				}
 
-				// Add a half-texel offset if required.
-				if (texel_offset.x != 0 ||
-					texel_offset.y != 0)
-				{
-					for (size_t i = 0; i < vertices.size(); ++i)
-						vertices[i].position += texel_offset;
-				}
+				offset = texel_offset;
+			}
+
+			// Add a half-texel offset if required.
+			if (offset.x != 0 ||
+				offset.y != 0)
+			{
+				for (size_t i = 0; i < vertices.size(); ++i)
+					vertices[i].position += offset;
+			}
+		}
+
+		// Dynamic geometry that has settled down is worth compiling again.
+		if (dynamic &&
+			num_renders >= MIN_STREAMED_RENDERS)
+			dynamic = false;
+
+		TextureHandle texture_handle = 0;
+		bool texture_loading = false;
+		if (texture != NULL)
+		{
+			texture_handle = texture->GetHandle(render_interface);
+
+			// A texture that is still loading is drawn with the placeholder if there is one, or not at all if not. The
+			// geometry isn't compiled until the texture is ready, so the placeholder's handle isn't baked into it.
+			texture_loading = texture->IsLoading(render_interface);
+			if (texture_loading &&
+				!texture_handle)
+				return;
+		}
+
+		if (!compile_attempted &&
+			!dynamic &&
+			!texture_loading)
+		{
+			// Note the geometry's bounds, so it can be batched with other geometry it doesn't overlap.
+			bounds_min = vertices[0].position;
+			bounds_max = vertices[0].position;
+			for (size_t i = 1; i < vertices.size(); ++i)
+			{
+				bounds_min.x = Math::Min(bounds_min.x, vertices[i].position.x);
+				bounds_min.y = Math::Min(bounds_min.y, vertices[i].position.y);
+				bounds_max.x = Math::Max(bounds_max.x, vertices[i].position.x);
+				bounds_max.y = Math::Max(bounds_max.y, vertices[i].position.y);
 			}
 
 			compile_attempted = true;
-			compiled_geometry = render_interface->CompileGeometry(&vertices[0], (int) vertices.size(), &indices[0], (int) indices.size(), texture != NULL ? texture->GetHandle(GetRenderInterface()) : NULL);
+			compiled_geometry = render_interface->CompileGeometry(&vertices[0], (int) vertices.size(), &indices[0], (int) indices.size(), texture_handle);
+			Profiler::IncrementCounter(Profiler::GEOMETRY_COMPILES);
 
 			// If we managed to compile the geometry, we can clear the local copy of vertices and indices and
 			// immediately render the compiled version.
 			if (compiled_geometry)
-			{	
-				render_interface->RenderCompiledGeometry(compiled_geometry, translation);
+			{
+				num_renders = 1;
+
+				RenderCompiledGeometry(render_interface, translation);
 				return;
 			}
 		}
 
-		// Either we've attempted to compile before (and failed), or the compile we just attempted failed; either way,
-		// render the uncompiled version.
-		render_interface->RenderGeometry(&vertices[0], (int) vertices.size(), &indices[0], (int) indices.size(), texture != NULL ? texture->GetHandle(GetRenderInterface()) : NULL, translation);
+		// Either the geometry is dynamic, or it couldn't be compiled; either way, stream it through the render
+		// interface's geometry buffer if it has one, or render it in immediate mode if not.
+		if (GeometryBatch::RenderGeometry(render_interface, &vertices[0], (int) vertices.size(), &indices[0], (int) indices.size(), texture_handle, translation))
+			return;
+
+		if (!GeometryBuffer::RenderGeometry(render_interface, &vertices[0], (int) vertices.size(), &indices[0], (int) indices.size(), texture_handle, translation))
+			render_interface->RenderGeometry(&vertices[0], (int) vertices.size(), &indices[0], (int) indices.size(), texture_handle, translation);
+		Profiler::IncrementCounter(Profiler::DRAW_CALLS);
 	}
 }
 
+// Renders the geometry's compiled handle, or defers it to be batched with other copies of it.
+void Geometry::RenderCompiledGeometry(RenderInterface* render_interface, const Vector2f& translation)
+{
+	if (GeometryBatch::RenderCompiledGeometry(render_interface, compiled_geometry, translation, bounds_min, bounds_max))
+		return;
+
+	render_interface->RenderCompiledGeometry(compiled_geometry, translation);
+	Profiler::IncrementCounter(Profiler::DRAW_CALLS);
+}
+
 // Returns the geometry's vertices. If these are written to, Release() should be called to force a recompile.
 std::vector< Vertex >& Geometry::GetVertices()
 {
+	if (vertices.capacity() == 0)
+		GeometryDatabase::AcquireBuffer(vertices);
+
 	return vertices;
 }
 
 // Returns the geometry's indices. If these are written to, Release() should be called to force a recompile.
 std::vector< int >& Geometry::GetIndices()
 {
+	if (indices.capacity() == 0)
+		GeometryDatabase::AcquireBuffer(indices);
+
 	return indices;
 }
 
@@ -170,15 +268,37 @@ void Geometry::SetTexture(const Texture* _texture)
 	Release();
 }
 
+// Gets the shader the geometry's texture is rendered with.
+const TextShader* Geometry::GetTextShader() const
+{
+	return text_shader;
+}
+
+// Sets the shader the geometry's texture is rendered with.
+void Geometry::SetTextShader(const TextShader* _text_shader)
+{
+	text_shader = _text_shader;
+}
+
+// Returns the number of bytes held by the geometry's vertex and index buffers.
+size_t Geometry::GetMemoryUsage() const
+{
+	return vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(int);
+}
+
 void Geometry::Release(bool clear_buffers)
 {
 	if (compiled_geometry)
 	{
+		// Geometry that is changed again soon after being compiled is likely to keep changing.
+		dynamic = num_renders < MIN_COMPILED_RENDERS;
+
 		GetRenderInterface()->ReleaseCompiledGeometry(compiled_geometry);
 		compiled_geometry = NULL;
 	}
 
 	compile_attempted = false;
+	num_renders = 0;
 
 	if (clear_buffers)
 	{
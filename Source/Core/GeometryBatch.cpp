@@ -0,0 +1,442 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "precompiled.h"
+#include "GeometryBatch.h"
+#include "GeometryBuffer.h"
+#include "Threading.h"
+#include <Rocket/Core.h>
+
+namespace Rocket {
+namespace Core {
+
+struct DeferredGeometry
+{
+	// The compiled geometry to render, or NULL if the geometry is uncompiled and stored in the batch's buffers.
+	CompiledGeometryHandle geometry;
+
+	TextureHandle texture;
+	int first_vertex;
+	int num_vertices;
+	int first_index;
+	int num_indices;
+
+	Vector2f translation;
+	Vector2f bounds_min;
+	Vector2f bounds_max;
+
+	// The next instance of the same compiled geometry in the geometry's group, or -1 if there are no more.
+	int next_instance;
+};
+
+// A run of consecutive instances in a group, bounded so overlap tests can skip them together.
+struct DeferredGeometryChunk
+{
+	int first_instance;
+	int num_instances;
+
+	Vector2f bounds_min;
+	Vector2f bounds_max;
+
+	// The group's next chunk, or -1 if there are no more.
+	int next_chunk;
+};
+
+// A run of deferred geometry rendered in a single call.
+struct DeferredGeometryGroup
+{
+	int first_instance;
+	int last_instance;
+
+	int first_chunk;
+	int last_chunk;
+
+	Vector2f bounds_min;
+	Vector2f bounds_max;
+};
+
+// The bounds of a run of consecutive groups, so overlap tests can skip them together.
+struct DeferredGeometryBlock
+{
+	Vector2f bounds_min;
+	Vector2f bounds_max;
+};
+
+typedef std::map< CompiledGeometryHandle, int > GroupIndexMap;
+
+struct Batch
+{
+	bool active;
+
+	std::vector< DeferredGeometry > geometry;
+	std::vector< Vertex > vertices;
+	std::vector< int > indices;
+
+	std::vector< DeferredGeometryGroup > groups;
+	std::vector< DeferredGeometryChunk > chunks;
+	std::vector< DeferredGeometryBlock > blocks;
+	std::vector< Vector2f > translations;
+
+	// The latest group of each piece of compiled geometry.
+	GroupIndexMap latest_groups;
+};
+
+// The number of instances in each of a group's chunks, and of groups in each block.
+const int CHUNK_SIZE = 16;
+const int BLOCK_SIZE = 16;
+// The number of bounds tested when looking for overlapping geometry before we give up and assume there is some. This
+// keeps gathering linear in the amount of geometry, at the cost of starting a new group when one could have been joined.
+const int MAX_OVERLAP_TESTS = 256;
+
+typedef std::map< RenderInterface*, Batch > BatchMap;
+static BatchMap batches;
+static Mutex mutex;
+
+// Returns true if two rectangles overlap; rectangles that only touch at their edges don't cover the same pixels.
+static bool Overlaps(const Vector2f& min_a, const Vector2f& max_a, const Vector2f& min_b, const Vector2f& max_b)
+{
+	return min_a.x < max_b.x && min_b.x < max_a.x &&
+		   min_a.y < max_b.y && min_b.y < max_a.y;
+}
+
+// Grows a rectangle to contain another.
+static void ExpandBounds(Vector2f& bounds_min, Vector2f& bounds_max, const Vector2f& other_min, const Vector2f& other_max)
+{
+	bounds_min.x = Math::Min(bounds_min.x, other_min.x);
+	bounds_min.y = Math::Min(bounds_min.y, other_min.y);
+	bounds_max.x = Math::Max(bounds_max.x, other_max.x);
+	bounds_max.y = Math::Max(bounds_max.y, other_max.y);
+}
+
+// Returns true if any of the geometry in a group might overlap a piece of geometry.
+static bool Overlaps(const Batch& batch, const DeferredGeometryGroup& group, const DeferredGeometry& geometry, int& num_tests)
+{
+	if (!Overlaps(group.bounds_min, group.bounds_max, geometry.bounds_min, geometry.bounds_max))
+		return false;
+
+	for (int i = group.first_chunk; i >= 0; i = batch.chunks[i].next_chunk)
+	{
+		const DeferredGeometryChunk& chunk = batch.chunks[i];
+		if (++num_tests > MAX_OVERLAP_TESTS)
+			return true;
+
+		if (!Overlaps(chunk.bounds_min, chunk.bounds_max, geometry.bounds_min, geometry.bounds_max))
+			continue;
+
+		int instance = chunk.first_instance;
+		for (int j = 0; j < chunk.num_instances; ++j)
+		{
+			if (++num_tests > MAX_OVERLAP_TESTS ||
+				Overlaps(batch.geometry[instance].bounds_min, batch.geometry[instance].bounds_max, geometry.bounds_min, geometry.bounds_max))
+				return true;
+
+			instance = batch.geometry[instance].next_instance;
+		}
+	}
+
+	return false;
+}
+
+// Returns true if any of the geometry in the groups after a group might overlap a piece of geometry.
+static bool OverlapsLaterGroups(const Batch& batch, int group_index, const DeferredGeometry& geometry)
+{
+	int num_tests = 0;
+
+	int i = (int) batch.groups.size() - 1;
+	while (i > group_index)
+	{
+		// Skip whole blocks of groups that are clear of the geometry.
+		int block_start = i - i % BLOCK_SIZE;
+		if (block_start > group_index)
+		{
+			const DeferredGeometryBlock& block = batch.blocks[i / BLOCK_SIZE];
+			if (++num_tests > MAX_OVERLAP_TESTS)
+				return true;
+
+			if (!Overlaps(block.bounds_min, block.bounds_max, geometry.bounds_min, geometry.bounds_max))
+			{
+				i = block_start - 1;
+				continue;
+			}
+		}
+
+		if (++num_tests > MAX_OVERLAP_TESTS ||
+			Overlaps(batch, batch.groups[i], geometry, num_tests))
+			return true;
+
+		--i;
+	}
+
+	return false;
+}
+
+// Adds a piece of geometry to the end of a group.
+static void AddToGroup(Batch& batch, int group_index, int instance)
+{
+	const DeferredGeometry& geometry = batch.geometry[instance];
+	DeferredGeometryGroup& group = batch.groups[group_index];
+
+	batch.geometry[group.last_instance].next_instance = instance;
+	group.last_instance = instance;
+	ExpandBounds(group.bounds_min, group.bounds_max, geometry.bounds_min, geometry.bounds_max);
+
+	DeferredGeometryBlock& block = batch.blocks[group_index / BLOCK_SIZE];
+	ExpandBounds(block.bounds_min, block.bounds_max, geometry.bounds_min, geometry.bounds_max);
+
+	// Start a new chunk if the group's last one is full.
+	if (batch.chunks[group.last_chunk].num_instances >= CHUNK_SIZE)
+	{
+		DeferredGeometryChunk chunk;
+		chunk.first_instance = instance;
+		chunk.num_instances = 1;
+		chunk.bounds_min = geometry.bounds_min;
+		chunk.bounds_max = geometry.bounds_max;
+		chunk.next_chunk = -1;
+
+		batch.chunks[group.last_chunk].next_chunk = (int) batch.chunks.size();
+		group.last_chunk = (int) batch.chunks.size();
+		batch.chunks.push_back(chunk);
+	}
+	else
+	{
+		DeferredGeometryChunk& chunk = batch.chunks[group.last_chunk];
+		chunk.num_instances++;
+		ExpandBounds(chunk.bounds_min, chunk.bounds_max, geometry.bounds_min, geometry.bounds_max);
+	}
+}
+
+// Starts a new group with a piece of geometry.
+static void AddGroup(Batch& batch, int instance)
+{
+	const DeferredGeometry& geometry = batch.geometry[instance];
+
+	DeferredGeometryChunk chunk;
+	chunk.first_instance = instance;
+	chunk.num_instances = 1;
+	chunk.bounds_min = geometry.bounds_min;
+	chunk.bounds_max = geometry.bounds_max;
+	chunk.next_chunk = -1;
+
+	DeferredGeometryGroup group;
+	group.first_instance = instance;
+	group.last_instance = instance;
+	group.first_chunk = (int) batch.chunks.size();
+	group.last_chunk = (int) batch.chunks.size();
+	group.bounds_min = geometry.bounds_min;
+	group.bounds_max = geometry.bounds_max;
+
+	batch.chunks.push_back(chunk);
+
+	if (batch.groups.size() % BLOCK_SIZE == 0)
+	{
+		DeferredGeometryBlock block;
+		block.bounds_min = geometry.bounds_min;
+		block.bounds_max = geometry.bounds_max;
+		batch.blocks.push_back(block);
+	}
+	else
+		ExpandBounds(batch.blocks.back().bounds_min, batch.blocks.back().bounds_max, geometry.bounds_min, geometry.bounds_max);
+
+	batch.groups.push_back(group);
+}
+
+// Renders a batch's deferred geometry.
+static void FlushBatch(RenderInterface* render_interface, Batch& batch)
+{
+	if (batch.geometry.empty())
+		return;
+
+	// Gather the geometry into groups. Compiled geometry joins the latest group of the same geometry, unless it overlaps
+	// geometry in any group after it; moving ahead of geometry it doesn't overlap can't change the rendered result.
+	for (int i = 0; i < (int) batch.geometry.size(); ++i)
+	{
+		DeferredGeometry& geometry = batch.geometry[i];
+		geometry.next_instance = -1;
+
+		if (geometry.geometry == 0)
+		{
+			AddGroup(batch, i);
+			continue;
+		}
+
+		GroupIndexMap::iterator latest_group = batch.latest_groups.find(geometry.geometry);
+		if (latest_group != batch.latest_groups.end() &&
+			!OverlapsLaterGroups(batch, latest_group->second, geometry))
+			AddToGroup(batch, latest_group->second, i);
+		else
+		{
+			batch.latest_groups[geometry.geometry] = (int) batch.groups.size();
+			AddGroup(batch, i);
+		}
+	}
+
+	for (size_t i = 0; i < batch.groups.size(); ++i)
+	{
+		DeferredGeometry& geometry = batch.geometry[batch.groups[i].first_instance];
+
+		if (geometry.geometry == 0)
+		{
+			Vertex* vertices = &batch.vertices[geometry.first_vertex];
+			int* indices = &batch.indices[geometry.first_index];
+
+			if (!GeometryBuffer::RenderGeometry(render_interface, vertices, geometry.num_vertices, indices, geometry.num_indices, geometry.texture, geometry.translation))
+				render_interface->RenderGeometry(vertices, geometry.num_vertices, indices, geometry.num_indices, geometry.texture, geometry.translation);
+		}
+		else if (geometry.next_instance < 0)
+			render_interface->RenderCompiledGeometry(geometry.geometry, geometry.translation);
+		else
+		{
+			batch.translations.clear();
+			for (int j = batch.groups[i].first_instance; j >= 0; j = batch.geometry[j].next_instance)
+				batch.translations.push_back(batch.geometry[j].translation);
+
+			render_interface->RenderCompiledGeometryInstanced(geometry.geometry, &batch.translations[0], (int) batch.translations.size());
+		}
+
+		Profiler::IncrementCounter(Profiler::DRAW_CALLS);
+	}
+
+	batch.geometry.clear();
+	batch.vertices.clear();
+	batch.indices.clear();
+	batch.groups.clear();
+	batch.chunks.clear();
+	batch.blocks.clear();
+	batch.latest_groups.clear();
+}
+
+// Starts deferring the geometry rendered through a render interface, if it supports instancing.
+void GeometryBatch::Begin(RenderInterface* render_interface)
+{
+	if (!render_interface->SupportsInstancing())
+		return;
+
+	MutexLock lock(mutex);
+
+	Batch& batch = batches[render_interface];
+	FlushBatch(render_interface, batch);
+	batch.active = true;
+}
+
+// Renders any deferred geometry, and stops deferring geometry rendered through a render interface.
+void GeometryBatch::End(RenderInterface* render_interface)
+{
+	MutexLock lock(mutex);
+
+	BatchMap::iterator i = batches.find(render_interface);
+	if (i == batches.end())
+		return;
+
+	FlushBatch(render_interface, (*i).second);
+	(*i).second.active = false;
+}
+
+// Renders any geometry deferred through a render interface.
+void GeometryBatch::Flush(RenderInterface* render_interface)
+{
+	MutexLock lock(mutex);
+
+	BatchMap::iterator i = batches.find(render_interface);
+	if (i != batches.end())
+		FlushBatch(render_interface, (*i).second);
+}
+
+// Frees the memory used to defer geometry rendered through a render interface.
+void GeometryBatch::Release(RenderInterface* render_interface)
+{
+	MutexLock lock(mutex);
+	batches.erase(render_interface);
+}
+
+// Defers rendering compiled geometry through a render interface.
+bool GeometryBatch::RenderCompiledGeometry(RenderInterface* render_interface, CompiledGeometryHandle geometry, const Vector2f& translation, const Vector2f& bounds_min, const Vector2f& bounds_max)
+{
+	MutexLock lock(mutex);
+
+	BatchMap::iterator i = batches.find(render_interface);
+	if (i == batches.end() ||
+		!(*i).second.active)
+		return false;
+
+	DeferredGeometry deferred_geometry;
+	deferred_geometry.geometry = geometry;
+	deferred_geometry.texture = 0;
+	deferred_geometry.first_vertex = 0;
+	deferred_geometry.num_vertices = 0;
+	deferred_geometry.first_index = 0;
+	deferred_geometry.num_indices = 0;
+	deferred_geometry.translation = translation;
+	deferred_geometry.bounds_min = bounds_min + translation;
+	deferred_geometry.bounds_max = bounds_max + translation;
+	deferred_geometry.next_instance = -1;
+
+	(*i).second.geometry.push_back(deferred_geometry);
+	return true;
+}
+
+// Defers rendering uncompiled geometry through a render interface.
+bool GeometryBatch::RenderGeometry(RenderInterface* render_interface, const Vertex* vertices, int num_vertices, const int* indices, int num_indices, TextureHandle texture, const Vector2f& translation)
+{
+	MutexLock lock(mutex);
+
+	BatchMap::iterator i = batches.find(render_interface);
+	if (i == batches.end() ||
+		!(*i).second.active)
+		return false;
+
+	Batch& batch = (*i).second;
+
+	DeferredGeometry deferred_geometry;
+	deferred_geometry.geometry = 0;
+	deferred_geometry.texture = texture;
+	deferred_geometry.first_vertex = (int) batch.vertices.size();
+	deferred_geometry.num_vertices = num_vertices;
+	deferred_geometry.first_index = (int) batch.indices.size();
+	deferred_geometry.num_indices = num_indices;
+	deferred_geometry.translation = translation;
+	deferred_geometry.next_instance = -1;
+
+	deferred_geometry.bounds_min = vertices[0].position;
+	deferred_geometry.bounds_max = vertices[0].position;
+	for (int j = 1; j < num_vertices; ++j)
+	{
+		deferred_geometry.bounds_min.x = Math::Min(deferred_geometry.bounds_min.x, vertices[j].position.x);
+		deferred_geometry.bounds_min.y = Math::Min(deferred_geometry.bounds_min.y, vertices[j].position.y);
+		deferred_geometry.bounds_max.x = Math::Max(deferred_geometry.bounds_max.x, vertices[j].position.x);
+		deferred_geometry.bounds_max.y = Math::Max(deferred_geometry.bounds_max.y, vertices[j].position.y);
+	}
+	deferred_geometry.bounds_min += translation;
+	deferred_geometry.bounds_max += translation;
+
+	batch.vertices.insert(batch.vertices.end(), vertices, vertices + num_vertices);
+	batch.indices.insert(batch.indices.end(), indices, indices + num_indices);
+	batch.geometry.push_back(deferred_geometry);
+	return true;
+}
+
+}
+}
@@ -0,0 +1,84 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef ROCKETCOREGEOMETRYBATCH_H
+#define ROCKETCOREGEOMETRYBATCH_H
+
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+class RenderInterface;
+
+/**
+	Defers the geometry rendered through a render interface that supports instancing, so that copies of the same
+	compiled geometry can be gathered into single instanced calls. Geometry is only moved ahead of other geometry it
+	doesn't overlap, so the rendered result is unchanged. Anything else sent to the render interface, such as a change
+	of scissor region, must flush the deferred geometry first.
+ */
+
+class GeometryBatch
+{
+public:
+	/// Starts deferring the geometry rendered through a render interface, if it supports instancing.
+	/// @param[in] render_interface The render interface about to be rendered through.
+	static void Begin(RenderInterface* render_interface);
+	/// Renders any deferred geometry, and stops deferring geometry rendered through a render interface.
+	/// @param[in] render_interface The render interface that has been rendered through.
+	static void End(RenderInterface* render_interface);
+	/// Renders any geometry deferred through a render interface.
+	/// @param[in] render_interface The render interface to flush.
+	static void Flush(RenderInterface* render_interface);
+	/// Frees the memory used to defer geometry rendered through a render interface.
+	/// @param[in] render_interface The render interface being released.
+	static void Release(RenderInterface* render_interface);
+
+	/// Defers rendering compiled geometry through a render interface.
+	/// @param[in] render_interface The render interface to render through.
+	/// @param[in] geometry The compiled geometry to render.
+	/// @param[in] translation The translation to apply to the geometry.
+	/// @param[in] bounds_min The top-left corner of the untranslated geometry's bounds.
+	/// @param[in] bounds_max The bottom-right corner of the untranslated geometry's bounds.
+	/// @return True if the geometry was deferred, false if the render interface isn't deferring geometry and it should be rendered immediately.
+	static bool RenderCompiledGeometry(RenderInterface* render_interface, CompiledGeometryHandle geometry, const Vector2f& translation, const Vector2f& bounds_min, const Vector2f& bounds_max);
+	/// Defers rendering uncompiled geometry through a render interface. The geometry is copied.
+	/// @param[in] render_interface The render interface to render through.
+	/// @param[in] vertices The geometry's vertex data.
+	/// @param[in] num_vertices The number of vertices.
+	/// @param[in] indices The geometry's index data.
+	/// @param[in] num_indices The number of indices.
+	/// @param[in] texture The texture to be applied to the geometry.
+	/// @param[in] translation The translation to apply to the geometry.
+	/// @return True if the geometry was deferred, false if the render interface isn't deferring geometry and it should be rendered immediately.
+	static bool RenderGeometry(RenderInterface* render_interface, const Vertex* vertices, int num_vertices, const int* indices, int num_indices, TextureHandle texture, const Vector2f& translation);
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "precompiled.h"
+#include "GeometryBuffer.h"
+#include "Threading.h"
+#include <Rocket/Core.h>
+
+namespace Rocket {
+namespace Core {
+
+// The size of the buffer each render interface streams geometry through.
+const int NUM_BUFFER_VERTICES = 65536;
+const int NUM_BUFFER_INDICES = 98304;
+
+struct StreamBuffer
+{
+	GeometryBufferHandle handle;
+	bool generated;
+
+	// The position the next geometry will be written to.
+	int next_vertex;
+	int next_index;
+
+	// The indices of the geometry being written, offset to the vertices' position in the buffer.
+	std::vector< int > indices;
+};
+
+typedef std::map< RenderInterface*, StreamBuffer > StreamBufferMap;
+static StreamBufferMap buffers;
+static Mutex mutex;
+
+// Writes geometry into a render interface's buffer and renders it.
+bool GeometryBuffer::RenderGeometry(RenderInterface* render_interface, const Vertex* vertices, int num_vertices, const int* indices, int num_indices, TextureHandle texture, const Vector2f& translation)
+{
+	if (num_vertices > NUM_BUFFER_VERTICES ||
+		num_indices > NUM_BUFFER_INDICES)
+		return false;
+
+	MutexLock lock(mutex);
+
+	StreamBufferMap::iterator i = buffers.find(render_interface);
+	if (i == buffers.end())
+	{
+		StreamBuffer buffer;
+		buffer.handle = 0;
+		buffer.generated = render_interface->GenerateGeometryBuffer(buffer.handle, NUM_BUFFER_VERTICES, NUM_BUFFER_INDICES);
+		buffer.next_vertex = 0;
+		buffer.next_index = 0;
+
+		i = buffers.insert(StreamBufferMap::value_type(render_interface, buffer)).first;
+	}
+
+	StreamBuffer& buffer = i->second;
+	if (!buffer.generated)
+		return false;
+
+	// Wrap around to the start of the buffer if the geometry won't fit in the remainder of it.
+	if (buffer.next_vertex + num_vertices > NUM_BUFFER_VERTICES ||
+		buffer.next_index + num_indices > NUM_BUFFER_INDICES)
+	{
+		buffer.next_vertex = 0;
+		buffer.next_index = 0;
+	}
+
+	buffer.indices.resize(num_indices);
+	for (int j = 0; j < num_indices; ++j)
+		buffer.indices[j] = indices[j] + buffer.next_vertex;
+
+	render_interface->UpdateGeometryBuffer(buffer.handle, buffer.next_vertex, vertices, num_vertices, buffer.next_index, &buffer.indices[0], num_indices);
+	render_interface->RenderGeometryBuffer(buffer.handle, buffer.next_index, num_indices, texture, translation);
+
+	buffer.next_vertex += num_vertices;
+	buffer.next_index += num_indices;
+
+	return true;
+}
+
+// Releases the buffers of all render interfaces.
+void GeometryBuffer::ReleaseBuffers()
+{
+	MutexLock lock(mutex);
+
+	for (StreamBufferMap::iterator i = buffers.begin(); i != buffers.end(); ++i)
+	{
+		if (i->second.generated)
+			i->first->ReleaseGeometryBuffer(i->second.handle);
+	}
+
+	buffers.clear();
+}
+
+// Releases a render interface's buffer, if it has one.
+void GeometryBuffer::ReleaseBuffer(RenderInterface* render_interface)
+{
+	MutexLock lock(mutex);
+
+	StreamBufferMap::iterator i = buffers.find(render_interface);
+	if (i == buffers.end())
+		return;
+
+	if (i->second.generated)
+		render_interface->ReleaseGeometryBuffer(i->second.handle);
+
+	buffers.erase(i);
+}
+
+}
+}
@@ -0,0 +1,67 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef ROCKETCOREGEOMETRYBUFFER_H
+#define ROCKETCOREGEOMETRYBUFFER_H
+
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+class RenderInterface;
+
+/**
+	Streams geometry that changes too often to be worth compiling through a single large buffer per render interface.
+	Geometry is written into the buffer in a ring, so regenerating it costs no allocations in either Rocket or the
+	application.
+ */
+
+class GeometryBuffer
+{
+public:
+	/// Writes geometry into a render interface's buffer and renders it.
+	/// @param[in] render_interface The render interface to render through.
+	/// @param[in] vertices The geometry's vertex data.
+	/// @param[in] num_vertices The number of vertices.
+	/// @param[in] indices The geometry's index data.
+	/// @param[in] num_indices The number of indices.
+	/// @param[in] texture The texture to be applied to the geometry.
+	/// @param[in] translation The translation to apply to the geometry.
+	/// @return True if the geometry was rendered, false if the render interface doesn't support geometry buffers or the geometry is too large for one.
+	static bool RenderGeometry(RenderInterface* render_interface, const Vertex* vertices, int num_vertices, const int* indices, int num_indices, TextureHandle texture, const Vector2f& translation);
+
+	/// Releases the buffers of all render interfaces.
+	static void ReleaseBuffers();
+	/// Releases a render interface's buffer, if it has one.
+	static void ReleaseBuffer(RenderInterface* render_interface);
+};
+
+}
+}
+
+#endif
@@ -27,6 +27,7 @@
 
 #include "precompiled.h"
 #include "GeometryDatabase.h"
+#include "Threading.h"
 #include <Rocket/Core/Geometry.h>
 
 namespace Rocket {
@@ -34,25 +35,110 @@ namespace Core {
 
 typedef std::set< Geometry* > GeometrySet;
 GeometrySet geometries;
+static Mutex mutex;
+
+// Buffers larger than this are freed rather than pooled, as few geometries would need them.
+const size_t MAX_POOLED_BUFFER_SIZE = 16 * 1024;
+// The maximum number of bytes the pool will hold, and the maximum number of buffers of each type.
+const size_t MAX_POOL_SIZE = 1024 * 1024;
+const size_t MAX_POOLED_BUFFERS = 256;
+
+typedef std::vector< std::vector< Vertex > > VertexBufferPool;
+typedef std::vector< std::vector< int > > IndexBufferPool;
+static VertexBufferPool vertex_pool;
+static IndexBufferPool index_pool;
+static size_t num_vertex_buffers = 0;
+static size_t num_index_buffers = 0;
+static size_t pool_size = 0;
+
+// Moves the storage of the top buffer in a pool into an empty buffer.
+template < typename T >
+static void AcquirePooledBuffer(std::vector< std::vector< T > >& pool, size_t& num_buffers, std::vector< T >& buffer)
+{
+	if (num_buffers == 0)
+		return;
+
+	std::vector< T >& pooled_buffer = pool[--num_buffers];
+	pool_size -= pooled_buffer.capacity() * sizeof(T);
+	buffer.swap(pooled_buffer);
+}
+
+// Moves the storage of a buffer into a pool if it's worth keeping, and frees it otherwise.
+template < typename T >
+static void RecyclePooledBuffer(std::vector< std::vector< T > >& pool, size_t& num_buffers, std::vector< T >& buffer)
+{
+	size_t buffer_size = buffer.capacity() * sizeof(T);
+	if (buffer_size > 0 &&
+		buffer_size <= MAX_POOLED_BUFFER_SIZE &&
+		pool_size + buffer_size <= MAX_POOL_SIZE &&
+		num_buffers < MAX_POOLED_BUFFERS)
+	{
+		// The pool's slots are reserved up front, so the buffers in it are never copied.
+		if (pool.empty())
+			pool.resize(MAX_POOLED_BUFFERS);
+
+		buffer.clear();
+		buffer.swap(pool[num_buffers++]);
+		pool_size += buffer_size;
+	}
+
+	std::vector< T >().swap(buffer);
+}
 
 // Adds a geometry to the database.
 void GeometryDatabase::AddGeometry(Geometry* geometry)
 {
+	MutexLock lock(mutex);
 	geometries.insert(geometry);
 }
 
 // Removes a geometry from the database.
 void GeometryDatabase::RemoveGeometry(Geometry* geometry)
 {
+	MutexLock lock(mutex);
 	geometries.erase(geometry);
 }
 
 // Releases all compiled geometries.
 void GeometryDatabase::ReleaseGeometries()
 {
+	MutexLock lock(mutex);
 	for (GeometrySet::iterator i = geometries.begin(); i != geometries.end(); ++i)
 		(*i)->Release();
 }
 
+// Gives a geometry's vertex buffer the storage of a pooled one, if there are any.
+void GeometryDatabase::AcquireBuffer(std::vector< Vertex >& vertices)
+{
+	MutexLock lock(mutex);
+	AcquirePooledBuffer(vertex_pool, num_vertex_buffers, vertices);
+}
+
+// Gives a geometry's index buffer the storage of a pooled one, if there are any.
+void GeometryDatabase::AcquireBuffer(std::vector< int >& indices)
+{
+	MutexLock lock(mutex);
+	AcquirePooledBuffer(index_pool, num_index_buffers, indices);
+}
+
+// Returns a destroyed geometry's buffers to the pool.
+void GeometryDatabase::RecycleBuffers(std::vector< Vertex >& vertices, std::vector< int >& indices)
+{
+	if (vertices.capacity() == 0 &&
+		indices.capacity() == 0)
+		return;
+
+	MutexLock lock(mutex);
+	RecyclePooledBuffer(vertex_pool, num_vertex_buffers, vertices);
+	RecyclePooledBuffer(index_pool, num_index_buffers, indices);
+}
+
+// Returns the number of bytes held by the buffer pool.
+size_t GeometryDatabase::GetMemoryUsage()
+{
+	MutexLock lock(mutex);
+	return pool_size;
+}
+
 }
 }
@@ -28,13 +28,16 @@
 #ifndef ROCKETCOREGEOMETRYDATABASE_H
 #define ROCKETCOREGEOMETRYDATABASE_H
 
+#include <Rocket/Core/Vertex.h>
+
 namespace Rocket {
 namespace Core {
 
 class Geometry;
 
 /**
-	Stores a list of all active geometries.
+	Stores a list of all active geometries, and a pool of the vertex and index buffers left behind by destroyed
+	geometries for new ones to reuse.
 
 	@author Peter Curry
  */
@@ -51,6 +54,21 @@ public:
 
 	/// Releases all compiled geometries.
 	static void ReleaseGeometries();
+
+	/// Gives a geometry's vertex buffer the storage of a pooled one, if there are any.
+	/// @param[out] vertices The empty vertex buffer to fill.
+	static void AcquireBuffer(std::vector< Vertex >& vertices);
+	/// Gives a geometry's index buffer the storage of a pooled one, if there are any.
+	/// @param[out] indices The empty index buffer to fill.
+	static void AcquireBuffer(std::vector< int >& indices);
+	/// Returns a destroyed geometry's buffers to the pool. Large buffers, and buffers that would take the pool over its
+	/// limit, are freed instead.
+	/// @param[in] vertices The geometry's vertex buffer. This is left without storage.
+	/// @param[in] indices The geometry's index buffer. This is left without storage.
+	static void RecycleBuffers(std::vector< Vertex >& vertices, std::vector< int >& indices);
+
+	/// Returns the number of bytes held by the buffer pool.
+	static size_t GetMemoryUsage();
 };
 
 }
@@ -0,0 +1,1163 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "precompiled.h"
+#include "ImageDecoder.h"
+#include <Rocket/Core.h>
+
+namespace Rocket {
+namespace Core {
+
+// The largest width or height of image we'll decode.
+const int MAX_IMAGE_SIZE = 16384;
+// The most memory we'll allocate for the pixels of a decoded image; this allows 8192x8192 images.
+const size_t MAX_IMAGE_BYTES = 256 * 1024 * 1024;
+// The most a deflate stream can expand its data by.
+const size_t MAX_DEFLATE_RATIO = 1032;
+
+// Reads little- and big-endian integers from a file.
+static unsigned int ReadLittleEndian16(const byte* data)
+{
+	return data[0] | (data[1] << 8);
+}
+
+static unsigned int ReadLittleEndian32(const byte* data)
+{
+	return data[0] | (data[1] << 8) | (data[2] << 16) | ((unsigned int) data[3] << 24);
+}
+
+static unsigned int ReadBigEndian32(const byte* data)
+{
+	return ((unsigned int) data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
+
+static bool IsValidSize(unsigned int width, unsigned int height)
+{
+	return width > 0 &&
+		   height > 0 &&
+		   width <= (unsigned int) MAX_IMAGE_SIZE &&
+		   height <= (unsigned int) MAX_IMAGE_SIZE;
+}
+
+// Returns true if an image's decoded pixels fit in the memory budget.
+static bool IsValidPixelSize(unsigned int width, unsigned int height)
+{
+	return IsValidSize(width, height) &&
+		   (size_t) width * (size_t) height * 4 <= MAX_IMAGE_BYTES;
+}
+
+/**
+	Reads the bits of a deflate stream, least significant first.
+ */
+
+struct BitReader
+{
+	BitReader(const byte* _data, size_t _size) : data(_data), size(_size), position(0), bits(0), num_bits(0)
+	{
+	}
+
+	// Returns the next bits of the stream. Reading past the end of the stream returns zeroes; this is caught by
+	// checking Overrun() once a block has been read.
+	unsigned int Peek(int count)
+	{
+		while (num_bits < count)
+		{
+			if (position < size)
+				bits |= (unsigned int) data[position] << num_bits;
+			++position;
+			num_bits += 8;
+		}
+
+		return bits & ((1u << count) - 1);
+	}
+
+	void Skip(int count)
+	{
+		bits >>= count;
+		num_bits -= count;
+	}
+
+	unsigned int Read(int count)
+	{
+		if (count == 0)
+			return 0;
+
+		unsigned int value = Peek(count);
+		Skip(count);
+		return value;
+	}
+
+	// Discards the bits left in the current byte.
+	void Align()
+	{
+		Skip(num_bits & 7);
+	}
+
+	bool Overrun() const
+	{
+		return position - num_bits / 8 > size;
+	}
+
+	const byte* data;
+	size_t size;
+	size_t position;
+
+	unsigned int bits;
+	int num_bits;
+};
+
+/**
+	A canonical Huffman code of a deflate stream. Codes of up to FAST_BITS bits are decoded through a lookup table,
+	and longer ones a bit at a time.
+ */
+
+struct HuffmanCode
+{
+	enum { MAX_BITS = 15, FAST_BITS = 9 };
+
+	// Builds the code from the lengths of each symbol's code, returning false if the lengths are over-subscribed.
+	bool Build(const byte* lengths, int num_symbols)
+	{
+		memset(counts, 0, sizeof(counts));
+		memset(fast, 0, sizeof(fast));
+
+		for (int i = 0; i < num_symbols; ++i)
+			counts[lengths[i]]++;
+		counts[0] = 0;
+
+		int left = 1;
+		for (int i = 1; i <= MAX_BITS; ++i)
+		{
+			left = (left << 1) - counts[i];
+			if (left < 0)
+				return false;
+		}
+
+		int offsets[MAX_BITS + 1];
+		int next_code[MAX_BITS + 1];
+		offsets[1] = 0;
+		next_code[1] = 0;
+		for (int i = 1; i < MAX_BITS; ++i)
+		{
+			offsets[i + 1] = offsets[i] + counts[i];
+			next_code[i + 1] = (next_code[i] + counts[i]) << 1;
+		}
+
+		for (int i = 0; i < num_symbols; ++i)
+		{
+			int length = lengths[i];
+			if (length == 0)
+				continue;
+
+			symbols[offsets[length]++] = (unsigned short) i;
+
+			// Codes are packed into the stream from their most significant bit, so the table is indexed by the
+			// code's bits reversed.
+			int code = next_code[length]++;
+			if (length <= FAST_BITS)
+			{
+				int reversed = 0;
+				for (int j = 0; j < length; ++j)
+					reversed |= ((code >> j) & 1) << (length - 1 - j);
+
+				for (int j = reversed; j < (1 << FAST_BITS); j += 1 << length)
+					fast[j] = (unsigned short) ((i << 4) | length);
+			}
+		}
+
+		return true;
+	}
+
+	// Decodes the next symbol from the stream, returning -1 if it doesn't match a code.
+	int Decode(BitReader& reader) const
+	{
+		unsigned int entry = fast[reader.Peek(FAST_BITS)];
+		if (entry != 0)
+		{
+			reader.Skip(entry & 15);
+			return entry >> 4;
+		}
+
+		int code = 0;
+		int first = 0;
+		int index = 0;
+		for (int length = 1; length <= MAX_BITS; ++length)
+		{
+			code |= reader.Read(1);
+
+			int count = counts[length];
+			if (code - first < count)
+				return symbols[index + (code - first)];
+
+			index += count;
+			first = (first + count) << 1;
+			code <<= 1;
+		}
+
+		return -1;
+	}
+
+	unsigned short counts[MAX_BITS + 1];
+	unsigned short symbols[288];
+	unsigned short fast[1 << FAST_BITS];
+};
+
+static const unsigned short length_bases[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const byte length_extra_bits[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const unsigned short distance_bases[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const byte distance_extra_bits[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+static const byte code_length_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+// Decodes the symbols of a compressed deflate block.
+static bool InflateBlock(std::vector< byte >& output, size_t max_output, BitReader& reader, const HuffmanCode& lengths, const HuffmanCode& distances)
+{
+	for (;;)
+	{
+		int symbol = lengths.Decode(reader);
+		if (symbol < 0 ||
+			reader.Overrun())
+			return false;
+
+		if (symbol < 256)
+		{
+			if (output.size() >= max_output)
+				return false;
+
+			output.push_back((byte) symbol);
+		}
+		else if (symbol == 256)
+			return true;
+		else
+		{
+			symbol -= 257;
+			if (symbol >= 29)
+				return false;
+
+			size_t length = length_bases[symbol] + reader.Read(length_extra_bits[symbol]);
+
+			int distance_symbol = distances.Decode(reader);
+			if (distance_symbol < 0 ||
+				distance_symbol >= 30)
+				return false;
+
+			size_t distance = distance_bases[distance_symbol] + reader.Read(distance_extra_bits[distance_symbol]);
+			if (distance > output.size() ||
+				output.size() + length > max_output)
+				return false;
+
+			// The copy may overlap the bytes it produces, so it is done a byte at a time.
+			size_t start = output.size() - distance;
+			for (size_t i = 0; i < length; ++i)
+				output.push_back(output[start + i]);
+		}
+	}
+}
+
+// Decompresses a zlib stream, failing if it would produce more than a maximum number of bytes.
+static bool Inflate(std::vector< byte >& output, size_t max_output, const byte* data, size_t size)
+{
+	if (size < 2 ||
+		(data[0] & 15) != 8 ||
+		((data[0] << 8) | data[1]) % 31 != 0 ||
+		(data[1] & 32) != 0)
+		return false;
+
+	BitReader reader(data + 2, size - 2);
+
+	// The maximum is read from the image's header, so we only reserve as much as the stream could actually expand to.
+	output.reserve(Math::Min(max_output, size * MAX_DEFLATE_RATIO));
+
+	HuffmanCode lengths;
+	HuffmanCode distances;
+
+	bool final_block = false;
+	while (!final_block)
+	{
+		final_block = reader.Read(1) != 0;
+		unsigned int type = reader.Read(2);
+
+		if (type == 0)
+		{
+			reader.Align();
+			unsigned int length = reader.Read(16);
+			unsigned int inverse_length = reader.Read(16);
+			if (length != (~inverse_length & 0xffff) ||
+				output.size() + length > max_output)
+				return false;
+
+			for (unsigned int i = 0; i < length; ++i)
+				output.push_back((byte) reader.Read(8));
+		}
+		else if (type == 1)
+		{
+			byte code_lengths[288 + 30];
+			memset(code_lengths, 8, 144);
+			memset(code_lengths + 144, 9, 112);
+			memset(code_lengths + 256, 7, 24);
+			memset(code_lengths + 280, 8, 8);
+			memset(code_lengths + 288, 5, 30);
+
+			lengths.Build(code_lengths, 288);
+			distances.Build(code_lengths + 288, 30);
+
+			if (!InflateBlock(output, max_output, reader, lengths, distances))
+				return false;
+		}
+		else if (type == 2)
+		{
+			int num_length_codes = reader.Read(5) + 257;
+			int num_distance_codes = reader.Read(5) + 1;
+			int num_code_length_codes = reader.Read(4) + 4;
+			if (num_length_codes > 286 ||
+				num_distance_codes > 30)
+				return false;
+
+			byte code_lengths[288 + 30];
+			memset(code_lengths, 0, 19);
+			for (int i = 0; i < num_code_length_codes; ++i)
+				code_lengths[code_length_order[i]] = (byte) reader.Read(3);
+
+			HuffmanCode code_length_code;
+			if (!code_length_code.Build(code_lengths, 19))
+				return false;
+
+			// The lengths of both codes are run-length encoded together.
+			int num_lengths = num_length_codes + num_distance_codes;
+			for (int i = 0; i < num_lengths; )
+			{
+				int symbol = code_length_code.Decode(reader);
+				if (symbol < 0 ||
+					reader.Overrun())
+					return false;
+
+				if (symbol < 16)
+				{
+					code_lengths[i++] = (byte) symbol;
+					continue;
+				}
+
+				byte value = 0;
+				int repeat;
+				if (symbol == 16)
+				{
+					if (i == 0)
+						return false;
+
+					value = code_lengths[i - 1];
+					repeat = 3 + reader.Read(2);
+				}
+				else if (symbol == 17)
+					repeat = 3 + reader.Read(3);
+				else
+					repeat = 11 + reader.Read(7);
+
+				if (i + repeat > num_lengths)
+					return false;
+
+				memset(code_lengths + i, value, repeat);
+				i += repeat;
+			}
+
+			if (!lengths.Build(code_lengths, num_length_codes) ||
+				!distances.Build(code_lengths + num_length_codes, num_distance_codes))
+				return false;
+
+			if (!InflateBlock(output, max_output, reader, lengths, distances))
+				return false;
+		}
+		else
+			return false;
+
+		if (reader.Overrun())
+			return false;
+	}
+
+	return true;
+}
+
+// The starting positions and spacing of the pixels in each pass of an Adam7-interlaced PNG.
+static const int adam7_x[7] = { 0, 4, 0, 2, 0, 1, 0 };
+static const int adam7_y[7] = { 0, 0, 4, 0, 2, 0, 1 };
+static const int adam7_dx[7] = { 8, 8, 4, 4, 2, 2, 1 };
+static const int adam7_dy[7] = { 8, 8, 8, 4, 4, 2, 2 };
+
+// Reverses the filter on a row of a PNG.
+static bool UnfilterRow(byte* row, const byte* previous_row, size_t row_size, int pixel_size, int filter)
+{
+	switch (filter)
+	{
+		case 0:
+			break;
+
+		case 1:
+			for (size_t i = pixel_size; i < row_size; ++i)
+				row[i] = (byte) (row[i] + row[i - pixel_size]);
+			break;
+
+		case 2:
+			for (size_t i = 0; i < row_size; ++i)
+				row[i] = (byte) (row[i] + previous_row[i]);
+			break;
+
+		case 3:
+			for (size_t i = 0; i < row_size; ++i)
+			{
+				int left = i >= (size_t) pixel_size ? row[i - pixel_size] : 0;
+				row[i] = (byte) (row[i] + ((left + previous_row[i]) >> 1));
+			}
+			break;
+
+		case 4:
+			for (size_t i = 0; i < row_size; ++i)
+			{
+				int left = i >= (size_t) pixel_size ? row[i - pixel_size] : 0;
+				int up = previous_row[i];
+				int up_left = i >= (size_t) pixel_size ? previous_row[i - pixel_size] : 0;
+
+				int estimate = left + up - up_left;
+				int left_distance = estimate > left ? estimate - left : left - estimate;
+				int up_distance = estimate > up ? estimate - up : up - estimate;
+				int up_left_distance = estimate > up_left ? estimate - up_left : up_left - estimate;
+
+				int predictor;
+				if (left_distance <= up_distance && left_distance <= up_left_distance)
+					predictor = left;
+				else if (up_distance <= up_left_distance)
+					predictor = up;
+				else
+					predictor = up_left;
+
+				row[i] = (byte) (row[i] + predictor);
+			}
+			break;
+
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+// Returns one sample of a row of a PNG, of any bit depth.
+static unsigned int GetSample(const byte* row, size_t index, int bit_depth)
+{
+	switch (bit_depth)
+	{
+		case 16:	return (row[index * 2] << 8) | row[index * 2 + 1];
+		case 8:		return row[index];
+		default:
+		{
+			size_t bit = index * bit_depth;
+			return (row[bit >> 3] >> (8 - bit_depth - (bit & 7))) & ((1 << bit_depth) - 1);
+		}
+	}
+}
+
+// Decodes a PNG file.
+static bool DecodePNG(std::vector< byte >& data, Vector2i& dimensions, const byte* file_data, size_t file_size)
+{
+	unsigned int width = 0;
+	unsigned int height = 0;
+	int bit_depth = 0;
+	int colour_type = -1;
+	bool interlaced = false;
+
+	byte palette[256 * 4];
+	int palette_size = 0;
+	memset(palette, 255, sizeof(palette));
+
+	bool has_colour_key = false;
+	unsigned int colour_key[3] = { 0, 0, 0 };
+
+	std::vector< byte > compressed_data;
+
+	size_t position = 8;
+	while (position + 12 <= file_size)
+	{
+		unsigned int chunk_size = ReadBigEndian32(file_data + position);
+		const byte* chunk_type = file_data + position + 4;
+		const byte* chunk = file_data + position + 8;
+		if (chunk_size > file_size - position - 12)
+			return false;
+
+		position += chunk_size + 12;
+
+		if (memcmp(chunk_type, "IHDR", 4) == 0)
+		{
+			if (chunk_size < 13)
+				return false;
+
+			width = ReadBigEndian32(chunk);
+			height = ReadBigEndian32(chunk + 4);
+			bit_depth = chunk[8];
+			colour_type = chunk[9];
+			interlaced = chunk[12] == 1;
+
+			if (!IsValidPixelSize(width, height) ||
+				chunk[10] != 0 ||
+				chunk[11] != 0 ||
+				chunk[12] > 1)
+				return false;
+
+			// Check the bit depth is one allowed for the colour type.
+			bool valid_depth;
+			switch (colour_type)
+			{
+				case 0:		valid_depth = bit_depth == 1 || bit_depth == 2 || bit_depth == 4 || bit_depth == 8 || bit_depth == 16; break;
+				case 3:		valid_depth = bit_depth == 1 || bit_depth == 2 || bit_depth == 4 || bit_depth == 8; break;
+				case 2:
+				case 4:
+				case 6:		valid_depth = bit_depth == 8 || bit_depth == 16; break;
+				default:	valid_depth = false; break;
+			}
+
+			if (!valid_depth)
+				return false;
+		}
+		else if (memcmp(chunk_type, "PLTE", 4) == 0)
+		{
+			palette_size = Math::Min((int) chunk_size / 3, 256);
+			for (int i = 0; i < palette_size; ++i)
+			{
+				palette[i * 4 + 0] = chunk[i * 3 + 0];
+				palette[i * 4 + 1] = chunk[i * 3 + 1];
+				palette[i * 4 + 2] = chunk[i * 3 + 2];
+			}
+		}
+		else if (memcmp(chunk_type, "tRNS", 4) == 0)
+		{
+			if (colour_type == 3)
+			{
+				for (unsigned int i = 0; i < chunk_size && i < 256; ++i)
+					palette[i * 4 + 3] = chunk[i];
+			}
+			else if (colour_type == 0 && chunk_size >= 2)
+			{
+				has_colour_key = true;
+				colour_key[0] = (chunk[0] << 8) | chunk[1];
+			}
+			else if (colour_type == 2 && chunk_size >= 6)
+			{
+				has_colour_key = true;
+				for (int i = 0; i < 3; ++i)
+					colour_key[i] = (chunk[i * 2] << 8) | chunk[i * 2 + 1];
+			}
+		}
+		else if (memcmp(chunk_type, "IDAT", 4) == 0)
+			compressed_data.insert(compressed_data.end(), chunk, chunk + chunk_size);
+		else if (memcmp(chunk_type, "IEND", 4) == 0)
+			break;
+	}
+
+	if (colour_type < 0 ||
+		compressed_data.empty() ||
+		(colour_type == 3 && palette_size == 0))
+		return false;
+
+	int num_channels;
+	switch (colour_type)
+	{
+		case 2:		num_channels = 3; break;
+		case 4:		num_channels = 2; break;
+		case 6:		num_channels = 4; break;
+		default:	num_channels = 1; break;
+	}
+
+	int pixel_bits = num_channels * bit_depth;
+	int pixel_size = Math::Max(pixel_bits / 8, 1);
+
+	// Work out the size of the filtered image, including the filter byte on each row of each pass.
+	size_t filtered_size = 0;
+	for (int pass = 0; pass < (interlaced ? 7 : 1); ++pass)
+	{
+		size_t pass_width = interlaced ? (width - adam7_x[pass] + adam7_dx[pass] - 1) / adam7_dx[pass] : width;
+		size_t pass_height = interlaced ? (height - adam7_y[pass] + adam7_dy[pass] - 1) / adam7_dy[pass] : height;
+		if (pass_width > 0 && pass_height > 0)
+			filtered_size += ((pass_width * pixel_bits + 7) / 8 + 1) * pass_height;
+	}
+
+	std::vector< byte > filtered_data;
+	if (!Inflate(filtered_data, filtered_size, &compressed_data[0], compressed_data.size()) ||
+		filtered_data.size() != filtered_size)
+		return false;
+
+	data.resize((size_t) width * height * 4);
+
+	byte* filtered_row = &filtered_data[0];
+	std::vector< byte > blank_row;
+
+	for (int pass = 0; pass < (interlaced ? 7 : 1); ++pass)
+	{
+		int x0 = interlaced ? adam7_x[pass] : 0;
+		int y0 = interlaced ? adam7_y[pass] : 0;
+		int dx = interlaced ? adam7_dx[pass] : 1;
+		int dy = interlaced ? adam7_dy[pass] : 1;
+
+		size_t pass_width = (width - x0 + dx - 1) / dx;
+		size_t pass_height = (height - y0 + dy - 1) / dy;
+		if (pass_width == 0 ||
+			pass_height == 0)
+			continue;
+
+		size_t row_size = (pass_width * pixel_bits + 7) / 8;
+		blank_row.assign(row_size, 0);
+		const byte* previous_row = &blank_row[0];
+
+		for (size_t y = 0; y < pass_height; ++y)
+		{
+			byte* row = filtered_row + 1;
+			if (!UnfilterRow(row, previous_row, row_size, pixel_size, filtered_row[0]))
+				return false;
+
+			byte* pixel = &data[((y0 + y * dy) * width + x0) * 4];
+			for (size_t x = 0; x < pass_width; ++x, pixel += dx * 4)
+			{
+				if (colour_type == 3)
+				{
+					unsigned int index = GetSample(row, x, bit_depth);
+					memcpy(pixel, &palette[index * 4], 4);
+					continue;
+				}
+
+				unsigned int samples[4];
+				for (int i = 0; i < num_channels; ++i)
+					samples[i] = GetSample(row, x * num_channels + i, bit_depth);
+
+				bool transparent = false;
+				if (has_colour_key)
+				{
+					transparent = samples[0] == colour_key[0];
+					if (colour_type == 2)
+						transparent = transparent && samples[1] == colour_key[1] && samples[2] == colour_key[2];
+				}
+
+				// Scale the samples to eight bits.
+				for (int i = 0; i < num_channels; ++i)
+				{
+					if (bit_depth == 16)
+						samples[i] >>= 8;
+					else if (bit_depth < 8)
+						samples[i] = samples[i] * 255 / ((1 << bit_depth) - 1);
+				}
+
+				switch (colour_type)
+				{
+					case 0:
+					case 4:
+						pixel[0] = pixel[1] = pixel[2] = (byte) samples[0];
+						pixel[3] = colour_type == 4 ? (byte) samples[1] : (transparent ? 0 : 255);
+						break;
+
+					default:
+						pixel[0] = (byte) samples[0];
+						pixel[1] = (byte) samples[1];
+						pixel[2] = (byte) samples[2];
+						pixel[3] = colour_type == 6 ? (byte) samples[3] : (transparent ? 0 : 255);
+						break;
+				}
+			}
+
+			previous_row = row;
+			filtered_row += row_size + 1;
+		}
+	}
+
+	dimensions = Vector2i((int) width, (int) height);
+	return true;
+}
+
+// Reads one pixel of a TGA's image or colour map.
+static void ReadTGAPixel(byte* pixel, const byte* source, int bits_per_pixel, bool has_alpha)
+{
+	switch (bits_per_pixel)
+	{
+		case 8:
+			pixel[0] = pixel[1] = pixel[2] = source[0];
+			pixel[3] = 255;
+			break;
+
+		case 15:
+		case 16:
+		{
+			unsigned int value = ReadLittleEndian16(source);
+			pixel[0] = (byte) (((value >> 10) & 31) * 255 / 31);
+			pixel[1] = (byte) (((value >> 5) & 31) * 255 / 31);
+			pixel[2] = (byte) ((value & 31) * 255 / 31);
+			pixel[3] = (has_alpha && bits_per_pixel == 16 && (value & 0x8000) == 0) ? 0 : 255;
+			break;
+		}
+
+		default:
+			pixel[0] = source[2];
+			pixel[1] = source[1];
+			pixel[2] = source[0];
+			pixel[3] = (has_alpha && bits_per_pixel == 32) ? source[3] : 255;
+			break;
+	}
+}
+
+// Decodes a TGA file.
+static bool DecodeTGA(std::vector< byte >& data, Vector2i& dimensions, const byte* file_data, size_t file_size)
+{
+	if (file_size < 18)
+		return false;
+
+	int id_length = file_data[0];
+	int colour_map_type = file_data[1];
+	int image_type = file_data[2];
+	unsigned int colour_map_origin = ReadLittleEndian16(file_data + 3);
+	unsigned int colour_map_length = ReadLittleEndian16(file_data + 5);
+	int colour_map_bits = file_data[7];
+	unsigned int width = ReadLittleEndian16(file_data + 12);
+	unsigned int height = ReadLittleEndian16(file_data + 14);
+	int bits_per_pixel = file_data[16];
+	int descriptor = file_data[17];
+
+	bool run_length_encoded = image_type >= 9;
+	int base_type = run_length_encoded ? image_type - 8 : image_type;
+	if (base_type < 1 ||
+		base_type > 3 ||
+		!IsValidPixelSize(width, height))
+		return false;
+
+	// Colour-mapped images have eight-bit indices, and greyscale ones eight-bit values.
+	if (base_type == 2)
+	{
+		if (bits_per_pixel != 15 && bits_per_pixel != 16 && bits_per_pixel != 24 && bits_per_pixel != 32)
+			return false;
+	}
+	else if (bits_per_pixel != 8)
+		return false;
+
+	// The alpha bits are only used if the descriptor says they are there.
+	bool has_alpha = (descriptor & 15) != 0;
+
+	size_t position = 18 + id_length;
+
+	std::vector< byte > colour_map;
+	if (colour_map_type == 1)
+	{
+		int entry_size = (colour_map_bits + 7) / 8;
+		if (entry_size < 2 ||
+			entry_size > 4 ||
+			position + colour_map_length * entry_size > file_size)
+			return false;
+
+		colour_map.resize((colour_map_origin + colour_map_length) * 4, 0);
+		for (unsigned int i = 0; i < colour_map_length; ++i)
+			ReadTGAPixel(&colour_map[(colour_map_origin + i) * 4], file_data + position + i * entry_size, colour_map_bits, has_alpha || colour_map_bits == 32);
+
+		position += colour_map_length * entry_size;
+	}
+	else if (base_type == 1)
+		return false;
+
+	int pixel_size = (bits_per_pixel + 7) / 8;
+	size_t num_pixels = (size_t) width * height;
+
+	// Read the pixels in file order; they are flipped into place afterwards.
+	std::vector< byte > pixels(num_pixels * 4);
+	for (size_t i = 0; i < num_pixels; )
+	{
+		size_t run_length = 1;
+		bool repeated = false;
+
+		if (run_length_encoded)
+		{
+			if (position >= file_size)
+				return false;
+
+			byte header = file_data[position++];
+			run_length = (header & 127) + 1;
+			repeated = (header & 128) != 0;
+
+			if (i + run_length > num_pixels)
+				return false;
+		}
+
+		for (size_t j = 0; j < run_length; ++j)
+		{
+			if (!repeated || j == 0)
+			{
+				if (position + pixel_size > file_size)
+					return false;
+			}
+
+			byte* pixel = &pixels[(i + j) * 4];
+			const byte* source = file_data + position;
+
+			if (base_type == 1)
+			{
+				if ((size_t) source[0] * 4 >= colour_map.size())
+					return false;
+
+				memcpy(pixel, &colour_map[source[0] * 4], 4);
+			}
+			else
+				ReadTGAPixel(pixel, source, bits_per_pixel, has_alpha);
+
+			if (!repeated)
+				position += pixel_size;
+		}
+
+		if (repeated)
+			position += pixel_size;
+
+		i += run_length;
+	}
+
+	// Images are stored bottom-up and left-to-right unless the descriptor says otherwise.
+	bool top_to_bottom = (descriptor & 32) != 0;
+	bool right_to_left = (descriptor & 16) != 0;
+
+	data.resize(num_pixels * 4);
+	for (unsigned int y = 0; y < height; ++y)
+	{
+		unsigned int source_y = top_to_bottom ? y : height - 1 - y;
+		for (unsigned int x = 0; x < width; ++x)
+		{
+			unsigned int source_x = right_to_left ? width - 1 - x : x;
+			memcpy(&data[((size_t) y * width + x) * 4], &pixels[((size_t) source_y * width + source_x) * 4], 4);
+		}
+	}
+
+	dimensions = Vector2i((int) width, (int) height);
+	return true;
+}
+
+// Returns the size of one block of a compressed format.
+static int GetBlockSize(RenderInterface::CompressedTextureFormat format)
+{
+	switch (format)
+	{
+		case RenderInterface::COMPRESSED_BC1:
+		case RenderInterface::COMPRESSED_ETC1:
+		case RenderInterface::COMPRESSED_ETC2_RGB:
+			return 8;
+
+		default:
+			return 16;
+	}
+}
+
+// Reads the blocks of a DDS file.
+static bool ReadDDS(std::vector< byte >& data, RenderInterface::CompressedTextureFormat& format, Vector2i& dimensions, int& num_mipmaps, const byte* file_data, size_t file_size)
+{
+	const unsigned int DDSD_MIPMAPCOUNT = 0x20000;
+	const unsigned int DDPF_FOURCC = 0x4;
+	const unsigned int DDSCAPS2_CUBEMAP = 0x200;
+	const unsigned int DDSCAPS2_VOLUME = 0x200000;
+
+	if (file_size < 128 ||
+		ReadLittleEndian32(file_data + 4) != 124)
+		return false;
+
+	unsigned int flags = ReadLittleEndian32(file_data + 8);
+	unsigned int height = ReadLittleEndian32(file_data + 12);
+	unsigned int width = ReadLittleEndian32(file_data + 16);
+	unsigned int mipmap_count = ReadLittleEndian32(file_data + 28);
+	unsigned int pixel_format_flags = ReadLittleEndian32(file_data + 80);
+	const byte* four_cc = file_data + 84;
+	unsigned int caps2 = ReadLittleEndian32(file_data + 112);
+
+	if (!IsValidSize(width, height) ||
+		(pixel_format_flags & DDPF_FOURCC) == 0 ||
+		(caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) != 0)
+		return false;
+
+	size_t position = 128;
+
+	if (memcmp(four_cc, "DXT1", 4) == 0)
+		format = RenderInterface::COMPRESSED_BC1;
+	else if (memcmp(four_cc, "DXT2", 4) == 0 || memcmp(four_cc, "DXT3", 4) == 0)
+		format = RenderInterface::COMPRESSED_BC2;
+	else if (memcmp(four_cc, "DXT4", 4) == 0 || memcmp(four_cc, "DXT5", 4) == 0)
+		format = RenderInterface::COMPRESSED_BC3;
+	else if (memcmp(four_cc, "DX10", 4) == 0)
+	{
+		// The extended header names the format by its DXGI_FORMAT, and must describe a single 2D texture.
+		if (file_size < 148 ||
+			ReadLittleEndian32(file_data + 132) != 3 ||
+			ReadLittleEndian32(file_data + 140) > 1)
+			return false;
+
+		switch (ReadLittleEndian32(file_data + 128))
+		{
+			case 71:
+			case 72:	format = RenderInterface::COMPRESSED_BC1; break;
+			case 74:
+			case 75:	format = RenderInterface::COMPRESSED_BC2; break;
+			case 77:
+			case 78:	format = RenderInterface::COMPRESSED_BC3; break;
+			case 98:
+			case 99:	format = RenderInterface::COMPRESSED_BC7; break;
+			default:	return false;
+		}
+
+		position = 148;
+	}
+	else
+		return false;
+
+	dimensions = Vector2i((int) width, (int) height);
+	num_mipmaps = (flags & DDSD_MIPMAPCOUNT) != 0 ? Math::Max((int) mipmap_count, 1) : 1;
+
+	// The levels are stored one after another, so they can be copied out in one go.
+	size_t size = 0;
+	Vector2i level_dimensions = dimensions;
+	for (int i = 0; i < num_mipmaps; ++i)
+	{
+		size += ImageDecoder::GetCompressedSize(format, level_dimensions);
+		if (level_dimensions.x == 1 && level_dimensions.y == 1)
+		{
+			num_mipmaps = i + 1;
+			break;
+		}
+
+		level_dimensions = Vector2i(Math::Max(level_dimensions.x / 2, 1), Math::Max(level_dimensions.y / 2, 1));
+	}
+
+	if (size > file_size - position)
+		return false;
+
+	data.assign(file_data + position, file_data + position + size);
+	return true;
+}
+
+// Reads the blocks of a KTX file.
+static bool ReadKTX(std::vector< byte >& data, RenderInterface::CompressedTextureFormat& format, Vector2i& dimensions, int& num_mipmaps, const byte* file_data, size_t file_size)
+{
+	if (file_size < 64)
+		return false;
+
+	// The header's fields are written in the endianness of the machine that wrote the file.
+	unsigned int endianness = ReadLittleEndian32(file_data + 12);
+	if (endianness != 0x04030201 &&
+		endianness != 0x01020304)
+		return false;
+
+	bool big_endian = endianness == 0x01020304;
+	unsigned int header[12];
+	for (int i = 0; i < 12; ++i)
+		header[i] = big_endian ? ReadBigEndian32(file_data + 16 + i * 4) : ReadLittleEndian32(file_data + 16 + i * 4);
+
+	unsigned int gl_type = header[0];
+	unsigned int gl_internal_format = header[3];
+	unsigned int width = header[5];
+	unsigned int height = header[6];
+	unsigned int depth = header[7];
+	unsigned int num_array_elements = header[8];
+	unsigned int num_faces = header[9];
+	unsigned int num_levels = header[10];
+	unsigned int key_value_size = header[11];
+
+	if (gl_type != 0 ||
+		!IsValidSize(width, height) ||
+		depth > 1 ||
+		num_array_elements > 1 ||
+		num_faces != 1)
+		return false;
+
+	switch (gl_internal_format)
+	{
+		case 0x83F0:	// GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+		case 0x83F1:	// GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+		case 0x8C4C:	// GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+		case 0x8C4D:	// GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+			format = RenderInterface::COMPRESSED_BC1;
+			break;
+
+		case 0x83F2:	// GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+		case 0x8C4E:	// GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT
+			format = RenderInterface::COMPRESSED_BC2;
+			break;
+
+		case 0x83F3:	// GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+		case 0x8C4F:	// GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+			format = RenderInterface::COMPRESSED_BC3;
+			break;
+
+		case 0x8E8C:	// GL_COMPRESSED_RGBA_BPTC_UNORM
+		case 0x8E8D:	// GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+			format = RenderInterface::COMPRESSED_BC7;
+			break;
+
+		case 0x8D64:	// GL_ETC1_RGB8_OES
+			format = RenderInterface::COMPRESSED_ETC1;
+			break;
+
+		case 0x9274:	// GL_COMPRESSED_RGB8_ETC2
+		case 0x9275:	// GL_COMPRESSED_SRGB8_ETC2
+			format = RenderInterface::COMPRESSED_ETC2_RGB;
+			break;
+
+		case 0x9278:	// GL_COMPRESSED_RGBA8_ETC2_EAC
+		case 0x9279:	// GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC
+			format = RenderInterface::COMPRESSED_ETC2_RGBA;
+			break;
+
+		case 0x93B0:	// GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+		case 0x93D0:	// GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR
+			format = RenderInterface::COMPRESSED_ASTC_4X4;
+			break;
+
+		default:
+			return false;
+	}
+
+	dimensions = Vector2i((int) width, (int) height);
+	num_mipmaps = Math::Max((int) Math::Min(num_levels, 32u), 1);
+
+	if (key_value_size > file_size - 64)
+		return false;
+
+	// Each level is prefixed with its size and padded to four bytes, so the blocks are copied out level by level.
+	size_t position = 64 + key_value_size;
+	Vector2i level_dimensions = dimensions;
+	data.clear();
+
+	for (int i = 0; i < num_mipmaps; ++i)
+	{
+		if (position + 4 > file_size)
+			return false;
+
+		size_t image_size = big_endian ? ReadBigEndian32(file_data + position) : ReadLittleEndian32(file_data + position);
+		size_t level_size = ImageDecoder::GetCompressedSize(format, level_dimensions);
+		position += 4;
+
+		if (image_size < level_size ||
+			image_size > file_size - position)
+			return false;
+
+		data.insert(data.end(), file_data + position, file_data + position + level_size);
+		position += (image_size + 3) & ~(size_t) 3;
+
+		if (level_dimensions.x == 1 && level_dimensions.y == 1)
+		{
+			num_mipmaps = i + 1;
+			break;
+		}
+
+		level_dimensions = Vector2i(Math::Max(level_dimensions.x / 2, 1), Math::Max(level_dimensions.y / 2, 1));
+	}
+
+	return true;
+}
+
+// Loads a texture from a file, through a render interface.
+bool ImageDecoder::LoadTexture(RenderInterface* render_interface, TextureHandle& texture_handle, Vector2i& texture_dimensions, size_t& texture_size, const String& source)
+{
+	texture_size = 0;
+
+	FileInterface* file_interface = GetFileInterface();
+	FileHandle file = file_interface->Open(source);
+	if (!file)
+		return false;
+
+	std::vector< byte > buffer;
+	size_t file_size = 0;
+	const byte* file_data = ReadFile(file, file_size, buffer);
+
+	bool success = false;
+	if (file_data != NULL)
+	{
+		std::vector< byte > data;
+		RenderInterface::CompressedTextureFormat format;
+		int num_mipmaps;
+
+		if (ReadCompressed(data, format, texture_dimensions, num_mipmaps, file_data, file_size))
+		{
+			success = render_interface->GenerateCompressedTexture(texture_handle, format, &data[0], data.size(), texture_dimensions, num_mipmaps);
+			if (success)
+				texture_size = data.size();
+		}
+		else if (Decode(data, texture_dimensions, file_data, file_size, source))
+			success = render_interface->GenerateTexture(texture_handle, &data[0], texture_dimensions);
+	}
+
+	file_interface->Close(file);
+	return success;
+}
+
+// Reads the contents of a file through the file interface.
+const byte* ImageDecoder::ReadFile(FileHandle file, size_t& size, std::vector< byte >& buffer)
+{
+	FileInterface* file_interface = GetFileInterface();
+
+	size = 0;
+	const byte* data = static_cast< const byte* >(file_interface->Map(file, size));
+	if (data != NULL)
+		return size > 0 ? data : NULL;
+
+	buffer.resize(file_interface->Length(file));
+	if (buffer.empty())
+		return NULL;
+
+	size = file_interface->Read(&buffer[0], buffer.size(), file);
+	return size > 0 ? &buffer[0] : NULL;
+}
+
+// Decodes a PNG or TGA file into 32-bit pixels.
+bool ImageDecoder::Decode(std::vector< byte >& data, Vector2i& dimensions, const byte* file_data, size_t file_size, const String& source)
+{
+	static const byte png_signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+	if (file_size >= 8 &&
+		memcmp(file_data, png_signature, 8) == 0)
+		return DecodePNG(data, dimensions, file_data, file_size);
+
+	// TGA files have no signature, so we go by the extension.
+	String extension = source.Substring(source.RFind(".") + 1).ToLower();
+	if (extension == "tga")
+		return DecodeTGA(data, dimensions, file_data, file_size);
+
+	return false;
+}
+
+// Reads the blocks of a GPU-compressed texture from a DDS or KTX file.
+bool ImageDecoder::ReadCompressed(std::vector< byte >& data, RenderInterface::CompressedTextureFormat& format, Vector2i& dimensions, int& num_mipmaps, const byte* file_data, size_t file_size)
+{
+	static const byte ktx_identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+	if (file_size >= 4 &&
+		memcmp(file_data, "DDS ", 4) == 0)
+		return ReadDDS(data, format, dimensions, num_mipmaps, file_data, file_size);
+
+	if (file_size >= 12 &&
+		memcmp(file_data, ktx_identifier, 12) == 0)
+		return ReadKTX(data, format, dimensions, num_mipmaps, file_data, file_size);
+
+	return false;
+}
+
+// Returns the size of one mipmap level of a compressed texture.
+size_t ImageDecoder::GetCompressedSize(RenderInterface::CompressedTextureFormat format, const Vector2i& dimensions)
+{
+	return (size_t) ((dimensions.x + 3) / 4) * (size_t) ((dimensions.y + 3) / 4) * GetBlockSize(format);
+}
+
+}
+}
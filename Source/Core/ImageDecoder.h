@@ -0,0 +1,91 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef ROCKETCOREIMAGEDECODER_H
+#define ROCKETCOREIMAGEDECODER_H
+
+#include <Rocket/Core/RenderInterface.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	The built-in image decoder, used by the render interface's default LoadTexture() and DecodeTexture(). PNG and TGA
+	files are decoded into 32-bit pixels for GenerateTexture(), and the blocks of GPU-compressed textures in DDS and KTX
+	containers are passed through to GenerateCompressedTexture() untouched.
+ */
+
+class ImageDecoder
+{
+public:
+	/// Loads a texture from a file, through a render interface.
+	/// @param[in] render_interface The render interface to generate the texture through.
+	/// @param[out] texture_handle The handle of the generated texture.
+	/// @param[out] texture_dimensions The dimensions of the texture.
+	/// @param[out] texture_size The number of bytes of compressed blocks the texture was generated from, or 0 if it was generated from pixels.
+	/// @param[in] source The file to load.
+	/// @return True if the texture was loaded, false if the file couldn't be read or decoded, or the texture couldn't be generated.
+	static bool LoadTexture(RenderInterface* render_interface, TextureHandle& texture_handle, Vector2i& texture_dimensions, size_t& texture_size, const String& source);
+
+	/// Reads the contents of a file through the file interface, mapping it into memory if the file interface can do so.
+	/// @param[in] file The open file to read.
+	/// @param[out] size The length of the contents.
+	/// @param[out] buffer The buffer the contents are read into if the file can't be mapped.
+	/// @return The file's contents, or NULL if the file is empty. These are valid until the file is closed and the buffer is destroyed.
+	static const byte* ReadFile(FileHandle file, size_t& size, std::vector< byte >& buffer);
+
+	/// Decodes a PNG or TGA file into 32-bit pixels. TGA files are recognised by their extension.
+	/// @param[out] data The decoded pixels, in red, green, blue, alpha order.
+	/// @param[out] dimensions The dimensions of the image.
+	/// @param[in] file_data The contents of the file.
+	/// @param[in] file_size The length of the file.
+	/// @param[in] source The name of the file.
+	/// @return True if the file was decoded, false if it is in another format or is corrupt.
+	static bool Decode(std::vector< byte >& data, Vector2i& dimensions, const byte* file_data, size_t file_size, const String& source);
+
+	/// Reads the blocks of a GPU-compressed texture from a DDS or KTX file. Only two-dimensional textures in one of the
+	/// formats in RenderInterface::CompressedTextureFormat are read.
+	/// @param[out] data The blocks of each mipmap level in turn, from the largest down.
+	/// @param[out] format The format of the blocks.
+	/// @param[out] dimensions The dimensions of the largest mipmap level.
+	/// @param[out] num_mipmaps The number of mipmap levels.
+	/// @param[in] file_data The contents of the file.
+	/// @param[in] file_size The length of the file.
+	/// @return True if the file held a compressed texture, false if not.
+	static bool ReadCompressed(std::vector< byte >& data, RenderInterface::CompressedTextureFormat& format, Vector2i& dimensions, int& num_mipmaps, const byte* file_data, size_t file_size);
+
+	/// Returns the size of one mipmap level of a compressed texture.
+	/// @param[in] format The format of the texture.
+	/// @param[in] dimensions The dimensions of the level.
+	/// @return The size of the level's blocks, in bytes.
+	static size_t GetCompressedSize(RenderInterface::CompressedTextureFormat format, const Vector2i& dimensions);
+};
+
+}
+}
+
+#endif
@@ -463,7 +463,8 @@ void LayoutBlockBox::CloseAbsoluteElements()
 			Vector2f absolute_position = absolute_elements[i].position;
 			absolute_position -= position - offset_root->GetPosition();
 
-			// Lay out the element.
+			// Lay out the element. Absolute elements share their stacking context and ancestors with their siblings,
+			// which their layout may modify (when it creates scrollbars, for example), so they are formatted serially.
 			LayoutEngine layout_engine;
 			layout_engine.FormatElement(absolute_element, containing_block);
 
@@ -31,6 +31,7 @@
 #include "Pool.h"
 #include "LayoutBlockBoxSpace.h"
 #include "LayoutInlineBoxText.h"
+#include "Threading.h"
 #include <Rocket/Core/Element.h>
 #include <Rocket/Core/ElementScroll.h>
 #include <Rocket/Core/ElementText.h>
@@ -56,6 +57,7 @@ struct LayoutChunk
 };
 
 static Pool< LayoutChunk > layout_chunk_pool(200, true);
+static Mutex layout_chunk_mutex;
 
 LayoutEngine::LayoutEngine()
 {
@@ -70,6 +72,8 @@ LayoutEngine::~LayoutEngine()
 // Formats the contents for a root-level element (usually a document or floating element).
 bool LayoutEngine::FormatElement(Element* element, const Vector2f& containing_block)
 {
+	Profiler::IncrementCounter(Profiler::ELEMENTS_LAID_OUT);
+
 	block_box = new LayoutBlockBox(this, NULL, NULL);
 	block_box->GetBox().SetContent(containing_block);
 
@@ -217,13 +221,16 @@ void LayoutEngine::BuildBox(Box& box, float& min_height, float& max_height, Layo
 	float box_height = box.GetSize().y;
 	if (box_height < 0)
 	{
-		if (element->GetLocalProperty(MIN_HEIGHT) != NULL)
-			min_height = element->ResolveProperty(MIN_HEIGHT, containing_block.y);
+		const Property *min_height_property, *max_height_property;
+		element->GetLocalMinMaxDimensionProperties(NULL, NULL, &min_height_property, &max_height_property);
+
+		if (min_height_property != NULL)
+			min_height = element->ResolveProperty(min_height_property, containing_block.y);
 		else
 			min_height = 0;
 
-		if (element->GetLocalProperty(MAX_HEIGHT) != NULL)
-			max_height = element->ResolveProperty(MAX_HEIGHT, containing_block.y);
+		if (max_height_property != NULL)
+			max_height = element->ResolveProperty(max_height_property, containing_block.y);
 		else
 			max_height = FLT_MAX;
 	}
@@ -239,13 +246,16 @@ float LayoutEngine::ClampWidth(float width, Element* element, float containing_b
 {
 	float min_width, max_width;
 
-	if (element->GetLocalProperty(MIN_WIDTH) != NULL)
-		min_width = element->ResolveProperty(MIN_WIDTH, containing_block_width);
+	const Property *min_width_property, *max_width_property;
+	element->GetLocalMinMaxDimensionProperties(&min_width_property, &max_width_property, NULL, NULL);
+
+	if (min_width_property != NULL)
+		min_width = element->ResolveProperty(min_width_property, containing_block_width);
 	else
 		min_width = 0;
 
-	if (element->GetLocalProperty(MAX_WIDTH) != NULL)
-		max_width = element->ResolveProperty(MAX_WIDTH, containing_block_width);
+	if (max_width_property != NULL)
+		max_width = element->ResolveProperty(max_width_property, containing_block_width);
 	else
 		max_width = FLT_MAX;
 
@@ -257,13 +267,16 @@ float LayoutEngine::ClampHeight(float height, Element* element, float containing
 {
 	float min_height, max_height;
 
-	if (element->GetLocalProperty(MIN_HEIGHT) != NULL)
-		min_height = element->ResolveProperty(MIN_HEIGHT, containing_block_height);
+	const Property *min_height_property, *max_height_property;
+	element->GetLocalMinMaxDimensionProperties(NULL, NULL, &min_height_property, &max_height_property);
+
+	if (min_height_property != NULL)
+		min_height = element->ResolveProperty(min_height_property, containing_block_height);
 	else
 		min_height = 0;
 
-	if (element->GetLocalProperty(MAX_HEIGHT) != NULL)
-		max_height = element->ResolveProperty(MAX_HEIGHT, containing_block_height);
+	if (max_height_property != NULL)
+		max_height = element->ResolveProperty(max_height_property, containing_block_height);
 	else
 		max_height = FLT_MAX;
 
@@ -290,11 +303,13 @@ void* LayoutEngine::AllocateLayoutChunk(size_t size)
 	(void)size;
 	ROCKET_ASSERT(size <= LayoutChunk::size);
 
+	MutexLock lock(layout_chunk_mutex);
 	return layout_chunk_pool.AllocateObject();
 }
 
 void LayoutEngine::DeallocateLayoutChunk(void* chunk)
 {
+	MutexLock lock(layout_chunk_mutex);
 	layout_chunk_pool.DeallocateObject((LayoutChunk*) chunk);
 }
 
@@ -347,6 +362,8 @@ bool LayoutEngine::FormatElement(Element* element)
 // Formats and positions an element as a block element.
 bool LayoutEngine::FormatElementBlock(Element* element)
 {
+	Profiler::IncrementCounter(Profiler::ELEMENTS_LAID_OUT);
+
 	LayoutBlockBox* new_block_context_box = block_context_box->AddBlockElement(element);
 	if (new_block_context_box == NULL)
 		return false;
@@ -397,6 +414,8 @@ bool LayoutEngine::FormatElementBlock(Element* element)
 // Formats and positions an element as an inline element.
 bool LayoutEngine::FormatElementInline(Element* element)
 {
+	Profiler::IncrementCounter(Profiler::ELEMENTS_LAID_OUT);
+
 	Box box;
 	float min_height, max_height;
 	BuildBox(box, min_height, max_height, block_context_box, element, true);
@@ -0,0 +1,92 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include <Rocket/Core/MemoryUsage.h>
+
+namespace Rocket {
+namespace Core {
+
+static const char* category_names[MemoryUsage::NUM_CATEGORIES] =
+{
+	"Elements",
+	"Styles",
+	"Properties",
+	"Geometry",
+	"Style sheets",
+	"Fonts",
+	"Textures"
+};
+
+MemoryUsage::MemoryUsage()
+{
+	for (int i = 0; i < NUM_CATEGORIES; ++i)
+		bytes[i] = 0;
+}
+
+// Adds to the number of bytes used in a category.
+void MemoryUsage::Add(Category category, size_t _bytes)
+{
+	bytes[category] += _bytes;
+}
+
+// Adds the usage from another breakdown into this one.
+void MemoryUsage::Add(const MemoryUsage& usage)
+{
+	for (int i = 0; i < NUM_CATEGORIES; ++i)
+		bytes[i] += usage.bytes[i];
+}
+
+// Returns the number of bytes used in a category.
+size_t MemoryUsage::Get(Category category) const
+{
+	return bytes[category];
+}
+
+// Returns the number of bytes used across all categories.
+size_t MemoryUsage::GetTotal() const
+{
+	size_t total = 0;
+	for (int i = 0; i < NUM_CATEGORIES; ++i)
+		total += bytes[i];
+
+	return total;
+}
+
+// Returns the name of a category.
+const char* MemoryUsage::GetCategoryName(Category category)
+{
+	if (category < 0 ||
+		category >= NUM_CATEGORIES)
+		return "";
+
+	return category_names[category];
+}
+
+}
+}
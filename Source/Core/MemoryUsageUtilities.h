@@ -0,0 +1,69 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREMEMORYUSAGEUTILITIES_H
+#define ROCKETCOREMEMORYUSAGEUTILITIES_H
+
+#include <Rocket/Core/String.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	Estimates of the heap memory held by the containers used through Rocket, for building MemoryUsage breakdowns.
+ */
+
+class MemoryUsageUtilities
+{
+public:
+	/// Returns the bytes held by a vector's buffer.
+	template < typename T >
+	static size_t GetVectorSize(const std::vector< T >& vector)
+	{
+		return vector.capacity() * sizeof(T);
+	}
+
+	/// Returns the bytes held by the nodes of an ordered associative container (a set or map). Each node holds its
+	/// value, three links and a colour.
+	template < typename T >
+	static size_t GetTreeSize(const T& container)
+	{
+		return container.size() * (sizeof(typename T::value_type) + 4 * sizeof(void*));
+	}
+
+	/// Returns the bytes held by a string's heap buffer; short strings are stored within the string itself.
+	static size_t GetStringSize(const String& string)
+	{
+		return string.Length() < 8 ? 0 : string.Length() + 1;
+	}
+};
+
+}
+}
+
+#endif
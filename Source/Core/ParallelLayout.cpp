@@ -0,0 +1,208 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "ParallelLayout.h"
+#include <Rocket/Core/ElementDocument.h>
+#include "ElementStyle.h"
+#include "TaskPool.h"
+#include "Threading.h"
+
+namespace Rocket {
+namespace Core {
+
+// An event raised during a parallel layout, waiting to be dispatched.
+struct DeferredEvent
+{
+	Element* element;
+	String name;
+	Dictionary parameters;
+	bool interruptible;
+};
+
+typedef std::vector< DeferredEvent > DeferredEventList;
+
+// The events deferred on a document being laid out in parallel. Batches can nest, so the events are only dispatched
+// once the outermost batch on the document has completed.
+struct DeferringDocument
+{
+	int depth;
+	DeferredEventList events;
+};
+
+typedef std::map< ElementDocument*, DeferringDocument > DeferringDocumentMap;
+
+static DeferringDocumentMap deferring_documents;
+static volatile int num_deferring_documents = 0;
+static Mutex mutex;
+
+// Updates the layout of a single document.
+class UpdateDocumentTask : public Task
+{
+public:
+	UpdateDocumentTask(ElementDocument* document) : document(document)
+	{
+	}
+
+	virtual void Execute()
+	{
+		document->UpdateLayout();
+	}
+
+private:
+	ElementDocument* document;
+};
+
+// Starts deferring events raised on elements in a document.
+static void BeginDeferringEvents(ElementDocument* document)
+{
+	MutexLock lock(mutex);
+
+	DeferringDocumentMap::iterator i = deferring_documents.find(document);
+	if (i == deferring_documents.end())
+	{
+		i = deferring_documents.insert(DeferringDocumentMap::value_type(document, DeferringDocument())).first;
+		(*i).second.depth = 0;
+		AtomicIncrement(num_deferring_documents);
+	}
+
+	(*i).second.depth++;
+}
+
+// Stops deferring events on a document, dispatching any that were raised if this ends the outermost batch.
+static void EndDeferringEvents(ElementDocument* document)
+{
+	DeferredEventList events;
+
+	{
+		MutexLock lock(mutex);
+
+		DeferringDocumentMap::iterator i = deferring_documents.find(document);
+		ROCKET_ASSERT(i != deferring_documents.end());
+
+		if (--(*i).second.depth > 0)
+			return;
+
+		events.swap((*i).second.events);
+		deferring_documents.erase(i);
+		AtomicDecrement(num_deferring_documents);
+	}
+
+	for (size_t i = 0; i < events.size(); ++i)
+	{
+		events[i].element->DispatchEvent(events[i].name, events[i].parameters, events[i].interruptible);
+		events[i].element->RemoveReference();
+	}
+}
+
+// Resolves the state of an element that its children read lazily, so it isn't resolved by several threads at once.
+static void PrepareParent(Element* parent)
+{
+	if (parent == NULL)
+		return;
+
+	parent->GetDisplay();
+	parent->GetStyle()->ResolveProperty(FONT_SIZE, 0);
+}
+
+// Returns true if layout may be spread over more than one thread.
+bool ParallelLayout::IsEnabled()
+{
+	return TaskPool::GetNumThreads() > 1;
+}
+
+// Updates the layout of a set of documents.
+void ParallelLayout::UpdateDocuments(const std::vector< ElementDocument* >& documents)
+{
+	std::vector< ElementDocument* > dirty_documents;
+	for (size_t i = 0; i < documents.size(); ++i)
+	{
+		if (documents[i]->IsLayoutDirty())
+			dirty_documents.push_back(documents[i]);
+	}
+
+	if (!IsEnabled() ||
+		dirty_documents.size() < 2)
+	{
+		for (size_t i = 0; i < dirty_documents.size(); ++i)
+			dirty_documents[i]->UpdateLayout();
+
+		return;
+	}
+
+	ROCKET_PROFILE_ZONE("ParallelLayout::UpdateDocuments");
+
+	std::vector< UpdateDocumentTask > tasks;
+	std::vector< Task* > task_pointers;
+	tasks.reserve(dirty_documents.size());
+
+	for (size_t i = 0; i < dirty_documents.size(); ++i)
+	{
+		PrepareParent(dirty_documents[i]->GetParentNode());
+		BeginDeferringEvents(dirty_documents[i]);
+
+		tasks.push_back(UpdateDocumentTask(dirty_documents[i]));
+		task_pointers.push_back(&tasks.back());
+	}
+
+	TaskPool::Run(&task_pointers[0], (int) task_pointers.size());
+
+	for (size_t i = 0; i < dirty_documents.size(); ++i)
+		EndDeferringEvents(dirty_documents[i]);
+}
+
+// Queues an event if its target's document is being laid out in parallel.
+bool ParallelLayout::DeferEvent(Element* element, const String& name, const Dictionary& parameters, bool interruptible)
+{
+	if (num_deferring_documents == 0)
+		return false;
+
+	ElementDocument* document = element->GetOwnerDocument();
+	if (document == NULL)
+		return false;
+
+	MutexLock lock(mutex);
+
+	DeferringDocumentMap::iterator i = deferring_documents.find(document);
+	if (i == deferring_documents.end())
+		return false;
+
+	element->AddReference();
+
+	DeferredEvent event;
+	event.element = element;
+	event.name = name;
+	event.parameters = parameters;
+	event.interruptible = interruptible;
+	(*i).second.events.push_back(event);
+
+	return true;
+}
+
+}
+}
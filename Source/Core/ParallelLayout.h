@@ -0,0 +1,68 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREPARALLELLAYOUT_H
+#define ROCKETCOREPARALLELLAYOUT_H
+
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+class Dictionary;
+class Element;
+class ElementDocument;
+
+/**
+	Spreads the layout of independent documents over the task pool. Events raised on elements of a document while it
+	is being formatted this way are queued, and dispatched on the calling thread once its layout has finished.
+ */
+
+class ParallelLayout
+{
+public:
+	/// Returns true if layout may be spread over more than one thread.
+	static bool IsEnabled();
+
+	/// Updates the layout of a set of documents.
+	/// @param[in] documents The documents to update.
+	static void UpdateDocuments(const std::vector< ElementDocument* >& documents);
+
+	/// Queues an event if its target's document is being laid out in parallel.
+	/// @param[in] element The element the event is targeted at.
+	/// @param[in] name The name of the event.
+	/// @param[in] parameters The event's parameters.
+	/// @param[in] interruptible True if the event can be interrupted.
+	/// @return True if the event was queued, false if it should be dispatched immediately.
+	static bool DeferEvent(Element* element, const String& name, const Dictionary& parameters, bool interruptible);
+};
+
+}
+}
+
+#endif
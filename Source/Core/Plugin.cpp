@@ -89,5 +89,15 @@ void Plugin::OnElementAnimate(Element* ROCKET_UNUSED(element))
 {
 }
 
+// Called when a profiler zone closes while the profiler is enabled.
+void Plugin::OnProfileZone(const char* ROCKET_UNUSED(name), float ROCKET_UNUSED(start_time), float ROCKET_UNUSED(end_time), int ROCKET_UNUSED(depth))
+{
+}
+
+// Called when a profiling frame ends while the profiler is enabled.
+void Plugin::OnProfileFrame(const ProfileFrame& ROCKET_UNUSED(frame))
+{
+}
+
 }
 }
@@ -28,6 +28,7 @@
 #include "precompiled.h"
 #include "PluginRegistry.h"
 #include <Rocket/Core/Plugin.h>
+#include "Threading.h"
 
 namespace Rocket {
 namespace Core {
@@ -36,6 +37,10 @@ typedef std::vector< Plugin* > PluginList;
 static PluginList basic_plugins;
 static PluginList document_plugins;
 static PluginList element_plugins;
+static PluginList profile_plugins;
+
+// Serialises element notifications, as elements may be created and destroyed during a parallel layout.
+static Mutex element_mutex;
 
 PluginRegistry::PluginRegistry()
 {
@@ -51,6 +56,8 @@ void PluginRegistry::RegisterPlugin(Plugin* plugin)
 		document_plugins.push_back(plugin);
 	if (event_classes & Plugin::EVT_ELEMENT)
 		element_plugins.push_back(plugin);
+	if (event_classes & Plugin::EVT_PROFILE)
+		profile_plugins.push_back(plugin);
 }
 
 // Calls OnInitialise() on all plugins.
@@ -70,6 +77,7 @@ void PluginRegistry::NotifyShutdown()
 	}
 	document_plugins.clear();
 	element_plugins.clear();
+	profile_plugins.clear();
 }
 
 // Calls OnContextCreate() on all plugins.
@@ -110,6 +118,7 @@ void PluginRegistry::NotifyDocumentUnload(ElementDocument* document)
 // Calls OnElementCreate() on all plugins.
 void PluginRegistry::NotifyElementCreate(Element* element)
 {
+	MutexLock lock(element_mutex);
 	for (size_t i = 0; i < element_plugins.size(); ++i)
 		element_plugins[i]->OnElementCreate(element);
 }
@@ -117,6 +126,7 @@ void PluginRegistry::NotifyElementCreate(Element* element)
 // Calls OnElementDestroy() on all plugins.
 void PluginRegistry::NotifyElementDestroy(Element* element)
 {
+	MutexLock lock(element_mutex);
 	for (size_t i = 0; i < element_plugins.size(); ++i)
 		element_plugins[i]->OnElementDestroy(element);
 }
@@ -127,5 +137,19 @@ void PluginRegistry::NotifyElementAnimate(Element* element)
 		element_plugins[i]->OnElementAnimate(element);
 }
 
+// Calls OnProfileZone() on all plugins.
+void PluginRegistry::NotifyProfileZone(const char* name, float start_time, float end_time, int depth)
+{
+	for (size_t i = 0; i < profile_plugins.size(); ++i)
+		profile_plugins[i]->OnProfileZone(name, start_time, end_time, depth);
+}
+
+// Calls OnProfileFrame() on all plugins.
+void PluginRegistry::NotifyProfileFrame(const ProfileFrame& frame)
+{
+	for (size_t i = 0; i < profile_plugins.size(); ++i)
+		profile_plugins[i]->OnProfileFrame(frame);
+}
+
 }
 }
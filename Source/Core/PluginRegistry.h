@@ -35,6 +35,7 @@ class Context;
 class Element;
 class ElementDocument;
 class Plugin;
+struct ProfileFrame;
 
 /**
 	@author Peter Curry
@@ -69,6 +70,11 @@ public:
 	/// Calls OnElementAnimate() on all plugins.
 	static void NotifyElementAnimate(Element* element);
 
+	/// Calls OnProfileZone() on all plugins.
+	static void NotifyProfileZone(const char* name, float start_time, float end_time, int depth);
+	/// Calls OnProfileFrame() on all plugins.
+	static void NotifyProfileFrame(const ProfileFrame& frame);
+
 private:
 	PluginRegistry();
 };
@@ -0,0 +1,140 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include <Rocket/Core/ProfileTraceWriter.h>
+#include <Rocket/Core/Profiler.h>
+
+namespace Rocket {
+namespace Core {
+
+// Converts a time from the system interface, in seconds, into the trace's microseconds.
+static double ToMicroseconds(float time)
+{
+	return (double) time * 1000000.0;
+}
+
+// Writes a string to the trace as a JSON string.
+static void WriteString(FILE* file, const char* string)
+{
+	fputc('"', file);
+	for (const char* c = string; *c != 0; ++c)
+	{
+		if (*c == '"' || *c == '\\')
+			fputc('\\', file);
+		fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+ProfileTraceWriter::ProfileTraceWriter(const String& path)
+{
+	first_event = true;
+
+	file = fopen(path.CString(), "wb");
+	if (file == NULL)
+	{
+		Log::Message(Log::LT_ERROR, "Failed to open profile trace file '%s' for writing.", path.CString());
+		return;
+	}
+
+	fputs("[\n", file);
+	Profiler::Enable();
+}
+
+ProfileTraceWriter::~ProfileTraceWriter()
+{
+	Close();
+}
+
+// Returns true if the trace file was opened successfully.
+bool ProfileTraceWriter::IsOpen() const
+{
+	return file != NULL;
+}
+
+int ProfileTraceWriter::GetEventClasses()
+{
+	return EVT_BASIC | EVT_PROFILE;
+}
+
+void ProfileTraceWriter::OnShutdown()
+{
+	delete this;
+}
+
+// Writes the zone as a complete duration event.
+void ProfileTraceWriter::OnProfileZone(const char* name, float start_time, float end_time, int ROCKET_UNUSED(depth))
+{
+	if (file == NULL)
+		return;
+
+	fputs(first_event ? "" : ",\n", file);
+	first_event = false;
+
+	fputs("{\"name\":", file);
+	WriteString(file, name);
+	fprintf(file, ",\"cat\":\"rocket\",\"ph\":\"X\",\"ts\":%.1f,\"dur\":%.1f,\"pid\":1,\"tid\":1}", ToMicroseconds(start_time), ToMicroseconds(end_time - start_time));
+}
+
+// Writes the frame's counters as a counter event.
+void ProfileTraceWriter::OnProfileFrame(const ProfileFrame& frame)
+{
+	if (file == NULL)
+		return;
+
+	fputs(first_event ? "" : ",\n", file);
+	first_event = false;
+
+	fprintf(file, "{\"name\":\"Counters\",\"cat\":\"rocket\",\"ph\":\"C\",\"ts\":%.1f,\"pid\":1,\"args\":{", ToMicroseconds(frame.end_time));
+	for (int i = 0; i < Profiler::NUM_COUNTERS; ++i)
+	{
+		if (i > 0)
+			fputc(',', file);
+
+		WriteString(file, Profiler::GetCounterName((Profiler::Counter) i));
+		fprintf(file, ":%d", frame.counters[i]);
+	}
+	fputs("}}", file);
+}
+
+// Closes the trace file, if it is open.
+void ProfileTraceWriter::Close()
+{
+	if (file == NULL)
+		return;
+
+	fputs("\n]\n", file);
+	fclose(file);
+	file = NULL;
+
+	Profiler::Disable();
+}
+
+}
+}
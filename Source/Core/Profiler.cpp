@@ -0,0 +1,243 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include <Rocket/Core/Profiler.h>
+#include <Rocket/Core.h>
+#include "PluginRegistry.h"
+#include "Threading.h"
+
+namespace Rocket {
+namespace Core {
+
+static const char* counter_names[Profiler::NUM_COUNTERS] =
+{
+	"Elements styled",
+	"Elements laid out",
+	"Elements rendered",
+	"Geometry compiles",
+	"Draw calls"
+};
+
+// A zone currently open on the zone stack.
+struct OpenZone
+{
+	const char* name;
+	float start_time;
+};
+typedef std::vector< OpenZone > ZoneStack;
+
+// Each thread opens and closes zones on its own stack, so contexts updated on separate threads don't unbalance each
+// other's zones.
+typedef std::map< uintptr_t, ZoneStack > ZoneStackMap;
+
+static int enable_count = 0;
+static ZoneStackMap zone_stacks;
+static int num_open_zones = 0;
+
+// Guards the zone stacks and the frames.
+static Mutex mutex;
+
+// The frame currently being recorded, and the last frame to complete.
+static ProfileFrame current_frame;
+static ProfileFrame last_frame;
+static bool frame_started = false;
+static bool frame_end_pending = false;
+
+// Returns the current time, or zero if we don't yet have a system interface.
+static float GetTime()
+{
+	SystemInterface* system_interface = GetSystemInterface();
+	if (system_interface == NULL)
+		return 0;
+
+	return system_interface->GetElapsedTime();
+}
+
+ProfileFrame::ProfileFrame() : counters(Profiler::NUM_COUNTERS, 0)
+{
+	start_time = 0;
+	end_time = 0;
+}
+
+// Enables the profiler.
+void Profiler::Enable()
+{
+	enable_count++;
+}
+
+// Releases a previous request to enable the profiler.
+void Profiler::Disable()
+{
+	if (enable_count > 0)
+		enable_count--;
+}
+
+// Returns true if the profiler is running.
+bool Profiler::IsEnabled()
+{
+	return enable_count > 0;
+}
+
+// Opens a new zone, nested within the currently open zone.
+void Profiler::BeginZone(const char* name)
+{
+	OpenZone zone;
+	zone.name = name;
+	zone.start_time = GetTime();
+
+	MutexLock lock(mutex);
+
+	if (!frame_started)
+	{
+		current_frame.start_time = zone.start_time;
+		frame_started = true;
+	}
+
+	zone_stacks[GetThreadIdentifier()].push_back(zone);
+	num_open_zones++;
+}
+
+// Closes the most recently opened zone.
+void Profiler::EndZone()
+{
+	MutexLock lock(mutex);
+
+	ZoneStackMap::iterator stack = zone_stacks.find(GetThreadIdentifier());
+	if (stack == zone_stacks.end())
+		return;
+
+	OpenZone zone = (*stack).second.back();
+	(*stack).second.pop_back();
+	num_open_zones--;
+
+	int depth = (int) (*stack).second.size();
+	if (depth == 0)
+		zone_stacks.erase(stack);
+
+	float end_time = GetTime();
+
+	// Accumulate the zone's time into the frame summary.
+	ProfileFrame::ZoneList::iterator i = current_frame.zones.begin();
+	while (i != current_frame.zones.end() &&
+		   (*i).name != zone.name)
+		++i;
+
+	if (i == current_frame.zones.end())
+	{
+		ProfileFrame::Zone frame_zone;
+		frame_zone.name = zone.name;
+		frame_zone.calls = 0;
+		frame_zone.time = 0;
+		i = current_frame.zones.insert(current_frame.zones.end(), frame_zone);
+	}
+
+	(*i).calls++;
+	(*i).time += end_time - zone.start_time;
+
+	PluginRegistry::NotifyProfileZone(zone.name, zone.start_time, end_time, depth);
+
+	// If the frame was ended while this zone was open, then end it now the last open zone has closed.
+	if (num_open_zones == 0 &&
+		frame_end_pending)
+		EndFrame();
+}
+
+// Adds to one of the profiler's counters for the current frame.
+void Profiler::IncrementCounter(Counter counter, int amount)
+{
+	if (enable_count > 0)
+	{
+		MutexLock lock(mutex);
+		current_frame.counters[counter] += amount;
+	}
+}
+
+// Returns the name of one of the profiler's counters.
+const char* Profiler::GetCounterName(Counter counter)
+{
+	if (counter < 0 ||
+		counter >= NUM_COUNTERS)
+		return "";
+
+	return counter_names[counter];
+}
+
+// Ends the current frame, sending its summary to any interested plugins.
+void Profiler::EndFrame()
+{
+	MutexLock lock(mutex);
+
+	// Don't end the frame from within a zone; the frame will be ended once the outermost zone closes.
+	if (num_open_zones > 0)
+	{
+		frame_end_pending = true;
+		return;
+	}
+
+	frame_end_pending = false;
+
+	if (enable_count == 0 &&
+		!frame_started)
+	{
+		last_frame = ProfileFrame();
+		return;
+	}
+
+	current_frame.end_time = GetTime();
+	if (!frame_started)
+		current_frame.start_time = current_frame.end_time;
+
+	last_frame = current_frame;
+	current_frame = ProfileFrame();
+	frame_started = false;
+
+	PluginRegistry::NotifyProfileFrame(last_frame);
+}
+
+// Returns the summary of the last completed frame.
+const ProfileFrame& Profiler::GetLastFrame()
+{
+	return last_frame;
+}
+
+ProfileZone::ProfileZone(const char* name)
+{
+	active = Profiler::IsEnabled();
+	if (active)
+		Profiler::BeginZone(name);
+}
+
+ProfileZone::~ProfileZone()
+{
+	if (active)
+		Profiler::EndZone();
+}
+
+}
+}
@@ -27,6 +27,7 @@
 
 #include "precompiled.h"
 #include <Rocket/Core/PropertyDictionary.h>
+#include "MemoryUsageUtilities.h"
 
 namespace Rocket {
 namespace Core {
@@ -73,6 +74,16 @@ const PropertyMap& PropertyDictionary::GetProperties() const
 	return properties;
 }
 
+// Returns an estimate of the number of bytes held by the dictionary's properties.
+size_t PropertyDictionary::GetMemoryUsage() const
+{
+	size_t size = MemoryUsageUtilities::GetTreeSize(properties);
+	for (PropertyMap::const_iterator i = properties.begin(); i != properties.end(); ++i)
+		size += MemoryUsageUtilities::GetStringSize(i->first) + MemoryUsageUtilities::GetStringSize(i->second.source);
+
+	return size;
+}
+
 // Imports potentially un-specified properties into the dictionary.
 void PropertyDictionary::Import(const PropertyDictionary& property_dictionary, int property_specificity)
 {
@@ -27,24 +27,25 @@
 
 #include "precompiled.h"
 #include <Rocket/Core/ReferenceCountable.h>
+#include "Threading.h"
 
 namespace Rocket {
 namespace Core {
 
-static int num_outstanding_objects = 0;
+static volatile int num_outstanding_objects = 0;
 
 // Constructor.
 ReferenceCountable::ReferenceCountable(int initial_count)
 {
 	reference_count = initial_count;
-	++num_outstanding_objects;
+	AtomicIncrement(num_outstanding_objects);
 }
 
 // Destructor. The reference count must be 0 when this is invoked.
 ReferenceCountable::~ReferenceCountable()
 {
 	ROCKET_ASSERT(reference_count == 0);
-	--num_outstanding_objects;
+	AtomicDecrement(num_outstanding_objects);
 }
 
 // Returns the number of references outstanding against this object.
@@ -56,8 +57,7 @@ int ReferenceCountable::GetReferenceCount()
 // Adds a reference to the object.
 void ReferenceCountable::AddReference()
 {	
-	reference_count++;
-	if (reference_count == 1)
+	if (AtomicIncrement(reference_count) == 1)
 	{
 		OnReferenceActivate();
 	}
@@ -67,13 +67,28 @@ void ReferenceCountable::AddReference()
 void ReferenceCountable::RemoveReference()
 {
 	ROCKET_ASSERT(reference_count > 0);
-	reference_count--;	
-	if (reference_count == 0)
+	if (AtomicDecrement(reference_count) == 0)
 	{
 		OnReferenceDeactivate();
 	}
 }
 
+// Adds a reference to the object if it is still referenced.
+bool ReferenceCountable::AddReferenceIfReferenced()
+{
+	int count = reference_count;
+	while (count > 0)
+	{
+		int previous_count = AtomicCompareExchange(reference_count, count + 1, count);
+		if (previous_count == count)
+			return true;
+
+		count = previous_count;
+	}
+
+	return false;
+}
+
 ReferenceCountable& ReferenceCountable::operator=(const ReferenceCountable& /*copy*/)
 {
 	ROCKET_ERRORMSG("Attempting to copy a reference counted object. This is not advisable.");
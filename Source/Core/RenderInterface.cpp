@@ -27,6 +27,10 @@
 
 #include "precompiled.h"
 #include <Rocket/Core/RenderInterface.h>
+#include "ElementRenderCache.h"
+#include "GeometryBatch.h"
+#include "GeometryBuffer.h"
+#include "ImageDecoder.h"
 #include "TextureDatabase.h"
 
 namespace Rocket {
@@ -35,6 +39,7 @@ namespace Core {
 RenderInterface::RenderInterface() : ReferenceCountable(0)
 {
 	context = NULL;
+	default_load_texture = false;
 }
 
 RenderInterface::~RenderInterface()
@@ -57,23 +62,100 @@ void RenderInterface::ReleaseCompiledGeometry(CompiledGeometryHandle ROCKET_UNUS
 {
 }
 
-// Called by Rocket when a texture is required by the library.
-bool RenderInterface::LoadTexture(TextureHandle& ROCKET_UNUSED(texture_handle), Vector2i& ROCKET_UNUSED(texture_dimensions), const String& ROCKET_UNUSED(source))
+// Returns false; compiled geometry is rendered one copy at a time by default.
+bool RenderInterface::SupportsInstancing()
+{
+	return false;
+}
+
+// Called by Rocket when it wants to render several copies of application-compiled geometry.
+void RenderInterface::RenderCompiledGeometryInstanced(CompiledGeometryHandle geometry, const Vector2f* translations, int num_instances)
+{
+	for (int i = 0; i < num_instances; ++i)
+		RenderCompiledGeometry(geometry, translations[i]);
+}
+
+// Called by Rocket when it wants a buffer to stream frequently-changing geometry through.
+bool RenderInterface::GenerateGeometryBuffer(GeometryBufferHandle& ROCKET_UNUSED(buffer), int ROCKET_UNUSED(num_vertices), int ROCKET_UNUSED(num_indices))
 {
 	return false;
 }
 
+// Called by Rocket when it wants to write geometry into a buffer.
+void RenderInterface::UpdateGeometryBuffer(GeometryBufferHandle ROCKET_UNUSED(buffer), int ROCKET_UNUSED(first_vertex), const Vertex* ROCKET_UNUSED(vertices), int ROCKET_UNUSED(num_vertices), int ROCKET_UNUSED(first_index), const int* ROCKET_UNUSED(indices), int ROCKET_UNUSED(num_indices))
+{
+}
+
+// Called by Rocket when it wants to render a range of a buffer's indices.
+void RenderInterface::RenderGeometryBuffer(GeometryBufferHandle ROCKET_UNUSED(buffer), int ROCKET_UNUSED(first_index), int ROCKET_UNUSED(num_indices), TextureHandle ROCKET_UNUSED(texture), const Vector2f& ROCKET_UNUSED(translation))
+{
+}
+
+// Called by Rocket when a buffer is no longer required.
+void RenderInterface::ReleaseGeometryBuffer(GeometryBufferHandle ROCKET_UNUSED(buffer))
+{
+}
+
+// Called by Rocket when a texture is required by the library.
+bool RenderInterface::LoadTexture(TextureHandle& texture_handle, Vector2i& texture_dimensions, const String& source)
+{
+	// From now on, Rocket loads this interface's textures through the decoder itself, so it knows their sizes.
+	default_load_texture = true;
+
+	size_t texture_size;
+	return ImageDecoder::LoadTexture(this, texture_handle, texture_dimensions, texture_size, source);
+}
+
 // Called by Rocket when a texture is required to be built from an internally-generated sequence of pixels.
 bool RenderInterface::GenerateTexture(TextureHandle& ROCKET_UNUSED(texture_handle), const byte* ROCKET_UNUSED(source), const Vector2i& ROCKET_UNUSED(source_dimensions))
 {
 	return false;
 }
 
+// Called by Rocket when a texture is required to be built from the blocks of a GPU-compressed format.
+bool RenderInterface::GenerateCompressedTexture(TextureHandle& ROCKET_UNUSED(texture_handle), CompressedTextureFormat ROCKET_UNUSED(format), const byte* ROCKET_UNUSED(source), size_t ROCKET_UNUSED(source_size), const Vector2i& ROCKET_UNUSED(source_dimensions), int ROCKET_UNUSED(num_mipmaps))
+{
+	return false;
+}
+
+// Called by Rocket to decode a texture's file into pixels when textures are being loaded in the background.
+bool RenderInterface::DecodeTexture(std::vector< byte >& data, Vector2i& dimensions, const byte* file_data, size_t file_size, const String& source)
+{
+	return ImageDecoder::Decode(data, dimensions, file_data, file_size, source);
+}
+
 // Called by Rocket when a loaded texture is no longer required.
 void RenderInterface::ReleaseTexture(TextureHandle ROCKET_UNUSED(texture))
 {
 }
 
+// Called by Rocket when it wants to render an element's subtree into an offscreen texture.
+bool RenderInterface::GenerateRenderTarget(TextureHandle& ROCKET_UNUSED(texture_handle), const Vector2i& ROCKET_UNUSED(dimensions))
+{
+	return false;
+}
+
+// Called by Rocket when it wants to redirect rendering into a render target, or back to the application's frame buffer.
+void RenderInterface::SetRenderTarget(TextureHandle ROCKET_UNUSED(render_target), const Vector2i& ROCKET_UNUSED(origin))
+{
+}
+
+// Called by Rocket when the active render target is about to be redrawn.
+void RenderInterface::ClearRenderTarget()
+{
+}
+
+// Returns false; text is rendered from bitmaps by default.
+bool RenderInterface::SupportsTextShader()
+{
+	return false;
+}
+
+// Called before and after rendering geometry textured with a signed distance field.
+void RenderInterface::SetTextShader(const TextShader* ROCKET_UNUSED(shader))
+{
+}
+
 // Returns the native horizontal texel offset for the renderer.
 float RenderInterface::GetHorizontalTexelOffset()
 {
@@ -100,6 +182,9 @@ void RenderInterface::Release()
 void RenderInterface::OnReferenceDeactivate()
 {
 	TextureDatabase::ReleaseTextures(this);
+	ElementRenderCache::ReleaseRenderTargets(this);
+	GeometryBuffer::ReleaseBuffer(this);
+	GeometryBatch::Release(this);
 	Release();
 }
 
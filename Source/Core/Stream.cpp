@@ -74,6 +74,13 @@ size_t Stream::Peek(void* buffer, size_t bytes) const
 	return read;
 }
 
+// Returns the stream's entire contents if they are held contiguously in memory.
+const byte* Stream::GetContiguousData(size_t& size) const
+{
+	size = 0;
+	return NULL;
+}
+
 // Read from one stream into another
 size_t Stream::Read(Stream* stream, size_t bytes) const
 {
@@ -37,6 +37,8 @@ StreamFile::StreamFile()
 {
 	file_handle = NULL;
 	length = 0;
+	mapped_data = NULL;
+	mapped_position = 0;
 }
 
 StreamFile::~StreamFile()
@@ -65,6 +67,12 @@ bool StreamFile::Open(const String& path)
 
 	GetLength();
 
+	size_t mapped_length;
+	mapped_data = (const byte*) GetFileInterface()->Map(file_handle, mapped_length);
+	mapped_position = 0;
+	if (mapped_data != NULL)
+		length = mapped_length;
+
 	return true;
 }
 
@@ -78,6 +86,8 @@ void StreamFile::Close()
 	}
 
 	length = 0;
+	mapped_data = NULL;
+	mapped_position = 0;
 }
 
 /// Returns the size of this stream (in bytes).
@@ -89,21 +99,56 @@ size_t StreamFile::Length() const
 // Returns the position of the stream pointer (in bytes).
 size_t StreamFile::Tell() const
 {
+	if (mapped_data != NULL)
+		return mapped_position;
+
 	return GetFileInterface()->Tell(file_handle);
 }
 
 // Sets the stream position (in bytes).
 bool StreamFile::Seek(long offset, int origin) const
 {
+	if (mapped_data != NULL)
+	{
+		long base = 0;
+		if (origin == SEEK_CUR)
+			base = (long) mapped_position;
+		else if (origin == SEEK_END)
+			base = (long) length;
+
+		if (base + offset < 0 ||
+			base + offset > (long) length)
+			return false;
+
+		mapped_position = (size_t) (base + offset);
+		return true;
+	}
+
 	return GetFileInterface()->Seek(file_handle, offset, origin);
 }
 
 // Read from the stream.
 size_t StreamFile::Read(void* buffer, size_t bytes) const
 {
+	if (mapped_data != NULL)
+	{
+		bytes = Math::ClampUpper(bytes, length - mapped_position);
+		memcpy(buffer, mapped_data + mapped_position, bytes);
+		mapped_position += bytes;
+
+		return bytes;
+	}
+
 	return GetFileInterface()->Read(buffer, bytes, file_handle);
 }
 
+// Returns the file's contents if the file interface was able to map them into memory.
+const byte* StreamFile::GetContiguousData(size_t& size) const
+{
+	size = mapped_data != NULL ? length : 0;
+	return mapped_data;
+}
+
 // Write to the stream at the current position.
 size_t StreamFile::Write(const void* ROCKET_UNUSED(buffer), size_t ROCKET_UNUSED(bytes))
 {
@@ -61,6 +61,9 @@ public:
 	virtual size_t Read(void* buffer, size_t bytes) const;
 	using Stream::Read;
 
+	/// Returns the file's contents if the file interface was able to map them into memory.
+	virtual const byte* GetContiguousData(size_t& size) const;
+
 	/// Write to the stream at the current position.
 	virtual size_t Write(const void* buffer, size_t bytes);
 	using Stream::Write;
@@ -79,6 +82,11 @@ private:
 
 	FileHandle file_handle;
 	size_t length;
+
+	// The file's contents, if the file interface mapped them into memory. Reads are served from the mapping, and the
+	// stream keeps its own position within it.
+	const byte* mapped_data;
+	mutable size_t mapped_position;
 };
 
 }
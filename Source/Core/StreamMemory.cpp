@@ -216,6 +216,13 @@ const byte* StreamMemory::RawStream() const
 	return buffer;
 }
 
+// Returns the stream's buffer, which is always contiguous.
+const byte* StreamMemory::GetContiguousData(size_t& size) const
+{
+	size = buffer_used;
+	return buffer;
+}
+
 void StreamMemory::Erase( size_t offset, size_t bytes )
 {
 	bytes = Math::ClampUpper(bytes, buffer_used - offset);
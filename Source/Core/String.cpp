@@ -35,7 +35,7 @@ namespace Core {
 int ROCKETCORE_API RocketStringFormatString(StringBase<char>& string, int max_size, const char* format, va_list argument_list)
 {
 	const int INTERNAL_BUFFER_SIZE = 1024;
-	static char buffer[INTERNAL_BUFFER_SIZE];
+	char buffer[INTERNAL_BUFFER_SIZE];
 	char* buffer_ptr = buffer;
 
 	if (max_size + 1 > INTERNAL_BUFFER_SIZE)
@@ -93,6 +93,7 @@ const String CURSOR = "cursor";
 const String DRAG = "drag";
 const String TAB_INDEX = "tab-index";
 const String SCROLLBAR_MARGIN = "scrollbar-margin";
+const String RENDER_CACHE = "render-cache";
 
 const String INFINITE = "infinite";
 const String ANIMATION_NAME = "animation-name";
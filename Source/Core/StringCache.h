@@ -96,6 +96,7 @@ extern const String CURSOR;
 extern const String DRAG;
 extern const String TAB_INDEX;
 extern const String SCROLLBAR_MARGIN;
+extern const String RENDER_CACHE;
 
 extern const String INFINITE;
 extern const String ANIMATION_NAME;
@@ -28,10 +28,13 @@
 #include "precompiled.h"
 #include <Rocket/Core/StyleSheet.h>
 #include <algorithm>
+#include "ElementAncestorFilter.h"
 #include "ElementDefinition.h"
+#include "MemoryUsageUtilities.h"
 #include "StyleSheetFactory.h"
 #include "StyleSheetNode.h"
 #include "StyleSheetParser.h"
+#include "Threading.h"
 #include <Rocket/Core/Element.h>
 #include <Rocket/Core/PropertyDefinition.h>
 #include <Rocket/Core/StyleSheetSpecification.h>
@@ -39,6 +42,9 @@
 namespace Rocket {
 namespace Core {
 
+// Protects the element definition caches and the building of the node indices of all sheets.
+static Mutex definition_mutex;
+
 // Sorts style nodes based on specificity.
 static bool StyleSheetNodeSort(const StyleSheetNode* lhs, const StyleSheetNode* rhs)
 {
@@ -49,6 +55,7 @@ StyleSheet::StyleSheet()
 {
 	root = new StyleSheetNode("", StyleSheetNode::ROOT);
 	specificity_offset = 0;
+	node_index_built = false;
 }
 
 StyleSheet::~StyleSheet()
@@ -88,18 +95,27 @@ StyleSheet* StyleSheet::CombineStyleSheet(const StyleSheet* other_sheet) const
 // Builds the node index for a combined style sheet.
 void StyleSheet::BuildNodeIndex()
 {
-	if (complete_node_index.empty())
-	{
-		styled_node_index.clear();
-		complete_node_index.clear();
-
-		root->BuildIndex(styled_node_index, complete_node_index);
-	}
+	// Cached sheets are shared between documents, which may be given the sheet on several threads at once. The index
+	// is built once under the lock, and only read after that.
+	MutexLock lock(definition_mutex);
+	if (node_index_built)
+		return;
+
+	styled_node_index.clear();
+	complete_node_index.clear();
+	class_invalidation_scopes.clear();
+	id_invalidation_scopes.clear();
+
+	root->BuildIndex(styled_node_index, complete_node_index);
+	root->BuildInvalidationScopes(class_invalidation_scopes, id_invalidation_scopes);
+	node_index_built = true;
 }
 
 // Returns the compiled element definition for a given element hierarchy.
-ElementDefinition* StyleSheet::GetElementDefinition(const Element* element) const
+ElementDefinition* StyleSheet::GetElementDefinition(const Element* element, const ElementAncestorFilter* ancestor_filter) const
 {
+	ROCKET_PROFILE_ZONE("StyleSheet::GetElementDefinition");
+
 	// Address cache is disabled for the time being; this doesn't work since the introduction of structural
 	// pseudo-classes.
 	ElementDefinitionCache::iterator cache_iterator;
@@ -114,6 +130,14 @@ ElementDefinition* StyleSheet::GetElementDefinition(const Element* element) cons
 		return definition;
 	}*/
 
+	// Nodes are checked against a filter over the element's ancestors before we walk the element's parents to match
+	// them. If the caller's filter isn't over our parent, we build our own; it only walks the parents once, when it
+	// is first queried.
+	ElementAncestorFilter local_filter(NULL, element->GetParentNode());
+	if (ancestor_filter == NULL ||
+		ancestor_filter->GetElement() != element->GetParentNode())
+		ancestor_filter = &local_filter;
+
 	// See if there are any styles defined for this element.
 	std::vector< const StyleSheetNode* > applicable_nodes;
 
@@ -129,7 +153,8 @@ ElementDefinition* StyleSheet::GetElementDefinition(const Element* element) cons
 			// nodes backwards, trying to match nodes in the element's hierarchy to nodes in the style hierarchy.
 			for (NodeList::const_iterator iterator = nodes.begin(); iterator != nodes.end(); iterator++)
 			{
-				if ((*iterator)->IsApplicable(element))
+				if ((*iterator)->MayHaveApplicableAncestors(*ancestor_filter) &&
+					(*iterator)->IsApplicable(element))
 				{
 					// Get the node to add any of its non-tag children that we match into our list.
 					(*iterator)->GetApplicableDescendants(applicable_nodes, element);
@@ -156,7 +181,8 @@ ElementDefinition* StyleSheet::GetElementDefinition(const Element* element) cons
 			{
 				structurally_volatile |= (*iterator)->IsStructurallyVolatile();
 
-				if ((*iterator)->IsApplicable(element))
+				if ((*iterator)->MayHaveApplicableAncestors(*ancestor_filter) &&
+					(*iterator)->IsApplicable(element))
 				{
 					std::vector< const StyleSheetNode* > volatile_nodes;
 					(*iterator)->GetApplicableDescendants(volatile_nodes, element);
@@ -182,6 +208,10 @@ ElementDefinition* StyleSheet::GetElementDefinition(const Element* element) cons
 	for (PseudoClassList::iterator i = volatile_pseudo_classes.begin(); i != volatile_pseudo_classes.end(); ++i)
 		node_ids += String(32, ":%s", (*i).CString());
 
+	// Sheets are shared between contexts, so the definition cache may be accessed from several threads. Matching the
+	// nodes only reads the sheet, so only the cache itself needs protecting.
+	MutexLock lock(definition_mutex);
+
 	cache_iterator = node_cache.find(node_ids);
 	if (cache_iterator != node_cache.end())
 	{
@@ -206,6 +236,26 @@ ElementDefinition* StyleSheet::GetElementDefinition(const Element* element) cons
 	return new_definition;
 }
 
+// Returns the elements whose definitions may change when a class is set on or cleared from an element.
+StyleSheet::InvalidationScope StyleSheet::GetClassInvalidationScope(const String& class_name) const
+{
+	InvalidationScopeMap::const_iterator i = class_invalidation_scopes.find(class_name);
+	if (i == class_invalidation_scopes.end())
+		return INVALIDATE_NONE;
+
+	return (*i).second;
+}
+
+// Returns the elements whose definitions may change when an element's ID is set or cleared.
+StyleSheet::InvalidationScope StyleSheet::GetIdInvalidationScope(const String& id) const
+{
+	InvalidationScopeMap::const_iterator i = id_invalidation_scopes.find(id);
+	if (i == id_invalidation_scopes.end())
+		return INVALIDATE_NONE;
+
+	return (*i).second;
+}
+
 // Destroys the style sheet.
 void StyleSheet::OnReferenceDeactivate()
 {
@@ -237,5 +287,28 @@ const KeyframeProperties *StyleSheet::GetAnimation(const String &name)
 	}
 }
 
+// Adds an estimate of the memory held by the style sheet to a breakdown.
+void StyleSheet::GetMemoryUsage(MemoryUsage& usage) const
+{
+	MutexLock lock(definition_mutex);
+
+	size_t index_size = sizeof(StyleSheet);
+	index_size += MemoryUsageUtilities::GetTreeSize(styled_node_index) + MemoryUsageUtilities::GetTreeSize(complete_node_index);
+	for (NodeIndex::const_iterator i = styled_node_index.begin(); i != styled_node_index.end(); ++i)
+		index_size += MemoryUsageUtilities::GetTreeSize((*i).second);
+	for (NodeIndex::const_iterator i = complete_node_index.begin(); i != complete_node_index.end(); ++i)
+		index_size += MemoryUsageUtilities::GetTreeSize((*i).second);
+	index_size += MemoryUsageUtilities::GetTreeSize(address_cache) + MemoryUsageUtilities::GetTreeSize(node_cache);
+	index_size += MemoryUsageUtilities::GetTreeSize(class_invalidation_scopes) + MemoryUsageUtilities::GetTreeSize(id_invalidation_scopes);
+	for (ElementDefinitionCache::const_iterator i = node_cache.begin(); i != node_cache.end(); ++i)
+		index_size += MemoryUsageUtilities::GetStringSize((*i).first);
+	usage.Add(MemoryUsage::STYLE_SHEETS, index_size);
+
+	root->GetMemoryUsage(usage);
+
+	for (ElementDefinitionCache::const_iterator i = node_cache.begin(); i != node_cache.end(); ++i)
+		(*i).second->GetMemoryUsage(usage);
+}
+
 }
 }
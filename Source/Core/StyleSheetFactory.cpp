@@ -29,6 +29,7 @@
 #include "StyleSheetFactory.h"
 #include <Rocket/Core/StyleSheet.h>
 #include "StreamFile.h"
+#include <Rocket/Core/StreamMemory.h>
 #include "StyleSheetNodeSelectorNthChild.h"
 #include "StyleSheetNodeSelectorNthLastChild.h"
 #include "StyleSheetNodeSelectorNthOfType.h"
@@ -40,6 +41,7 @@
 #include "StyleSheetNodeSelectorOnlyChild.h"
 #include "StyleSheetNodeSelectorOnlyOfType.h"
 #include "StyleSheetNodeSelectorEmpty.h"
+#include "Threading.h"
 #include <Rocket/Core/Log.h>
 
 namespace Rocket {
@@ -47,6 +49,9 @@ namespace Core {
 
 static StyleSheetFactory* instance = NULL;
 
+// Protects the style sheet caches; sheets are loaded while the lock is held, so no sheet is ever loaded twice.
+static Mutex mutex;
+
 StyleSheetFactory::StyleSheetFactory()
 {
 	ROCKET_ASSERT(instance == NULL);
@@ -92,6 +97,8 @@ void StyleSheetFactory::Shutdown()
 
 StyleSheet* StyleSheetFactory::GetStyleSheet(const String& sheet_name)
 {
+	MutexLock lock(mutex);
+
 	// Look up the sheet definition in the cache
 	StyleSheets::iterator itr = instance->stylesheets.find(sheet_name);
 	if (itr != instance->stylesheets.end())
@@ -114,14 +121,89 @@ StyleSheet* StyleSheetFactory::GetStyleSheet(const String& sheet_name)
 
 StyleSheet* StyleSheetFactory::GetStyleSheet(const StringList& sheets)
 {
-	// Generate a unique key for these sheets
-	String combined_key;
+	// Load the individual sheets; these are all cached, so this is only a lookup once they've been loaded.
+	std::vector< StyleSheet* > sub_sheets;
 	for (size_t i = 0; i < sheets.size(); i++)
-	{		
-		URL path(sheets[i]);
-		combined_key += path.GetFileName();
+	{
+		StyleSheet* sub_sheet = GetStyleSheet(sheets[i]);
+		if (sub_sheet)
+			sub_sheets.push_back(sub_sheet);
+		else
+			Log::Message(Log::LT_ERROR, "Failed to load style sheet %s.", sheets[i].CString());
+	}
+
+	StyleSheet* sheet = CombineStyleSheets(sub_sheets);
+
+	for (size_t i = 0; i < sub_sheets.size(); i++)
+		sub_sheets[i]->RemoveReference();
+
+	return sheet;
+}
+
+// Gets a sheet parsed from inline RCSS, retrieving it from the cache if identical RCSS has already been parsed.
+StyleSheet* StyleSheetFactory::GetInlineStyleSheet(const String& content, const String& source_url)
+{
+	// Relative paths in the sheet are resolved against its source, so identical RCSS from different sources can't
+	// share a sheet.
+	Hash hash = StringUtilities::FNVHash(content.CString(), (int) content.Length()) ^ StringUtilities::FNVHash(source_url.CString(), (int) source_url.Length());
+
+	MutexLock lock(mutex);
+
+	std::pair< InlineStyleSheets::iterator, InlineStyleSheets::iterator > range = instance->inline_stylesheets.equal_range(hash);
+	for (InlineStyleSheets::iterator itr = range.first; itr != range.second; ++itr)
+	{
+		if ((*itr).second.content == content &&
+			(*itr).second.source_url == source_url)
+		{
+			(*itr).second.sheet->AddReference();
+			return (*itr).second.sheet;
+		}
+	}
+
+	StyleSheet* sheet = new StyleSheet();
+	StreamMemory* stream = new StreamMemory((const byte*) content.CString(), content.Length());
+	stream->SetSourceURL(source_url);
+
+	bool loaded = sheet->LoadStyleSheet(stream);
+	stream->RemoveReference();
+
+	if (!loaded)
+	{
+		sheet->RemoveReference();
+		return NULL;
+	}
+
+	// Add it to the cache, and add a reference count so the cache will keep hold of it.
+	InlineStyleSheet inline_sheet;
+	inline_sheet.source_url = source_url;
+	inline_sheet.content = content;
+	inline_sheet.sheet = sheet;
+	instance->inline_stylesheets.insert(InlineStyleSheets::value_type(hash, inline_sheet));
+	sheet->AddReference();
+
+	return sheet;
+}
+
+// Combines a chain of sheets into one, in order of increasing precedence.
+StyleSheet* StyleSheetFactory::CombineStyleSheets(const std::vector< StyleSheet* >& sheets)
+{
+	if (sheets.empty())
+		return NULL;
+
+	if (sheets.size() == 1)
+	{
+		sheets[0]->AddReference();
+		return sheets[0];
 	}
 
+	// Generate a unique key for these sheets. The components are held by our caches until they are cleared along
+	// with this one, so their addresses can't be reused by another sheet while the key is live.
+	String combined_key;
+	for (size_t i = 0; i < sheets.size(); i++)
+		combined_key += String(32, "%p;", (void*) sheets[i]);
+
+	MutexLock lock(mutex);
+
 	// Look up the sheet definition in the cache.
 	StyleSheets::iterator itr = instance->stylesheet_cache.find(combined_key);
 	if (itr != instance->stylesheet_cache.end())
@@ -130,31 +212,17 @@ StyleSheet* StyleSheetFactory::GetStyleSheet(const StringList& sheets)
 		return (*itr).second;
 	}
 
-	// Load and combine the sheets.
-	StyleSheet* sheet = NULL;
-	for (size_t i = 0; i < sheets.size(); i++)
+	// Combine the sheets.
+	StyleSheet* sheet = sheets[0];
+	sheet->AddReference();
+
+	for (size_t i = 1; i < sheets.size(); i++)
 	{
-		StyleSheet* sub_sheet = GetStyleSheet(sheets[i]);
-		if (sub_sheet)
-		{
-			if (sheet)
-			{
-				StyleSheet* new_sheet = sheet->CombineStyleSheet(sub_sheet);
-				sheet->RemoveReference();
-				sub_sheet->RemoveReference();
-
-				sheet = new_sheet;
-			}
-			else
-				sheet = sub_sheet;
-		}
-		else
-			Log::Message(Log::LT_ERROR, "Failed to load style sheet %s.", sheets[i].CString());
+		StyleSheet* new_sheet = sheet->CombineStyleSheet(sheets[i]);
+		sheet->RemoveReference();
+		sheet = new_sheet;
 	}
 
-	if (sheet == NULL)
-		return NULL;
-
 	// Add to cache, and a reference to the sheet to hold it in the cache.
 	instance->stylesheet_cache[combined_key] = sheet;
 	sheet->AddReference();
@@ -164,14 +232,20 @@ StyleSheet* StyleSheetFactory::GetStyleSheet(const StringList& sheets)
 // Clear the style sheet cache.
 void StyleSheetFactory::ClearStyleSheetCache()
 {
+	MutexLock lock(mutex);
+
 	for (StyleSheets::iterator i = instance->stylesheets.begin(); i != instance->stylesheets.end(); ++i)
 		(*i).second->RemoveReference();
 
 	for (StyleSheets::iterator i = instance->stylesheet_cache.begin(); i != instance->stylesheet_cache.end(); ++i)
 		(*i).second->RemoveReference();
 
+	for (InlineStyleSheets::iterator i = instance->inline_stylesheets.begin(); i != instance->inline_stylesheets.end(); ++i)
+		(*i).second.sheet->RemoveReference();
+
 	instance->stylesheets.clear();
 	instance->stylesheet_cache.clear();
+	instance->inline_stylesheets.clear();
 }
 
 // Returns one of the available node selectors.
@@ -59,6 +59,19 @@ public:
 	/// @param sheets List of sheets to combine into one	
 	static StyleSheet* GetStyleSheet(const StringList& sheets);
 
+	/// Gets a sheet parsed from inline RCSS, retrieving it from the cache if identical RCSS has already been parsed
+	/// from the same source.
+	/// @param[in] content The RCSS to parse.
+	/// @param[in] source_url The URL of the document the RCSS came from, used to resolve relative paths.
+	/// @return The parsed sheet with a reference added for the caller, or NULL if the RCSS failed to parse.
+	static StyleSheet* GetInlineStyleSheet(const String& content, const String& source_url);
+
+	/// Combines a chain of sheets into one, in order of increasing precedence. Combined sheets are cached against
+	/// the identity of their components, so the sheets passed in must have come from this factory.
+	/// @param[in] sheets The sheets to combine.
+	/// @return The combined sheet with a reference added for the caller, or NULL if the chain is empty.
+	static StyleSheet* CombineStyleSheets(const std::vector< StyleSheet* >& sheets);
+
 	/// Clear the style sheet cache.
 	static void ClearStyleSheetCache();
 
@@ -78,9 +91,20 @@ private:
 	typedef std::map<String, StyleSheet*> StyleSheets;
 	StyleSheets stylesheets;
 
-	// Cache of combined style sheets
+	// Cache of combined style sheets, keyed on the addresses of their cached components.
 	StyleSheets stylesheet_cache;
 
+	// Sheets parsed from inline RCSS, keyed on a hash of their source and content. The source and content are
+	// kept to resolve hash collisions.
+	struct InlineStyleSheet
+	{
+		String source_url;
+		String content;
+		StyleSheet* sheet;
+	};
+	typedef std::multimap< Hash, InlineStyleSheet > InlineStyleSheets;
+	InlineStyleSheets inline_stylesheets;
+
 	// Custom complex selectors available for style sheets.
 	typedef std::map< String, StyleSheetNodeSelector* > SelectorMap;
 	SelectorMap selectors;
@@ -29,6 +29,8 @@
 #include "StyleSheetNode.h"
 #include <algorithm>
 #include <Rocket/Core/Element.h>
+#include "ElementAncestorFilter.h"
+#include "MemoryUsageUtilities.h"
 #include "StyleSheetFactory.h"
 #include "StyleSheetNodeSelector.h"
 
@@ -157,6 +159,8 @@ void StyleSheetNode::BuildIndex(StyleSheet::NodeIndex& styled_index, StyleSheet:
 	// If this is a tag node, then we insert it into the list of all tag nodes. Makes sense, neh?
 	if (type == TAG)
 	{
+		BuildAncestorHashes();
+
 		StyleSheet::NodeIndex::iterator iterator = complete_index.find(name);
 		if (iterator == complete_index.end())
 			(*complete_index.insert(StyleSheet::NodeIndex::value_type(name, StyleSheet::NodeList())).first).second.insert(this);
@@ -190,6 +194,56 @@ void StyleSheetNode::BuildIndex(StyleSheet::NodeIndex& styled_index, StyleSheet:
 	}
 }
 
+// Generates the filter hashes of the tags, IDs and classes this node requires of an element's ancestors.
+void StyleSheetNode::BuildAncestorHashes()
+{
+	ancestor_hashes.clear();
+
+	// Everything above us in the tree is a requirement on an ancestor. Pseudo-classes aren't in the filter, as they
+	// change too often to track.
+	for (const StyleSheetNode* ancestor = parent; ancestor != NULL; ancestor = ancestor->parent)
+	{
+		switch (ancestor->type)
+		{
+			case TAG:
+			{
+				if (!ancestor->name.Empty())
+					ancestor_hashes.push_back(ElementAncestorFilter::GetTagHash(ancestor->name));
+			}
+			break;
+
+			case ID:		ancestor_hashes.push_back(ElementAncestorFilter::GetIdHash(ancestor->name)); break;
+			case CLASS:		ancestor_hashes.push_back(ElementAncestorFilter::GetClassHash(ancestor->name)); break;
+			default:		break;
+		}
+	}
+}
+
+// Records the classes and IDs named by this node and its descendants.
+bool StyleSheetNode::BuildInvalidationScopes(StyleSheet::InvalidationScopeMap& class_scopes, StyleSheet::InvalidationScopeMap& id_scopes) const
+{
+	// A class or ID node with a tag node below it is a requirement on an ancestor of the elements that tag matches.
+	bool has_tag_descendant = false;
+	for (int i = 0; i < NUM_NODE_TYPES; i++)
+	{
+		for (NodeMap::const_iterator j = children[i].begin(); j != children[i].end(); ++j)
+		{
+			if ((*j).second->BuildInvalidationScopes(class_scopes, id_scopes))
+				has_tag_descendant = true;
+		}
+	}
+
+	if (type == CLASS ||
+		type == ID)
+	{
+		StyleSheet::InvalidationScope scope = has_tag_descendant ? StyleSheet::INVALIDATE_SUBTREE : StyleSheet::INVALIDATE_ELEMENT;
+		StyleSheet::InvalidationScope& recorded_scope = (type == CLASS ? class_scopes : id_scopes)[name];
+		recorded_scope = Math::Max(recorded_scope, scope);
+	}
+
+	return has_tag_descendant || type == TAG;
+}
+
 // Returns the name of this node.
 const String& StyleSheetNode::GetName() const
 {
@@ -391,6 +445,18 @@ bool StyleSheetNode::IsApplicable(const Element* element) const
 	return false;
 }
 
+// Returns false if this node's ancestor requirements can't be met by an element's ancestors.
+bool StyleSheetNode::MayHaveApplicableAncestors(const ElementAncestorFilter& ancestor_filter) const
+{
+	for (size_t i = 0; i < ancestor_hashes.size(); ++i)
+	{
+		if (!ancestor_filter.MayContain(ancestor_hashes[i]))
+			return false;
+	}
+
+	return true;
+}
+
 // Appends all applicable non-tag descendants of this node into the given element list.
 void StyleSheetNode::GetApplicableDescendants(std::vector< const StyleSheetNode* >& applicable_nodes, const Element* element) const
 {
@@ -492,6 +558,23 @@ bool StyleSheetNode::IsStructurallyVolatile(bool check_ancestors) const
 	return false;
 }
 
+// Adds an estimate of the memory held by this node and its descendants to a breakdown.
+void StyleSheetNode::GetMemoryUsage(MemoryUsage& usage) const
+{
+	size_t node_size = sizeof(StyleSheetNode) + MemoryUsageUtilities::GetStringSize(name);
+	for (int i = 0; i < NUM_NODE_TYPES; i++)
+		node_size += MemoryUsageUtilities::GetTreeSize(children[i]);
+
+	usage.Add(MemoryUsage::STYLE_SHEETS, node_size);
+	usage.Add(MemoryUsage::PROPERTIES, properties.GetMemoryUsage());
+
+	for (int i = 0; i < NUM_NODE_TYPES; i++)
+	{
+		for (NodeMap::const_iterator j = children[i].begin(); j != children[i].end(); ++j)
+			(*j).second->GetMemoryUsage(usage);
+	}
+}
+
 // Constructs a structural pseudo-class child node.
 StyleSheetNode* StyleSheetNode::CreateStructuralChild(const String& child_name)
 {
@@ -35,6 +35,7 @@
 namespace Rocket {
 namespace Core {
 
+class ElementAncestorFilter;
 class StyleSheetNodeSelector;
 
 typedef std::map< StringList, PropertyDictionary > PseudoClassPropertyMap;
@@ -72,6 +73,12 @@ public:
 	bool MergeHierarchy(StyleSheetNode* node, int specificity_offset = 0);
 	/// Builds up a style sheet's index recursively.
 	void BuildIndex(StyleSheet::NodeIndex& styled_index, StyleSheet::NodeIndex& complete_index);
+	/// Records the classes and IDs named by this node and its descendants, and whether each is named on the subject of
+	/// a selector or on one of its ancestors.
+	/// @param[out] class_scopes The map of classes to the scope of elements affected by changing them.
+	/// @param[out] id_scopes The map of IDs to the scope of elements affected by changing them.
+	/// @return True if this node or one of its descendants is a tag node.
+	bool BuildInvalidationScopes(StyleSheet::InvalidationScopeMap& class_scopes, StyleSheet::InvalidationScopeMap& id_scopes) const;
 
 	/// Returns the name of this node.
 	const String& GetName() const;
@@ -109,6 +116,11 @@ public:
 
 	/// Returns true if this node is applicable to the given element, given its IDs, classes and heritage.
 	bool IsApplicable(const Element* element) const;
+	/// Returns false if this node's ancestor requirements can't be met by an element's ancestors. This is a cheap
+	/// pre-check for IsApplicable(); a true result still needs to be confirmed by walking the hierarchy.
+	/// @param[in] ancestor_filter A filter over the ancestors of the element being matched.
+	/// @return False if the node definitely can't apply, true if it might.
+	bool MayHaveApplicableAncestors(const ElementAncestorFilter& ancestor_filter) const;
 	/// Appends all applicable non-tag descendants of this node into the given element list.
 	void GetApplicableDescendants(std::vector< const StyleSheetNode* >& applicable_nodes, const Element* element) const;
 
@@ -117,6 +129,10 @@ public:
 	/// @return True if this node uses a structural selector.
 	bool IsStructurallyVolatile(bool check_ancestors = true) const;
 
+	/// Adds an estimate of the memory held by this node and its descendants to a breakdown.
+	/// @param[out] usage The breakdown to add to.
+	void GetMemoryUsage(MemoryUsage& usage) const;
+
 private:
 	// Constructs a structural pseudo-class child node.
 	StyleSheetNode* CreateStructuralChild(const String& child_name);
@@ -124,6 +140,8 @@ private:
 	void GetPseudoClassProperties(PseudoClassPropertyMap& pseudo_class_properties, const StringList& ancestor_pseudo_classes);
 
 	int CalculateSpecificity();
+	// Generates the filter hashes of the tags, IDs and classes this node requires of an element's ancestors.
+	void BuildAncestorHashes();
 
 	// The parent of this node; is NULL for the root node.
 	StyleSheetNode* parent;
@@ -144,6 +162,9 @@ private:
 	// The generic properties for this node.
 	PropertyDictionary properties;
 
+	// The filter hashes for this node's ancestor requirements; built with the style sheet's index.
+	std::vector< Hash > ancestor_hashes;
+
 	// This node's child nodes, whether standard tagged children, or further derivations of this tag by ID or class.
 	typedef std::map< String, StyleSheetNode* > NodeMap;
 	NodeMap children[NUM_NODE_TYPES];
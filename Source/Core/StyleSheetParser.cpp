@@ -43,6 +43,8 @@ StyleSheetParser::StyleSheetParser()
 {
 	line_number = 0;
 	stream = NULL;
+	parse_data = NULL;
+	parse_data_length = 0;
 	parse_buffer_pos = 0;
 }
 
@@ -172,6 +174,11 @@ int StyleSheetParser::Parse(StyleSheet* sheet, StyleSheetNode* node, Stream* _st
 		}
 	}	
 
+	// The parsed data may have been the stream's own memory.
+	parse_data = NULL;
+	parse_data_length = 0;
+	parse_buffer_pos = 0;
+
 	return rule_count;
 }
 
@@ -181,6 +188,12 @@ bool StyleSheetParser::ParseProperties(PropertyDictionary& parsed_properties, co
 	bool success = ReadProperties(parsed_properties);
 	stream->RemoveReference();
 	stream = NULL;
+
+	// The parsed data may have been the string itself.
+	parse_data = NULL;
+	parse_data_length = 0;
+	parse_buffer_pos = 0;
+
 	return success;
 }
 
@@ -391,49 +404,56 @@ bool StyleSheetParser::ReadCharacter(char& buffer)
 	// stream or we find the requested token
 	do
 	{
-		while (parse_buffer_pos < parse_buffer.Length())
+		while (parse_buffer_pos < parse_data_length)
 		{
-			if (parse_buffer[parse_buffer_pos] == '\n')
+			if (parse_data[parse_buffer_pos] == '\n')
 				line_number++;
 			else if (comment)
 			{
 				// Check for closing comment
-				if (parse_buffer[parse_buffer_pos] == '*')
+				if (parse_data[parse_buffer_pos] == '*')
 				{
 					parse_buffer_pos++;
-					if (parse_buffer_pos >= parse_buffer.Length())
+					if (parse_buffer_pos >= parse_data_length)
 					{
 						if (!FillBuffer())
 							return false;
 					}
 
-					if (parse_buffer[parse_buffer_pos] == '/')
+					if (parse_data[parse_buffer_pos] == '/')
 						comment = false;
 				}
 			}
 			else
 			{
 				// Check for an opening comment
-				if (parse_buffer[parse_buffer_pos] == '/')
+				if (parse_data[parse_buffer_pos] == '/')
 				{
 					parse_buffer_pos++;
-					if (parse_buffer_pos >= parse_buffer.Length())
+					if (parse_buffer_pos >= parse_data_length)
 					{
 						if (!FillBuffer())
 						{
 							buffer = '/';
 							parse_buffer = "/";
+							parse_data = parse_buffer.CString();
+							parse_data_length = parse_buffer.Length();
 							return true;
 						}
 					}
 					
-					if (parse_buffer[parse_buffer_pos] == '*')
+					if (parse_data[parse_buffer_pos] == '*')
 						comment = true;
 					else
 					{
 						buffer = '/';
 						if (parse_buffer_pos == 0)
+						{
+							// This only happens after a refill, so the data is always in our own buffer.
 							parse_buffer.Insert(parse_buffer_pos, '/');
+							parse_data = parse_buffer.CString();
+							parse_data_length = parse_buffer.Length();
+						}
 						else
 							parse_buffer_pos--;
 						return true;
@@ -443,7 +463,7 @@ bool StyleSheetParser::ReadCharacter(char& buffer)
 				if (!comment)
 				{
 					// If we find a character, return it
-					buffer = parse_buffer[parse_buffer_pos];
+					buffer = parse_data[parse_buffer_pos];
 					return true;
 				}
 			}
@@ -463,11 +483,28 @@ bool StyleSheetParser::FillBuffer()
 	if (stream->IsEOS())
 		return false;
 
+	parse_buffer_pos = 0;
+
+	// If the stream is already in memory, parse the rest of it in place.
+	size_t data_size;
+	const char* data = (const char*) stream->GetContiguousData(data_size);
+	size_t data_position = data != NULL ? stream->Tell() : 0;
+	if (data != NULL &&
+		data_position < data_size &&
+		stream->Seek(0, SEEK_END))
+	{
+		parse_data = data + data_position;
+		parse_data_length = data_size - data_position;
+
+		return true;
+	}
+
 	// Read in some data (4092 instead of 4096 to avoid the buffer growing when we have to add back
 	// a character after a failed comment parse.)
 	parse_buffer.Clear();
 	bool read = stream->Read(parse_buffer, 4092) > 0;
-	parse_buffer_pos = 0;
+	parse_data = parse_buffer.CString();
+	parse_data_length = parse_buffer.Length();
 
 	return read;
 }
@@ -64,9 +64,12 @@ public:
 private:
 	// Stream we're parsing from.
 	Stream* stream;
+	// The data being parsed; either the stream's own memory, if it is held contiguously, or parse_buffer.
+	const char* parse_data;
+	size_t parse_data_length;
 	// Parser memory buffer.
 	String parse_buffer;
-	// How far we've read through the buffer.
+	// How far we've read through the data.
 	size_t parse_buffer_pos;
 
 	// The name of the file we'r parsing.
@@ -266,6 +266,7 @@ void StyleSheetSpecification::RegisterDefaultProperties()
 	RegisterProperty(FOCUS, "auto", true, false).AddParser("keyword", "none, auto");
 
 	RegisterProperty(SCROLLBAR_MARGIN, "0", false, false).AddParser("number");
+	RegisterProperty(RENDER_CACHE, "none", false, false).AddParser("keyword", "none, texture");
 
 	// See default values https://developer.mozilla.org/en-US/docs/Web/CSS/animation
 
@@ -28,6 +28,7 @@
 #include "precompiled.h"
 #include <Rocket/Core/SystemInterface.h>
 #include <Rocket/Core/Log.h>
+#include "TaskPool.h"
 
 #ifdef ROCKET_PLATFORM_WIN32
 #include <windows.h>
@@ -106,6 +107,24 @@ void SystemInterface::JoinPath(String& translated_path, const String& document_p
 	URL url(translated_path.Replace(":", "|") + path.Replace("\\", "/"));
 	translated_path = url.GetPathedFileName().Replace("|", ":");
 }
+
+// Submits a job to be run, possibly on another thread.
+SystemInterface::JobHandle SystemInterface::SubmitJob(JobFunction function, void* data)
+{
+	return TaskPool::Submit(function, data);
+}
+
+// Waits for a submitted job to complete.
+void SystemInterface::WaitForJob(JobHandle job)
+{
+	TaskPool::Wait(job);
+}
+
+// Runs a function once for every index in a range, possibly in parallel.
+void SystemInterface::ParallelFor(JobFunction function, void* data, int count)
+{
+	TaskPool::ParallelFor(function, data, count);
+}
 	
 // Activate keyboard (for touchscreen devices)
 void SystemInterface::ActivateKeyboard() 
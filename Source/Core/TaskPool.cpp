@@ -0,0 +1,386 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "TaskPool.h"
+#include "Threading.h"
+#include <deque>
+
+namespace Rocket {
+namespace Core {
+
+// A batch of jobs being run; the threads waiting on the batch wait until its count reaches zero.
+struct TaskBatch
+{
+	int num_remaining;
+	// True for jobs queued with Submit(), which run on the worker threads in the background.
+	bool background;
+};
+
+// A job waiting to be run, and the batch it belongs to.
+struct QueuedJob
+{
+	SystemInterface::JobFunction function;
+	void* data;
+	int index;
+	TaskBatch* batch;
+};
+
+typedef std::deque< QueuedJob > JobQueue;
+
+// One of the pool's threads. Jobs queued by the worker go onto its own queue, which it runs newest-first; idle threads
+// steal the oldest jobs from the front.
+struct Worker
+{
+	Thread* thread;
+	uintptr_t identifier;
+	JobQueue queue;
+};
+
+typedef std::vector< Worker* > WorkerList;
+
+static int num_threads = 1;
+static int num_background_threads = 1;
+static WorkerList workers;
+static bool stopping = false;
+
+// Guards the queues, the workers and the batch counts.
+static Mutex mutex;
+// Signalled when jobs are queued or the workers are stopping.
+static Condition job_queued;
+// Signalled when a batch's last job completes.
+static Condition batch_completed;
+// Jobs queued from threads outside the pool.
+static JobQueue shared_queue;
+// Jobs queued with Submit(). These are kept apart from the batches of parallel work, so a thread waiting on a batch
+// doesn't pick up a long-running background job.
+static JobQueue background_queue;
+
+Task::~Task()
+{
+}
+
+// Runs one task of a batch passed to the system interface.
+static void ExecuteTask(void* data, int index)
+{
+	static_cast< Task** >(data)[index]->Execute();
+}
+
+// Returns the worker for the calling thread, or NULL if it isn't one of the pool's threads; the mutex must be locked.
+static Worker* FindWorker()
+{
+	uintptr_t identifier = GetThreadIdentifier();
+	for (size_t i = 0; i < workers.size(); ++i)
+	{
+		if (workers[i]->identifier == identifier)
+			return workers[i];
+	}
+
+	return NULL;
+}
+
+// Runs queued jobs on a worker thread until the pool is stopped.
+static void WorkerMain(void* argument);
+
+// Starts the pool's threads if they aren't running; the mutex must be locked.
+static void StartWorkers()
+{
+	if (!workers.empty())
+		return;
+
+	stopping = false;
+	int num_workers = Math::Max(num_threads - 1, num_background_threads);
+	for (int i = 0; i < num_workers; ++i)
+	{
+		Worker* worker = new Worker();
+		worker->thread = new Thread();
+		worker->identifier = 0;
+		workers.push_back(worker);
+
+		// The worker records its identifier once it can lock the mutex.
+		if (!worker->thread->Start(WorkerMain, worker))
+		{
+			workers.pop_back();
+			delete worker->thread;
+			delete worker;
+			break;
+		}
+	}
+}
+
+// Queues a job onto the calling thread's queue; the mutex must be locked.
+static void PushJob(Worker* worker, SystemInterface::JobFunction function, void* data, int index, TaskBatch* batch)
+{
+	QueuedJob job;
+	job.function = function;
+	job.data = data;
+	job.index = index;
+	job.batch = batch;
+
+	if (batch->background)
+		background_queue.push_back(job);
+	else if (worker != NULL)
+		worker->queue.push_back(job);
+	else
+		shared_queue.push_back(job);
+}
+
+// Takes the next job for the calling thread, stealing from the other workers if it has none of its own, and then
+// taking a background job if allowed; the mutex must be locked.
+static bool PopJob(Worker* worker, QueuedJob& job, bool background)
+{
+	if (worker != NULL &&
+		!worker->queue.empty())
+	{
+		job = worker->queue.back();
+		worker->queue.pop_back();
+		return true;
+	}
+
+	if (!shared_queue.empty())
+	{
+		job = shared_queue.front();
+		shared_queue.pop_front();
+		return true;
+	}
+
+	for (size_t i = 0; i < workers.size(); ++i)
+	{
+		if (workers[i] != worker &&
+			!workers[i]->queue.empty())
+		{
+			job = workers[i]->queue.front();
+			workers[i]->queue.pop_front();
+			return true;
+		}
+	}
+
+	if (background &&
+		!background_queue.empty())
+	{
+		job = background_queue.front();
+		background_queue.pop_front();
+		return true;
+	}
+
+	return false;
+}
+
+// Runs a job taken from a queue; the mutex must be locked, and will be locked again when this returns.
+static void ExecuteJob(const QueuedJob& job)
+{
+	mutex.Unlock();
+	job.function(job.data, job.index);
+	mutex.Lock();
+
+	job.batch->num_remaining--;
+	if (job.batch->num_remaining == 0)
+		batch_completed.Broadcast();
+}
+
+// Runs queued jobs on the calling thread until a batch has completed; the mutex must be locked.
+static void WaitForBatch(TaskBatch* batch)
+{
+	Worker* worker = FindWorker();
+
+	// Help out with the queues while we wait; this may run jobs from other batches, which is fine as they're all
+	// independent of ours. Background jobs are only run while waiting on one, as they may take a while.
+	QueuedJob job;
+	while (batch->num_remaining > 0)
+	{
+		if (PopJob(worker, job, batch->background))
+			ExecuteJob(job);
+		else
+			batch_completed.Wait(mutex);
+	}
+}
+
+// Runs queued jobs on a worker thread until the pool is stopped.
+static void WorkerMain(void* argument)
+{
+	Worker* worker = static_cast< Worker* >(argument);
+
+	mutex.Lock();
+	worker->identifier = GetThreadIdentifier();
+
+	QueuedJob job;
+	for (;;)
+	{
+		if (PopJob(worker, job, true))
+			ExecuteJob(job);
+		else if (stopping)
+			break;
+		else
+			job_queued.Wait(mutex);
+	}
+
+	mutex.Unlock();
+}
+
+// Sets the number of threads that will run tasks.
+void TaskPool::SetNumThreads(int _num_threads)
+{
+	if (_num_threads <= 0)
+		_num_threads = GetNumProcessors();
+
+	if (_num_threads == num_threads)
+		return;
+
+	// Stop the current workers; the new ones will be started with the next job.
+	Shutdown();
+	num_threads = _num_threads;
+}
+
+// Returns the number of threads that will run tasks.
+int TaskPool::GetNumThreads()
+{
+	return num_threads;
+}
+
+// Sets the number of threads that will run background jobs.
+void TaskPool::SetNumBackgroundThreads(int _num_background_threads)
+{
+	if (_num_background_threads < 0)
+		_num_background_threads = GetNumProcessors();
+
+	if (_num_background_threads == num_background_threads)
+		return;
+
+	Shutdown();
+	num_background_threads = _num_background_threads;
+}
+
+// Returns the number of threads that will run background jobs.
+int TaskPool::GetNumBackgroundThreads()
+{
+	return num_background_threads;
+}
+
+// Runs a batch of tasks through the system interface, returning once all of them have completed.
+void TaskPool::Run(Task** tasks, int num_tasks)
+{
+	if (num_threads <= 1 ||
+		num_tasks <= 1)
+	{
+		for (int i = 0; i < num_tasks; ++i)
+			tasks[i]->Execute();
+
+		return;
+	}
+
+	GetSystemInterface()->ParallelFor(ExecuteTask, tasks, num_tasks);
+}
+
+// Queues a job on the pool's own threads.
+SystemInterface::JobHandle TaskPool::Submit(SystemInterface::JobFunction function, void* data)
+{
+	TaskBatch* batch = new TaskBatch();
+	batch->num_remaining = 1;
+	batch->background = true;
+
+	if (num_background_threads <= 0)
+	{
+		function(data, 0);
+		batch->num_remaining = 0;
+		return batch;
+	}
+
+	mutex.Lock();
+	StartWorkers();
+	PushJob(FindWorker(), function, data, 0, batch);
+	job_queued.Broadcast();
+	mutex.Unlock();
+
+	return batch;
+}
+
+// Waits for a job queued with Submit() to complete.
+void TaskPool::Wait(SystemInterface::JobHandle job)
+{
+	TaskBatch* batch = static_cast< TaskBatch* >(job);
+	if (batch == NULL)
+		return;
+
+	mutex.Lock();
+	WaitForBatch(batch);
+	mutex.Unlock();
+
+	delete batch;
+}
+
+// Runs a function once for every index in a range on the pool's own threads.
+void TaskPool::ParallelFor(SystemInterface::JobFunction function, void* data, int count)
+{
+	if (num_threads <= 1 ||
+		count <= 1)
+	{
+		for (int i = 0; i < count; ++i)
+			function(data, i);
+
+		return;
+	}
+
+	TaskBatch batch;
+	batch.num_remaining = count;
+	batch.background = false;
+
+	mutex.Lock();
+	StartWorkers();
+
+	Worker* worker = FindWorker();
+	for (int i = 0; i < count; ++i)
+		PushJob(worker, function, data, i, &batch);
+	job_queued.Broadcast();
+
+	WaitForBatch(&batch);
+	mutex.Unlock();
+}
+
+// Stops the pool's threads.
+void TaskPool::Shutdown()
+{
+	mutex.Lock();
+	stopping = true;
+	job_queued.Broadcast();
+	WorkerList stopped_workers = workers;
+	mutex.Unlock();
+
+	// The workers drain the queues before they stop, so they stay in the list (and can be stolen from) until they
+	// have all been joined.
+	for (size_t i = 0; i < stopped_workers.size(); ++i)
+		delete stopped_workers[i]->thread;
+
+	mutex.Lock();
+	for (size_t i = 0; i < stopped_workers.size(); ++i)
+		delete stopped_workers[i];
+	workers.clear();
+	mutex.Unlock();
+}
+
+}
+}
@@ -0,0 +1,99 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCORETASKPOOL_H
+#define ROCKETCORETASKPOOL_H
+
+#include <Rocket/Core/SystemInterface.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	A unit of work that can be run on the task pool.
+ */
+
+class Task
+{
+public:
+	virtual ~Task();
+
+	/// Runs the task. This may be called from any thread.
+	virtual void Execute() = 0;
+};
+
+/**
+	Runs libRocket's parallel work. Batches of tasks are passed to the system interface's job functions, which by
+	default run them on the pool's own work-stealing worker threads. Background jobs, such as texture decodes, are
+	run on the same threads, so enough are started for both the tasks and the background jobs; they are only started
+	the first time a job is queued.
+ */
+
+class TaskPool
+{
+public:
+	/// Sets the number of threads that will run tasks, including the thread that runs the batch.
+	/// @param[in] num_threads The number of threads. One runs all tasks on the calling thread, zero uses one thread per processor.
+	static void SetNumThreads(int num_threads);
+	/// Returns the number of threads that will run tasks, including the thread that runs the batch.
+	static int GetNumThreads();
+	/// Sets the minimum number of worker threads that run background jobs queued with Submit().
+	/// @param[in] num_threads The number of threads. Zero runs background jobs on the calling thread as they are submitted, a negative number uses one thread per processor.
+	static void SetNumBackgroundThreads(int num_threads);
+	/// Returns the minimum number of worker threads that run background jobs.
+	static int GetNumBackgroundThreads();
+
+	/// Runs a batch of tasks through the system interface, returning once all of them have completed. If only one
+	/// thread has been requested, the tasks are run on the calling thread.
+	/// @param[in] tasks The tasks to run.
+	/// @param[in] num_tasks The number of tasks.
+	static void Run(Task** tasks, int num_tasks);
+
+	/// Queues a background job on the pool's own threads. Threads waiting on a batch of tasks won't run the job.
+	/// @param[in] function The function to run.
+	/// @param[in] data The data to pass to the function.
+	/// @return A handle to the job, which must be passed to Wait().
+	static SystemInterface::JobHandle Submit(SystemInterface::JobFunction function, void* data);
+	/// Waits for a job queued with Submit() to complete. The calling thread runs queued jobs while it waits.
+	/// @param[in] job The job's handle.
+	static void Wait(SystemInterface::JobHandle job);
+	/// Runs a function once for every index in a range on the pool's own threads, returning once all have completed.
+	/// The calling thread runs queued jobs while it waits, so the function may safely run loops of its own.
+	/// @param[in] function The function to run.
+	/// @param[in] data The data to pass to each call of the function.
+	/// @param[in] count The number of calls to make.
+	static void ParallelFor(SystemInterface::JobFunction function, void* data, int count);
+
+	/// Stops the pool's threads.
+	static void Shutdown();
+};
+
+}
+}
+
+#endif
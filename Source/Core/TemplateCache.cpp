@@ -29,12 +29,14 @@
 #include "TemplateCache.h"
 #include "StreamFile.h"
 #include "Template.h"
+#include "Threading.h"
 #include <Rocket/Core/Log.h>
 
 namespace Rocket {
 namespace Core {
 
 static TemplateCache* instance = NULL;
+static Mutex mutex;
 
 TemplateCache::TemplateCache()
 {
@@ -66,6 +68,8 @@ void TemplateCache::Shutdown()
 
 Template* TemplateCache::LoadTemplate(const String& name)
 {
+	MutexLock lock(mutex);
+
 	// Check if the template is already loaded
 	Templates::iterator itr = instance->templates.find(name);
 	if (itr != instance->templates.end())
@@ -106,6 +110,8 @@ Template* TemplateCache::LoadTemplate(const String& name)
 
 Template* TemplateCache::GetTemplate(const String& name)
 {
+	MutexLock lock(mutex);
+
 	// Check if the template is already loaded
 	Templates::iterator itr = instance->template_ids.find(name);
 	if (itr != instance->template_ids.end())
@@ -89,6 +89,15 @@ Vector2i Texture::GetDimensions(RenderInterface* render_interface) const
 	return resource->GetDimensions(render_interface);
 }
 
+// Returns true if the texture is being loaded in the background.
+bool Texture::IsLoading(RenderInterface* render_interface) const
+{
+	if (resource == NULL)
+		return false;
+
+	return resource->IsLoading(render_interface);
+}
+
 // Releases this texture's resource (if any), and sets it to another texture's resource.
 const Texture& Texture::operator=(const Texture& copy)
 {
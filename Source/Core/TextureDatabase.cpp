@@ -28,12 +28,14 @@
 #include "precompiled.h"
 #include "TextureDatabase.h"
 #include "TextureResource.h"
+#include "Threading.h"
 #include <Rocket/Core.h>
 
 namespace Rocket {
 namespace Core {
 
 static TextureDatabase* instance = NULL;
+static Mutex mutex;
 
 TextureDatabase::TextureDatabase()
 {
@@ -67,12 +69,13 @@ TextureResource* TextureDatabase::Fetch(const String& source, const String& sour
 	else
 		GetSystemInterface()->JoinPath(path, source_directory.Replace("|", ":"), source);
 
+	MutexLock lock(mutex);
+
+	// A texture may still be in the database while it is being released on another thread; if so, we replace it.
 	TextureMap::iterator iterator = instance->textures.find(path);
-	if (iterator != instance->textures.end())
-	{
-		(*iterator).second->AddReference();
+	if (iterator != instance->textures.end() &&
+		(*iterator).second->AddReferenceIfReferenced())
 		return (*iterator).second;
-	}
 
 	TextureResource* resource = new TextureResource();
 	if (!resource->Load(path))
@@ -88,6 +91,7 @@ TextureResource* TextureDatabase::Fetch(const String& source, const String& sour
 // Releases all textures in the database.
 void TextureDatabase::ReleaseTextures()
 {
+	MutexLock lock(mutex);
 	for (TextureMap::iterator i = instance->textures.begin(); i != instance->textures.end(); ++i)
 		i->second->Release();
 }
@@ -97,8 +101,10 @@ void TextureDatabase::RemoveTexture(TextureResource* texture)
 {
 	if (instance != NULL)
 	{
+		MutexLock lock(mutex);
 		TextureMap::iterator iterator = instance->textures.find(texture->GetSource());
-		if (iterator != instance->textures.end())
+		if (iterator != instance->textures.end() &&
+			(*iterator).second == texture)
 			instance->textures.erase(iterator);
 	}
 }
@@ -108,10 +114,33 @@ void TextureDatabase::ReleaseTextures(RenderInterface* render_interface)
 {
 	if (instance != NULL)
 	{
+		MutexLock lock(mutex);
 		for (TextureMap::iterator i = instance->textures.begin(); i != instance->textures.end(); ++i)
 			i->second->Release(render_interface);
 	}
 }
 
+// Adds the texture memory held by all textures in the database to a breakdown.
+void TextureDatabase::GetMemoryUsage(MemoryUsage& usage)
+{
+	if (instance == NULL)
+		return;
+
+	MutexLock lock(mutex);
+	for (TextureMap::iterator i = instance->textures.begin(); i != instance->textures.end(); ++i)
+	{
+		if (i->first.Substring(0, 7) == "?font::")
+			usage.Add(MemoryUsage::FONTS, i->second->GetMemoryUsage());
+		else
+			usage.Add(MemoryUsage::TEXTURES, i->second->GetMemoryUsage());
+	}
+}
+
+// Returns the lock protecting the database and its textures.
+Mutex& TextureDatabase::GetMutex()
+{
+	return mutex;
+}
+
 }
 }
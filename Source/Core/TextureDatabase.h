@@ -34,6 +34,8 @@
 namespace Rocket {
 namespace Core {
 
+class MemoryUsage;
+class Mutex;
 class RenderInterface;
 class TextureResource;
 
@@ -60,6 +62,15 @@ public:
 	/// Release all textures bound through a render interface.
 	static void ReleaseTextures(RenderInterface* render_interface);
 
+	/// Adds the texture memory held by all textures in the database to a breakdown. Font textures are reported
+	/// separately from image textures.
+	static void GetMemoryUsage(MemoryUsage& usage);
+
+	/// Returns the lock protecting the database and its textures. Font layers are generated on demand from within
+	/// texture loads, so the font database and its font faces share this lock rather than risk a lock-order
+	/// inversion.
+	static Mutex& GetMutex();
+
 private:
 	TextureDatabase();
 	~TextureDatabase();
@@ -0,0 +1,371 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "precompiled.h"
+#include "TextureLoader.h"
+#include "ElementDecoration.h"
+#include "ImageDecoder.h"
+#include "TextureDatabase.h"
+#include "TextureResource.h"
+#include "Threading.h"
+#include <Rocket/Core.h>
+
+namespace Rocket {
+namespace Core {
+
+// A texture being loaded through a render interface.
+struct TextureLoad
+{
+	TextureResource* texture;
+	RenderInterface* render_interface;
+	String source;
+	SystemInterface::JobHandle job;
+
+	// The decoded pixels or compressed blocks, written by the job.
+	std::vector< byte > data;
+	Vector2i dimensions;
+	bool decoded;
+	bool complete;
+
+	bool compressed;
+	RenderInterface::CompressedTextureFormat format;
+	int num_mipmaps;
+};
+
+// An element waiting on a texture.
+struct TextureListener
+{
+	String source;
+	Element* element;
+	bool decorated;
+	bool loaded;
+};
+
+typedef std::vector< TextureLoad* > TextureLoadList;
+typedef std::vector< TextureListener > TextureListenerList;
+
+static TextureLoadList loads;
+static TextureListenerList listeners;
+
+static bool enabled = false;
+static String placeholder_source;
+static TextureResource* placeholder = NULL;
+
+static Mutex mutex;
+
+// Reads and decodes a texture's file on a job.
+static void DecodeTexture(void* data, int ROCKET_UNUSED(index))
+{
+	TextureLoad* load = static_cast< TextureLoad* >(data);
+	bool decoded = false;
+	bool compressed = false;
+
+	FileInterface* file_interface = GetFileInterface();
+	FileHandle handle = file_interface->Open(load->source);
+	if (handle)
+	{
+		std::vector< byte > buffer;
+		size_t size = 0;
+		const byte* file_data = ImageDecoder::ReadFile(handle, size, buffer);
+
+		// Compressed textures are passed straight through to the render interface; anything else is decoded by it.
+		if (file_data != NULL)
+		{
+			compressed = ImageDecoder::ReadCompressed(load->data, load->format, load->dimensions, load->num_mipmaps, file_data, size);
+			decoded = compressed || load->render_interface->DecodeTexture(load->data, load->dimensions, file_data, size, load->source);
+		}
+
+		file_interface->Close(handle);
+	}
+
+	// Don't trust the render interface to have filled in all of the pixels it claims to have.
+	if (decoded &&
+		!compressed &&
+		(load->dimensions.x <= 0 ||
+		 load->dimensions.y <= 0 ||
+		 load->data.size() < (size_t) load->dimensions.x * (size_t) load->dimensions.y * 4))
+		decoded = false;
+
+	MutexLock lock(mutex);
+	load->decoded = decoded;
+	load->compressed = compressed;
+	load->complete = true;
+}
+
+// Enables or disables background loading.
+void TextureLoader::SetEnabled(bool _enabled)
+{
+	MutexLock lock(mutex);
+	enabled = _enabled;
+}
+
+// Returns true if background loading is enabled.
+bool TextureLoader::IsEnabled()
+{
+	MutexLock lock(mutex);
+	return enabled;
+}
+
+// Sets the texture drawn in place of textures that are still loading.
+void TextureLoader::SetPlaceholder(const String& source)
+{
+	MutexLock database_lock(TextureDatabase::GetMutex());
+	MutexLock lock(mutex);
+
+	if (placeholder != NULL)
+	{
+		placeholder->RemoveReference();
+		placeholder = NULL;
+	}
+
+	placeholder_source = source;
+}
+
+// Returns the placeholder texture, or NULL if there is none.
+TextureResource* TextureLoader::GetPlaceholder()
+{
+	MutexLock lock(mutex);
+
+	// The placeholder is fetched when it is first needed, as it may be set before the texture database exists.
+	if (placeholder == NULL &&
+		!placeholder_source.Empty())
+	{
+		placeholder = TextureDatabase::Fetch(placeholder_source, "");
+		if (placeholder == NULL)
+			placeholder_source.Clear();
+	}
+
+	return placeholder;
+}
+
+// Starts loading a texture in the background.
+bool TextureLoader::Load(TextureResource* texture, RenderInterface* render_interface)
+{
+	const String& source = texture->GetSource();
+	if (source.Empty() ||
+		source[0] == '?')
+		return false;
+
+	MutexLock lock(mutex);
+
+	// The placeholder itself has to be loaded immediately.
+	if (!enabled ||
+		texture == placeholder)
+		return false;
+
+	TextureLoad* load = new TextureLoad();
+	load->texture = texture;
+	load->render_interface = render_interface;
+	load->source = source;
+	load->decoded = false;
+	load->complete = false;
+	load->compressed = false;
+	load->format = RenderInterface::COMPRESSED_BC1;
+	load->num_mipmaps = 0;
+	loads.push_back(load);
+
+	load->job = GetSystemInterface()->SubmitJob(DecodeTexture, load);
+	return true;
+}
+
+// Cancels the background loads of a texture.
+void TextureLoader::Cancel(TextureResource* texture, RenderInterface* render_interface)
+{
+	TextureLoadList cancelled_loads;
+
+	{
+		MutexLock lock(mutex);
+		for (size_t i = 0; i < loads.size(); )
+		{
+			if (loads[i]->texture == texture &&
+				(render_interface == NULL || loads[i]->render_interface == render_interface))
+			{
+				cancelled_loads.push_back(loads[i]);
+				loads.erase(loads.begin() + i);
+			}
+			else
+				++i;
+		}
+	}
+
+	// The jobs may still be decoding, so we have to wait for them without the lock.
+	for (size_t i = 0; i < cancelled_loads.size(); ++i)
+	{
+		GetSystemInterface()->WaitForJob(cancelled_loads[i]->job);
+		delete cancelled_loads[i];
+	}
+}
+
+// Generates the textures that have finished decoding for a render interface and notifies their listeners.
+void TextureLoader::GenerateTextures(RenderInterface* render_interface)
+{
+	TextureLoadList completed_loads;
+	TextureListenerList loaded_listeners;
+
+	{
+		MutexLock lock(mutex);
+
+		for (size_t i = 0; i < loads.size(); )
+		{
+			TextureLoad* load = loads[i];
+
+			// A texture that is being released is left for TextureLoader::Cancel() to clean up.
+			if (load->render_interface != render_interface ||
+				!load->complete ||
+				!load->texture->AddReferenceIfReferenced())
+			{
+				++i;
+				continue;
+			}
+
+			loads.erase(loads.begin() + i);
+			completed_loads.push_back(load);
+		}
+	}
+
+	// The jobs have finished decoding, so waiting on them is quick, but it is still done without the locks held.
+	for (size_t i = 0; i < completed_loads.size(); ++i)
+	{
+		TextureLoad* load = completed_loads[i];
+		GetSystemInterface()->WaitForJob(load->job);
+
+		TextureHandle handle = 0;
+		bool generated = false;
+		if (load->decoded)
+		{
+			if (load->compressed)
+				generated = render_interface->GenerateCompressedTexture(handle, load->format, &load->data[0], load->data.size(), load->dimensions, load->num_mipmaps);
+			else
+				generated = render_interface->GenerateTexture(handle, &load->data[0], load->dimensions);
+		}
+
+		// This takes the texture database's lock, and discards the texture if it was released in the meantime.
+		bool loaded = load->texture->FinishLoad(render_interface, generated, handle, load->dimensions, load->compressed ? load->data.size() : 0);
+
+		{
+			MutexLock lock(mutex);
+
+			for (size_t j = 0; j < listeners.size(); )
+			{
+				if (listeners[j].source == load->source)
+				{
+					listeners[j].element->AddReference();
+					listeners[j].loaded = loaded;
+					loaded_listeners.push_back(listeners[j]);
+					listeners.erase(listeners.begin() + j);
+				}
+				else
+					++j;
+			}
+		}
+
+		load->texture->RemoveReference();
+		delete load;
+	}
+
+	// The listeners are notified without the locks held, as their event handlers may load more textures.
+	for (size_t i = 0; i < loaded_listeners.size(); ++i)
+	{
+		Element* element = loaded_listeners[i].element;
+
+		// The element's size and decorators were generated against the placeholder, so they are generated again
+		// whether or not the texture loaded.
+		element->DirtyLayout();
+		element->DirtyRenderCache();
+		if (loaded_listeners[i].decorated)
+			element->GetElementDecoration()->ReloadDecorators();
+
+		if (loaded_listeners[i].loaded)
+		{
+			Dictionary parameters;
+			parameters.Set("source", loaded_listeners[i].source);
+			element->DispatchEvent(LOAD, parameters, true);
+		}
+
+		element->RemoveReference();
+	}
+}
+
+// Adds an element as a listener on a texture that is loading.
+void TextureLoader::AddListener(const String& source, Element* element, bool decorated)
+{
+	MutexLock lock(mutex);
+
+	for (size_t i = 0; i < listeners.size(); ++i)
+	{
+		if (listeners[i].element == element &&
+			listeners[i].source == source)
+		{
+			listeners[i].decorated |= decorated;
+			return;
+		}
+	}
+
+	TextureListener listener;
+	listener.source = source;
+	listener.element = element;
+	listener.decorated = decorated;
+	listener.loaded = false;
+	listeners.push_back(listener);
+}
+
+// Removes an element as a listener from all textures.
+void TextureLoader::RemoveListener(Element* element)
+{
+	MutexLock lock(mutex);
+
+	for (size_t i = 0; i < listeners.size(); )
+	{
+		if (listeners[i].element == element)
+			listeners.erase(listeners.begin() + i);
+		else
+			++i;
+	}
+}
+
+// Cancels all loads and releases the placeholder.
+void TextureLoader::Shutdown()
+{
+	TextureLoadList cancelled_loads;
+
+	{
+		MutexLock lock(mutex);
+		cancelled_loads.swap(loads);
+		listeners.clear();
+	}
+
+	for (size_t i = 0; i < cancelled_loads.size(); ++i)
+	{
+		GetSystemInterface()->WaitForJob(cancelled_loads[i]->job);
+		delete cancelled_loads[i];
+	}
+
+	SetPlaceholder(placeholder_source);
+}
+
+}
+}
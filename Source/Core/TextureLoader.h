@@ -0,0 +1,93 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef ROCKETCORETEXTURELOADER_H
+#define ROCKETCORETEXTURELOADER_H
+
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+class Element;
+class RenderInterface;
+class TextureResource;
+
+/**
+	Loads textures in the background. A texture's file is read through the file interface and decoded through
+	RenderInterface::DecodeTexture() on a job, and the decoded pixels are handed to RenderInterface::GenerateTexture()
+	when a context using the render interface is next rendered. Until then, the texture is drawn with the placeholder
+	texture if one is set. Elements that used the texture while it was loading are listeners on it; they are sent a
+	'load' event once it is ready.
+ */
+
+class TextureLoader
+{
+public:
+	/// Enables or disables background loading.
+	static void SetEnabled(bool enabled);
+	/// Returns true if background loading is enabled.
+	static bool IsEnabled();
+
+	/// Sets the texture drawn in place of textures that are still loading.
+	/// @param[in] source The placeholder's source, or the empty string for no placeholder.
+	static void SetPlaceholder(const String& source);
+	/// Returns the placeholder texture, or NULL if there is none.
+	static TextureResource* GetPlaceholder();
+
+	/// Starts loading a texture in the background, if background loading is enabled and the texture is loaded from a
+	/// file. This must be called with the texture database's lock held.
+	/// @param[in] texture The texture to load.
+	/// @param[in] render_interface The render interface the texture is being loaded through.
+	/// @return True if the load was started, false if the texture should be loaded immediately.
+	static bool Load(TextureResource* texture, RenderInterface* render_interface);
+	/// Cancels the background loads of a texture, waiting for any that are being decoded.
+	/// @param[in] texture The texture to cancel the loads of.
+	/// @param[in] render_interface The render interface to cancel the load through, or NULL for all of them.
+	static void Cancel(TextureResource* texture, RenderInterface* render_interface = NULL);
+
+	/// Generates the textures that have finished decoding for a render interface and notifies their listeners.
+	/// @param[in] render_interface The render interface to generate the textures through.
+	static void GenerateTextures(RenderInterface* render_interface);
+
+	/// Adds an element as a listener on a texture that is loading.
+	/// @param[in] source The source of the texture.
+	/// @param[in] element The element to send a 'load' event to once the texture is ready.
+	/// @param[in] decorated True if the element's decorators should be regenerated once the texture is ready.
+	static void AddListener(const String& source, Element* element, bool decorated);
+	/// Removes an element as a listener from all textures.
+	/// @param[in] element The element to remove.
+	static void RemoveListener(Element* element);
+
+	/// Cancels all loads and releases the placeholder.
+	static void Shutdown();
+};
+
+}
+}
+
+#endif
@@ -27,8 +27,12 @@
 
 #include "precompiled.h"
 #include "TextureResource.h"
+#include "FontDistanceField.h"
 #include "FontFaceHandle.h"
+#include "ImageDecoder.h"
 #include "TextureDatabase.h"
+#include "TextureLoader.h"
+#include "Threading.h"
 #include <Rocket/Core.h>
 
 namespace Rocket {
@@ -36,6 +40,12 @@ namespace Core {
 
 TextureResource::TextureResource()
 {
+	for (int i = 0; i < NUM_PUBLISHED_SLOTS; ++i)
+	{
+		published_data[i].version = 0;
+		published_data[i].render_interface = NULL;
+		published_data[i].handle = 0;
+	}
 }
 
 TextureResource::~TextureResource()
@@ -55,27 +65,50 @@ bool TextureResource::Load(const String& _source)
 // Returns the resource's underlying texture.
 TextureHandle TextureResource::GetHandle(RenderInterface* render_interface) const
 {
-	TextureDataMap::iterator texture_iterator = texture_data.find(render_interface);
-	if (texture_iterator == texture_data.end())
+	// Once the texture has loaded, its handle can be read without the lock.
+	TextureHandle handle;
+	Vector2i dimensions;
+	if (ReadPublishedData(render_interface, handle, dimensions))
+		return handle;
+
+	MutexLock lock(TextureDatabase::GetMutex());
+
+	TextureDataMap::iterator texture_iterator = GetData(render_interface);
+	if (texture_iterator->second.loading)
 	{
-		Load(render_interface);
-		texture_iterator = texture_data.find(render_interface);
+		TextureResource* placeholder = TextureLoader::GetPlaceholder();
+		return placeholder != NULL ? placeholder->GetHandle(render_interface) : 0;
 	}
 
-	return texture_iterator->second.first;
+	return texture_iterator->second.handle;
 }
 
 // Returns the dimensions of the resource's texture.
-const Vector2i& TextureResource::GetDimensions(RenderInterface* render_interface) const
+Vector2i TextureResource::GetDimensions(RenderInterface* render_interface) const
 {
-	TextureDataMap::iterator texture_iterator = texture_data.find(render_interface);
-	if (texture_iterator == texture_data.end())
+	TextureHandle handle;
+	Vector2i dimensions;
+	if (ReadPublishedData(render_interface, handle, dimensions))
+		return dimensions;
+
+	MutexLock lock(TextureDatabase::GetMutex());
+
+	TextureDataMap::iterator texture_iterator = GetData(render_interface);
+	if (texture_iterator->second.loading)
 	{
-		Load(render_interface);
-		texture_iterator = texture_data.find(render_interface);
+		TextureResource* placeholder = TextureLoader::GetPlaceholder();
+		if (placeholder != NULL)
+			return placeholder->GetDimensions(render_interface);
 	}
 
-	return texture_iterator->second.second;
+	return texture_iterator->second.dimensions;
+}
+
+// Returns true if the texture is loading in the background.
+bool TextureResource::IsLoading(RenderInterface* render_interface) const
+{
+	MutexLock lock(TextureDatabase::GetMutex());
+	return GetData(render_interface)->second.loading;
 }
 
 // Returns the resource's source.
@@ -84,14 +117,35 @@ const String& TextureResource::GetSource() const
 	return source;
 }
 
+// Returns the number of bytes of texture memory held by the resource.
+size_t TextureResource::GetMemoryUsage() const
+{
+	size_t size = 0;
+	for (TextureDataMap::const_iterator i = texture_data.begin(); i != texture_data.end(); ++i)
+	{
+		if ((*i).second.handle != 0)
+			size += (*i).second.size;
+	}
+
+	return size;
+}
+
 // Releases the texture's handle.
 void TextureResource::Release(RenderInterface* render_interface)
 {
+	// This is done before taking the lock, as it waits on any jobs decoding the texture.
+	TextureLoader::Cancel(this, render_interface);
+
+	MutexLock lock(TextureDatabase::GetMutex());
+
+	// Withdraw the published handles before releasing them, so readers that don't take the lock stop finding them.
+	UnpublishData(render_interface);
+
 	if (render_interface == NULL)
 	{
 		for (TextureDataMap::iterator texture_iterator = texture_data.begin(); texture_iterator != texture_data.end(); ++texture_iterator)
 		{
-			TextureHandle handle = texture_iterator->second.first;
+			TextureHandle handle = texture_iterator->second.handle;
 			if (handle)
 				texture_iterator->first->ReleaseTexture(handle);
 		}
@@ -104,7 +158,7 @@ void TextureResource::Release(RenderInterface* render_interface)
 		if (texture_iterator == texture_data.end())
 			return;
 
-		TextureHandle handle = texture_iterator->second.first;
+		TextureHandle handle = texture_iterator->second.handle;
 		if (handle)
 			texture_iterator->first->ReleaseTexture(handle);
 
@@ -113,8 +167,15 @@ void TextureResource::Release(RenderInterface* render_interface)
 }
 
 // Attempts to load the texture from the source.
-bool TextureResource::Load(RenderInterface* render_interface) const
+bool TextureResource::Load(RenderInterface* render_interface, bool background) const
 {
+	if (background &&
+		TextureLoader::Load(const_cast< TextureResource* >(this), render_interface))
+	{
+		SetData(render_interface, TextureData(0, Vector2i(0, 0), 0, true));
+		return true;
+	}
+
 	// Check for special loader tokens.
 	if (!source.Empty() &&
 		source[0] == '?')
@@ -143,6 +204,20 @@ bool TextureResource::Load(RenderInterface* render_interface) const
 											 texture_id);
 			}
 		}
+		else if (protocol == "distance-field")
+		{
+			// The requested texture is part of a font face's distance field atlas.
+			delete_data = true;
+
+			FontDistanceField* distance_field;
+			int texture_id;
+
+			if (sscanf(source.CString(), "?distance-field::%p/%d", &distance_field, &texture_id) == 2)
+			{
+				MutexLock lock(TextureDatabase::GetMutex());
+				distance_field->GenerateTexture(data, dimensions, texture_id);
+			}
+		}
 
 		// If texture data was generated, great! Otherwise, fallback to the LoadTexture() code and
 		// hope the client knows what the hell to do with the question mark in their file name.
@@ -156,33 +231,152 @@ bool TextureResource::Load(RenderInterface* render_interface) const
 
 			if (success)
 			{
-				texture_data[render_interface] = TextureData(handle, dimensions);
+				SetData(render_interface, TextureData(handle, dimensions));
 				return true;
 			}
 			else
 			{
 				Log::Message(Log::LT_WARNING, "Failed to generate internal texture %s.", source.CString());
-				texture_data[render_interface] = TextureData(0, Vector2i(0, 0));
+				SetData(render_interface, TextureData(0, Vector2i(0, 0)));
 
 				return false;
 			}
 		}
 	}
 
+	// If the render interface uses the built-in decoder, we call it directly so we know the size of compressed textures.
 	TextureHandle handle;
 	Vector2i dimensions;
-	if (!render_interface->LoadTexture(handle, dimensions, source))
+	size_t size = 0;
+	bool loaded;
+	if (render_interface->default_load_texture)
+		loaded = ImageDecoder::LoadTexture(render_interface, handle, dimensions, size, source);
+	else
+		loaded = render_interface->LoadTexture(handle, dimensions, source);
+
+	if (!loaded)
 	{
 		Log::Message(Log::LT_WARNING, "Failed to load texture from %s.", source.CString());
-		texture_data[render_interface] = TextureData(0, Vector2i(0, 0));
+		SetData(render_interface, TextureData(0, Vector2i(0, 0)));
+
+		return false;
+	}
+
+	SetData(render_interface, TextureData(handle, dimensions, size));
+	return true;
+}
+
+// Completes a background load of the texture.
+bool TextureResource::FinishLoad(RenderInterface* render_interface, bool generated, TextureHandle handle, const Vector2i& dimensions, size_t size)
+{
+	MutexLock lock(TextureDatabase::GetMutex());
+
+	TextureDataMap::iterator texture_iterator = texture_data.find(render_interface);
+	if (texture_iterator == texture_data.end() ||
+		!texture_iterator->second.loading)
+	{
+		if (generated)
+			render_interface->ReleaseTexture(handle);
 
 		return false;
 	}
 
-	texture_data[render_interface] = TextureData(handle, dimensions);
+	// If the texture couldn't be decoded or generated, the render interface gets a chance to load it itself.
+	if (!generated)
+	{
+		texture_data.erase(texture_iterator);
+		return Load(render_interface, false);
+	}
+
+	SetData(render_interface, TextureData(handle, dimensions, size));
 	return true;
 }
 
+// Finds the texture's data for a render interface, loading it if necessary.
+TextureResource::TextureDataMap::iterator TextureResource::GetData(RenderInterface* render_interface) const
+{
+	TextureDataMap::iterator texture_iterator = texture_data.find(render_interface);
+	if (texture_iterator == texture_data.end())
+	{
+		Load(render_interface);
+		texture_iterator = texture_data.find(render_interface);
+	}
+
+	return texture_iterator;
+}
+
+// Stores the texture's data for a render interface, publishing it if the texture isn't loading.
+void TextureResource::SetData(RenderInterface* render_interface, const TextureData& data) const
+{
+	texture_data[render_interface] = data;
+	if (data.loading)
+		return;
+
+	UnpublishData(render_interface);
+
+	// If every slot is taken, the texture is still read correctly through the lock.
+	for (int i = 0; i < NUM_PUBLISHED_SLOTS; ++i)
+	{
+		if (published_data[i].render_interface == NULL)
+		{
+			WritePublishedData(published_data[i], render_interface, data.handle, data.dimensions);
+			return;
+		}
+	}
+}
+
+// Copies out the published data for a render interface without taking the lock.
+bool TextureResource::ReadPublishedData(RenderInterface* render_interface, TextureHandle& handle, Vector2i& dimensions) const
+{
+	if (render_interface == NULL)
+		return false;
+
+	for (int i = 0; i < NUM_PUBLISHED_SLOTS; ++i)
+	{
+		const PublishedData& published = published_data[i];
+
+		int version = published.version;
+		MemoryFence();
+
+		if ((version & 1) != 0 ||
+			published.render_interface != render_interface)
+			continue;
+
+		handle = published.handle;
+		dimensions = published.dimensions;
+
+		// If the slot was rewritten while we copied it, the copy may be torn; the caller falls back to the lock.
+		MemoryFence();
+		return published.version == version;
+	}
+
+	return false;
+}
+
+// Writes a slot of published data.
+void TextureResource::WritePublishedData(PublishedData& published, RenderInterface* render_interface, TextureHandle handle, const Vector2i& dimensions) const
+{
+	// The atomic increments are full fences, so readers see the odd version before any of the new data.
+	AtomicIncrement(published.version);
+
+	published.render_interface = render_interface;
+	published.handle = handle;
+	published.dimensions = dimensions;
+
+	AtomicIncrement(published.version);
+}
+
+// Withdraws the published data for a render interface, or for all render interfaces if it is NULL.
+void TextureResource::UnpublishData(RenderInterface* render_interface) const
+{
+	for (int i = 0; i < NUM_PUBLISHED_SLOTS; ++i)
+	{
+		if (published_data[i].render_interface != NULL &&
+			(render_interface == NULL || published_data[i].render_interface == render_interface))
+			WritePublishedData(published_data[i], NULL, 0, Vector2i(0, 0));
+	}
+}
+
 void TextureResource::OnReferenceDeactivate()
 {
 	Release();
@@ -44,6 +44,7 @@ namespace Core {
 class TextureResource : public ReferenceCountable
 {
 friend class TextureDatabase;
+friend class TextureLoader;
 
 public:
 	virtual ~TextureResource();
@@ -53,20 +54,38 @@ public:
 	/// render interface, all this does is store the source.
 	bool Load(const String& source);
 
-	/// Returns the resource's underlying texture handle.
+	/// Returns the resource's underlying texture handle. If the texture is loading in the background, this is the
+	/// placeholder's handle.
 	TextureHandle GetHandle(RenderInterface* render_interface) const;
-	/// Returns the dimensions of the resource's texture.
-	const Vector2i& GetDimensions(RenderInterface* render_interface) const;
+	/// Returns the dimensions of the resource's texture. If the texture is loading in the background, these are the
+	/// placeholder's dimensions.
+	Vector2i GetDimensions(RenderInterface* render_interface) const;
+	/// Returns true if the texture is loading in the background, starting the load if it hasn't been already.
+	bool IsLoading(RenderInterface* render_interface) const;
 
 	/// Returns the resource's source.
 	const String& GetSource() const;
 
+	/// Returns the number of bytes of texture memory held by the resource, across all render interfaces it has been
+	/// loaded through. Textures are assumed to be 32-bit.
+	size_t GetMemoryUsage() const;
+
 	/// Releases the texture's handle.
 	void Release(RenderInterface* render_interface = NULL);
 
 protected:
 	/// Attempts to load the texture from the source.
-	bool Load(RenderInterface* render_interface) const;
+	/// @param[in] render_interface The render interface to load the texture through.
+	/// @param[in] background True if the texture may be loaded in the background, false if it must be loaded now.
+	bool Load(RenderInterface* render_interface, bool background = true) const;
+	/// Completes a background load of the texture.
+	/// @param[in] render_interface The render interface the texture was loaded through.
+	/// @param[in] generated True if the texture was generated from its decoded file, false if it couldn't be and the texture should be loaded through the render interface instead.
+	/// @param[in] handle The handle of the generated texture.
+	/// @param[in] dimensions The dimensions of the generated texture.
+	/// @param[in] size The number of bytes the texture was generated from if it was compressed, or 0 if it was generated from 32-bit pixels.
+	/// @return True if the texture was loaded, false if not.
+	bool FinishLoad(RenderInterface* render_interface, bool generated, TextureHandle handle, const Vector2i& dimensions, size_t size);
 
 	/// Releases the texture and destroys the resource.
 	virtual void OnReferenceDeactivate();
@@ -76,9 +95,51 @@ private:
 
 	String source;
 
-	typedef std::pair< TextureHandle, Vector2i > TextureData;
+	struct TextureData
+	{
+		TextureData(TextureHandle _handle = 0, const Vector2i& _dimensions = Vector2i(0, 0), size_t _size = 0, bool _loading = false) : handle(_handle), dimensions(_dimensions), size(_size), loading(_loading)
+		{
+			// Textures are assumed to be uncompressed 32-bit pixels unless we know otherwise.
+			if (size == 0)
+				size = (size_t) dimensions.x * (size_t) dimensions.y * 4;
+		}
+
+		TextureHandle handle;
+		Vector2i dimensions;
+		// The number of bytes of texture memory used by the texture.
+		size_t size;
+		// True while the texture is being loaded in the background.
+		bool loading;
+	};
+
 	typedef std::map< RenderInterface*, TextureData > TextureDataMap;
 	mutable TextureDataMap texture_data;
+
+	// A copy of a loaded texture's handle and dimensions, published so they can be read without taking the texture
+	// database's lock. The version is odd while the slot is being written; a reader copies the slot out and only
+	// trusts the copy if the version was even and unchanged across it.
+	struct PublishedData
+	{
+		volatile int version;
+		RenderInterface* render_interface;
+		TextureHandle handle;
+		Vector2i dimensions;
+	};
+
+	static const int NUM_PUBLISHED_SLOTS = 4;
+	mutable PublishedData published_data[NUM_PUBLISHED_SLOTS];
+
+	// Finds the texture's data for a render interface, loading it if necessary.
+	TextureDataMap::iterator GetData(RenderInterface* render_interface) const;
+	// Stores the texture's data for a render interface, publishing it if the texture isn't loading.
+	void SetData(RenderInterface* render_interface, const TextureData& data) const;
+	// Copies out the published data for a render interface without taking the lock. Returns false if the texture
+	// isn't published for the render interface, or a slot changed while it was being read.
+	bool ReadPublishedData(RenderInterface* render_interface, TextureHandle& handle, Vector2i& dimensions) const;
+	// Writes a slot of published data. Must be called with the lock held.
+	void WritePublishedData(PublishedData& published, RenderInterface* render_interface, TextureHandle handle, const Vector2i& dimensions) const;
+	// Withdraws the published data for a render interface, or for all render interfaces if it is NULL.
+	void UnpublishData(RenderInterface* render_interface) const;
 };
 
 }
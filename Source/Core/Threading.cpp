@@ -0,0 +1,309 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "Threading.h"
+
+#if defined ROCKET_PLATFORM_WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace Rocket {
+namespace Core {
+
+Mutex::Mutex()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	CRITICAL_SECTION* critical_section = new CRITICAL_SECTION;
+	InitializeCriticalSection(critical_section);
+	handle = critical_section;
+#else
+	pthread_mutexattr_t attributes;
+	pthread_mutexattr_init(&attributes);
+	pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+
+	pthread_mutex_t* mutex = new pthread_mutex_t;
+	pthread_mutex_init(mutex, &attributes);
+	pthread_mutexattr_destroy(&attributes);
+	handle = mutex;
+#endif
+}
+
+Mutex::~Mutex()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	CRITICAL_SECTION* critical_section = (CRITICAL_SECTION*) handle;
+	DeleteCriticalSection(critical_section);
+	delete critical_section;
+#else
+	pthread_mutex_t* mutex = (pthread_mutex_t*) handle;
+	pthread_mutex_destroy(mutex);
+	delete mutex;
+#endif
+}
+
+// Locks the mutex, blocking until it is available.
+void Mutex::Lock()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	EnterCriticalSection((CRITICAL_SECTION*) handle);
+#else
+	pthread_mutex_lock((pthread_mutex_t*) handle);
+#endif
+}
+
+// Unlocks the mutex.
+void Mutex::Unlock()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	LeaveCriticalSection((CRITICAL_SECTION*) handle);
+#else
+	pthread_mutex_unlock((pthread_mutex_t*) handle);
+#endif
+}
+
+ReadWriteLock::ReadWriteLock()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	SRWLOCK* lock = new SRWLOCK;
+	InitializeSRWLock(lock);
+	handle = lock;
+#else
+	pthread_rwlock_t* lock = new pthread_rwlock_t;
+	pthread_rwlock_init(lock, NULL);
+	handle = lock;
+#endif
+}
+
+ReadWriteLock::~ReadWriteLock()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	delete (SRWLOCK*) handle;
+#else
+	pthread_rwlock_t* lock = (pthread_rwlock_t*) handle;
+	pthread_rwlock_destroy(lock);
+	delete lock;
+#endif
+}
+
+// Locks the lock for reading.
+void ReadWriteLock::LockShared()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	AcquireSRWLockShared((SRWLOCK*) handle);
+#else
+	pthread_rwlock_rdlock((pthread_rwlock_t*) handle);
+#endif
+}
+
+// Unlocks the lock after reading.
+void ReadWriteLock::UnlockShared()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	ReleaseSRWLockShared((SRWLOCK*) handle);
+#else
+	pthread_rwlock_unlock((pthread_rwlock_t*) handle);
+#endif
+}
+
+// Locks the lock for writing.
+void ReadWriteLock::Lock()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	AcquireSRWLockExclusive((SRWLOCK*) handle);
+#else
+	pthread_rwlock_wrlock((pthread_rwlock_t*) handle);
+#endif
+}
+
+// Unlocks the lock after writing.
+void ReadWriteLock::Unlock()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	ReleaseSRWLockExclusive((SRWLOCK*) handle);
+#else
+	pthread_rwlock_unlock((pthread_rwlock_t*) handle);
+#endif
+}
+
+Condition::Condition()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	CONDITION_VARIABLE* condition = new CONDITION_VARIABLE;
+	InitializeConditionVariable(condition);
+	handle = condition;
+#else
+	pthread_cond_t* condition = new pthread_cond_t;
+	pthread_cond_init(condition, NULL);
+	handle = condition;
+#endif
+}
+
+Condition::~Condition()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	delete (CONDITION_VARIABLE*) handle;
+#else
+	pthread_cond_t* condition = (pthread_cond_t*) handle;
+	pthread_cond_destroy(condition);
+	delete condition;
+#endif
+}
+
+// Unlocks the mutex and waits for the condition to be signalled.
+void Condition::Wait(Mutex& mutex)
+{
+#if defined ROCKET_PLATFORM_WIN32
+	SleepConditionVariableCS((CONDITION_VARIABLE*) handle, (CRITICAL_SECTION*) mutex.handle, INFINITE);
+#else
+	pthread_cond_wait((pthread_cond_t*) handle, (pthread_mutex_t*) mutex.handle);
+#endif
+}
+
+// Wakes all threads waiting on the condition.
+void Condition::Broadcast()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	WakeAllConditionVariable((CONDITION_VARIABLE*) handle);
+#else
+	pthread_cond_broadcast((pthread_cond_t*) handle);
+#endif
+}
+
+// The function and argument a thread was started with.
+struct ThreadStart
+{
+	Thread::Function function;
+	void* argument;
+};
+
+#if defined ROCKET_PLATFORM_WIN32
+static DWORD WINAPI ThreadMain(LPVOID parameter)
+#else
+static void* ThreadMain(void* parameter)
+#endif
+{
+	ThreadStart start = *(ThreadStart*) parameter;
+	delete (ThreadStart*) parameter;
+
+	start.function(start.argument);
+	return 0;
+}
+
+Thread::Thread() : handle(NULL)
+{
+}
+
+Thread::~Thread()
+{
+	Join();
+}
+
+// Starts the thread.
+bool Thread::Start(Function function, void* argument)
+{
+	ROCKET_ASSERT(handle == NULL);
+
+	ThreadStart* start = new ThreadStart;
+	start->function = function;
+	start->argument = argument;
+
+#if defined ROCKET_PLATFORM_WIN32
+	handle = CreateThread(NULL, 0, ThreadMain, start, 0, NULL);
+#else
+	pthread_t* thread = new pthread_t;
+	if (pthread_create(thread, NULL, ThreadMain, start) == 0)
+		handle = thread;
+	else
+		delete thread;
+#endif
+
+	if (handle == NULL)
+	{
+		delete start;
+		return false;
+	}
+
+	return true;
+}
+
+// Blocks until the thread's function has returned.
+void Thread::Join()
+{
+	if (handle == NULL)
+		return;
+
+#if defined ROCKET_PLATFORM_WIN32
+	WaitForSingleObject((HANDLE) handle, INFINITE);
+	CloseHandle((HANDLE) handle);
+#else
+	pthread_t* thread = (pthread_t*) handle;
+	pthread_join(*thread, NULL);
+	delete thread;
+#endif
+
+	handle = NULL;
+}
+
+// Orders the calling thread's memory accesses.
+void MemoryFence()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	MemoryBarrier();
+#else
+	__sync_synchronize();
+#endif
+}
+
+// Returns a value identifying the calling thread.
+uintptr_t GetThreadIdentifier()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	return (uintptr_t) GetCurrentThreadId();
+#else
+	return (uintptr_t) pthread_self();
+#endif
+}
+
+// Returns the number of processors available to the application.
+int GetNumProcessors()
+{
+#if defined ROCKET_PLATFORM_WIN32
+	SYSTEM_INFO system_info;
+	GetSystemInfo(&system_info);
+	return Math::Max(1, (int) system_info.dwNumberOfProcessors);
+#else
+	return Math::Max(1, (int) sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+}
+
+}
+}
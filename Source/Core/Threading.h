@@ -0,0 +1,263 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCORETHREADING_H
+#define ROCKETCORETHREADING_H
+
+#include <Rocket/Core/Platform.h>
+#include <Rocket/Core/Types.h>
+
+#if defined(ROCKET_PLATFORM_WIN32) && !defined(__MINGW32__)
+#include <intrin.h>
+#endif
+
+namespace Rocket {
+namespace Core {
+
+/**
+	A recursive mutex, used to protect the state that the core shares between contexts so that separate contexts can
+	be updated and rendered on separate threads.
+ */
+
+class Mutex
+{
+public:
+	Mutex();
+	~Mutex();
+
+	/// Locks the mutex, blocking until it is available. The mutex may be locked recursively by the same thread.
+	void Lock();
+	/// Unlocks the mutex. This must be called once for each call to Lock().
+	void Unlock();
+
+private:
+	Mutex(const Mutex&);
+	Mutex& operator=(const Mutex&);
+
+	void* handle;
+
+	friend class Condition;
+};
+
+/**
+	Locks a mutex for the lifetime of the lock.
+ */
+
+class MutexLock
+{
+public:
+	MutexLock(Mutex& mutex) : mutex(mutex)
+	{
+		mutex.Lock();
+	}
+
+	~MutexLock()
+	{
+		mutex.Unlock();
+	}
+
+private:
+	MutexLock(const MutexLock&);
+	MutexLock& operator=(const MutexLock&);
+
+	Mutex& mutex;
+};
+
+/**
+	A reader-writer lock, allowing any number of threads to read shared state at once while only one thread at a time
+	may modify it. Unlike Mutex, the lock is not recursive.
+ */
+
+class ReadWriteLock
+{
+public:
+	ReadWriteLock();
+	~ReadWriteLock();
+
+	/// Locks the lock for reading, blocking while another thread holds it for writing.
+	void LockShared();
+	/// Unlocks the lock after a call to LockShared().
+	void UnlockShared();
+	/// Locks the lock for writing, blocking until no other thread holds it.
+	void Lock();
+	/// Unlocks the lock after a call to Lock().
+	void Unlock();
+
+private:
+	ReadWriteLock(const ReadWriteLock&);
+	ReadWriteLock& operator=(const ReadWriteLock&);
+
+	void* handle;
+};
+
+/**
+	Locks a reader-writer lock for reading for the lifetime of the lock.
+ */
+
+class ReadLock
+{
+public:
+	ReadLock(ReadWriteLock& lock) : lock(lock)
+	{
+		lock.LockShared();
+	}
+
+	~ReadLock()
+	{
+		lock.UnlockShared();
+	}
+
+private:
+	ReadLock(const ReadLock&);
+	ReadLock& operator=(const ReadLock&);
+
+	ReadWriteLock& lock;
+};
+
+/**
+	Locks a reader-writer lock for writing for the lifetime of the lock.
+ */
+
+class WriteLock
+{
+public:
+	WriteLock(ReadWriteLock& lock) : lock(lock)
+	{
+		lock.Lock();
+	}
+
+	~WriteLock()
+	{
+		lock.Unlock();
+	}
+
+private:
+	WriteLock(const WriteLock&);
+	WriteLock& operator=(const WriteLock&);
+
+	ReadWriteLock& lock;
+};
+
+/**
+	A condition variable, used to wait on a mutex until another thread signals a change in the state it protects.
+ */
+
+class Condition
+{
+public:
+	Condition();
+	~Condition();
+
+	/// Atomically unlocks a mutex and waits for the condition to be signalled, relocking the mutex before returning.
+	/// The mutex must be locked exactly once by the calling thread. Waits may end spuriously, so the caller should
+	/// recheck the state it is waiting on.
+	/// @param[in] mutex The mutex protecting the state being waited on.
+	void Wait(Mutex& mutex);
+	/// Wakes all threads waiting on the condition.
+	void Broadcast();
+
+private:
+	Condition(const Condition&);
+	Condition& operator=(const Condition&);
+
+	void* handle;
+};
+
+/**
+	A thread of execution, running a function until it returns.
+ */
+
+class Thread
+{
+public:
+	typedef void (*Function)(void* argument);
+
+	Thread();
+	/// Joins the thread if it is still running.
+	~Thread();
+
+	/// Starts the thread.
+	/// @param[in] function The function to run on the new thread.
+	/// @param[in] argument The argument to pass to the function.
+	/// @return True if the thread was started, false otherwise.
+	bool Start(Function function, void* argument);
+	/// Blocks until the thread's function has returned.
+	void Join();
+
+private:
+	Thread(const Thread&);
+	Thread& operator=(const Thread&);
+
+	void* handle;
+};
+
+/// Atomically increments an integer.
+/// @return The incremented value.
+inline int AtomicIncrement(volatile int& value)
+{
+#if defined(ROCKET_PLATFORM_WIN32) && !defined(__MINGW32__)
+	return (int) _InterlockedIncrement((volatile long*) &value);
+#else
+	return __sync_add_and_fetch(&value, 1);
+#endif
+}
+
+/// Atomically decrements an integer.
+/// @return The decremented value.
+inline int AtomicDecrement(volatile int& value)
+{
+#if defined(ROCKET_PLATFORM_WIN32) && !defined(__MINGW32__)
+	return (int) _InterlockedDecrement((volatile long*) &value);
+#else
+	return __sync_sub_and_fetch(&value, 1);
+#endif
+}
+
+/// Atomically replaces an integer with a new value, if it is currently equal to an expected value.
+/// @return The value of the integer before the operation.
+inline int AtomicCompareExchange(volatile int& value, int exchange, int comparand)
+{
+#if defined(ROCKET_PLATFORM_WIN32) && !defined(__MINGW32__)
+	return (int) _InterlockedCompareExchange((volatile long*) &value, (long) exchange, (long) comparand);
+#else
+	return __sync_val_compare_and_swap(&value, comparand, exchange);
+#endif
+}
+
+/// Orders the calling thread's memory accesses, so that no read or write before the fence is reordered with any after
+/// it.
+void MemoryFence();
+/// Returns a value identifying the calling thread, unique among all running threads.
+uintptr_t GetThreadIdentifier();
+/// Returns the number of processors available to the application.
+int GetNumProcessors();
+
+}
+}
+
+#endif
@@ -181,6 +181,8 @@ void WidgetSlider::Update()
 				arrow_timers[i] += DEFAULT_REPEAT_PERIOD;
 				SetBarPosition(i == 0 ? OnLineDecrement() : OnLineIncrement());
 			}
+
+			ScheduleUpdate();
 		}
 	}
 }
@@ -382,6 +384,12 @@ Element* WidgetSlider::GetParent() const
 	return parent;
 }
 
+// Schedules an update of the parent element, which updates the slider.
+void WidgetSlider::ScheduleUpdate()
+{
+	parent->ScheduleUpdate();
+}
+
 // Handles events coming through from the slider's components.
 void WidgetSlider::ProcessEvent(Event& event)
 {
@@ -450,12 +458,14 @@ void WidgetSlider::ProcessEvent(Event& event)
 			arrow_timers[0] = DEFAULT_REPEAT_DELAY;
 			last_update_time = Clock::GetElapsedTime();
 			SetBarPosition(OnLineDecrement());
+			ScheduleUpdate();
 		}
 		else if (event.GetTargetElement() == arrows[1])
 		{
 			arrow_timers[1] = DEFAULT_REPEAT_DELAY;
 			last_update_time = Clock::GetElapsedTime();
 			SetBarPosition(OnLineIncrement());
+			ScheduleUpdate();
 		}
 	}
 	else if (event == MOUSEUP ||
@@ -89,6 +89,10 @@ protected:
 	/// Returns the widget's parent element.
 	Element* GetParent() const;
 
+	/// Schedules an update of the element that updates the slider, so a held arrow button keeps repeating. By default
+	/// this is the slider's parent element.
+	virtual void ScheduleUpdate();
+
 	/// Handles events coming through from the slider's components.
 	virtual void ProcessEvent(Event& event);
 
@@ -117,6 +117,14 @@ float WidgetSliderScroll::OnPageDecrement(float ROCKET_UNUSED(click_position))
 	return Scroll(-bar_length);
 }
 
+// Schedules an update of the scrolling element, which updates its scrollbars.
+void WidgetSliderScroll::ScheduleUpdate()
+{
+	Element* scrolling_element = GetParent()->GetParentNode();
+	if (scrolling_element != NULL)
+		scrolling_element->ScheduleUpdate();
+}
+
 // Returns the bar position after scrolling for a number of pixels.
 float WidgetSliderScroll::Scroll(float distance)
 {
@@ -86,6 +86,9 @@ protected:
 	/// @return The new position of the bar.
 	virtual float OnPageDecrement(float click_position);
 
+	/// Schedules an update of the scrolling element, which updates its scrollbars.
+	virtual void ScheduleUpdate();
+
 private:
 	// Returns the bar position after scrolling for a number of pixels.
 	float Scroll(float distance);
@@ -0,0 +1,209 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "ElementMemory.h"
+#include <Rocket/Core.h>
+#include <algorithm>
+#include "CommonSource.h"
+#include "MemorySource.h"
+
+namespace Rocket {
+namespace Debugger {
+
+// The minimum time between refreshes, in seconds. Walking every document in the context isn't free, so we don't do
+// it every frame.
+const float REFRESH_INTERVAL = 1.0f;
+
+// The number of documents shown in the heaviest documents list.
+const int MAX_DOCUMENTS = 5;
+
+typedef std::pair< size_t, Core::ElementDocument* > DocumentUsage;
+
+// Orders documents from heaviest to lightest.
+static bool CompareDocumentUsage(const DocumentUsage& lhs, const DocumentUsage& rhs)
+{
+	return lhs.first > rhs.first;
+}
+
+// Formats a byte count into a short human-readable string.
+static Core::String FormatBytes(size_t bytes)
+{
+	if (bytes >= 1024 * 1024)
+		return Core::String(32, "%.2f MB", bytes / (1024.0f * 1024.0f));
+	if (bytes >= 1024)
+		return Core::String(32, "%.1f KB", bytes / 1024.0f);
+
+	return Core::String(32, "%u B", (unsigned int) bytes);
+}
+
+ElementMemory::ElementMemory(const Core::String& tag) : Core::ElementDocument(tag)
+{
+	debug_context = NULL;
+	last_refresh_time = 0;
+
+	context_content = NULL;
+	documents_content = NULL;
+	shared_content = NULL;
+}
+
+ElementMemory::~ElementMemory()
+{
+}
+
+// Initialises the memory element.
+bool ElementMemory::Initialise()
+{
+	SetInnerRML(memory_rml);
+	SetId("rkt-debug-memory");
+
+	context_content = GetElementById("context-content");
+	documents_content = GetElementById("documents-content");
+	shared_content = GetElementById("shared-content");
+
+	Core::StyleSheet* style_sheet = Core::Factory::InstanceStyleSheetString(Core::String(common_rcss) + Core::String(memory_rcss));
+	if (style_sheet == NULL)
+		return false;
+
+	SetStyleSheet(style_sheet);
+	style_sheet->RemoveReference();
+
+	return true;
+}
+
+// Sets the context to report on.
+void ElementMemory::SetDebugContext(Core::Context* context)
+{
+	debug_context = context;
+
+	// Force a refresh on the next render.
+	last_refresh_time = 0;
+}
+
+void ElementMemory::OnRender()
+{
+	Core::ElementDocument::OnRender();
+
+	float time = Core::GetSystemInterface()->GetElapsedTime();
+	if (last_refresh_time > 0 &&
+		time - last_refresh_time < REFRESH_INTERVAL)
+		return;
+
+	last_refresh_time = time;
+
+	if (debug_context != NULL)
+	{
+		if (context_content != NULL)
+		{
+			Core::MemoryUsage usage;
+			debug_context->GetMemoryUsage(usage);
+			context_content->SetInnerRML(GenerateBreakdownRML(usage));
+		}
+
+		if (documents_content != NULL)
+		{
+			std::vector< DocumentUsage > documents;
+			for (int i = 0; i < debug_context->GetNumDocuments(); ++i)
+			{
+				Core::ElementDocument* document = debug_context->GetDocument(i);
+
+				// Skip our own documents if we're debugging the context we're hosted in.
+				if (document->GetId().Substring(0, 10) == "rkt-debug-")
+					continue;
+
+				Core::MemoryUsage usage;
+				document->GetMemoryUsage(usage);
+				documents.push_back(DocumentUsage(usage.GetTotal(), document));
+			}
+
+			std::sort(documents.begin(), documents.end(), CompareDocumentUsage);
+
+			Core::String documents_rml;
+			for (size_t i = 0; i < documents.size() && i < (size_t) MAX_DOCUMENTS; ++i)
+			{
+				Core::String name = documents[i].second->GetTitle();
+				if (name.Empty())
+					name = documents[i].second->GetSourceURL();
+				if (name.Empty())
+					name = documents[i].second->GetAddress();
+
+				documents_rml.Append(Core::String(256, "<div class=\"memory-row\">%s<span class=\"value\">%s</span></div>", name.Replace("<", "&lt;").Replace(">", "&gt;").CString(), FormatBytes(documents[i].first).CString()));
+			}
+
+			if (documents_rml.Empty())
+				documents_rml = "No documents loaded.";
+
+			documents_content->SetInnerRML(documents_rml);
+		}
+	}
+	else
+	{
+		if (context_content != NULL)
+			context_content->SetInnerRML("No context being debugged.");
+		if (documents_content != NULL)
+			documents_content->SetInnerRML("");
+	}
+
+	if (shared_content != NULL)
+	{
+		Core::MemoryUsage usage;
+		Core::GetMemoryUsage(usage);
+		shared_content->SetInnerRML(GenerateBreakdownRML(usage));
+	}
+}
+
+void ElementMemory::ProcessEvent(Core::Event& event)
+{
+	Core::Element::ProcessEvent(event);
+
+	if (event == "click" &&
+		event.GetTargetElement()->GetId() == "close_button")
+	{
+		if (IsVisible())
+			SetProperty("visibility", "hidden");
+	}
+}
+
+// Generates the RML for a breakdown, one row per non-empty category.
+Core::String ElementMemory::GenerateBreakdownRML(const Core::MemoryUsage& usage)
+{
+	Core::String rml;
+	for (int i = 0; i < Core::MemoryUsage::NUM_CATEGORIES; ++i)
+	{
+		size_t size = usage.Get((Core::MemoryUsage::Category) i);
+		if (size == 0)
+			continue;
+
+		rml.Append(Core::String(256, "<div class=\"memory-row\">%s<span class=\"value\">%s</span></div>", Core::MemoryUsage::GetCategoryName((Core::MemoryUsage::Category) i), FormatBytes(size).CString()));
+	}
+
+	rml.Append(Core::String(256, "<div class=\"memory-row\">Total<span class=\"value\">%s</span></div>", FormatBytes(usage.GetTotal()).CString()));
+	return rml;
+}
+
+}
+}
@@ -0,0 +1,80 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETDEBUGGERELEMENTMEMORY_H
+#define ROCKETDEBUGGERELEMENTMEMORY_H
+
+#include <Rocket/Core/ElementDocument.h>
+
+namespace Rocket {
+namespace Core {
+
+class MemoryUsage;
+
+}
+
+namespace Debugger {
+
+/**
+	Shows the estimated memory held by the debugged context, its heaviest documents and Rocket's shared resources.
+ */
+
+class ElementMemory : public Core::ElementDocument
+{
+public:
+	ElementMemory(const Core::String& tag);
+	virtual ~ElementMemory();
+
+	/// Initialises the memory element.
+	/// @return True if the element initialised successfully, false otherwise.
+	bool Initialise();
+
+	/// Sets the context to report on.
+	/// @param[in] context The context being debugged.
+	void SetDebugContext(Core::Context* context);
+
+protected:
+	virtual void OnRender();
+	virtual void ProcessEvent(Core::Event& event);
+
+private:
+	// Generates the RML for a breakdown, one row per non-empty category.
+	Core::String GenerateBreakdownRML(const Core::MemoryUsage& usage);
+
+	Core::Context* debug_context;
+	float last_refresh_time;
+
+	Core::Element* context_content;
+	Core::Element* documents_content;
+	Core::Element* shared_content;
+};
+
+}
+}
+
+#endif
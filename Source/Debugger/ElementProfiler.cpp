@@ -0,0 +1,147 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "ElementProfiler.h"
+#include <Rocket/Core.h>
+#include "CommonSource.h"
+#include "ProfilerSource.h"
+
+namespace Rocket {
+namespace Debugger {
+
+// The minimum time between refreshes of the breakdown, in seconds. Rebuilding the breakdown has its own cost, which
+// would show up in the frames we're profiling if we refreshed it every frame.
+const float REFRESH_INTERVAL = 0.5f;
+
+ElementProfiler::ElementProfiler(const Core::String& tag) : Core::ElementDocument(tag)
+{
+	profiling = false;
+	last_refresh_time = 0;
+
+	frame_content = NULL;
+	zones_content = NULL;
+	counters_content = NULL;
+}
+
+ElementProfiler::~ElementProfiler()
+{
+	SetProfiling(false);
+}
+
+// Initialises the profiler element.
+bool ElementProfiler::Initialise()
+{
+	SetInnerRML(profiler_rml);
+	SetId("rkt-debug-profiler");
+
+	frame_content = GetElementById("frame-content");
+	zones_content = GetElementById("zones-content");
+	counters_content = GetElementById("counters-content");
+
+	Core::StyleSheet* style_sheet = Core::Factory::InstanceStyleSheetString(Core::String(common_rcss) + Core::String(profiler_rcss));
+	if (style_sheet == NULL)
+		return false;
+
+	SetStyleSheet(style_sheet);
+	style_sheet->RemoveReference();
+
+	return true;
+}
+
+void ElementProfiler::OnRender()
+{
+	Core::ElementDocument::OnRender();
+
+	float time = Core::GetSystemInterface()->GetElapsedTime();
+	if (time - last_refresh_time < REFRESH_INTERVAL)
+		return;
+
+	last_refresh_time = time;
+
+	const Core::ProfileFrame& frame = Core::Profiler::GetLastFrame();
+
+	if (frame_content != NULL)
+		frame_content->SetInnerRML(Core::String(128, "<div class=\"profile-row\">Frame time<span class=\"value\">%.2f ms</span></div>", (frame.end_time - frame.start_time) * 1000.0f));
+
+	if (zones_content != NULL)
+	{
+		Core::String zones;
+		for (size_t i = 0; i < frame.zones.size(); ++i)
+			zones.Append(Core::String(256, "<div class=\"profile-row\">%s<span class=\"value\">%.2f ms</span><span class=\"value\">%d</span></div>", frame.zones[i].name, frame.zones[i].time * 1000.0f, frame.zones[i].calls));
+
+		if (zones.Empty())
+			zones = "No zones profiled.";
+
+		zones_content->SetInnerRML(zones);
+	}
+
+	if (counters_content != NULL)
+	{
+		Core::String counters;
+		for (int i = 0; i < Core::Profiler::NUM_COUNTERS; ++i)
+			counters.Append(Core::String(256, "<div class=\"profile-row\">%s<span class=\"value\">%d</span></div>", Core::Profiler::GetCounterName((Core::Profiler::Counter) i), frame.counters[i]));
+
+		counters_content->SetInnerRML(counters);
+	}
+}
+
+void ElementProfiler::OnPropertyChange(const Core::PropertyNameList& changed_properties)
+{
+	Core::ElementDocument::OnPropertyChange(changed_properties);
+
+	if (changed_properties.find("visibility") != changed_properties.end())
+		SetProfiling(IsVisible());
+}
+
+void ElementProfiler::ProcessEvent(Core::Event& event)
+{
+	Core::Element::ProcessEvent(event);
+
+	if (event == "click" &&
+		event.GetTargetElement()->GetId() == "close_button")
+	{
+		if (IsVisible())
+			SetProperty("visibility", "hidden");
+	}
+}
+
+// Enables or disables the profiler to match our visibility.
+void ElementProfiler::SetProfiling(bool _profiling)
+{
+	if (profiling == _profiling)
+		return;
+
+	profiling = _profiling;
+	if (profiling)
+		Core::Profiler::Enable();
+	else
+		Core::Profiler::Disable();
+}
+
+}
+}
@@ -0,0 +1,71 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETDEBUGGERELEMENTPROFILER_H
+#define ROCKETDEBUGGERELEMENTPROFILER_H
+
+#include <Rocket/Core/ElementDocument.h>
+
+namespace Rocket {
+namespace Debugger {
+
+/**
+	Shows a live breakdown of the last profiled frame. The profiler is enabled while the element is visible.
+ */
+
+class ElementProfiler : public Core::ElementDocument
+{
+public:
+	ElementProfiler(const Core::String& tag);
+	virtual ~ElementProfiler();
+
+	/// Initialises the profiler element.
+	/// @return True if the element initialised successfully, false otherwise.
+	bool Initialise();
+
+protected:
+	virtual void OnRender();
+	virtual void OnPropertyChange(const Core::PropertyNameList& changed_properties);
+	virtual void ProcessEvent(Core::Event& event);
+
+private:
+	// Enables or disables the profiler to match our visibility.
+	void SetProfiling(bool profiling);
+
+	bool profiling;
+	float last_refresh_time;
+
+	Core::Element* frame_content;
+	Core::Element* zones_content;
+	Core::Element* counters_content;
+};
+
+}
+}
+
+#endif
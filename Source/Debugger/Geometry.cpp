@@ -58,6 +58,7 @@ void Geometry::RenderOutline(const Core::Vector2f& origin, const Core::Vector2f&
 	Core::GeometryUtilities::GenerateQuad(vertices + 8, indices + 12, Core::Vector2f(0, 0), Core::Vector2f(width, dimensions.y), colour, 8);
 	Core::GeometryUtilities::GenerateQuad(vertices + 12, indices + 18, Core::Vector2f(dimensions.x - width, 0), Core::Vector2f(width, dimensions.y), colour, 12);
 
+	Core::ElementUtilities::FlushGeometry(render_interface);
 	render_interface->RenderGeometry(vertices, 4 * 4, indices, 6 * 4, NULL, origin);
 }
 
@@ -74,6 +75,7 @@ void Geometry::RenderBox(const Core::Vector2f& origin, const Core::Vector2f& dim
 
 	Core::GeometryUtilities::GenerateQuad(vertices, indices, Core::Vector2f(0, 0), Core::Vector2f(dimensions.x, dimensions.y), colour, 0);
 
+	Core::ElementUtilities::FlushGeometry(render_interface);
 	render_interface->RenderGeometry(vertices, 4, indices, 6, NULL, origin);
 }
 
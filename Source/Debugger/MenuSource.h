@@ -81,5 +81,7 @@ static const char* menu_rml =
 "<div id =\"button-group\">\n"
 "	<button id =\"event-log-button\">Event Log</button>\n"
 "	<button id =\"debug-info-button\">Element Info</button>\n"
+"	<button id =\"profiler-button\">Profiler</button>\n"
+"	<button id =\"memory-button\">Memory</button>\n"
 "	<button id =\"outlines-button\">Outlines</button>\n"
 "</div>\n";
@@ -31,6 +31,8 @@
 #include "ElementContextHook.h"
 #include "ElementInfo.h"
 #include "ElementLog.h"
+#include "ElementProfiler.h"
+#include "ElementMemory.h"
 #include "FontSource.h"
 #include "Geometry.h"
 #include "MenuSource.h"
@@ -53,6 +55,8 @@ Plugin::Plugin()
 	menu_element = NULL;
 	info_element = NULL;
 	log_element = NULL;
+	profiler_element = NULL;
+	memory_element = NULL;
 
 	render_outlines = false;
 }
@@ -76,7 +80,9 @@ bool Plugin::Initialise(Core::Context* context)
 
 	if (!LoadMenuElement() ||
 		!LoadInfoElement() ||
-		!LoadLogElement())
+		!LoadLogElement() ||
+		!LoadProfilerElement() ||
+		!LoadMemoryElement())
 	{
 		Core::Log::Message(Core::Log::LT_ERROR, "Failed to initialise debugger, error while load debugger elements.");
 		return false;
@@ -135,6 +141,9 @@ bool Plugin::SetContext(Core::Context* context)
 		info_element->Reset();
 	}
 
+	if (memory_element != NULL)
+		memory_element->SetDebugContext(context);
+
 	debug_context = context;
 	return true;
 }
@@ -279,6 +288,20 @@ void Plugin::ProcessEvent(Core::Event& event)
 			else
 				info_element->SetProperty("visibility", "visible");
 		}
+		else if (event.GetTargetElement()->GetId() == "profiler-button")
+		{
+			if (profiler_element->IsVisible())
+				profiler_element->SetProperty("visibility", "hidden");
+			else
+				profiler_element->SetProperty("visibility", "visible");
+		}
+		else if (event.GetTargetElement()->GetId() == "memory-button")
+		{
+			if (memory_element->IsVisible())
+				memory_element->SetProperty("visibility", "hidden");
+			else
+				memory_element->SetProperty("visibility", "visible");
+		}
 		else if (event.GetTargetElement()->GetId() == "outlines-button")
 		{
 			render_outlines = !render_outlines;
@@ -333,6 +356,12 @@ bool Plugin::LoadMenuElement()
 	Core::Element* element_info_button = menu_element->GetElementById("debug-info-button");
 	element_info_button->AddEventListener("click", this);
 
+	Core::Element* profiler_button = menu_element->GetElementById("profiler-button");
+	profiler_button->AddEventListener("click", this);
+
+	Core::Element* memory_button = menu_element->GetElementById("memory-button");
+	memory_button->AddEventListener("click", this);
+
 	Core::Element* outlines_button = menu_element->GetElementById("outlines-button");
 	outlines_button->AddEventListener("click", this);
 
@@ -384,6 +413,50 @@ bool Plugin::LoadLogElement()
 	return true;
 }
 
+bool Plugin::LoadProfilerElement()
+{
+	Core::Factory::RegisterElementInstancer("debug-profiler", new Core::ElementInstancerGeneric< ElementProfiler >())->RemoveReference();
+	profiler_element = dynamic_cast< ElementProfiler* >(host_context->CreateDocument("debug-profiler"));
+	if (profiler_element == NULL)
+		return false;
+
+	profiler_element->SetProperty("visibility", "hidden");
+
+	if (!profiler_element->Initialise())
+	{
+		profiler_element->RemoveReference();
+		host_context->UnloadDocument(profiler_element);
+		profiler_element = NULL;
+
+		return false;
+	}
+
+	return true;
+}
+
+bool Plugin::LoadMemoryElement()
+{
+	Core::Factory::RegisterElementInstancer("debug-memory", new Core::ElementInstancerGeneric< ElementMemory >())->RemoveReference();
+	memory_element = dynamic_cast< ElementMemory* >(host_context->CreateDocument("debug-memory"));
+	if (memory_element == NULL)
+		return false;
+
+	memory_element->SetProperty("visibility", "hidden");
+
+	if (!memory_element->Initialise())
+	{
+		memory_element->RemoveReference();
+		host_context->UnloadDocument(memory_element);
+		memory_element = NULL;
+
+		return false;
+	}
+
+	memory_element->SetDebugContext(debug_context);
+
+	return true;
+}
+
 void Plugin::ReleaseElements()
 {
 	if (menu_element)
@@ -405,6 +478,18 @@ void Plugin::ReleaseElements()
 		delete log_hook;
 	}
 
+	if (profiler_element)
+	{
+		profiler_element->RemoveReference();
+		profiler_element = NULL;
+	}
+
+	if (memory_element)
+	{
+		memory_element->RemoveReference();
+		memory_element = NULL;
+	}
+
 	if (hook_element)
 	{
 		hook_element->RemoveReference();
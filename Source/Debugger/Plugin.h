@@ -43,6 +43,8 @@ namespace Debugger {
 
 class ElementLog;
 class ElementInfo;
+class ElementProfiler;
+class ElementMemory;
 class ElementContextHook;
 class SystemInterface;
 
@@ -108,6 +110,8 @@ private:
 	bool LoadMenuElement();
 	bool LoadInfoElement();
 	bool LoadLogElement();
+	bool LoadProfilerElement();
+	bool LoadMemoryElement();
 	bool LoadHookElement();
 
 	// Release all loaded elements
@@ -122,6 +126,8 @@ private:
 	Core::ElementDocument* menu_element;
 	ElementInfo* info_element;
 	ElementLog* log_element;
+	ElementProfiler* profiler_element;
+	ElementMemory* memory_element;
 	ElementContextHook* hook_element;
 	SystemInterface* log_hook;
 
@@ -0,0 +1,69 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+static const char* profiler_rcss =
+"body\n"
+"{\n"
+"	width: 320px;\n"
+"	height: 300px;\n"
+"	min-width: 200px;\n"
+"	min-height: 150px;\n"
+"	top: 42;\n"
+"	left: 440;\n"
+"}\n"
+"div.profile-row\n"
+"{\n"
+"	margin: 1px 4px;\n"
+"}\n"
+"div.profile-row span.value\n"
+"{\n"
+"	float: right;\n"
+"	width: 60px;\n"
+"	text-align: right;\n"
+"}\n";
+
+static const char* profiler_rml =
+"<h1>\n"
+"	<handle id=\"position_handle\" move_target=\"#document\">\n"
+"		<div id=\"close_button\">X</div>\n"
+"		<div style=\"width: 100px;\">Profiler</div>\n"
+"	</handle>\n"
+"</h1>\n"
+"<div id=\"content\">\n"
+"	<h2>Frame</h2>\n"
+"	<div id=\"frame-content\">\n"
+"	</div>\n"
+"	<h2>Zones</h2>\n"
+"	<div id=\"zones-content\">\n"
+"		No zones profiled.\n"
+"	</div>\n"
+"	<h2>Counters</h2>\n"
+"	<div id=\"counters-content\">\n"
+"	</div>\n"
+"</div>\n"
+"<handle id=\"size_handle\" size_target=\"#document\" />";